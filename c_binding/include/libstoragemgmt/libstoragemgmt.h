@@ -3256,6 +3256,479 @@ int LSM_DLL_EXPORT lsm_volume_read_cache_policy_update(lsm_connect *conn,
                                                        uint32_t rcp,
                                                        lsm_flag flags);
 
+/**
+ * lsm_connect_fd_get - Retrieve the file descriptor of a connection.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Retrieve the file descriptor used to talk to the plugin, so it can be
+ *      added to an event loop (poll/epoll/select).  When it becomes readable
+ *      call lsm_connect_process() to collect responses for asynchronous
+ *      requests.  The descriptor is owned by the connection and must not be
+ *      read, written or closed by the caller.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @fd:
+ *      Output pointer of int. Connection file descriptor.
+ * @flags:
+ *      Reserved for future use, must be LSM_CLIENT_FLAG_RSVD.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or not a valid lsm_connect pointer
+ *              or invalid flags.
+ */
+int LSM_DLL_EXPORT lsm_connect_fd_get(lsm_connect *conn, int *fd,
+                                      lsm_flag flags);
+
+/**
+ * lsm_connect_process - Collect responses for asynchronous requests.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Read whatever response data is available on the connection without
+ *      blocking and complete the matching asynchronous requests.  Call it
+ *      whenever the descriptor from lsm_connect_fd_get() is readable, every
+ *      complete response received is consumed, so the descriptor stays
+ *      readable only while more data is pending.  Use lsm_request_done() to
+ *      check individual requests.
+ *      While any asynchronous request is outstanding, the blocking API calls
+ *      on the same connection fail with LSM_ERR_INVALID_ARGUMENT.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @completed:
+ *      Output pointer of uint32_t. Number of requests completed by this
+ *      call, not counting requests already released by lsm_request_free().
+ *      Also set when an error is returned.
+ * @flags:
+ *      Reserved for future use, must be LSM_CLIENT_FLAG_RSVD.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On success, including when no data was available.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or not a valid lsm_connect pointer
+ *              or invalid flags.
+ *          * LSM_ERR_TRANSPORT_COMMUNICATION
+ *              When the plugin went away, all outstanding requests are
+ *              completed with this error.
+ */
+int LSM_DLL_EXPORT lsm_connect_process(lsm_connect *conn, uint32_t *completed,
+                                       lsm_flag flags);
+
+/**
+ * lsm_request_done - Check if an asynchronous request has completed.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Check if the response for an asynchronous request has been received
+ *      by lsm_connect_process().
+ *
+ * @req:
+ *      Request returned by one of the *_async() functions.
+ * @done:
+ *      Output pointer of int. 1 if completed, 0 if still in progress.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When req is not a valid request or done is NULL.
+ */
+int LSM_DLL_EXPORT lsm_request_done(lsm_request *req, int *done);
+
+/**
+ * lsm_request_free - Release an asynchronous request.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Release the memory of an asynchronous request.  If the request has not
+ *      completed yet its response is discarded when it arrives.  Requests
+ *      still held when the connection is closed are released by
+ *      lsm_connect_close().
+ *
+ * @conn:
+ *      Valid lsm_connect pointer the request was submitted on.
+ * @req:
+ *      Request to release.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or invalid.
+ */
+int LSM_DLL_EXPORT lsm_request_free(lsm_connect *conn, lsm_request *req);
+
+/**
+ * lsm_volume_list_async - Submit a volume query without waiting.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Asynchronous version of lsm_volume_list(). Retrieve the result with
+ *      lsm_request_volumes_get() once the request is done.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @search_key:
+ *      Search key(NULL for all). Valid search keys are: "id", "system_id",
+ *      "pool_id".
+ * @search_value:
+ *      Search value.
+ * @req:
+ *      Output pointer of lsm_request. Should be freed by lsm_request_free().
+ * @flags:
+ *      Reserved for future use, must be LSM_CLIENT_FLAG_RSVD.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On successful submission.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or not a valid lsm_connect pointer
+ *              or invalid flags.
+ *          * LSM_ERR_UNSUPPORTED_SEARCH_KEY
+ *              When search_key is not supported.
+ *          * LSM_ERR_TRANSPORT_COMMUNICATION
+ *              When the request could not be sent.
+ */
+int LSM_DLL_EXPORT lsm_volume_list_async(lsm_connect *conn,
+                                         const char *search_key,
+                                         const char *search_value,
+                                         lsm_request **req, lsm_flag flags);
+
+/**
+ * lsm_pool_list_async - Submit a pool query without waiting.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Asynchronous version of lsm_pool_list(). Retrieve the result with
+ *      lsm_request_pools_get() once the request is done.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @search_key:
+ *      Search key(NULL for all). Valid search keys are: "id", "system_id".
+ * @search_value:
+ *      Search value.
+ * @req:
+ *      Output pointer of lsm_request. Should be freed by lsm_request_free().
+ * @flags:
+ *      Reserved for future use, must be LSM_CLIENT_FLAG_RSVD.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On successful submission.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or not a valid lsm_connect pointer
+ *              or invalid flags.
+ *          * LSM_ERR_UNSUPPORTED_SEARCH_KEY
+ *              When search_key is not supported.
+ *          * LSM_ERR_TRANSPORT_COMMUNICATION
+ *              When the request could not be sent.
+ */
+int LSM_DLL_EXPORT lsm_pool_list_async(lsm_connect *conn,
+                                       const char *search_key,
+                                       const char *search_value,
+                                       lsm_request **req, lsm_flag flags);
+
+/**
+ * lsm_volume_create_async - Submit a volume creation without waiting.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Asynchronous version of lsm_volume_create(). Retrieve the new volume
+ *      or job id with lsm_request_volume_get() once the request is done.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @pool:
+ *      Valid pool (lsm_pool) in which to create the volume.
+ * @volume_name:
+ *      Human recognizable name, not all arrays support.
+ * @size:
+ *      Size of new volume in bytes.
+ * @provisioning:
+ *      Type of volume provisioning to use, see lsm_volume_create().
+ * @req:
+ *      Output pointer of lsm_request. Should be freed by lsm_request_free().
+ * @flags:
+ *      Reserved for future use, must be LSM_CLIENT_FLAG_RSVD.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On successful submission.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or invalid.
+ *          * LSM_ERR_TRANSPORT_COMMUNICATION
+ *              When the request could not be sent.
+ */
+int LSM_DLL_EXPORT lsm_volume_create_async(
+    lsm_connect *conn, lsm_pool *pool, const char *volume_name, uint64_t size,
+    lsm_volume_provision_type provisioning, lsm_request **req, lsm_flag flags);
+
+/**
+ * lsm_volume_resize_async - Submit a volume resize without waiting.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Asynchronous version of lsm_volume_resize(). Retrieve the resized
+ *      volume or job id with lsm_request_volume_get() once the request is
+ *      done.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @volume:
+ *      Volume to re-size.
+ * @new_size:
+ *      New size of volume in bytes.
+ * @req:
+ *      Output pointer of lsm_request. Should be freed by lsm_request_free().
+ * @flags:
+ *      Reserved for future use, must be LSM_CLIENT_FLAG_RSVD.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On successful submission.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or invalid.
+ *          * LSM_ERR_NO_STATE_CHANGE
+ *              When new_size is the current volume size.
+ *          * LSM_ERR_TRANSPORT_COMMUNICATION
+ *              When the request could not be sent.
+ */
+int LSM_DLL_EXPORT lsm_volume_resize_async(lsm_connect *conn,
+                                           lsm_volume *volume,
+                                           uint64_t new_size,
+                                           lsm_request **req, lsm_flag flags);
+
+/**
+ * lsm_volume_delete_async - Submit a volume deletion without waiting.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Asynchronous version of lsm_volume_delete(). Retrieve the job id, if
+ *      any, with lsm_request_job_get() once the request is done.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @volume:
+ *      Volume that is to be deleted.
+ * @req:
+ *      Output pointer of lsm_request. Should be freed by lsm_request_free().
+ * @flags:
+ *      Reserved for future use, must be LSM_CLIENT_FLAG_RSVD.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On successful submission.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or invalid.
+ *          * LSM_ERR_TRANSPORT_COMMUNICATION
+ *              When the request could not be sent.
+ */
+int LSM_DLL_EXPORT lsm_volume_delete_async(lsm_connect *conn,
+                                           lsm_volume *volume,
+                                           lsm_request **req, lsm_flag flags);
+
+/**
+ * lsm_request_volumes_get - Retrieve volumes of a completed request.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Retrieve the result of a completed lsm_volume_list_async() request.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @req:
+ *      Completed request.
+ * @volumes:
+ *      Output pointer of lsm_volume array. It should be manually freed by
+ *      lsm_volume_record_array_free().
+ * @count:
+ *      Output pointer of uint32_t. Number of volumes.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or invalid, the request is of a
+ *              different kind or has not completed yet.
+ *          * Any error returned by the plugin for the request.
+ */
+int LSM_DLL_EXPORT lsm_request_volumes_get(lsm_connect *conn,
+                                           lsm_request *req,
+                                           lsm_volume **volumes[],
+                                           uint32_t *count);
+
+/**
+ * lsm_request_pools_get - Retrieve pools of a completed request.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Retrieve the result of a completed lsm_pool_list_async() request.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @req:
+ *      Completed request.
+ * @pools:
+ *      Output pointer of lsm_pool array. It should be manually freed by
+ *      lsm_pool_record_array_free().
+ * @count:
+ *      Output pointer of uint32_t. Number of pools.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or invalid, the request is of a
+ *              different kind or has not completed yet.
+ *          * Any error returned by the plugin for the request.
+ */
+int LSM_DLL_EXPORT lsm_request_pools_get(lsm_connect *conn, lsm_request *req,
+                                         lsm_pool **pools[], uint32_t *count);
+
+/**
+ * lsm_request_volume_get - Retrieve volume or job of a completed request.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Retrieve the result of a completed lsm_volume_create_async() or
+ *      lsm_volume_resize_async() request.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @req:
+ *      Completed request.
+ * @volume:
+ *      Output pointer of lsm_volume, NULL when a job was started. Should be
+ *      freed by lsm_volume_record_free().
+ * @job:
+ *      Output pointer of job id, NULL when the operation already finished.
+ *      Should be freed by lsm_job_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_JOB_STARTED
+ *              When a job was started, check job with lsm_job_status_get().
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or invalid, the request is of a
+ *              different kind or has not completed yet.
+ *          * Any error returned by the plugin for the request.
+ */
+int LSM_DLL_EXPORT lsm_request_volume_get(lsm_connect *conn, lsm_request *req,
+                                          lsm_volume **volume, char **job);
+
+/**
+ * lsm_request_job_get - Retrieve job id of a completed request.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Retrieve the result of a completed lsm_volume_delete_async() request.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @req:
+ *      Completed request.
+ * @job:
+ *      Output pointer of job id, NULL when the operation already finished.
+ *      Should be freed by lsm_job_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_JOB_STARTED
+ *              When a job was started, check job with lsm_job_status_get().
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or invalid, the request is of a
+ *              different kind or has not completed yet.
+ *          * Any error returned by the plugin for the request.
+ */
+int LSM_DLL_EXPORT lsm_request_job_get(lsm_connect *conn, lsm_request *req,
+                                       char **job);
+
+/**
+ * lsm_connect_rpc_timing_cb_set - Report per call timing of a connection.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Register a callback which is invoked once for every blocking call made
+ *      to the plugin on this connection, with the time spent encoding the
+ *      request, sending it, waiting for the first byte of the reply,
+ *      receiving the rest of it and parsing the JSON, together with the
+ *      request and reply payload sizes and the call result.  The callback
+ *      runs in the calling thread as soon as the reply is parsed, so the
+ *      time the API call takes beyond that is spent converting the reply
+ *      into lsm records.  When no callback is registered the only cost is a
+ *      pointer check per call.  Asynchronous requests are not timed.
+ *
+ * @conn:
+ *      Valid lsm_connect pointer.
+ * @cb:
+ *      lsm_rpc_timing_cb callback, NULL to disable timing.
+ * @user_data:
+ *      Pointer handed to the callback untouched.
+ * @flags:
+ *      Reserved for future use, must be LSM_CLIENT_FLAG_RSVD.
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number'.
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When not a valid lsm_connect pointer or invalid flags.
+ */
+int LSM_DLL_EXPORT lsm_connect_rpc_timing_cb_set(lsm_connect *conn,
+                                                 lsm_rpc_timing_cb cb,
+                                                 void *user_data,
+                                                 lsm_flag flags);
+
 #ifdef __cplusplus
 }
 #endif
@@ -66,6 +66,50 @@ int LSM_DLL_EXPORT lsm_local_disk_vpd83_search(const char *vpd83,
                                                lsm_string_list **disk_path_list,
                                                lsm_error **lsm_err);
 
+/**
+ * lsm_local_disk_vpd83_bulk_search - Search disks of many VPD83 strings.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Search all the disk paths of each specified SCSI VPD 0x83 page NAA
+ *      type ID, like lsm_local_disk_vpd83_search() does for a single one.
+ *      All local disks are enumerated and queried only once, whatever the
+ *      number of requested IDs, so this should be used when mapping many
+ *      volumes to their local disk paths.
+ *
+ * @vpd83_list:
+ *      Pointer of &lsm_string_list. The SCSI VPD 0x83 page NAA type IDs
+ *      to search.
+ * @disk_path_lists:
+ *      Output pointer of an array of &lsm_string_list, with one element per
+ *      entry of @vpd83_list in the same order. Each element holds the disk
+ *      paths of that ID, like "/dev/sdb", and is an empty list if none was
+ *      found. NULL if got error.
+ *      Memory should be freed by calling lsm_string_list_free() on every
+ *      element and then free() on the array.
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success or not found.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or any VPD83 string is too long.
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *          * LSM_ERR_LIB_BUG
+ *              When something unexpected happens.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_vpd83_bulk_search(
+    lsm_string_list *vpd83_list, lsm_string_list ***disk_path_lists,
+    lsm_error **lsm_err);
+
 /**
  * lsm_local_disk_serial_num_get - Query serial number.
  * Version:
@@ -475,6 +519,186 @@ int LSM_DLL_EXPORT lsm_local_disk_fault_led_on(const char *disk_path,
 int LSM_DLL_EXPORT lsm_local_disk_fault_led_off(const char *disk_path,
                                                 lsm_error **lsm_err);
 
+/**
+ * lsm_local_disk_ident_led_on_batch - Turn on identification LED of disks.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Turn on the identification LED for all specified disks.
+ *      Disks in the same enclosure are updated by a single SES control
+ *      page, instead of scanning all enclosures for each disk as
+ *      lsm_local_disk_ident_led_on() does. The enclosure slot of each disk is
+ *      cached until the SES generation code of its enclosure changes.
+ *      All disk paths are checked before any LED is changed. If updating
+ *      one enclosure fails, enclosures updated before it keep the new LED
+ *      state.
+ *      Require read and write access to specified disk paths.
+ *
+ * @disk_paths:
+ *      lsm_string_list. The paths of disks, example "/dev/sdb".
+ *      Empty list is allowed and changes nothing.
+ * @lsm_err:
+ *      Output pointer of lsm_error. Error message could be retrieved via
+ *      lsm_error_message_get(). Memory should be freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *          * LSM_ERR_LIB_BUG
+ *              When something unexpected happens.
+ *          * LSM_ERR_NOT_FOUND_DISK
+ *              When any provided disk path not found.
+ *          * LSM_ERR_PERMISSION_DENIED
+ *              Insufficient permission to access provided disk paths.
+ *          * LSM_ERR_NO_SUPPORT
+ *              Action is not supported by any of the disks.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_ident_led_on_batch(
+    lsm_string_list *disk_paths, lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_ident_led_off_batch - Turn off identification LED of disks.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Turn off the identification LED for all specified disks.
+ *      Disks in the same enclosure are updated by a single SES control
+ *      page, instead of scanning all enclosures for each disk as
+ *      lsm_local_disk_ident_led_off() does. The enclosure slot of each disk is
+ *      cached until the SES generation code of its enclosure changes.
+ *      All disk paths are checked before any LED is changed. If updating
+ *      one enclosure fails, enclosures updated before it keep the new LED
+ *      state.
+ *      Require read and write access to specified disk paths.
+ *
+ * @disk_paths:
+ *      lsm_string_list. The paths of disks, example "/dev/sdb".
+ *      Empty list is allowed and changes nothing.
+ * @lsm_err:
+ *      Output pointer of lsm_error. Error message could be retrieved via
+ *      lsm_error_message_get(). Memory should be freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *          * LSM_ERR_LIB_BUG
+ *              When something unexpected happens.
+ *          * LSM_ERR_NOT_FOUND_DISK
+ *              When any provided disk path not found.
+ *          * LSM_ERR_PERMISSION_DENIED
+ *              Insufficient permission to access provided disk paths.
+ *          * LSM_ERR_NO_SUPPORT
+ *              Action is not supported by any of the disks.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_ident_led_off_batch(
+    lsm_string_list *disk_paths, lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_fault_led_on_batch - Turn on the fault LED of disks.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Turn on the fault LED for all specified disks.
+ *      Disks in the same enclosure are updated by a single SES control
+ *      page, instead of scanning all enclosures for each disk as
+ *      lsm_local_disk_fault_led_on() does. The enclosure slot of each disk is
+ *      cached until the SES generation code of its enclosure changes.
+ *      All disk paths are checked before any LED is changed. If updating
+ *      one enclosure fails, enclosures updated before it keep the new LED
+ *      state.
+ *      Require read and write access to specified disk paths.
+ *
+ * @disk_paths:
+ *      lsm_string_list. The paths of disks, example "/dev/sdb".
+ *      Empty list is allowed and changes nothing.
+ * @lsm_err:
+ *      Output pointer of lsm_error. Error message could be retrieved via
+ *      lsm_error_message_get(). Memory should be freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *          * LSM_ERR_LIB_BUG
+ *              When something unexpected happens.
+ *          * LSM_ERR_NOT_FOUND_DISK
+ *              When any provided disk path not found.
+ *          * LSM_ERR_PERMISSION_DENIED
+ *              Insufficient permission to access provided disk paths.
+ *          * LSM_ERR_NO_SUPPORT
+ *              Action is not supported by any of the disks.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_fault_led_on_batch(
+    lsm_string_list *disk_paths, lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_fault_led_off_batch - Turn off the fault LED of disks.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Turn off the fault LED for all specified disks.
+ *      Disks in the same enclosure are updated by a single SES control
+ *      page, instead of scanning all enclosures for each disk as
+ *      lsm_local_disk_fault_led_off() does. The enclosure slot of each disk is
+ *      cached until the SES generation code of its enclosure changes.
+ *      All disk paths are checked before any LED is changed. If updating
+ *      one enclosure fails, enclosures updated before it keep the new LED
+ *      state.
+ *      Require read and write access to specified disk paths.
+ *
+ * @disk_paths:
+ *      lsm_string_list. The paths of disks, example "/dev/sdb".
+ *      Empty list is allowed and changes nothing.
+ * @lsm_err:
+ *      Output pointer of lsm_error. Error message could be retrieved via
+ *      lsm_error_message_get(). Memory should be freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *          * LSM_ERR_LIB_BUG
+ *              When something unexpected happens.
+ *          * LSM_ERR_NOT_FOUND_DISK
+ *              When any provided disk path not found.
+ *          * LSM_ERR_PERMISSION_DENIED
+ *              Insufficient permission to access provided disk paths.
+ *          * LSM_ERR_NO_SUPPORT
+ *              Action is not supported by any of the disks.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_fault_led_off_batch(
+    lsm_string_list *disk_paths, lsm_error **lsm_err);
+
 /**
  * lsm_local_disk_led_status_get - Query disk LED status.
  * Version:
@@ -558,6 +782,742 @@ int LSM_DLL_EXPORT lsm_local_disk_link_speed_get(const char *disk_path,
                                                  uint32_t *link_speed,
                                                  lsm_error **lsm_err);
 
+/**
+ * lsm_local_disk_info_list - Query all attributes of all local disks.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Query the disk path, VPD83, serial number, RPM, link type, link speed,
+ *      health status and LED status of every local disk listed by
+ *      lsm_local_disk_list(), like the lsm_local_disk_*_get() functions do,
+ *      in one call. The first SCSI commands of all disks are sent
+ *      asynchronously from the calling thread, then each disk is opened once
+ *      for its remaining SCSI commands and disks are queried in parallel by
+ *      up to @worker_count threads.
+ *      Failing to query an attribute of a disk is not an error: that
+ *      attribute is set to its unknown value instead.
+ *
+ * @worker_count:
+ *      Maximum number of disks queried at the same time, including the
+ *      calling thread. 0 for the default of 16.
+ * @infos:
+ *      Output pointer of &lsm_local_disk_info array, to be used with the
+ *      lsm_local_disk_info_*_get() functions. NULL if got error.
+ *      Memory should be freed by lsm_local_disk_info_array_free().
+ * @count:
+ *      Output pointer of uint32_t, the element count of @infos.
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL.
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *          * LSM_ERR_LIB_BUG
+ *              When something unexpected happens.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_info_list(uint32_t worker_count,
+                                            lsm_local_disk_info ***infos,
+                                            uint32_t *count,
+                                            lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_info_array_free - Free local disk attributes array.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Free the array returned by lsm_local_disk_info_list().
+ *
+ * @infos:
+ *      Array of &lsm_local_disk_info. NULL is ignored.
+ * @count:
+ *      Element count of @infos.
+ *
+ * Return:
+ *      void
+ *
+ */
+void LSM_DLL_EXPORT lsm_local_disk_info_array_free(
+    lsm_local_disk_info **infos, uint32_t count);
+
+/**
+ * lsm_local_disk_info_disk_path_get - Retrieve the disk path.
+ *
+ * Version:
+ *      1.9
+ *
+ * @info:
+ *      Pointer of &lsm_local_disk_info.
+ *
+ * Return:
+ *      String like "/dev/sdb". NULL if @info is invalid. Valid as long as
+ *      @info is.
+ *
+ */
+const char LSM_DLL_EXPORT *
+    lsm_local_disk_info_disk_path_get(lsm_local_disk_info *info);
+
+/**
+ * lsm_local_disk_info_vpd83_get - Retrieve the VPD83 NAA ID.
+ *
+ * Version:
+ *      1.9
+ *
+ * @info:
+ *      Pointer of &lsm_local_disk_info.
+ *
+ * Return:
+ *      String as by lsm_local_disk_vpd83_get(). Empty string if not
+ *      supported or failed to query. NULL if @info is invalid. Valid as long
+ *      as @info is.
+ *
+ */
+const char LSM_DLL_EXPORT *
+    lsm_local_disk_info_vpd83_get(lsm_local_disk_info *info);
+
+/**
+ * lsm_local_disk_info_serial_num_get - Retrieve the serial number.
+ *
+ * Version:
+ *      1.9
+ *
+ * @info:
+ *      Pointer of &lsm_local_disk_info.
+ *
+ * Return:
+ *      String as by lsm_local_disk_serial_num_get(). Empty string if not
+ *      supported or failed to query. NULL if @info is invalid. Valid as long
+ *      as @info is.
+ *
+ */
+const char LSM_DLL_EXPORT *
+    lsm_local_disk_info_serial_num_get(lsm_local_disk_info *info);
+
+/**
+ * lsm_local_disk_info_rpm_get - Retrieve the rotation speed.
+ *
+ * Version:
+ *      1.9
+ *
+ * @info:
+ *      Pointer of &lsm_local_disk_info.
+ *
+ * Return:
+ *      int32_t as by lsm_local_disk_rpm_get(). LSM_DISK_RPM_UNKNOWN if failed
+ *      to query or @info is invalid.
+ *
+ */
+int32_t LSM_DLL_EXPORT lsm_local_disk_info_rpm_get(lsm_local_disk_info *info);
+
+/**
+ * lsm_local_disk_info_link_type_get - Retrieve the link type.
+ *
+ * Version:
+ *      1.9
+ *
+ * @info:
+ *      Pointer of &lsm_local_disk_info.
+ *
+ * Return:
+ *      lsm_disk_link_type as by lsm_local_disk_link_type_get().
+ *      LSM_DISK_LINK_TYPE_UNKNOWN if failed to query or @info is invalid.
+ *
+ */
+lsm_disk_link_type LSM_DLL_EXPORT
+    lsm_local_disk_info_link_type_get(lsm_local_disk_info *info);
+
+/**
+ * lsm_local_disk_info_link_speed_get - Retrieve the link speed.
+ *
+ * Version:
+ *      1.9
+ *
+ * @info:
+ *      Pointer of &lsm_local_disk_info.
+ *
+ * Return:
+ *      Link speed in Mbps as by lsm_local_disk_link_speed_get().
+ *      LSM_DISK_LINK_SPEED_UNKNOWN if not supported, failed to query or
+ *      @info is invalid.
+ *
+ */
+uint32_t LSM_DLL_EXPORT
+    lsm_local_disk_info_link_speed_get(lsm_local_disk_info *info);
+
+/**
+ * lsm_local_disk_info_health_status_get - Retrieve the health status.
+ *
+ * Version:
+ *      1.9
+ *
+ * @info:
+ *      Pointer of &lsm_local_disk_info.
+ *
+ * Return:
+ *      int32_t as by lsm_local_disk_health_status_get().
+ *      LSM_DISK_HEALTH_STATUS_UNKNOWN if not supported, failed to query or
+ *      @info is invalid.
+ *
+ */
+int32_t LSM_DLL_EXPORT
+    lsm_local_disk_info_health_status_get(lsm_local_disk_info *info);
+
+/**
+ * lsm_local_disk_info_led_status_get - Retrieve the LED status.
+ *
+ * Version:
+ *      1.9
+ *
+ * @info:
+ *      Pointer of &lsm_local_disk_info.
+ *
+ * Return:
+ *      uint32_t as by lsm_local_disk_led_status_get().
+ *      LSM_DISK_LED_STATUS_UNKNOWN if not supported, failed to query or
+ *      @info is invalid.
+ *
+ */
+uint32_t LSM_DLL_EXPORT
+    lsm_local_disk_info_led_status_get(lsm_local_disk_info *info);
+
+/**
+ * lsm_local_disk_inventory_alloc - Create a local disk inventory.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Create an in-process inventory of the local disks, as listed by
+ *      lsm_local_disk_list(), caching their identity attributes: VPD83,
+ *      serial number, link type and RPM. Each attribute is queried from
+ *      the disk on first use only. The inventory listens to udev events of
+ *      block disks and forgets everything cached about a disk when it is
+ *      added, changed or removed, so later lookups are answered from
+ *      memory until the next hotplug event.
+ *      Pending udev events are applied on every inventory call, or could be
+ *      waited for by polling the file descriptor returned by
+ *      lsm_local_disk_inventory_fd_get().
+ *      The inventory could be used by multiple threads at once.
+ *
+ * @inventory:
+ *      Output pointer of &lsm_local_disk_inventory.
+ *      NULL if got error. Memory should be freed by
+ *      lsm_local_disk_inventory_free().
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL.
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *          * LSM_ERR_NO_SUPPORT
+ *              When udev events could not be received.
+ *          * LSM_ERR_LIB_BUG
+ *              When something unexpected happens.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_inventory_alloc(
+    lsm_local_disk_inventory **inventory, lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_inventory_free - Free a local disk inventory.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Free the memory of the local disk inventory and stop listening to
+ *      udev events.
+ *
+ * @inventory:
+ *      Pointer of &lsm_local_disk_inventory. NULL is ignored.
+ *
+ * Return:
+ *      void
+ *
+ */
+void LSM_DLL_EXPORT
+    lsm_local_disk_inventory_free(lsm_local_disk_inventory *inventory);
+
+/**
+ * lsm_local_disk_inventory_fd_get - File descriptor of udev events.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Return the file descriptor receiving the udev events of the
+ *      inventory. It becomes readable when disks are added, changed or
+ *      removed and could be used with poll() or select() to learn about
+ *      hotplug. Events are applied by the next call on the inventory. The
+ *      file descriptor belongs to the inventory and should not be read from
+ *      or closed.
+ *
+ * @inventory:
+ *      Pointer of &lsm_local_disk_inventory.
+ *
+ * Return:
+ *      File descriptor, or -1 if inventory is invalid.
+ *
+ */
+int LSM_DLL_EXPORT
+    lsm_local_disk_inventory_fd_get(lsm_local_disk_inventory *inventory);
+
+/**
+ * lsm_local_disk_inventory_refresh - Rebuild a local disk inventory.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Forget everything cached and list the local disks again. Only needed
+ *      when udev events might have been lost, like after the kernel dropped
+ *      some of them on a very busy system.
+ *
+ * @inventory:
+ *      Pointer of &lsm_local_disk_inventory.
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or inventory is invalid.
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *          * LSM_ERR_LIB_BUG
+ *              When something unexpected happens.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_inventory_refresh(
+    lsm_local_disk_inventory *inventory, lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_inventory_list - Query local disk paths from inventory.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Like lsm_local_disk_list(), but answered from the inventory.
+ *
+ * @inventory:
+ *      Pointer of &lsm_local_disk_inventory.
+ * @disk_paths:
+ *      Output pointer of &lsm_string_list, sorted. Empty &lsm_string_list
+ *      if no disk found. NULL if got error. Memory should be freed by
+ *      lsm_string_list_free().
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or inventory is invalid.
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_inventory_list(
+    lsm_local_disk_inventory *inventory, lsm_string_list **disk_paths,
+    lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_inventory_vpd83_get - Query VPD83 from inventory.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Like lsm_local_disk_vpd83_get(), but the result of disks in the
+ *      inventory is cached. Disk paths not in the inventory are passed to
+ *      lsm_local_disk_vpd83_get() every time.
+ *
+ * @inventory:
+ *      Pointer of &lsm_local_disk_inventory.
+ * @disk_path:
+ *      String. The path of disk path, example "/dev/sdb".
+ * @vpd83:
+ *      Output pointer of VPD83 NAA ID, as by lsm_local_disk_vpd83_get().
+ *      Memory should be freed by free().
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number', as by
+ *      lsm_local_disk_vpd83_get(), and LSM_ERR_INVALID_ARGUMENT when
+ *      inventory is invalid.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_inventory_vpd83_get(
+    lsm_local_disk_inventory *inventory, const char *disk_path, char **vpd83,
+    lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_inventory_serial_num_get - Query serial number from
+ * inventory.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Like lsm_local_disk_serial_num_get(), but the result of disks in the
+ *      inventory is cached. Disk paths not in the inventory are passed to
+ *      lsm_local_disk_serial_num_get() every time.
+ *
+ * @inventory:
+ *      Pointer of &lsm_local_disk_inventory.
+ * @disk_path:
+ *      String. The path of disk path, example "/dev/sdb".
+ * @serial_num:
+ *      Output pointer of SCSI VPD80 serial number.
+ *      NULL when error. Memory should be freed by free().
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number', as by
+ *      lsm_local_disk_serial_num_get(), and LSM_ERR_INVALID_ARGUMENT when
+ *      inventory is invalid.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_inventory_serial_num_get(
+    lsm_local_disk_inventory *inventory, const char *disk_path,
+    char **serial_num, lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_inventory_link_type_get - Query link type from inventory.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Like lsm_local_disk_link_type_get(), but the result of disks in the
+ *      inventory is cached. Disk paths not in the inventory are passed to
+ *      lsm_local_disk_link_type_get() every time.
+ *
+ * @inventory:
+ *      Pointer of &lsm_local_disk_inventory.
+ * @disk_path:
+ *      String. The path of disk path, example "/dev/sdb".
+ * @link_type:
+ *      Output pointer of lsm_disk_link_type.
+ *      LSM_DISK_LINK_TYPE_UNKNOWN when error.
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number', as by
+ *      lsm_local_disk_link_type_get(), and LSM_ERR_INVALID_ARGUMENT when
+ *      inventory is invalid.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_inventory_link_type_get(
+    lsm_local_disk_inventory *inventory, const char *disk_path,
+    lsm_disk_link_type *link_type, lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_inventory_rpm_get - Query rotation speed from inventory.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Like lsm_local_disk_rpm_get(), but the result of disks in the
+ *      inventory is cached. Disk paths not in the inventory are passed to
+ *      lsm_local_disk_rpm_get() every time.
+ *
+ * @inventory:
+ *      Pointer of &lsm_local_disk_inventory.
+ * @disk_path:
+ *      String. The path of disk path, example "/dev/sdb".
+ * @rpm:
+ *      Output pointer of int32_t, as by lsm_local_disk_rpm_get().
+ *      LSM_DISK_RPM_UNKNOWN when error.
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number', as by
+ *      lsm_local_disk_rpm_get(), and LSM_ERR_INVALID_ARGUMENT when
+ *      inventory is invalid.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_inventory_rpm_get(
+    lsm_local_disk_inventory *inventory, const char *disk_path, int32_t *rpm,
+    lsm_error **lsm_err);
+
+/**
+ * LSM_LOCAL_DISK_HEALTH_SHM_NAME - Shared memory object of lsmd sampler.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Name of the shared memory object lsmd publishes into when its local
+ *      disk health sampler is enabled in lsmd.conf, to be given to
+ *      lsm_local_disk_health_table_open().
+ */
+#define LSM_LOCAL_DISK_HEALTH_SHM_NAME "/lsm_local_disk_health"
+
+/**
+ * lsm_local_disk_sampler_start - Start sampling health of local disks.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Start a background thread which, every @interval_ms milliseconds plus
+ *      a random delay of up to @jitter_ms milliseconds, lists the local disks
+ *      and queries the health status, link type and link speed of each, then
+ *      publishes the results into the POSIX shared memory object @shm_name.
+ *      Any process could read them by lsm_local_disk_health_table_open()
+ *      without sending any command to the disks.
+ *      The link type of a disk is only queried again when it was missing
+ *      from the previous listing or when its previous sample failed.
+ *      The shared memory object is readable by everyone, created or
+ *      replaced when started and removed when stopped.
+ *      Querying disks usually requires root privilege, failures are
+ *      published as the error of the affected disks.
+ *
+ * @shm_name:
+ *      String. Name of the shared memory object, starting with '/',
+ *      example "/lsm_local_disk_health".
+ * @interval_ms:
+ *      Milliseconds between the start of two sampling rounds, at least 1.
+ *      The first round starts immediately.
+ * @jitter_ms:
+ *      Maximum random milliseconds added to each interval, so that many
+ *      hosts do not query their disks at the same time. 0 for none.
+ * @worker_count:
+ *      Maximum number of disks queried at the same time. 0 for the default
+ *      of 16.
+ * @sampler:
+ *      Output pointer of &lsm_local_disk_sampler. NULL if got error.
+ *      Should be stopped by lsm_local_disk_sampler_stop().
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL, @shm_name is invalid or
+ *              @interval_ms is 0.
+ *          * LSM_ERR_PERMISSION_DENIED
+ *              When the shared memory object could not be created.
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *          * LSM_ERR_LIB_BUG
+ *              When something unexpected happens.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_sampler_start(
+    const char *shm_name, uint32_t interval_ms, uint32_t jitter_ms,
+    uint32_t worker_count, lsm_local_disk_sampler **sampler,
+    lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_sampler_stop - Stop sampling health of local disks.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Wait for the sampling round in progress, if any, then stop the
+ *      sampler, mark its results as stopped and remove its shared memory
+ *      object. Readers still holding it open get LSM_ERR_DAEMON_NOT_RUNNING
+ *      from lsm_local_disk_health_table_get().
+ *
+ * @sampler:
+ *      Pointer of &lsm_local_disk_sampler. NULL is ignored.
+ *
+ * Return:
+ *      void
+ *
+ */
+void LSM_DLL_EXPORT lsm_local_disk_sampler_stop(
+    lsm_local_disk_sampler *sampler);
+
+/**
+ * lsm_local_disk_health_table_open - Open results of local disk sampler.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Map read only the shared memory object published by
+ *      lsm_local_disk_sampler_start(), in this or another process. Looking
+ *      up disks in it sends no command to the disks and takes no lock, so
+ *      any number of readers could use it at once.
+ *
+ * @shm_name:
+ *      String. Name given to lsm_local_disk_sampler_start().
+ * @table:
+ *      Output pointer of &lsm_local_disk_health_table. NULL if got error.
+ *      Memory should be freed by lsm_local_disk_health_table_close().
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or @shm_name is invalid.
+ *          * LSM_ERR_DAEMON_NOT_RUNNING
+ *              When no sampler publishes to @shm_name.
+ *          * LSM_ERR_PERMISSION_DENIED
+ *              When the shared memory object could not be read.
+ *          * LSM_ERR_NO_SUPPORT
+ *              When the shared memory object is not in a format known by
+ *              this library version.
+ *          * LSM_ERR_NO_MEMORY
+ *              When no memory.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_health_table_open(
+    const char *shm_name, lsm_local_disk_health_table **table,
+    lsm_error **lsm_err);
+
+/**
+ * lsm_local_disk_health_table_close - Close results of local disk sampler.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Unmap the shared memory object and free the memory of @table.
+ *
+ * @table:
+ *      Pointer of &lsm_local_disk_health_table. NULL is ignored.
+ *
+ * Return:
+ *      void
+ *
+ */
+void LSM_DLL_EXPORT lsm_local_disk_health_table_close(
+    lsm_local_disk_health_table *table);
+
+/**
+ * lsm_local_disk_health_table_generation_get - Count of published rounds.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Return how many sampling rounds the sampler has published. Readers
+ *      could compare it with the value of their previous lookups to skip
+ *      them when nothing changed. 0 means no round was published yet, so
+ *      every disk is not found.
+ *
+ * @table:
+ *      Pointer of &lsm_local_disk_health_table.
+ *
+ * Return:
+ *      uint64_t. 0 if @table is invalid.
+ *
+ */
+uint64_t LSM_DLL_EXPORT lsm_local_disk_health_table_generation_get(
+    lsm_local_disk_health_table *table);
+
+/**
+ * lsm_local_disk_health_table_get - Query last sample of a local disk.
+ *
+ * Version:
+ *      1.9
+ *
+ * Description:
+ *      Look up the results of the last round of the sampler for given disk.
+ *      No command is sent to the disk.
+ *
+ * @table:
+ *      Pointer of &lsm_local_disk_health_table.
+ * @disk_path:
+ *      String. The path of disk path, example "/dev/sdb".
+ * @health_status:
+ *      Output pointer of int32_t, as by lsm_local_disk_health_status_get().
+ *      LSM_DISK_HEALTH_STATUS_UNKNOWN when error.
+ * @link_type:
+ *      Output pointer of lsm_disk_link_type, as by
+ *      lsm_local_disk_link_type_get(). LSM_DISK_LINK_TYPE_UNKNOWN if not
+ *      found or could not be queried, even when the return is not
+ *      LSM_ERR_OK.
+ * @link_speed:
+ *      Output pointer of uint32_t, as by lsm_local_disk_link_speed_get().
+ *      LSM_DISK_LINK_SPEED_UNKNOWN if not found or could not be queried,
+ *      even when the return is not LSM_ERR_OK.
+ * @sample_time:
+ *      Output pointer of uint64_t, seconds since the Epoch when the disk
+ *      was sampled, 0 if not found. Readers should check it against the
+ *      interval of the sampler to detect a stuck sampler.
+ * @lsm_err:
+ *      Output pointer of &lsm_error. Error message could be
+ *      retrieved via lsm_error_message_get(). Memory should be
+ *      freed by lsm_error_free().
+ *
+ * Return:
+ *      Error code as enumerated by 'lsm_error_number':
+ *          * LSM_ERR_OK
+ *              On success.
+ *          * LSM_ERR_INVALID_ARGUMENT
+ *              When any argument is NULL or @table is invalid.
+ *          * LSM_ERR_NOT_FOUND_DISK
+ *              When @disk_path was not found by the last round.
+ *          * LSM_ERR_DAEMON_NOT_RUNNING
+ *              When the sampler was stopped, the table should be opened
+ *              again.
+ *          * LSM_ERR_TIMEOUT
+ *              When the sampler kept updating the table for too long,
+ *              like if it crashed while doing so.
+ *          * Other errors
+ *              As returned by lsm_local_disk_health_status_get() when
+ *              the disk was sampled.
+ *
+ */
+int LSM_DLL_EXPORT lsm_local_disk_health_table_get(
+    lsm_local_disk_health_table *table, const char *disk_path,
+    int32_t *health_status, lsm_disk_link_type *link_type,
+    uint32_t *link_speed, uint64_t *sample_time, lsm_error **lsm_err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1264,6 +1264,105 @@ int LSM_DLL_EXPORT lsm_register_plugin_v1_3(
  */
 void LSM_DLL_EXPORT *lsm_private_data_get(lsm_plugin_ptr plug);
 
+/**
+ * Opaque data type for a job run by the framework on behalf of the plug-in.
+ */
+typedef struct _lsm_plugin_job lsm_plugin_job;
+
+/**
+ * Work of a job, called on a framework worker thread.  The plug-in is still
+ * serving requests on the main thread meanwhile, so any plug-in state shared
+ * with the request callbacks needs its own locking.
+ * @param plug      Opaque plug-in pointer
+ * @param job       Job being run, for lsm_plugin_job_progress_set(),
+ *                  lsm_plugin_job_cancelled(), lsm_plugin_job_result_set()
+ *                  and lsm_plugin_job_error_set()
+ * @param data      Data passed to lsm_plugin_job_submit()
+ * @return LSM_ERR_OK when the job completed, else the error code reported
+ *         by job_status.
+ */
+typedef int (*lsm_plug_job_work)(lsm_plugin_ptr plug, lsm_plugin_job *job,
+                                 void *data);
+
+/**
+ * Frees the data of a job once the job is freed or dropped.
+ * @param data      Data passed to lsm_plugin_job_submit()
+ */
+typedef void (*lsm_plug_job_data_free)(void *data);
+
+/**
+ * Queues work to run on a framework worker thread and returns at once with
+ * the id of the new job, so a request callback can return
+ * LSM_ERR_JOB_STARTED with it.  job_status and job_free requests for these
+ * ids are answered by the framework without reaching the plug-in callbacks.
+ * Up to four jobs run at the same time, the rest wait in submission order.
+ * Jobs still queued or running when the plug-in unregisters are cancelled
+ * and waited for before the unregister callback.  Version: 1.9
+ * @param plug          Opaque plug-in pointer
+ * @param work          Work of the job
+ * @param data          Passed to work, may be NULL
+ * @param data_free     Called with data when the job is freed, may be NULL
+ * @param[out] job_id   Id of the new job, to be freed by the caller
+ * @return Error code as enumerated by \ref lsm_error_number.
+ * @retval LSM_ERR_OK on success, data is then owned by the job.
+ * @retval LSM_ERR_INVALID_ARGUMENT if plug, work or job_id is invalid.
+ * @retval LSM_ERR_NO_MEMORY on memory allocation failure or when no worker
+ *         thread could be started, data is then still owned by the caller.
+ */
+int LSM_DLL_EXPORT lsm_plugin_job_submit(lsm_plugin_ptr plug,
+                                         lsm_plug_job_work work, void *data,
+                                         lsm_plug_job_data_free data_free,
+                                         char **job_id);
+
+/**
+ * Sets the progress reported by job_status while the job runs.  The progress
+ * is 100 once work returns LSM_ERR_OK.  Version: 1.9
+ * @param job       Job being run
+ * @param percent   Progress from 0 to 100
+ * @return Error code as enumerated by \ref lsm_error_number.
+ * @retval LSM_ERR_OK on success.
+ * @retval LSM_ERR_INVALID_ARGUMENT if job is invalid or percent over 100.
+ */
+int LSM_DLL_EXPORT lsm_plugin_job_progress_set(lsm_plugin_job *job,
+                                               uint8_t percent);
+
+/**
+ * Checks whether the client freed the job or the plug-in is unregistering.
+ * Work should poll this between steps and return early once it is set; its
+ * result is discarded then.  Version: 1.9
+ * @param job       Job being run
+ * @return 1 if cancelled, 0 if not or job is invalid.
+ */
+int LSM_DLL_EXPORT lsm_plugin_job_cancelled(lsm_plugin_job *job);
+
+/**
+ * Sets the result returned by job_status once work returns LSM_ERR_OK.  The
+ * value is copied, the caller keeps ownership of it.  Version: 1.9
+ * @param job       Job being run
+ * @param t         LSM_DATA_TYPE_VOLUME, LSM_DATA_TYPE_FS, LSM_DATA_TYPE_SS
+ *                  or LSM_DATA_TYPE_POOL
+ * @param value     Result of that type, NULL to clear the result
+ * @return Error code as enumerated by \ref lsm_error_number.
+ * @retval LSM_ERR_OK on success.
+ * @retval LSM_ERR_INVALID_ARGUMENT if job, t or value is invalid.
+ * @retval LSM_ERR_NO_MEMORY on memory allocation failure.
+ */
+int LSM_DLL_EXPORT lsm_plugin_job_result_set(lsm_plugin_job *job,
+                                             lsm_data_type t, void *value);
+
+/**
+ * Sets the error message returned by job_status along with the error code
+ * when work fails.  Version: 1.9
+ * @param job       Job being run
+ * @param msg       Error message
+ * @return Error code as enumerated by \ref lsm_error_number.
+ * @retval LSM_ERR_OK on success.
+ * @retval LSM_ERR_INVALID_ARGUMENT if job or msg is invalid.
+ * @retval LSM_ERR_NO_MEMORY on memory allocation failure.
+ */
+int LSM_DLL_EXPORT lsm_plugin_job_error_set(lsm_plugin_job *job,
+                                            const char *msg);
+
 /**
  * Logs an error with the plug-in
  * @param plug  Plug-in pointer
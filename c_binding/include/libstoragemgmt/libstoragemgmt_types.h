@@ -52,6 +52,11 @@ typedef uint64_t lsm_flag;
  */
 typedef struct _lsm_connect lsm_connect;
 
+/**
+ * Opaque data type for an asynchronous request on a connection.
+ */
+typedef struct _lsm_request lsm_request;
+
 /**
  * Opaque data type for a block based storage unit
  */
@@ -128,6 +133,26 @@ typedef struct _lsm_target_port lsm_target_port;
  */
 typedef struct _lsm_battery lsm_battery;
 
+/**
+ * Opaque data type for local disk inventory
+ */
+typedef struct _lsm_local_disk_inventory lsm_local_disk_inventory;
+
+/**
+ * Opaque data type for the attributes of a local disk
+ */
+typedef struct _lsm_local_disk_info lsm_local_disk_info;
+
+/**
+ * Opaque data type for local disk health sampler
+ */
+typedef struct _lsm_local_disk_sampler lsm_local_disk_sampler;
+
+/**
+ * Opaque data type for reader of local disk health sampler results
+ */
+typedef struct _lsm_local_disk_health_table lsm_local_disk_health_table;
+
 /** \enum lsm_replication_type Different types of replications that can be
  * created */
 typedef enum {
@@ -449,6 +474,32 @@ typedef enum {
 #define LSM_SYSTEM_READ_CACHE_PCT_NO_SUPPORT -2
 #define LSM_SYSTEM_READ_CACHE_PCT_UNKNOWN    -1
 
+/**
+ * Time spent in each stage of a single client library call to the plugin,
+ * handed to the callback registered with lsm_connect_rpc_timing_cb_set().
+ * All durations are in nanoseconds.  A stage which was never reached, like
+ * parsing a reply that failed to arrive, is left as zero.
+ */
+typedef struct lsm_rpc_timing {
+    const char *method;      /**< RPC method, valid during the callback only */
+    int rc;                  /**< lsm_error_number of the RPC */
+    uint64_t encode_ns;      /**< Serializing the request to JSON */
+    uint64_t send_ns;        /**< Writing the request to the socket */
+    uint64_t wait_ns;        /**< Waiting for the first byte of the reply */
+    uint64_t recv_ns;        /**< Reading the rest of the reply */
+    uint64_t parse_ns;       /**< Parsing the reply JSON */
+    uint64_t request_bytes;  /**< Size of the request payload */
+    uint64_t response_bytes; /**< Size of the reply payload */
+} lsm_rpc_timing;
+
+/**
+ * Callback invoked once per completed RPC when timing is enabled.
+ * @param timing        Timing break down of the call
+ * @param user_data     Pointer given to lsm_connect_rpc_timing_cb_set()
+ */
+typedef void (*lsm_rpc_timing_cb)(const lsm_rpc_timing *timing,
+                                  void *user_data);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <assert.h>
+#include <dirent.h>
+#include <errno.h>
+#include <libudev.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libblk.h"
+#include "libstoragemgmt/libstoragemgmt.h"
+#include "libstoragemgmt/libstoragemgmt_error.h"
+#include "utils.h"
+
+#define _SYSFS_BLOCK_PATH "/sys/block"
+
+#define _BLK_DEV_PATH_MAX_LEN (NAME_MAX + sizeof("/dev/"))
+
+#define _BLK_NAME_ARRAY_INIT_LEN 64
+
+static bool _blk_is_local_disk_path(const char *disk_path);
+static int _blk_name_cmp(const void *a, const void *b);
+
+static bool _blk_is_local_disk_path(const char *disk_path) {
+    return (strncmp(disk_path, "/dev/sd", strlen("/dev/sd")) == 0) ||
+           (strncmp(disk_path, "/dev/nvme", strlen("/dev/nvme")) == 0);
+}
+
+static int _blk_name_cmp(const void *a, const void *b) {
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+int _blk_disk_list_sysfs(char *err_msg, lsm_string_list *disk_paths) {
+    int rc = LSM_ERR_OK;
+    DIR *dir = NULL;
+    struct dirent *dp = NULL;
+    char **names = NULL;
+    char **tmp_names = NULL;
+    uint32_t name_count = 0;
+    uint32_t name_max = 0;
+    uint32_t i = 0;
+    char disk_path[_BLK_DEV_PATH_MAX_LEN];
+    char strerr_buff[_LSM_ERR_MSG_LEN];
+
+    assert(err_msg != NULL);
+    assert(disk_paths != NULL);
+
+    dir = _fs_opendir(_SYSFS_BLOCK_PATH);
+    if (dir == NULL) {
+        rc = LSM_ERR_NO_SUPPORT;
+        _lsm_err_msg_set(err_msg, "Cannot open %s: error (%d)%s",
+                         _SYSFS_BLOCK_PATH, errno,
+                         error_to_str(errno, strerr_buff, _LSM_ERR_MSG_LEN));
+        goto out;
+    }
+
+    /* The kernel name of SCSI and NVMe disks is also their /dev name */
+    while ((dp = readdir(dir)) != NULL) {
+        snprintf(disk_path, sizeof(disk_path), "/dev/%s", dp->d_name);
+        if (!_blk_is_local_disk_path(disk_path))
+            continue;
+        if (name_count == name_max) {
+            name_max =
+                name_max == 0 ? _BLK_NAME_ARRAY_INIT_LEN : name_max * 2;
+            tmp_names = (char **)realloc(names, sizeof(char *) * name_max);
+            _alloc_null_check(err_msg, tmp_names, rc, out);
+            names = tmp_names;
+        }
+        names[name_count] = strdup(dp->d_name);
+        _alloc_null_check(err_msg, names[name_count], rc, out);
+        ++name_count;
+    }
+
+    if (name_count > 0)
+        qsort(names, name_count, sizeof(char *), _blk_name_cmp);
+
+    for (i = 0; i < name_count; ++i) {
+        snprintf(disk_path, sizeof(disk_path), "/dev/%s", names[i]);
+        /* Hidden disks, like the paths of NVMe multipath, have no node */
+        if (!_file_exists(disk_path))
+            continue;
+        if (lsm_string_list_append(disk_paths, disk_path) != LSM_ERR_OK) {
+            rc = LSM_ERR_NO_MEMORY;
+            _lsm_err_msg_set(err_msg, "No memory");
+            goto out;
+        }
+    }
+
+out:
+    if (dir != NULL)
+        closedir(dir);
+    for (i = 0; i < name_count; ++i)
+        free(names[i]);
+    free(names);
+    return rc;
+}
+
+int _blk_disk_list_udev(char *err_msg, lsm_string_list *disk_paths) {
+    struct udev *udev = NULL;
+    struct udev_enumerate *udev_enum = NULL;
+    struct udev_list_entry *udev_devs = NULL;
+    struct udev_list_entry *udev_list = NULL;
+    struct udev_device *udev_dev = NULL;
+    int udev_rc = 0;
+    const char *udev_path = NULL;
+    const char *disk_path = NULL;
+    int rc = LSM_ERR_OK;
+
+    assert(err_msg != NULL);
+    assert(disk_paths != NULL);
+
+    udev = udev_new();
+    if (udev == NULL) {
+        rc = LSM_ERR_NO_MEMORY;
+        goto out;
+    }
+    udev_enum = udev_enumerate_new(udev);
+    if (udev_enum == NULL) {
+        rc = LSM_ERR_NO_MEMORY;
+        goto out;
+    }
+
+    udev_rc = udev_enumerate_add_match_subsystem(udev_enum, "block");
+    if (udev_rc != 0) {
+        rc = LSM_ERR_LIB_BUG;
+        _lsm_err_msg_set(err_msg,
+                         "udev_enumerate_scan_subsystems() failed "
+                         "with %d",
+                         udev_rc);
+        goto out;
+    }
+    udev_rc = udev_enumerate_add_match_property(udev_enum, "DEVTYPE", "disk");
+    if (udev_rc != 0) {
+        rc = LSM_ERR_LIB_BUG;
+        _lsm_err_msg_set(err_msg,
+                         "udev_enumerate_add_match_property() failed "
+                         "with %d",
+                         udev_rc);
+        goto out;
+    }
+
+    udev_rc = udev_enumerate_scan_devices(udev_enum);
+    if (udev_rc != 0) {
+        rc = LSM_ERR_LIB_BUG;
+        _lsm_err_msg_set(err_msg,
+                         "udev_enumerate_scan_devices() failed "
+                         "with %d",
+                         udev_rc);
+        goto out;
+    }
+
+    udev_devs = udev_enumerate_get_list_entry(udev_enum);
+    if (udev_devs == NULL)
+        goto out;
+
+    udev_list_entry_foreach(udev_list, udev_devs) {
+        udev_path = udev_list_entry_get_name(udev_list);
+        if (udev_path == NULL)
+            continue;
+        udev_dev = udev_device_new_from_syspath(udev, udev_path);
+        if (udev_dev == NULL) {
+            rc = LSM_ERR_NO_MEMORY;
+            goto out;
+        }
+        disk_path = udev_device_get_devnode(udev_dev);
+        if (disk_path == NULL) {
+            udev_device_unref(udev_dev);
+            continue;
+        }
+        if (_blk_is_local_disk_path(disk_path)) {
+            if (_file_exists(disk_path)) {
+                rc = lsm_string_list_append(disk_paths, disk_path);
+                if (rc != LSM_ERR_OK) {
+                    udev_device_unref(udev_dev);
+                    goto out;
+                }
+            }
+        }
+        udev_device_unref(udev_dev);
+    }
+
+out:
+    if (udev != NULL)
+        udev_unref(udev);
+
+    if (udev_enum != NULL)
+        udev_enumerate_unref(udev_enum);
+
+    return rc;
+}
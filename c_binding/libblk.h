@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _LIBBLK_H_
+#define _LIBBLK_H_
+
+#include "libstoragemgmt/libstoragemgmt_common.h"
+#include "libstoragemgmt/libstoragemgmt_types.h"
+
+/*
+ * Preconditions:
+ *  err_msg != NULL
+ *  disk_paths != NULL
+ *
+ * Append the device paths of all the SCSI and NVMe whole disks, like
+ * "/dev/sda" and "/dev/nvme0n1", found by reading the names in /sys/block,
+ * sorted by name.  Partitions are not listed by /sys/block, and disks
+ * without device node are skipped, so the result is the same as
+ * _blk_disk_list_udev() without creating a udev device for every block
+ * device like dm or loop ones.
+ * Return:
+ *  LSM_ERR_NO_SUPPORT if /sys/block cannot be opened, nothing appended.
+ *  LSM_ERR_NO_MEMORY
+ *  LSM_ERR_OK
+ */
+LSM_DLL_LOCAL int _blk_disk_list_sysfs(char *err_msg,
+                                       lsm_string_list *disk_paths);
+
+/*
+ * Preconditions:
+ *  err_msg != NULL
+ *  disk_paths != NULL
+ *
+ * Same as _blk_disk_list_sysfs(), but enumerate the disks of the udev
+ * "block" subsystem, in the order of udev.
+ * Return:
+ *  LSM_ERR_NO_MEMORY
+ *  LSM_ERR_LIB_BUG
+ *  LSM_ERR_OK
+ */
+LSM_DLL_LOCAL int _blk_disk_list_udev(char *err_msg,
+                                      lsm_string_list *disk_paths);
+
+#endif /* End of _LIBBLK_H_ */
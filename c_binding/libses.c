@@ -24,7 +24,10 @@
 #include <assert.h>
 #include <dirent.h>
 #include <errno.h>
+#include <glib.h>
 #include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
@@ -69,6 +72,9 @@
 /* SES-3 Table 12 - Type descriptor header format */
 #define _T10_SES_CFG_DP_HDR_LEN 4
 
+/* Times to re-read the SES pages when their GENERATION CODE differs */
+#define _SES_GEN_CODE_RETRY_MAX 3
+
 #pragma pack(push, 1)
 /*
  * SES-3 rev 11a "Table 30 - Additional Element Status diagnostic page"
@@ -240,15 +246,104 @@ static int _ses_bsg_paths_get(char *err_msg, char ***bsg_paths,
                               uint32_t *bsg_count);
 
 /*
- * Return element index of given SAS address. The index is including overall
- * status item in status page(0x02).
+ * Enclosure slot of a target port SAS address, as cached in _ses_slot_map.
+ * The 'element_index' is including overall status item in status page(0x02),
+ * the 'add_st_index' is the ELEMENT INDEX field as found in additional
+ * element status page(0x0a).
+ */
+struct _ses_slot {
+    char sas_addr[_SG_T10_SPL_SAS_ADDR_LEN];
+    char *bsg_path;
+    uint32_t gen_code_be;
+    int16_t element_index;
+    uint8_t add_st_index;
+};
+
+/*
+ * Process wide map of target port SAS address to struct _ses_slot, filled
+ * by scanning all enclosures once. An entry is trusted only while the
+ * GENERATION CODE of its enclosure is unchanged and the additional element
+ * status page still lists that SAS address at the same element.
+ */
+static pthread_mutex_t _ses_slot_map_lock = PTHREAD_MUTEX_INITIALIZER;
+static GHashTable *_ses_slot_map = NULL;
+
+/* Serializes _ses_slot_map_refresh(), counts the finished scans */
+static pthread_mutex_t _ses_slot_map_scan_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t _ses_slot_map_scan_gen = 0;
+
+/*
+ * Invoke 'cb' for each SAS address of device slot in additional element
+ * status page. Stop when 'cb' returns true.
  * 'add_st_data' should be 'uint8_t [_SG_T10_SPC_RECV_DIAG_MAX_LEN]'
+ */
+static void _ses_add_st_walk(uint8_t *add_st_data,
+                             bool (*cb)(const char *sas_addr,
+                                        struct _ses_add_st_dp *dp,
+                                        void *data),
+                             void *data);
+
+/*
+ * Return the additional element status descriptor of given SAS address or
+ * NULL if not found.
+ */
+static struct _ses_add_st_dp *_ses_add_st_dp_find(const char *sas_addr,
+                                                  uint8_t *add_st_data);
+
+/*
+ * Return element index of given additional element status descriptor.
+ * The index is including overall status item in status page(0x02).
  * 'cfg_data' should be 'uint8_t [_SG_T10_SPC_RECV_DIAG_MAX_LEN]'
  * The SES-3 ELEMENT INDEX field which is uint8_t, we expand it to
  * int16_t in order to include -1 as 'not found' error.
  */
-static int16_t _ses_find_sas_addr(const char *sas_addr, uint8_t *add_st_data,
-                                  uint8_t *cfg_data);
+static int16_t _ses_element_index_of_dp(struct _ses_add_st_dp *dp,
+                                        uint8_t *cfg_data);
+
+/*
+ * Drop all cached slots of given enclosure.
+ */
+static void _ses_slot_map_drop(const char *bsg_path);
+
+/*
+ * Add the slots of given enclosure, as its pages shows, into 'map' which
+ * is not yet shared.
+ */
+static int _ses_slot_map_fill(char *err_msg, GHashTable *map,
+                              const char *bsg_path, uint8_t *cfg_data,
+                              uint8_t *add_st_data);
+
+/*
+ * Rebuild the _ses_slot_map from all enclosures which could be read.
+ */
+static int _ses_slot_map_refresh(char *err_msg);
+
+/*
+ * Copy the cached slot of given SAS address into 'slot'. The slot->bsg_path
+ * should be freed by caller. 'found' is false if not cached.
+ */
+static int _ses_slot_map_lookup(char *err_msg, const char *sas_addr,
+                                struct _ses_slot *slot, bool *found);
+
+/*
+ * Open the enclosure of cached slot and retrieve its status page and
+ * additional element status page.  If the enclosure is gone or the
+ * GENERATION CODE changed since cached, 'stale' is set to true, all slots
+ * of this enclosure are dropped from cache and no fd is returned.
+ */
+static int _ses_enc_open(char *err_msg, struct _ses_slot *slot,
+                         uint8_t *status_data, uint8_t *add_st_data, int *fd,
+                         bool *stale);
+
+/*
+ * Update the selected elements of given enclosure with ctrl_bytes and
+ * ctrl_bit in single SEND DIAGNOSTIC command. All slots should be of the
+ * same enclosure.
+ */
+static int _ses_enc_slots_ctrl(char *err_msg, struct _ses_slot *slots,
+                               uint32_t slot_count, uint8_t *status_data,
+                               uint8_t *add_st_data, uint8_t ctrl_bytes,
+                               uint8_t ctrl_bit, int ctrl_type, bool *stale);
 
 /*
  * 'status' should be 'uint8_t [_T10_SES_DEV_SLOT_STATUS_LEN]'.
@@ -257,9 +352,18 @@ static int _ses_raw_status_get(char *err_msg, uint8_t *status_data,
                                const int16_t element_index, uint8_t *status,
                                uint32_t *gen_code_be);
 
-static int _ses_ctrl_data_gen(char *err_msg, uint8_t *status_data,
-                              uint8_t *status, const int16_t element_index,
-                              uint16_t *len);
+/*
+ * Convert status page in 'status_data' into control page with no element
+ * selected.
+ */
+static void _ses_ctrl_data_gen(uint8_t *status_data, uint16_t *len);
+
+/*
+ * Update the control element of 'element_index' with 'status'.
+ * 'status' should be 'uint8_t [_T10_SES_DEV_SLOT_STATUS_LEN]'.
+ */
+static void _ses_ctrl_data_set(uint8_t *ctrl_data, uint8_t *status,
+                               const int16_t element_index);
 
 /*
  * When EIIOE is set to zero, we need to add the overall element count into
@@ -286,10 +390,15 @@ static int16_t _ses_eiioe(uint8_t *cfg_data, int16_t element_index);
 static void _ses_cfg_parse(uint8_t *cfg_data, uint8_t **dp_hdr_begin,
                            uint16_t *total_dp_hdr_count);
 
+/*
+ * Find the enclosure slot of given SAS address, with status page and
+ * additional element status page of that enclosure retrieved.
+ * The slot->bsg_path should be freed by caller.
+ */
 static int _ses_info_get_by_sas_addr(char *err_msg, const char *tp_sas_addr,
-                                     uint8_t *cfg_data, uint8_t *status_data,
+                                     uint8_t *status_data,
                                      uint8_t *add_st_data, int *fd,
-                                     int16_t *element_index);
+                                     struct _ses_slot *slot);
 
 static void _ses_cfg_parse(uint8_t *cfg_data, uint8_t **dp_hdr_begin,
                            uint16_t *total_dp_hdr_count) {
@@ -332,7 +441,7 @@ static int _ses_bsg_paths_get(char *err_msg, char ***bsg_paths,
     struct dirent *dp = NULL;
     lsm_string_list *bsg_name_list = NULL;
     const char *bsg_name = NULL;
-    char *sysfs_bsg_type_path = NULL;
+    char bsg_type_name[NAME_MAX + sizeof("/device/type")];
     char dev_type[_LINUX_SCSI_DEV_TYPE_SES_LEN + 1];
     ssize_t dev_type_size = 0;
     char strerr_buff[_LSM_ERR_MSG_LEN];
@@ -351,13 +460,12 @@ static int _ses_bsg_paths_get(char *err_msg, char ***bsg_paths,
     /* We don't use libudev here because libudev seems have no way to check
      * whether 'bsg' kernel module is loaded or not.
      */
-    if (!_file_exists(_SYSFS_BSG_ROOT_PATH)) {
+    dir = _fs_opendir(_SYSFS_BSG_ROOT_PATH);
+    if ((dir == NULL) && (errno == ENOENT)) {
         rc = LSM_ERR_INVALID_ARGUMENT;
         _lsm_err_msg_set(err_msg, "Required kernel module 'bsg' not loaded");
         goto out;
     }
-
-    dir = opendir(_SYSFS_BSG_ROOT_PATH);
     if (dir == NULL) {
         _lsm_err_msg_set(err_msg, "Cannot open %s: error (%d)%s",
                          _SYSFS_BSG_ROOT_PATH, errno,
@@ -370,32 +478,27 @@ static int _ses_bsg_paths_get(char *err_msg, char ***bsg_paths,
     do {
         if ((dp = readdir(dir)) != NULL) {
             bsg_name = dp->d_name;
-            if ((bsg_name == NULL) || (strlen(bsg_name) == 0))
+            if ((bsg_name == NULL) || (strlen(bsg_name) == 0) ||
+                (bsg_name[0] == '.'))
                 continue;
-            sysfs_bsg_type_path = (char *)malloc(
-                sizeof(char) *
-                (strlen(_SYSFS_BSG_ROOT_PATH) + strlen("/") + strlen(bsg_name) +
-                 strlen("/device/type") + 1 /* trailing \0 */));
-            _alloc_null_check(err_msg, sysfs_bsg_type_path, rc, out);
-            sprintf(sysfs_bsg_type_path, "%s/%s/device/type",
-                    _SYSFS_BSG_ROOT_PATH, bsg_name);
-            tmp_rc =
-                _read_file(sysfs_bsg_type_path, (uint8_t *)dev_type,
-                           &dev_type_size, _LINUX_SCSI_DEV_TYPE_SES_LEN + 1);
-            if ((tmp_rc != 0) && (tmp_rc != EFBIG)) {
-                free(sysfs_bsg_type_path);
+            /* Relative to the opened _SYSFS_BSG_ROOT_PATH, d_name is never
+             * longer than NAME_MAX.
+             */
+            snprintf(bsg_type_name, sizeof(bsg_type_name), "%s/device/type",
+                     bsg_name);
+            tmp_rc = _sysfs_attr_read(dirfd(dir), bsg_type_name,
+                                      (uint8_t *)dev_type, &dev_type_size,
+                                      _LINUX_SCSI_DEV_TYPE_SES_LEN + 1);
+            if ((tmp_rc != 0) && (tmp_rc != EFBIG))
                 continue;
-            }
             if (strncmp(dev_type, _LINUX_SCSI_DEV_TYPE_SES,
                         _LINUX_SCSI_DEV_TYPE_SES_LEN) == 0) {
                 if (lsm_string_list_append(bsg_name_list, bsg_name) != 0) {
-                    free(sysfs_bsg_type_path);
                     _lsm_err_msg_set(err_msg, "No memory");
                     rc = LSM_ERR_NO_MEMORY;
                     goto out;
                 }
             }
-            free(sysfs_bsg_type_path);
         }
     } while (dp != NULL);
 
@@ -436,21 +539,22 @@ out:
     return rc;
 }
 
-static int16_t _ses_find_sas_addr(const char *sas_addr, uint8_t *add_st_data,
-                                  uint8_t *cfg_data) {
+static void _ses_add_st_walk(uint8_t *add_st_data,
+                             bool (*cb)(const char *sas_addr,
+                                        struct _ses_add_st_dp *dp,
+                                        void *data),
+                             void *data) {
     struct _ses_add_st *add_st = NULL;
     struct _ses_add_st_dp *dp = NULL;
     struct _ses_add_st_dp_sas *dp_sas = NULL;
     struct _ses_add_st_sas_phy *phy = NULL;
     uint8_t *end_p = NULL;
     uint8_t *tmp_p = NULL;
-    int16_t element_index = -1;
     uint8_t i = 0;
     char tmp_sas_addr[_SG_T10_SPL_SAS_ADDR_LEN];
 
-    assert(sas_addr != NULL);
     assert(add_st_data != NULL);
-    assert(cfg_data != NULL);
+    assert(cb != NULL);
 
     add_st = (struct _ses_add_st *)add_st_data;
     end_p = add_st_data + be16toh(add_st->len_be) + 4;
@@ -458,7 +562,7 @@ static int16_t _ses_find_sas_addr(const char *sas_addr, uint8_t *add_st_data,
     tmp_p = &add_st->dp_list_begin;
     while (tmp_p < end_p) {
         if (tmp_p + sizeof(struct _ses_add_st_dp) > end_p)
-            goto out;
+            return;
         dp = (struct _ses_add_st_dp *)tmp_p;
         tmp_p += dp->len + 2;
 
@@ -473,14 +577,14 @@ static int16_t _ses_find_sas_addr(const char *sas_addr, uint8_t *add_st_data,
             continue;
 
         if (&dp->data_begin + sizeof(struct _ses_add_st_dp_sas) > end_p)
-            goto out;
+            return;
         dp_sas = (struct _ses_add_st_dp_sas *)&dp->data_begin;
         if (dp_sas->dp_type != _T10_SES_DESCRIPTOR_TYPE_DEV_SLOT)
             continue;
         if (dp_sas->phy_count == 0)
             continue;
         if (&dp_sas->phy_list + sizeof(struct _ses_add_st_sas_phy) > end_p)
-            goto out;
+            return;
         for (i = 0; i < dp_sas->phy_count; ++i) {
             phy =
                 (struct _ses_add_st_sas_phy *)((uint8_t *)(&dp_sas->phy_list) +
@@ -489,18 +593,329 @@ static int16_t _ses_find_sas_addr(const char *sas_addr, uint8_t *add_st_data,
                                                    i);
             _be_raw_to_hex((uint8_t *)&phy->sas_addr,
                            _SG_T10_SPL_SAS_ADDR_LEN_BITS, tmp_sas_addr);
-            if (strncmp(tmp_sas_addr, sas_addr, _SG_T10_SPL_SAS_ADDR_LEN) ==
-                0) {
-                if (dp->eiioe == _T10_SES_ADD_DP_INCLUDE_OVERALL)
-                    return dp->element_index;
-                else
-                    return _ses_eiioe(cfg_data, dp->element_index);
+            if (cb(tmp_sas_addr, dp, data))
+                return;
+        }
+    }
+}
+
+struct _ses_add_st_dp_find_data {
+    const char *sas_addr;
+    struct _ses_add_st_dp *dp;
+};
+
+static bool _ses_add_st_dp_find_cb(const char *sas_addr,
+                                   struct _ses_add_st_dp *dp, void *data) {
+    struct _ses_add_st_dp_find_data *find =
+        (struct _ses_add_st_dp_find_data *)data;
+
+    if (strncmp(sas_addr, find->sas_addr, _SG_T10_SPL_SAS_ADDR_LEN) != 0)
+        return false;
+    find->dp = dp;
+    return true;
+}
+
+static struct _ses_add_st_dp *_ses_add_st_dp_find(const char *sas_addr,
+                                                  uint8_t *add_st_data) {
+    struct _ses_add_st_dp_find_data find;
+
+    assert(sas_addr != NULL);
+    assert(add_st_data != NULL);
+
+    find.sas_addr = sas_addr;
+    find.dp = NULL;
+    _ses_add_st_walk(add_st_data, _ses_add_st_dp_find_cb, &find);
+    return find.dp;
+}
+
+static int16_t _ses_element_index_of_dp(struct _ses_add_st_dp *dp,
+                                        uint8_t *cfg_data) {
+    assert(dp != NULL);
+    assert(cfg_data != NULL);
+
+    if (dp->eiioe == _T10_SES_ADD_DP_INCLUDE_OVERALL)
+        return dp->element_index;
+    else
+        return _ses_eiioe(cfg_data, dp->element_index);
+}
+
+static void _ses_slot_free(gpointer data) {
+    struct _ses_slot *slot = (struct _ses_slot *)data;
+
+    if (slot != NULL) {
+        free(slot->bsg_path);
+        free(slot);
+    }
+}
+
+static gboolean _ses_slot_of_bsg(gpointer key, gpointer value,
+                                 gpointer user_data) {
+    struct _ses_slot *slot = (struct _ses_slot *)value;
+
+    (void)key;
+    return strcmp(slot->bsg_path, (const char *)user_data) == 0;
+}
+
+static void _ses_slot_map_drop(const char *bsg_path) {
+    assert(bsg_path != NULL);
+
+    pthread_mutex_lock(&_ses_slot_map_lock);
+    if (_ses_slot_map != NULL)
+        g_hash_table_foreach_remove(_ses_slot_map, _ses_slot_of_bsg,
+                                    (gpointer)bsg_path);
+    pthread_mutex_unlock(&_ses_slot_map_lock);
+}
+
+struct _ses_slot_map_fill_data {
+    GHashTable *map;
+    const char *bsg_path;
+    uint8_t *cfg_data;
+    uint32_t gen_code_be;
+    int rc;
+};
+
+static bool _ses_slot_map_fill_cb(const char *sas_addr,
+                                  struct _ses_add_st_dp *dp, void *data) {
+    struct _ses_slot_map_fill_data *fill =
+        (struct _ses_slot_map_fill_data *)data;
+    struct _ses_slot *slot = NULL;
+    char *key = NULL;
+    int16_t element_index = -1;
+
+    element_index = _ses_element_index_of_dp(dp, fill->cfg_data);
+    if (element_index < 0)
+        return false;
+
+    slot = (struct _ses_slot *)calloc(1, sizeof(struct _ses_slot));
+    key = strdup(sas_addr);
+    if ((slot == NULL) || (key == NULL))
+        goto nomem;
+    slot->bsg_path = strdup(fill->bsg_path);
+    if (slot->bsg_path == NULL)
+        goto nomem;
+    memcpy(slot->sas_addr, sas_addr, _SG_T10_SPL_SAS_ADDR_LEN);
+    slot->gen_code_be = fill->gen_code_be;
+    slot->element_index = element_index;
+    slot->add_st_index = dp->element_index;
+
+    /* When multiple enclosure services report the same disk, the last one
+     * wins.
+     */
+    g_hash_table_replace(fill->map, key, slot);
+    return false;
+
+nomem:
+    free(key);
+    _ses_slot_free(slot);
+    fill->rc = LSM_ERR_NO_MEMORY;
+    return true;
+}
+
+static int _ses_slot_map_fill(char *err_msg, GHashTable *map,
+                              const char *bsg_path, uint8_t *cfg_data,
+                              uint8_t *add_st_data) {
+    struct _ses_slot_map_fill_data fill;
+
+    assert(err_msg != NULL);
+    assert(map != NULL);
+    assert(bsg_path != NULL);
+    assert(cfg_data != NULL);
+    assert(add_st_data != NULL);
+
+    fill.map = map;
+    fill.bsg_path = bsg_path;
+    fill.cfg_data = cfg_data;
+    fill.gen_code_be = ((struct _ses_add_st *)add_st_data)->gen_code_be;
+    fill.rc = LSM_ERR_OK;
+    _ses_add_st_walk(add_st_data, _ses_slot_map_fill_cb, &fill);
+
+    if (fill.rc != LSM_ERR_OK)
+        _lsm_err_msg_set(err_msg, "No memory");
+    return fill.rc;
+}
+
+/*
+ * Workflow:
+ *  1. Find all scsi generic paths that correspond to enclosures.
+ *  2. For each enclosure, retrieve these SES pages:
+ *      6.1.2 Configuration diagnostic page
+ *      6.1.13 Additional Element Status diagnostic page
+ *     and retry if their GENERATION CODE differs, which means the enclosure
+ *     changed between the two commands.  An enclosure which cannot be
+ *     opened or read is skipped, its disks will be reported as not found.
+ *  3. Collect the element index of every SAS address the enclosures report
+ *     into a new map, then swap it in for _ses_slot_map.
+ *
+ * Lookups are not blocked by the scan, only the swap takes
+ * _ses_slot_map_lock.  Scans are serialized by _ses_slot_map_scan_lock, a
+ * caller which waited there for a scan started after its own cache miss
+ * uses that scan's result instead of doing one more.
+ */
+static int _ses_slot_map_refresh(char *err_msg) {
+    int rc = LSM_ERR_OK;
+    char **bsg_paths = NULL;
+    uint32_t bsg_count = 0;
+    uint32_t i = 0;
+    uint32_t j = 0;
+    int fd = -1;
+    uint8_t *cfg_data = NULL;
+    uint8_t *add_st_data = NULL;
+    struct _ses_cfg_hdr *cfg_hdr = NULL;
+    struct _ses_add_st *add_st = NULL;
+    GHashTable *map = NULL;
+    GHashTable *old_map = NULL;
+    uint64_t scan_gen = 0;
+
+    assert(err_msg != NULL);
+
+    scan_gen = __atomic_load_n(&_ses_slot_map_scan_gen, __ATOMIC_ACQUIRE);
+    pthread_mutex_lock(&_ses_slot_map_scan_lock);
+    if (_ses_slot_map_scan_gen != scan_gen)
+        goto out;
+
+    cfg_data = (uint8_t *)malloc(_SG_T10_SPC_RECV_DIAG_MAX_LEN);
+    _alloc_null_check(err_msg, cfg_data, rc, out);
+    add_st_data = (uint8_t *)malloc(_SG_T10_SPC_RECV_DIAG_MAX_LEN);
+    _alloc_null_check(err_msg, add_st_data, rc, out);
+    cfg_hdr = (struct _ses_cfg_hdr *)cfg_data;
+    add_st = (struct _ses_add_st *)add_st_data;
+    map = g_hash_table_new_full(g_str_hash, g_str_equal, free,
+                                _ses_slot_free);
+    _alloc_null_check(err_msg, map, rc, out);
+
+    _good(_ses_bsg_paths_get(err_msg, &bsg_paths, &bsg_count), rc, out);
+
+    for (i = 0; i < bsg_count; ++i) {
+        if (_sg_io_open_rw(err_msg, bsg_paths[i], &fd) != LSM_ERR_OK) {
+            _lsm_err_msg_clear(err_msg);
+            continue;
+        }
+        for (j = 0; j < _SES_GEN_CODE_RETRY_MAX; ++j) {
+            if ((_sg_io_recv_diag(err_msg, fd, _T10_SES_CFG_PG_CODE,
+                                  cfg_data) != LSM_ERR_OK) ||
+                (_sg_io_recv_diag(err_msg, fd, _T10_SES_ADD_STATUS_PG_CODE,
+                                  add_st_data) != LSM_ERR_OK)) {
+                _lsm_err_msg_clear(err_msg);
+                j = _SES_GEN_CODE_RETRY_MAX;
+                break;
             }
+            if (cfg_hdr->gen_code_be == add_st->gen_code_be)
+                break;
         }
+        close(fd);
+        fd = -1;
+        /* An enclosure still changing is left out too */
+        if (j < _SES_GEN_CODE_RETRY_MAX)
+            _good(_ses_slot_map_fill(err_msg, map, bsg_paths[i], cfg_data,
+                                     add_st_data),
+                  rc, out);
     }
 
+    pthread_mutex_lock(&_ses_slot_map_lock);
+    old_map = _ses_slot_map;
+    _ses_slot_map = map;
+    pthread_mutex_unlock(&_ses_slot_map_lock);
+    map = old_map;
+    __atomic_store_n(&_ses_slot_map_scan_gen, scan_gen + 1, __ATOMIC_RELEASE);
+
 out:
-    return element_index;
+    pthread_mutex_unlock(&_ses_slot_map_scan_lock);
+    if (map != NULL)
+        g_hash_table_destroy(map);
+    if (bsg_paths != NULL) {
+        for (i = 0; i < bsg_count; ++i)
+            free(bsg_paths[i]);
+        free(bsg_paths);
+    }
+    free(cfg_data);
+    free(add_st_data);
+    return rc;
+}
+
+static int _ses_slot_map_lookup(char *err_msg, const char *sas_addr,
+                                struct _ses_slot *slot, bool *found) {
+    int rc = LSM_ERR_OK;
+    struct _ses_slot *cached = NULL;
+
+    assert(err_msg != NULL);
+    assert(sas_addr != NULL);
+    assert(slot != NULL);
+    assert(found != NULL);
+
+    *found = false;
+    memset(slot, 0, sizeof(struct _ses_slot));
+
+    pthread_mutex_lock(&_ses_slot_map_lock);
+    if (_ses_slot_map != NULL)
+        cached = (struct _ses_slot *)g_hash_table_lookup(_ses_slot_map,
+                                                         sas_addr);
+    if (cached != NULL) {
+        memcpy(slot, cached, sizeof(struct _ses_slot));
+        slot->bsg_path = strdup(cached->bsg_path);
+        if (slot->bsg_path == NULL) {
+            _lsm_err_msg_set(err_msg, "No memory");
+            rc = LSM_ERR_NO_MEMORY;
+        } else {
+            *found = true;
+        }
+    }
+    pthread_mutex_unlock(&_ses_slot_map_lock);
+    return rc;
+}
+
+static int _ses_enc_open(char *err_msg, struct _ses_slot *slot,
+                         uint8_t *status_data, uint8_t *add_st_data, int *fd,
+                         bool *stale) {
+    int rc = LSM_ERR_OK;
+    struct _ses_st_hdr *st_hdr = (struct _ses_st_hdr *)status_data;
+    struct _ses_add_st *add_st = (struct _ses_add_st *)add_st_data;
+
+    assert(err_msg != NULL);
+    assert(slot != NULL);
+    assert(status_data != NULL);
+    assert(add_st_data != NULL);
+    assert(fd != NULL);
+    assert(stale != NULL);
+
+    *stale = false;
+
+    /* The enclosure might be gone, a rescan will tell the real error if any.
+     */
+    if (_sg_io_open_rw(err_msg, slot->bsg_path, fd) != LSM_ERR_OK) {
+        _lsm_err_msg_clear(err_msg);
+        *stale = true;
+        goto out;
+    }
+    _good(_sg_io_recv_diag(err_msg, *fd, _T10_SES_STATUS_PG_CODE, status_data),
+          rc, out);
+    _good(_sg_io_recv_diag(err_msg, *fd, _T10_SES_ADD_STATUS_PG_CODE,
+                           add_st_data),
+          rc, out);
+
+    if ((st_hdr->gen_code_be != slot->gen_code_be) ||
+        (add_st->gen_code_be != slot->gen_code_be))
+        *stale = true;
+
+out:
+    if ((rc != LSM_ERR_OK) || (*stale == true)) {
+        if (*fd >= 0)
+            close(*fd);
+        *fd = -1;
+    }
+    if (*stale == true)
+        _ses_slot_map_drop(slot->bsg_path);
+    return rc;
+}
+
+/*
+ * Check whether the additional element status page still reports the slot
+ * of cached SAS address.
+ */
+static bool _ses_slot_valid(struct _ses_slot *slot, uint8_t *add_st_data) {
+    struct _ses_add_st_dp *dp = NULL;
+
+    dp = _ses_add_st_dp_find(slot->sas_addr, add_st_data);
+    return (dp != NULL) && (dp->element_index == slot->add_st_index);
 }
 
 static int _ses_raw_status_get(char *err_msg, uint8_t *status_data,
@@ -543,16 +958,12 @@ out:
     return rc;
 }
 
-static int _ses_ctrl_data_gen(char *err_msg, uint8_t *status_data,
-                              uint8_t *status, const int16_t element_index,
-                              uint16_t *len) {
+static void _ses_ctrl_data_gen(uint8_t *status_data, uint16_t *len) {
     struct _ses_ctrl_diag_hdr *ctrl_hdr = NULL;
     uint8_t *tmp_p = NULL;
     uint8_t *end_p = NULL;
 
-    assert(err_msg != NULL);
     assert(status_data != NULL);
-    assert(status != NULL);
     assert(len != NULL);
 
     ctrl_hdr = (struct _ses_ctrl_diag_hdr *)(status_data);
@@ -568,15 +979,23 @@ static int _ses_ctrl_data_gen(char *err_msg, uint8_t *status_data,
                          _T10_SES_CTRL_SELECT_BIT);
         tmp_p += _T10_SES_DEV_SLOT_STATUS_LEN;
     }
+}
 
-    /* update the selected element */
+static void _ses_ctrl_data_set(uint8_t *ctrl_data, uint8_t *status,
+                               const int16_t element_index) {
+    struct _ses_ctrl_diag_hdr *ctrl_hdr = NULL;
+    uint8_t *tmp_p = NULL;
 
+    assert(ctrl_data != NULL);
+    assert(status != NULL);
+
+    ctrl_hdr = (struct _ses_ctrl_diag_hdr *)(ctrl_data);
+
+    /* update the selected element */
     tmp_p = &ctrl_hdr->ctrl_dp_list_begin +
             _T10_SES_DEV_SLOT_STATUS_LEN * element_index;
 
     memcpy(tmp_p, status, _T10_SES_DEV_SLOT_STATUS_LEN);
-
-    return LSM_ERR_OK;
 }
 
 /*
@@ -624,49 +1043,146 @@ static int16_t _ses_eiioe(uint8_t *cfg_data, int16_t element_index) {
     return element_index + add;
 }
 
-/*
- * Workflow:
- *  1. Find all scsi generic paths that correspond to enclosures.
- *  2. Find which scsi generic path connects to the given SAS address via the
- *     following SES page:
- *      6.1.13 Additional Element Status diagnostic page
- *  3. Record the element index of the port that the given SAS address is
- *     connecting to.
- *  4. Retrieve status of above element index.
- *  5. Update status data of these SES pages with ctrl_value:
- *      6.1.3 Enclosure Control diagnostic page
- *      7.2.2 Control element format
- *      7.3.2 Device Slot element
- *  4. Invoke SEND DIAGNOSTICS command.
- */
-int _ses_dev_slot_ctrl(char *err_msg, const char *tp_sas_addr, int ctrl_value,
-                       int ctrl_type) {
+static int _ses_enc_slots_ctrl(char *err_msg, struct _ses_slot *slots,
+                               uint32_t slot_count, uint8_t *status_data,
+                               uint8_t *add_st_data, uint8_t ctrl_bytes,
+                               uint8_t ctrl_bit, int ctrl_type, bool *stale) {
     int rc = LSM_ERR_OK;
     int fd = -1;
-    uint8_t cfg_data[_SG_T10_SPC_RECV_DIAG_MAX_LEN];
-    uint8_t status_data[_SG_T10_SPC_RECV_DIAG_MAX_LEN];
-    uint8_t add_st_data[_SG_T10_SPC_RECV_DIAG_MAX_LEN];
+    uint32_t i = 0;
     uint8_t status[_T10_SES_DEV_SLOT_STATUS_LEN];
-    int16_t element_index = -1;
-    uint8_t ctrl_bytes = 0;
-    uint8_t ctrl_bit = 0;
-    uint32_t gen_code_be;
+    uint32_t gen_code_be = 0;
     uint16_t ctrl_data_len = 0;
 
-    _good(_ses_info_get_by_sas_addr(err_msg, tp_sas_addr, cfg_data, status_data,
-                                    add_st_data, &fd, &element_index),
+    assert(slots != NULL);
+    assert(slot_count > 0);
+    assert(stale != NULL);
+
+    _good(_ses_enc_open(err_msg, &slots[0], status_data, add_st_data, &fd,
+                        stale),
           rc, out);
+    if (*stale == true)
+        goto out;
 
-    _good(_ses_raw_status_get(err_msg, status_data, element_index, status,
-                              &gen_code_be),
+    for (i = 0; i < slot_count; ++i) {
+        if (!_ses_slot_valid(&slots[i], add_st_data)) {
+            _ses_slot_map_drop(slots[0].bsg_path);
+            *stale = true;
+            goto out;
+        }
+    }
+
+    _ses_ctrl_data_gen(status_data, &ctrl_data_len);
+
+    for (i = 0; i < slot_count; ++i) {
+        _good(_ses_raw_status_get(err_msg, status_data, slots[i].element_index,
+                                  status, &gen_code_be),
+              rc, out);
+
+        /* Only keep the PRDFAIL bit */
+        status[_T10_SES_CTRL_PRDFAIL_BYTES] &= 1 << _T10_SES_CTRL_PRDFAIL_BIT;
+
+        /* Set the SELECT bit */
+        _set_array_bit(status, _T10_SES_CTRL_SELECT_BYTES,
+                       _T10_SES_CTRL_SELECT_BIT);
+
+        if (ctrl_type == _SES_CTRL_SET)
+            _set_array_bit(status, ctrl_bytes, ctrl_bit);
+        else
+            _clear_array_bit(status, ctrl_bytes, ctrl_bit);
+
+        _ses_ctrl_data_set(status_data, status, slots[i].element_index);
+    }
+
+    /* The SEND DIAGNOSTIC fails if GENERATION CODE changed since the status
+     * page was retrieved, drop the cache so that next call will rescan.
+     */
+    rc = _sg_io_send_diag(err_msg, fd, status_data, ctrl_data_len);
+    if (rc != LSM_ERR_OK) {
+        _ses_slot_map_drop(slots[0].bsg_path);
+        goto out;
+    }
+
+    /*
+     * Verify whether certain action is supported
+     */
+    _good(_sg_io_recv_diag(err_msg, fd, _T10_SES_STATUS_PG_CODE, status_data),
           rc, out);
 
-    /* Only keep the PRDFAIL bit */
-    status[_T10_SES_CTRL_PRDFAIL_BYTES] &= 1 << _T10_SES_CTRL_PRDFAIL_BIT;
+    for (i = 0; i < slot_count; ++i) {
+        _good(_ses_raw_status_get(err_msg, status_data, slots[i].element_index,
+                                  status, &gen_code_be),
+              rc, out);
 
-    /* Set the SELECT bit */
-    _set_array_bit(status, _T10_SES_CTRL_SELECT_BYTES,
-                   _T10_SES_CTRL_SELECT_BIT);
+        if (((ctrl_type == _SES_CTRL_CLEAR) &&
+             (status[ctrl_bytes] & (1 << ctrl_bit))) ||
+            ((ctrl_type == _SES_CTRL_SET) &&
+             !((status[ctrl_bytes] & (1 << ctrl_bit))))) {
+            /* Control bit is still set */
+            rc = LSM_ERR_NO_SUPPORT;
+            _lsm_err_msg_set(err_msg,
+                             "Requested SES action is not supported "
+                             "by vendor enclosure vendor or/and kernel driver");
+            goto out;
+        }
+    }
+
+out:
+    if (fd >= 0)
+        close(fd);
+    return rc;
+}
+
+static int _ses_slot_cmp(const void *a, const void *b) {
+    const struct _ses_slot *slot_a = (const struct _ses_slot *)a;
+    const struct _ses_slot *slot_b = (const struct _ses_slot *)b;
+    int rc = strcmp(slot_a->bsg_path, slot_b->bsg_path);
+
+    if (rc != 0)
+        return rc;
+    return slot_a->element_index - slot_b->element_index;
+}
+
+static void _ses_slots_clear(struct _ses_slot *slots, uint32_t slot_count) {
+    uint32_t i = 0;
+
+    for (i = 0; i < slot_count; ++i)
+        free(slots[i].bsg_path);
+    memset(slots, 0, sizeof(struct _ses_slot) * slot_count);
+}
+
+/*
+ * Workflow:
+ *  1. Find the enclosure and element index of each given SAS address in the
+ *     _ses_slot_map, rebuilding the map if any is missing.
+ *  2. Group the slots by enclosure.
+ *  3. For each enclosure, retrieve its status page and check its GENERATION
+ *     CODE is still the cached one. If not, rebuild the map and start over.
+ *  4. Update status data of these SES pages with ctrl_value for all slots of
+ *     this enclosure:
+ *      6.1.3 Enclosure Control diagnostic page
+ *      7.2.2 Control element format
+ *      7.3.2 Device Slot element
+ *  5. Invoke one SEND DIAGNOSTICS command per enclosure.
+ */
+int _ses_dev_slot_ctrl_batch(char *err_msg, lsm_string_list *tp_sas_addrs,
+                             int ctrl_value, int ctrl_type) {
+    int rc = LSM_ERR_OK;
+    uint8_t *status_data = NULL;
+    uint8_t *add_st_data = NULL;
+    struct _ses_slot *slots = NULL;
+    uint32_t slot_count = 0;
+    const char *tp_sas_addr = NULL;
+    uint32_t attempt = 0;
+    uint32_t i = 0;
+    uint32_t j = 0;
+    uint8_t ctrl_bytes = 0;
+    uint8_t ctrl_bit = 0;
+    bool found = false;
+    bool stale = false;
+
+    assert(err_msg != NULL);
+    assert(tp_sas_addrs != NULL);
 
     if (ctrl_value == _SES_DEV_CTRL_RQST_IDENT) {
         ctrl_bytes = _T10_SES_CTRL_RQST_IDENT_BYTES;
@@ -680,116 +1196,171 @@ int _ses_dev_slot_ctrl(char *err_msg, const char *tp_sas_addr, int ctrl_value,
         goto out;
     }
 
-    if (ctrl_type == _SES_CTRL_SET)
-        _set_array_bit(status, ctrl_bytes, ctrl_bit);
-    else if (ctrl_type == _SES_CTRL_CLEAR)
-        _clear_array_bit(status, ctrl_bytes, ctrl_bit);
-    else {
+    if ((ctrl_type != _SES_CTRL_SET) && (ctrl_type != _SES_CTRL_CLEAR)) {
         rc = LSM_ERR_LIB_BUG;
         _lsm_err_msg_set(err_msg, "Got invalid ctrl_type %d", ctrl_type);
         goto out;
     }
 
-    _good(_ses_ctrl_data_gen(err_msg, status_data, status, element_index,
-                             &ctrl_data_len),
-          rc, out);
+    slot_count = lsm_string_list_size(tp_sas_addrs);
+    if (slot_count == 0)
+        goto out;
 
-    /* TODO(Gris Ge): If gen_code_be not match, the SEND DIAGNOSTIC will fail,
-     *                in that case, we should refresh status and retry.
-     */
-    _good(_sg_io_send_diag(err_msg, fd, status_data, ctrl_data_len), rc, out);
+    slots = (struct _ses_slot *)calloc(slot_count, sizeof(struct _ses_slot));
+    _alloc_null_check(err_msg, slots, rc, out);
+    status_data = (uint8_t *)malloc(_SG_T10_SPC_RECV_DIAG_MAX_LEN);
+    _alloc_null_check(err_msg, status_data, rc, out);
+    add_st_data = (uint8_t *)malloc(_SG_T10_SPC_RECV_DIAG_MAX_LEN);
+    _alloc_null_check(err_msg, add_st_data, rc, out);
+
+    /* The first attempt trusts the cache, later ones rescan all enclosures */
+    for (attempt = 0; attempt <= _SES_GEN_CODE_RETRY_MAX; ++attempt) {
+        if (attempt > 0)
+            _good(_ses_slot_map_refresh(err_msg), rc, out);
+
+        _ses_slots_clear(slots, slot_count);
+        found = true;
+        _lsm_string_list_foreach(tp_sas_addrs, i, tp_sas_addr) {
+            _good(_ses_slot_map_lookup(err_msg, tp_sas_addr, &slots[i],
+                                       &found),
+                  rc, out);
+            if (found == false)
+                break;
+        }
+        if (found == false) {
+            if (attempt == 0)
+                continue;
+            rc = LSM_ERR_NO_SUPPORT;
+            _lsm_err_msg_set(err_msg,
+                             "Failed to find any SCSI enclosure with "
+                             "given SAS address %s",
+                             tp_sas_addr);
+            goto out;
+        }
 
-    /*
-     * Verify whether certain action is supported
-     */
-    _good(_sg_io_recv_diag(err_msg, fd, _T10_SES_STATUS_PG_CODE, status_data),
-          rc, out);
+        qsort(slots, slot_count, sizeof(struct _ses_slot), _ses_slot_cmp);
 
-    _good(_ses_raw_status_get(err_msg, status_data, element_index, status,
-                              &gen_code_be),
-          rc, out);
+        stale = false;
+        for (i = 0; i < slot_count; i = j) {
+            for (j = i + 1; j < slot_count; ++j) {
+                if (strcmp(slots[j].bsg_path, slots[i].bsg_path) != 0)
+                    break;
+            }
+            _good(_ses_enc_slots_ctrl(err_msg, &slots[i], j - i, status_data,
+                                      add_st_data, ctrl_bytes, ctrl_bit,
+                                      ctrl_type, &stale),
+                  rc, out);
+            if (stale == true)
+                break;
+        }
+        if (stale == false)
+            goto out;
+    }
 
-    if (((ctrl_type == _SES_CTRL_CLEAR) &&
-         (status[ctrl_bytes] & (1 << ctrl_bit))) ||
-        ((ctrl_type == _SES_CTRL_SET) &&
-         !((status[ctrl_bytes] & (1 << ctrl_bit))))) {
-        /* Control bit is still set */
-        rc = LSM_ERR_NO_SUPPORT;
-        _lsm_err_msg_set(err_msg,
-                         "Requested SES action is not supported "
-                         "by vendor enclosure vendor or/and kernel driver");
+    rc = LSM_ERR_LIB_BUG;
+    _lsm_err_msg_set(err_msg, "SCSI enclosure configuration kept changing "
+                              "during the SES action");
+
+out:
+    if (slots != NULL) {
+        _ses_slots_clear(slots, slot_count);
+        free(slots);
+    }
+    free(status_data);
+    free(add_st_data);
+    return rc;
+}
+
+int _ses_dev_slot_ctrl(char *err_msg, const char *tp_sas_addr, int ctrl_value,
+                       int ctrl_type) {
+    int rc = LSM_ERR_OK;
+    lsm_string_list *tp_sas_addrs = NULL;
+
+    assert(err_msg != NULL);
+    assert(tp_sas_addr != NULL);
+
+    tp_sas_addrs = lsm_string_list_alloc(0 /* no pre-allocation */);
+    _alloc_null_check(err_msg, tp_sas_addrs, rc, out);
+    if (lsm_string_list_append(tp_sas_addrs, tp_sas_addr) != 0) {
+        rc = LSM_ERR_NO_MEMORY;
+        _lsm_err_msg_set(err_msg, "No memory");
+        goto out;
     }
 
+    rc = _ses_dev_slot_ctrl_batch(err_msg, tp_sas_addrs, ctrl_value,
+                                  ctrl_type);
+
 out:
-    if (fd >= 0)
-        close(fd);
+    if (tp_sas_addrs != NULL)
+        lsm_string_list_free(tp_sas_addrs);
     return rc;
 }
 
 static int _ses_info_get_by_sas_addr(char *err_msg, const char *tp_sas_addr,
-                                     uint8_t *cfg_data, uint8_t *status_data,
+                                     uint8_t *status_data,
                                      uint8_t *add_st_data, int *fd,
-                                     int16_t *element_index) {
+                                     struct _ses_slot *slot) {
     int rc = LSM_ERR_OK;
-    char **bsg_paths = NULL;
-    uint32_t bsg_count = 0;
-    uint32_t i = 0;
+    uint32_t attempt = 0;
     bool found = false;
+    bool stale = false;
 
     assert(tp_sas_addr != NULL);
-    assert(cfg_data != NULL);
     assert(status_data != NULL);
     assert(add_st_data != NULL);
-    assert(element_index != NULL);
     assert(fd != NULL);
+    assert(slot != NULL);
 
-    _good(_ses_bsg_paths_get(err_msg, &bsg_paths, &bsg_count), rc, out);
+    *fd = -1;
+    memset(slot, 0, sizeof(struct _ses_slot));
 
-    for (i = 0; i < bsg_count; ++i) {
-        _good(_sg_io_open_rw(err_msg, bsg_paths[i], fd), rc, out);
-        _good(_sg_io_recv_diag(err_msg, *fd, _T10_SES_CFG_PG_CODE, cfg_data),
-              rc, out);
-        _good(_sg_io_recv_diag(err_msg, *fd, _T10_SES_STATUS_PG_CODE,
-                               status_data),
-              rc, out);
-        _good(_sg_io_recv_diag(err_msg, *fd, _T10_SES_ADD_STATUS_PG_CODE,
-                               add_st_data),
-              rc, out);
-        /* TODO(Gris Ge): We need to check "GENERATION CODE" of above four
-         *                pages are identical, or we need retry.
-         */
+    /* The first attempt trusts the cache, later ones rescan all enclosures */
+    for (attempt = 0; attempt <= _SES_GEN_CODE_RETRY_MAX; ++attempt) {
+        if (attempt > 0)
+            _good(_ses_slot_map_refresh(err_msg), rc, out);
 
-        *element_index = _ses_find_sas_addr(tp_sas_addr, add_st_data, cfg_data);
-        if (*element_index != -1) {
-            found = true;
+        free(slot->bsg_path);
+        _good(_ses_slot_map_lookup(err_msg, tp_sas_addr, slot, &found), rc,
+              out);
+        if (found == false) {
+            if (attempt == 0)
+                continue;
             break;
         }
 
-        if (*fd >= 0)
-            close(*fd);
+        _good(_ses_enc_open(err_msg, slot, status_data, add_st_data, fd,
+                            &stale),
+              rc, out);
+        if (stale == true)
+            continue;
+
+        if (_ses_slot_valid(slot, add_st_data))
+            goto out;
+
+        _ses_slot_map_drop(slot->bsg_path);
+        close(*fd);
         *fd = -1;
     }
-    if (found != true) {
+
+    if (found == false) {
         rc = LSM_ERR_NO_SUPPORT;
         _lsm_err_msg_set(err_msg,
                          "Failed to find any SCSI enclosure with "
                          "given SAS address %s",
                          tp_sas_addr);
-        goto out;
+    } else {
+        rc = LSM_ERR_LIB_BUG;
+        _lsm_err_msg_set(err_msg, "SCSI enclosure configuration kept "
+                                  "changing during the SES action");
     }
 
 out:
-    if (bsg_paths != NULL) {
-        for (i = 0; i < bsg_count; ++i) {
-            free(bsg_paths[i]);
-        }
-        free(bsg_paths);
-    }
     if (rc != LSM_ERR_OK) {
-        *element_index = -1;
         if (*fd >= 0)
             close(*fd);
         *fd = -1;
+        free(slot->bsg_path);
+        memset(slot, 0, sizeof(struct _ses_slot));
     }
     return rc;
 }
@@ -798,22 +1369,23 @@ int _ses_status_get(char *err_msg, const char *tp_sas_addr,
                     struct _ses_dev_slot_status *status) {
     int rc = LSM_ERR_OK;
     int fd = -1;
-    uint8_t cfg_data[_SG_T10_SPC_RECV_DIAG_MAX_LEN];
     uint8_t status_data[_SG_T10_SPC_RECV_DIAG_MAX_LEN];
     uint8_t add_st_data[_SG_T10_SPC_RECV_DIAG_MAX_LEN];
     uint8_t raw_status[_T10_SES_DEV_SLOT_STATUS_LEN];
-    int16_t element_index = -1;
+    struct _ses_slot slot;
     uint32_t gen_code_be = 0;
 
     assert(tp_sas_addr != NULL);
     assert(status != NULL);
 
-    _good(_ses_info_get_by_sas_addr(err_msg, tp_sas_addr, cfg_data, status_data,
-                                    add_st_data, &fd, &element_index),
+    memset(&slot, 0, sizeof(struct _ses_slot));
+
+    _good(_ses_info_get_by_sas_addr(err_msg, tp_sas_addr, status_data,
+                                    add_st_data, &fd, &slot),
           rc, out);
 
-    _good(_ses_raw_status_get(err_msg, status_data, element_index, raw_status,
-                              &gen_code_be),
+    _good(_ses_raw_status_get(err_msg, status_data, slot.element_index,
+                              raw_status, &gen_code_be),
           rc, out);
 
     memcpy(status, raw_status, _T10_SES_DEV_SLOT_STATUS_LEN);
@@ -821,5 +1393,6 @@ int _ses_status_get(char *err_msg, const char *tp_sas_addr,
 out:
     if (fd >= 0)
         close(fd);
+    free(slot.bsg_path);
     return rc;
 }
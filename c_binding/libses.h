@@ -24,6 +24,7 @@
 
 #include "libstoragemgmt/libstoragemgmt_common.h"
 #include "libstoragemgmt/libstoragemgmt_error.h"
+#include "libstoragemgmt/libstoragemgmt_types.h"
 
 #define _SES_CTRL_SET   1
 #define _SES_CTRL_CLEAR 2
@@ -89,6 +90,21 @@ struct _ses_dev_slot_status {
 LSM_DLL_LOCAL int _ses_dev_slot_ctrl(char *err_msg, const char *tp_sas_addr,
                                      int ctrl_value, int ctrl_type);
 
+/*
+ * Like _ses_dev_slot_ctrl(), but for many target port SAS addresses with
+ * one SEND DIAGNOSTIC per enclosure. Nothing is changed if any SAS address
+ * is not found in enclosures.
+ *
+ * err_msg:      Should be 'char err_msg[_LSM_ERR_MSG_LEN]'.
+ * tp_sas_addrs: Target port SAS addresses.
+ * ctrl_value:   Should be _SES_DEV_CTRL_RQST_IDENT or
+ *               _SES_DEV_CTRL_RQST_FAULT.
+ * ctrl_type:    _SES_CTRL_SET or _SES_CTRL_CLEAR.
+ */
+LSM_DLL_LOCAL int _ses_dev_slot_ctrl_batch(char *err_msg,
+                                           lsm_string_list *tp_sas_addrs,
+                                           int ctrl_value, int ctrl_type);
+
 /*
  * err_msg:     Should be 'char err_msg[_LSM_ERR_MSG_LEN]'.
  * tp_sas_addr: Target port SAS address.
@@ -18,6 +18,7 @@
  */
 
 #include "libsg.h"
+#include "libsg_async.h"
 #include "utils.h"
 
 #include "libstoragemgmt/libstoragemgmt_error.h"
@@ -28,6 +29,7 @@
 #include <fcntl.h>
 #include <limits.h>
 #include <linux/bsg.h>
+#include <pthread.h>
 #include <scsi/scsi.h>
 #include <scsi/scsi.h> /* For SCSI_IOCTL_GET_BUS_NUMBER */
 #include <scsi/sg.h>
@@ -38,11 +40,6 @@
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 
-/* SGIO timeout: 1 second
- * TODO(Gris Ge): Raise LSM_ERR_TIMEOUT error for this
- */
-#define _SG_IO_TMO 1000
-
 /* SPC-5 rev 07 Table 142 - INQUIRY command */
 #define _T10_SPC_INQUIRY_CMD_LEN 6
 /* SPC-5 rev 07 Table 219 - RECEIVE DIAGNOSTIC RESULTS command */
@@ -58,17 +55,9 @@
 /* SPC-5 rev 07 - REQUEST SENSE command */
 #define _T10_SPC_VPD_SUP_VPD_PGS_LIST_OFFSET 4
 
-/* SPC-5 rev 07 4.4.2.1 Descriptor format sense data overview
- * Quote:
- * The ADDITIONAL SENSE LENGTH field indicates the number of additional sense
- * bytes that follow. The additional sense length shall be less than or equal to
- * 244 (i.e., limiting the total length of the sense data to 252 bytes).
- */
-#define _T10_SPC_SENSE_DATA_MAX_LENGTH 252
-
 /* The max length of char[] required to hold hex dump of sense data */
 #define _T10_SPC_SENSE_DATA_STR_MAX_LENGTH                                     \
-    _T10_SPC_SENSE_DATA_MAX_LENGTH * 2 + 1
+    _SG_T10_SPC_SENSE_DATA_MAX_LEN * 2 + 1
 
 /* SPC-5 rev 07 Table 300 - Summary of log page codes */
 #define _T10_SPC_INFO_EXCEP_PAGE_CODE 0x2f
@@ -124,11 +113,6 @@
  */
 #define _T10_SAT_ATA_INFO_VPD_PAGE_MAX_LEN 572
 
-/*
- * SBC-4 rev 14 Table 261 - Block Device Characteristics VPD page
- */
-#define _T10_SBC_VPD_BLK_DEV_CHA_MAX_LEN 64
-
 const char *const _T10_SPC_SENSE_KEY_STR[] = {
     "NO SENSE",       "RECOVERED ERROR", "NOT READY",      "MEDIUM ERROR",
     "HARDWARE ERROR", "ILLEGAL REQUEST", "UNIT ATTENTION", "DATA PROTECT",
@@ -139,10 +123,6 @@ const char *const _T10_SPC_SENSE_KEY_STR[] = {
 /* The offset of ADDITIONAL SENSE LENGTH */
 #define _T10_SPC_SENSE_DATA_LEN_OFFSET 8
 
-#define _SG_IO_NO_DATA   0
-#define _SG_IO_SEND_DATA 1
-#define _SG_IO_RECV_DATA 2
-
 #pragma pack(push, 1)
 /*
  * SPC-5 rev 7 Table 589 - Device Identification VPD page
@@ -322,11 +302,16 @@ struct _sg_t10_ata_pass_through_12_cdb {
 
 #pragma pack(pop)
 
+/* Set by _sg_io_backend_set(), NULL means SG_IO ioctl */
+static struct _sg_async *_sg_io_engine = NULL;
+/* The engine runs one command at a time for all threads */
+static pthread_mutex_t _sg_io_engine_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /*
  * For SG_IO v3.
  * Return 0 if pass, return -1 means got sense_data, return errno of ioctl
  * error if ioctl failed.
- * The 'sense_data' should be uint8_t[_T10_SPC_SENSE_DATA_MAX_LENGTH].
+ * The 'sense_data' should be uint8_t[_SG_T10_SPC_SENSE_DATA_MAX_LEN].
  */
 static int _sg_io_v3(int fd, uint8_t *cdb, uint8_t cdb_len, uint8_t *data,
                      ssize_t data_len, uint8_t *sense_data, int direction);
@@ -335,11 +320,27 @@ static int _sg_io_v3(int fd, uint8_t *cdb, uint8_t cdb_len, uint8_t *data,
  * For SG_IO v4 BSG only.
  * Return 0 if pass, return -1 means got sense_data, return errno of ioctl
  * error if ioctl failed.
- * The 'sense_data' should be uint8_t[_T10_SPC_SENSE_DATA_MAX_LENGTH].
+ * The 'sense_data' should be uint8_t[_SG_T10_SPC_SENSE_DATA_MAX_LEN].
  */
 static int _sg_io_v4(int fd, uint8_t *cdb, uint8_t cdb_len, uint8_t *data,
                      ssize_t data_len, uint8_t *sense_data, int direction);
 
+/*
+ * Run the command through _sg_io_engine and store the same return as
+ * _sg_io_v3() into 'result'.  Return false if no engine is set, the SG_IO
+ * ioctl should be used then.
+ */
+static bool _sg_io_engine_run(int fd, uint8_t *cdb, uint8_t cdb_len,
+                              uint8_t *data, ssize_t data_len,
+                              uint8_t *sense_data, int direction,
+                              int *result);
+
+/*
+ * Fill 'cdb' with INQUIRY of given VPD page and return its allocation
+ * length.  The 'cdb' should be uint8_t[_T10_SPC_INQUIRY_CMD_LEN].
+ */
+static ssize_t _sg_vpd_cdb_init(uint8_t *cdb, uint8_t page_code);
+
 static struct _sg_t10_vpd83_dp *_sg_t10_vpd83_dp_new(void);
 
 static int _sg_io_open(char *err_msg, const char *disk_path, int *fd,
@@ -376,15 +377,19 @@ static int _sg_io_v3(int fd, uint8_t *cdb, uint8_t cdb_len, uint8_t *data,
     assert(cdb != NULL);
     assert(cdb_len != 0);
 
+    if (_sg_io_engine_run(fd, cdb, cdb_len, data, data_len, sense_data,
+                          direction, &rc))
+        return rc;
+
     memset(&io_hdr, 0, sizeof(struct sg_io_hdr));
-    memset(sense_data, 0, _T10_SPC_SENSE_DATA_MAX_LENGTH);
+    memset(sense_data, 0, _SG_T10_SPC_SENSE_DATA_MAX_LEN);
     if (direction == _SG_IO_RECV_DATA)
         memset(data, 0, (size_t)data_len);
     io_hdr.interface_id = 'S'; /* 'S' for SCSI generic */
     io_hdr.cmdp = cdb;
     io_hdr.cmd_len = cdb_len;
     io_hdr.sbp = sense_data;
-    io_hdr.mx_sb_len = _T10_SPC_SENSE_DATA_MAX_LENGTH;
+    io_hdr.mx_sb_len = _SG_T10_SPC_SENSE_DATA_MAX_LEN;
     if (direction == _SG_IO_RECV_DATA)
         io_hdr.dxfer_direction = SG_DXFER_FROM_DEV;
     else if (direction == _SG_IO_SEND_DATA)
@@ -418,8 +423,12 @@ static int _sg_io_v4(int fd, uint8_t *cdb, uint8_t cdb_len, uint8_t *data,
     assert(cdb != NULL);
     assert(cdb_len != 0);
 
+    if (_sg_io_engine_run(fd, cdb, cdb_len, data, data_len, sense_data,
+                          direction, &rc))
+        return rc;
+
     memset(&io_hdr, 0, sizeof(struct sg_io_v4));
-    memset(sense_data, 0, _T10_SPC_SENSE_DATA_MAX_LENGTH);
+    memset(sense_data, 0, _SG_T10_SPC_SENSE_DATA_MAX_LEN);
     if (direction == _SG_IO_RECV_DATA)
         memset(data, 0, (size_t)data_len);
     io_hdr.guard = 'Q'; /* Just to be different from v3 */
@@ -428,7 +437,7 @@ static int _sg_io_v4(int fd, uint8_t *cdb, uint8_t cdb_len, uint8_t *data,
     io_hdr.request_len = cdb_len;
     io_hdr.request = (__u64)(uintptr_t)cdb;
     io_hdr.response = (__u64)(uintptr_t)sense_data;
-    io_hdr.max_response_len = _T10_SPC_SENSE_DATA_MAX_LENGTH;
+    io_hdr.max_response_len = _SG_T10_SPC_SENSE_DATA_MAX_LEN;
 
     if (data != NULL) {
         if (direction == _SG_IO_RECV_DATA) {
@@ -454,30 +463,15 @@ static int _sg_io_v4(int fd, uint8_t *cdb, uint8_t cdb_len, uint8_t *data,
     return rc;
 }
 
-int _sg_io_vpd(char *err_msg, int fd, uint8_t page_code, uint8_t *data) {
-    int rc = LSM_ERR_OK;
-    uint8_t vpd_00_data[_SG_T10_SPC_VPD_MAX_LEN];
-    uint8_t cdb[_T10_SPC_INQUIRY_CMD_LEN];
-    uint8_t sense_data[_T10_SPC_SENSE_DATA_MAX_LENGTH];
-    int ioctl_errno = 0;
-    int rc_vpd_00 = 0;
-    char strerr_buff[_LSM_ERR_MSG_LEN];
-    uint8_t sense_key = _T10_SPC_SENSE_KEY_NO_SENSE;
-    char sense_err_msg[_LSM_ERR_MSG_LEN / 2];
+static ssize_t _sg_vpd_cdb_init(uint8_t *cdb, uint8_t page_code) {
     ssize_t data_len = 0;
 
-    assert(err_msg != NULL);
-    assert(fd >= 0);
-    assert(data != NULL);
-
-    memset(sense_err_msg, 0, sizeof(sense_err_msg));
-
     switch (page_code) {
     case _SG_T10_SPC_VPD_ATA_INFO:
         data_len = _T10_SAT_ATA_INFO_VPD_PAGE_MAX_LEN;
         break;
     case _SG_T10_SBC_VPD_BLK_DEV_CHA:
-        data_len = _T10_SBC_VPD_BLK_DEV_CHA_MAX_LEN;
+        data_len = _SG_T10_SBC_VPD_BLK_DEV_CHA_MAX_LEN;
         break;
     default:
         data_len = _SG_T10_SPC_VPD_MAX_LEN;
@@ -496,6 +490,28 @@ int _sg_io_vpd(char *err_msg, int fd, uint8_t page_code, uint8_t *data) {
     /* We have no use case need for handling auto contingent allegiance(ACA)
      * yet.
      */
+    return data_len;
+}
+
+int _sg_io_vpd(char *err_msg, int fd, uint8_t page_code, uint8_t *data) {
+    int rc = LSM_ERR_OK;
+    uint8_t vpd_00_data[_SG_T10_SPC_VPD_MAX_LEN];
+    uint8_t cdb[_T10_SPC_INQUIRY_CMD_LEN];
+    uint8_t sense_data[_SG_T10_SPC_SENSE_DATA_MAX_LEN];
+    int ioctl_errno = 0;
+    int rc_vpd_00 = 0;
+    char strerr_buff[_LSM_ERR_MSG_LEN];
+    uint8_t sense_key = _T10_SPC_SENSE_KEY_NO_SENSE;
+    char sense_err_msg[_LSM_ERR_MSG_LEN / 2];
+    ssize_t data_len = 0;
+
+    assert(err_msg != NULL);
+    assert(fd >= 0);
+    assert(data != NULL);
+
+    memset(sense_err_msg, 0, sizeof(sense_err_msg));
+
+    data_len = _sg_vpd_cdb_init(cdb, page_code);
 
     ioctl_errno = _sg_io_v3(fd, cdb, _T10_SPC_INQUIRY_CMD_LEN, data, data_len,
                             sense_data, _SG_IO_RECV_DATA);
@@ -773,7 +789,7 @@ static int _sg_io_open(char *err_msg, const char *disk_path, int *fd,
     assert(disk_path != NULL);
     assert(fd != NULL);
 
-    *fd = open(disk_path, oflag);
+    *fd = _fs_open(disk_path, oflag);
     if (*fd < 0) {
         switch (errno) {
         case ENOENT:
@@ -902,7 +918,7 @@ int _sg_io_recv_diag(char *err_msg, int fd, uint8_t page_code, uint8_t *data) {
     uint8_t cdb[_T10_SPC_RECV_DIAG_CMD_LEN];
     int ioctl_errno = 0;
     char strerr_buff[_LSM_ERR_MSG_LEN];
-    uint8_t sense_data[_T10_SPC_SENSE_DATA_MAX_LENGTH];
+    uint8_t sense_data[_SG_T10_SPC_SENSE_DATA_MAX_LEN];
     uint8_t sense_key = _T10_SPC_SENSE_KEY_NO_SENSE;
     char sense_err_msg[_LSM_ERR_MSG_LEN / 2];
 
@@ -957,7 +973,7 @@ int _sg_io_send_diag(char *err_msg, int fd, uint8_t *data, uint16_t data_len) {
     uint8_t cdb[_T10_SPC_SEND_DIAG_CMD_LEN];
     int ioctl_errno = 0;
     char strerr_buff[_LSM_ERR_MSG_LEN];
-    uint8_t sense_data[_T10_SPC_SENSE_DATA_MAX_LENGTH];
+    uint8_t sense_data[_SG_T10_SPC_SENSE_DATA_MAX_LEN];
     uint8_t sense_key = _T10_SPC_SENSE_KEY_NO_SENSE;
     char sense_err_msg[_LSM_ERR_MSG_LEN / 2];
 
@@ -1059,7 +1075,7 @@ int _sg_io_mode_sense(char *err_msg, int fd, uint8_t page_code,
     int rc = LSM_ERR_OK;
     uint8_t tmp_data[_SG_T10_SPC_MODE_SENSE_MAX_LEN];
     uint8_t cdb[_T10_SPC_MODE_SENSE_CMD_LEN];
-    uint8_t sense_data[_T10_SPC_SENSE_DATA_MAX_LENGTH];
+    uint8_t sense_data[_SG_T10_SPC_SENSE_DATA_MAX_LEN];
     int ioctl_errno = 0;
     char strerr_buff[_LSM_ERR_MSG_LEN];
     uint8_t sense_key = _T10_SPC_SENSE_KEY_NO_SENSE;
@@ -1241,7 +1257,7 @@ static int _sg_log_sense(char *err_msg, int fd, uint8_t page_code,
     int rc = LSM_ERR_OK;
     uint8_t tmp_data[_T10_SPC_LOG_SENSE_MAX_LEN];
     uint8_t cdb[_T10_SPC_LOG_SENSE_CMD_LEN];
-    uint8_t sense_data[_T10_SPC_SENSE_DATA_MAX_LENGTH];
+    uint8_t sense_data[_SG_T10_SPC_SENSE_DATA_MAX_LEN];
     int ioctl_errno = 0;
     char strerr_buff[_LSM_ERR_MSG_LEN];
     uint8_t sense_key = _T10_SPC_SENSE_KEY_NO_SENSE;
@@ -1308,7 +1324,7 @@ int _sg_request_sense(char *err_msg, int fd, uint8_t *returned_sense_data) {
     int rc = LSM_ERR_OK;
     uint8_t request_sense[_T10_SPC_REQUEST_SENSE_MAX_LEN];
     uint8_t cdb[_T10_SPC_REQUEST_SENSE_CMD_LEN];
-    uint8_t sense_data[_T10_SPC_SENSE_DATA_MAX_LENGTH];
+    uint8_t sense_data[_SG_T10_SPC_SENSE_DATA_MAX_LEN];
     int ioctl_errno = 0;
     uint8_t sense_key = _T10_SPC_SENSE_KEY_NO_SENSE;
     char sense_err_msg[_LSM_ERR_MSG_LEN / 2];
@@ -1347,7 +1363,7 @@ int _sg_request_sense(char *err_msg, int fd, uint8_t *returned_sense_data) {
         goto out;
     }
 
-    memcpy(returned_sense_data, sense_data, _T10_SPC_SENSE_DATA_MAX_LENGTH);
+    memcpy(returned_sense_data, sense_data, _SG_T10_SPC_SENSE_DATA_MAX_LEN);
 
 out:
 
@@ -1380,7 +1396,7 @@ int _sg_sas_health_status(char *err_msg, int fd, int32_t *health_status) {
     uint8_t info_excep_mode_page[_SG_T10_SPC_MODE_SENSE_MAX_LEN];
     uint8_t info_excep_log_page[_T10_SPC_LOG_SENSE_MAX_LEN];
     uint8_t asc = 0;
-    uint8_t requested_sense[_T10_SPC_SENSE_DATA_MAX_LENGTH];
+    uint8_t requested_sense[_SG_T10_SPC_SENSE_DATA_MAX_LEN];
     struct _sg_t10_sense_fixed *sense_fixed = NULL;
     struct _sg_t10_info_excep_mode_page_0_hdr *ie_mode_hdr = NULL;
     struct _sg_t10_info_excep_general_log_hdr *ie_log_hdr = NULL;
@@ -1423,7 +1439,7 @@ int _sg_ata_health_status(char *err_msg, int fd, int32_t *health_status) {
     int rc = LSM_ERR_OK;
     int ioctl_errno = 0;
     struct _sg_t10_ata_pass_through_12_cdb cdb;
-    uint8_t sense_data[_T10_SPC_SENSE_DATA_MAX_LENGTH];
+    uint8_t sense_data[_SG_T10_SPC_SENSE_DATA_MAX_LEN];
     uint8_t lba_mid = 0;
     uint8_t lba_high = 0;
     uint8_t status = 0;
@@ -1435,7 +1451,7 @@ int _sg_ata_health_status(char *err_msg, int fd, int32_t *health_status) {
      * when needed. Current, they are hard coded for ATA health status only.
      */
     memset(&cdb, 0, sizeof(cdb));
-    memset(sense_data, 0, _T10_SPC_SENSE_DATA_MAX_LENGTH);
+    memset(sense_data, 0, _SG_T10_SPC_SENSE_DATA_MAX_LEN);
 
     cdb.operation_code = _T10_SAT_ATA_PASS_THROUGH_12;
 
@@ -1534,3 +1550,143 @@ out:
 
     return rc;
 }
+
+int _sg_io_result_check(char *err_msg, const char *cmd_name, int result,
+                        uint8_t *sense_data) {
+    int rc = LSM_ERR_OK;
+    char strerr_buff[_LSM_ERR_MSG_LEN];
+    uint8_t sense_key = _T10_SPC_SENSE_KEY_NO_SENSE;
+    char sense_err_msg[_LSM_ERR_MSG_LEN / 2];
+
+    assert(err_msg != NULL);
+    assert(cmd_name != NULL);
+    assert(sense_data != NULL);
+
+    memset(sense_err_msg, 0, sizeof(sense_err_msg));
+
+    if (result == 0)
+        goto out;
+
+    if (result == ETIMEDOUT) {
+        rc = LSM_ERR_TIMEOUT;
+        _lsm_err_msg_set(err_msg, "Timeout on SGIO %s", cmd_name);
+        goto out;
+    }
+
+    /* It might possible we got "NO SENSE" or "RECOVERED ERROR" */
+    if ((_check_sense_data(sense_err_msg, sense_data, &sense_key) == 0) &&
+        (result == -1))
+        goto out;
+
+    rc = LSM_ERR_LIB_BUG;
+    _lsm_err_msg_set(err_msg, "Got error from SGIO %s: error %d(%s), %s",
+                     cmd_name, result,
+                     error_to_str(result, strerr_buff, _LSM_ERR_MSG_LEN),
+                     sense_err_msg);
+
+out:
+    return rc;
+}
+
+static bool _sg_io_engine_run(int fd, uint8_t *cdb, uint8_t cdb_len,
+                              uint8_t *data, ssize_t data_len,
+                              uint8_t *sense_data, int direction,
+                              int *result) {
+    struct _sg_async_cmd cmd;
+    char err_msg[_LSM_ERR_MSG_LEN];
+
+    assert(cdb_len <= _SG_ASYNC_CDB_MAX_LEN);
+
+    /* No lock for the common case of no engine */
+    if (__atomic_load_n(&_sg_io_engine, __ATOMIC_ACQUIRE) == NULL)
+        return false;
+
+    memset(&cmd, 0, sizeof(struct _sg_async_cmd));
+    memset(sense_data, 0, _SG_T10_SPC_SENSE_DATA_MAX_LEN);
+    if ((direction == _SG_IO_RECV_DATA) && (data != NULL))
+        memset(data, 0, (size_t)data_len);
+
+    cmd.fd = fd;
+    memcpy(cmd.cdb, cdb, cdb_len);
+    cmd.cdb_len = cdb_len;
+    cmd.data = data;
+    cmd.data_len = data == NULL ? 0 : (uint32_t)data_len;
+    cmd.direction = direction;
+
+    pthread_mutex_lock(&_sg_io_engine_lock);
+    if (_sg_io_engine == NULL) {
+        pthread_mutex_unlock(&_sg_io_engine_lock);
+        return false;
+    }
+    _sg_async_submit(_sg_io_engine, &cmd);
+    if (_sg_async_run(err_msg, _sg_io_engine) != LSM_ERR_OK)
+        cmd.result = EIO;
+    pthread_mutex_unlock(&_sg_io_engine_lock);
+
+    *result = cmd.result;
+    if (cmd.result == -1)
+        memcpy(sense_data, cmd.sense_data, _SG_T10_SPC_SENSE_DATA_MAX_LEN);
+    else if ((cmd.result != 0) && (data != NULL))
+        memset(data, 0, (size_t)data_len);
+    return true;
+}
+
+int _sg_io_backend_set(char *err_msg, const struct _sg_async_backend *backend,
+                       void *priv) {
+    int rc = LSM_ERR_OK;
+    struct _sg_async *engine = NULL;
+
+    assert(err_msg != NULL);
+
+    if (backend != NULL)
+        _good(_sg_async_new_with_backend(err_msg, 0, backend, priv, &engine),
+              rc, out);
+
+    pthread_mutex_lock(&_sg_io_engine_lock);
+    _sg_async_free(_sg_io_engine);
+    __atomic_store_n(&_sg_io_engine, engine, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&_sg_io_engine_lock);
+
+out:
+    return rc;
+}
+
+void _sg_io_vpd_cmd_init(struct _sg_async_cmd *cmd, int fd,
+                         uint8_t page_code, uint8_t *data) {
+    assert(cmd != NULL);
+    assert(fd >= 0);
+    assert(data != NULL);
+
+    memset(cmd, 0, sizeof(struct _sg_async_cmd));
+    cmd->fd = fd;
+    cmd->cdb_len = _T10_SPC_INQUIRY_CMD_LEN;
+    cmd->data_len = (uint32_t)_sg_vpd_cdb_init(cmd->cdb, page_code);
+    cmd->data = data;
+    cmd->direction = _SG_IO_RECV_DATA;
+}
+
+int _sg_io_batch_begin(char *err_msg, struct _sg_async **engine,
+                       bool *shared) {
+    assert(err_msg != NULL);
+    assert(engine != NULL);
+    assert(shared != NULL);
+
+    pthread_mutex_lock(&_sg_io_engine_lock);
+    if (_sg_io_engine != NULL) {
+        /* Unlocked by _sg_io_batch_end() */
+        *engine = _sg_io_engine;
+        *shared = true;
+        return LSM_ERR_OK;
+    }
+    pthread_mutex_unlock(&_sg_io_engine_lock);
+
+    *shared = false;
+    return _sg_async_new(err_msg, 0, engine);
+}
+
+void _sg_io_batch_end(struct _sg_async *engine, bool shared) {
+    if (shared)
+        pthread_mutex_unlock(&_sg_io_engine_lock);
+    else
+        _sg_async_free(engine);
+}
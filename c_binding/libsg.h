@@ -49,6 +49,8 @@
 
 /* SBC-4 rev9 Table 236 - Block Device Characteristics VPD page */
 #define _SG_T10_SBC_VPD_BLK_DEV_CHA 0xb1
+/* SBC-4 rev 14 Table 261 - Block Device Characteristics VPD page */
+#define _SG_T10_SBC_VPD_BLK_DEV_CHA_MAX_LEN 64
 /* SBC-4 rev9 Table 237 - MEDIUM ROTATION RATE field */
 #define _SG_T10_SBC_MEDIUM_ROTATION_NO_SUPPORT 0
 /* SBC-4 rev9 Table 237 - MEDIUM ROTATION RATE field */
@@ -86,6 +88,23 @@
 #define _T10_SPC_REQUEST_SENSE_MAX_LEN 0xff
 /* ^ SPC-5 rev07 6.35 REQUEST SENSE command */
 
+/* SPC-5 rev 07 4.4.2.1 Descriptor format sense data overview
+ * Quote:
+ * The ADDITIONAL SENSE LENGTH field indicates the number of additional sense
+ * bytes that follow. The additional sense length shall be less than or equal to
+ * 244 (i.e., limiting the total length of the sense data to 252 bytes).
+ */
+#define _SG_T10_SPC_SENSE_DATA_MAX_LEN 252
+
+/* SGIO timeout: 1 second
+ * TODO(Gris Ge): Raise LSM_ERR_TIMEOUT error for this
+ */
+#define _SG_IO_TMO 1000
+
+#define _SG_IO_NO_DATA   0
+#define _SG_IO_SEND_DATA 1
+#define _SG_IO_RECV_DATA 2
+
 #pragma pack(push, 1)
 
 /*
@@ -268,4 +287,64 @@ LSM_DLL_LOCAL int _sg_io_mode_sense(char *err_msg, int fd, uint8_t page_code,
  */
 LSM_DLL_LOCAL int _sg_host_no(char *err_msg, int fd, unsigned int *host_no);
 
+/*
+ * Convert the result of a SCSI command issued through _sg_async_run() into
+ * lsm_error_number, with error message mentioning 'cmd_name'.
+ * A timed out command gives LSM_ERR_TIMEOUT.
+ * Preconditions:
+ *  err_msg != NULL
+ *  cmd_name != NULL
+ *  sense_data is uint8_t[_SG_T10_SPC_SENSE_DATA_MAX_LEN]
+ */
+LSM_DLL_LOCAL int _sg_io_result_check(char *err_msg, const char *cmd_name,
+                                      int result, uint8_t *sense_data);
+
+struct _sg_async;
+struct _sg_async_backend;
+struct _sg_async_cmd;
+
+/*
+ * Send every SCSI command of this file through given backend of
+ * libsg_async.h instead of the SG_IO ioctl, one at a time, and hand that
+ * engine to _sg_io_batch_begin().  Tests and benchmarks use it with the
+ * fake backend of libsg_fake.h.
+ * The backend->free() is invoked on 'priv' when replaced or when NULL
+ * 'backend' restores the ioctl.
+ * Not thread safe, should be invoked before any local disk query.
+ * Preconditions:
+ *  err_msg != NULL
+ */
+LSM_DLL_LOCAL int _sg_io_backend_set(char *err_msg,
+                                     const struct _sg_async_backend *backend,
+                                     void *priv);
+
+/*
+ * Fill 'cmd' of libsg_async.h with INQUIRY of given VPD page.  Same as
+ * _sg_io_vpd(), a failure of the command does not tell whether the page is
+ * supported, check the Supported VPD Pages page for that.
+ * Preconditions:
+ *  cmd != NULL
+ *  fd >= 0
+ *  data is uint8_t[_SG_T10_SBC_VPD_BLK_DEV_CHA_MAX_LEN] for
+ *  _SG_T10_SBC_VPD_BLK_DEV_CHA, uint8_t[_SG_T10_SPC_VPD_MAX_LEN] otherwise.
+ */
+LSM_DLL_LOCAL void _sg_io_vpd_cmd_init(struct _sg_async_cmd *cmd, int fd,
+                                       uint8_t page_code, uint8_t *data);
+
+/*
+ * Get an engine of libsg_async.h for a batch of commands: the one set by
+ * _sg_io_backend_set(), or else a new one with the native backend.
+ * Should be paired with _sg_io_batch_end().  The blocking SG_IO functions
+ * of this file should not be used in between by the same thread, including
+ * from 'done' callbacks of the commands.
+ * Preconditions:
+ *  err_msg != NULL
+ *  engine != NULL
+ *  shared != NULL
+ */
+LSM_DLL_LOCAL int _sg_io_batch_begin(char *err_msg, struct _sg_async **engine,
+                                     bool *shared);
+
+LSM_DLL_LOCAL void _sg_io_batch_end(struct _sg_async *engine, bool shared);
+
 #endif /* End of _LIBSG_H_ */
@@ -0,0 +1,776 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "libsg_async.h"
+#include "libsg.h"
+#include "utils.h"
+
+#include "libstoragemgmt/libstoragemgmt_error.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/major.h>
+#include <poll.h>
+#include <pthread.h>
+#include <scsi/sg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Maximum worker threads of native backend for blocking SG_IO */
+#define _SG_NATIVE_WORKER_MAX 32
+
+/* DID_TIME_OUT of host_status in linux kernel include/scsi/scsi_status.h */
+#define _SG_HOST_STATUS_TIME_OUT 0x03
+
+struct _sg_async {
+    const struct _sg_async_backend *backend;
+    void *priv;
+    uint32_t max_in_flight;
+    uint32_t in_flight_count;
+    struct _sg_async_cmd *in_flight;
+    struct _sg_async_cmd *queue_head;
+    struct _sg_async_cmd *queue_tail;
+    bool freeing;
+};
+
+/*
+ * Command written to a sg device, until read back. Holds its own data and
+ * sense buffers as sg driver copies them out in read(), which might happen
+ * after the command was abandoned.
+ */
+struct _sg_native_req {
+    struct sg_io_hdr hdr;
+    struct _sg_async_cmd *cmd;
+    /* ^ NULL once abandoned */
+    int fd;
+    uint8_t *bounce;
+    uint8_t sense_data[_SG_T10_SPC_SENSE_DATA_MAX_LEN];
+    struct _sg_native_req *next;
+};
+
+struct _sg_native {
+    struct _sg_native_req *reqs;
+    uint32_t req_count;
+
+    /* Commands running blocking SG_IO in worker threads */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_t workers[_SG_NATIVE_WORKER_MAX];
+    uint32_t worker_count;
+    uint32_t worker_max;
+    uint32_t worker_busy;
+    struct _sg_async_cmd *todo_head;
+    struct _sg_async_cmd *todo_tail;
+    struct _sg_async_cmd *done;
+    /* Workers write to wake_fds[1] when a command is done */
+    int wake_fds[2];
+    bool stop;
+};
+
+static uint64_t _now_ms(void);
+
+/*
+ * Invoke 'done' of command which is no longer in flight.
+ */
+static void _sg_async_finish(struct _sg_async *engine,
+                             struct _sg_async_cmd *cmd, int result);
+
+/*
+ * Hand queued commands to backend until 'max_in_flight' is reached.
+ */
+static void _sg_async_fill(struct _sg_async *engine);
+
+/*
+ * Abandon commands passed their deadline.
+ */
+static void _sg_async_expire(struct _sg_async *engine, uint64_t now);
+
+static int _sg_native_submit(void *priv, struct _sg_async_cmd *cmd);
+static int _sg_native_reap(void *priv, struct _sg_async *engine,
+                           int timeout_ms);
+static bool _sg_native_abandon(void *priv, struct _sg_async_cmd *cmd);
+static void _sg_native_free(void *priv);
+
+static const struct _sg_async_backend _sg_native_backend = {
+    _sg_native_submit,
+    _sg_native_reap,
+    _sg_native_abandon,
+    _sg_native_free,
+};
+
+/*
+ * Same as _sg_io_v3() of libsg.c except the timeout and buffers.
+ */
+static void _sg_native_hdr_init(struct sg_io_hdr *hdr,
+                                struct _sg_async_cmd *cmd, uint8_t *data,
+                                uint8_t *sense_data);
+
+/*
+ * Convert SG_IO result to _sg_async_cmd.result.
+ */
+static int _sg_native_result(struct sg_io_hdr *hdr, int ioctl_errno);
+
+static bool _sg_native_is_sg(int fd);
+
+/*
+ * Write the command to sg device using asynchronous sg v3 interface.
+ * Return 0 or errno.
+ */
+static int _sg_native_sg_write(struct _sg_native *native,
+                               struct _sg_async_cmd *cmd);
+
+/*
+ * Read one completed command from sg device.
+ */
+static void _sg_native_sg_read(struct _sg_native *native,
+                               struct _sg_async *engine, int fd);
+
+/*
+ * Complete all commands of given sg device with 'result', used when the
+ * device is gone.
+ */
+static void _sg_native_sg_fail(struct _sg_native *native,
+                               struct _sg_async *engine, int fd, int result);
+
+/*
+ * Queue command to worker threads, start new worker if needed.
+ * Return 0 or errno.
+ */
+static int _sg_native_worker_queue(struct _sg_native *native,
+                                   struct _sg_async_cmd *cmd);
+
+static void *_sg_native_worker(void *arg);
+
+static uint64_t _now_ms(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int _sg_async_new(char *err_msg, uint32_t max_in_flight,
+                  struct _sg_async **engine) {
+    int rc = LSM_ERR_OK;
+    struct _sg_native *native = NULL;
+    char strerr_buff[_LSM_ERR_MSG_LEN];
+
+    assert(err_msg != NULL);
+    assert(engine != NULL);
+
+    *engine = NULL;
+
+    if (max_in_flight == 0)
+        max_in_flight = _SG_ASYNC_DEFAULT_IN_FLIGHT;
+
+    native = (struct _sg_native *)calloc(1, sizeof(struct _sg_native));
+    _alloc_null_check(err_msg, native, rc, out);
+    native->wake_fds[0] = -1;
+    native->wake_fds[1] = -1;
+    native->worker_max = max_in_flight < _SG_NATIVE_WORKER_MAX
+                             ? max_in_flight
+                             : _SG_NATIVE_WORKER_MAX;
+
+    pthread_mutex_init(&native->lock, NULL);
+    pthread_cond_init(&native->cond, NULL);
+
+    if ((pipe(native->wake_fds) != 0) ||
+        (fcntl(native->wake_fds[0], F_SETFL, O_NONBLOCK) != 0) ||
+        (fcntl(native->wake_fds[1], F_SETFL, O_NONBLOCK) != 0)) {
+        rc = LSM_ERR_LIB_BUG;
+        _lsm_err_msg_set(err_msg, "Failed to create pipe: error %d(%s)",
+                         errno,
+                         error_to_str(errno, strerr_buff, _LSM_ERR_MSG_LEN));
+        goto out;
+    }
+
+    rc = _sg_async_new_with_backend(err_msg, max_in_flight,
+                                    &_sg_native_backend, native, engine);
+    if (rc == LSM_ERR_OK)
+        native = NULL;
+
+out:
+    if (native != NULL)
+        _sg_native_free(native);
+    return rc;
+}
+
+int _sg_async_new_with_backend(char *err_msg, uint32_t max_in_flight,
+                               const struct _sg_async_backend *backend,
+                               void *priv, struct _sg_async **engine) {
+    int rc = LSM_ERR_OK;
+
+    assert(err_msg != NULL);
+    assert(backend != NULL);
+    assert(engine != NULL);
+
+    *engine = (struct _sg_async *)calloc(1, sizeof(struct _sg_async));
+    _alloc_null_check(err_msg, *engine, rc, out);
+
+    (*engine)->backend = backend;
+    (*engine)->priv = priv;
+    (*engine)->max_in_flight =
+        max_in_flight == 0 ? _SG_ASYNC_DEFAULT_IN_FLIGHT : max_in_flight;
+
+out:
+    return rc;
+}
+
+void _sg_async_free(struct _sg_async *engine) {
+    struct _sg_async_cmd **pp = NULL;
+    struct _sg_async_cmd *cmd = NULL;
+
+    if (engine == NULL)
+        return;
+
+    engine->freeing = true;
+    engine->queue_head = NULL;
+    engine->queue_tail = NULL;
+
+    pp = &engine->in_flight;
+    while (*pp != NULL) {
+        cmd = *pp;
+        if (engine->backend->abandon(engine->priv, cmd)) {
+            *pp = cmd->next;
+            engine->in_flight_count--;
+        } else {
+            pp = &cmd->next;
+        }
+    }
+
+    /* The commands could not be abandoned will complete by their timeout.
+     * Leak the backend instead of hanging if it fails.
+     */
+    while (engine->in_flight != NULL) {
+        if (engine->backend->reap(engine->priv, engine, -1) != 0) {
+            free(engine);
+            return;
+        }
+    }
+
+    engine->backend->free(engine->priv);
+    free(engine);
+}
+
+void _sg_async_submit(struct _sg_async *engine, struct _sg_async_cmd *cmd) {
+    assert(engine != NULL);
+    assert(cmd != NULL);
+    assert(cmd->cdb_len > 0 && cmd->cdb_len <= _SG_ASYNC_CDB_MAX_LEN);
+
+    cmd->next = NULL;
+    cmd->backend_data = NULL;
+    cmd->result = 0;
+    memset(cmd->sense_data, 0, _SG_T10_SPC_SENSE_DATA_MAX_LEN);
+
+    if (engine->freeing)
+        return;
+
+    if (engine->queue_tail == NULL)
+        engine->queue_head = cmd;
+    else
+        engine->queue_tail->next = cmd;
+    engine->queue_tail = cmd;
+}
+
+static void _sg_async_finish(struct _sg_async *engine,
+                             struct _sg_async_cmd *cmd, int result) {
+    cmd->result = result;
+    cmd->next = NULL;
+    if ((cmd->done != NULL) && (engine->freeing == false))
+        cmd->done(cmd, cmd->user_data);
+}
+
+void _sg_async_complete(struct _sg_async *engine, struct _sg_async_cmd *cmd,
+                        int result) {
+    struct _sg_async_cmd **pp = NULL;
+
+    assert(engine != NULL);
+    assert(cmd != NULL);
+
+    for (pp = &engine->in_flight; *pp != NULL; pp = &(*pp)->next) {
+        if (*pp == cmd) {
+            *pp = cmd->next;
+            engine->in_flight_count--;
+            _sg_async_finish(engine, cmd, result);
+            return;
+        }
+    }
+    /* Backend should not report command not in flight */
+    assert(false);
+}
+
+static void _sg_async_fill(struct _sg_async *engine) {
+    struct _sg_async_cmd *cmd = NULL;
+    uint32_t timeout_ms = 0;
+    int result = 0;
+
+    while ((engine->queue_head != NULL) &&
+           (engine->in_flight_count < engine->max_in_flight)) {
+        cmd = engine->queue_head;
+        engine->queue_head = cmd->next;
+        if (engine->queue_head == NULL)
+            engine->queue_tail = NULL;
+
+        timeout_ms = cmd->timeout_ms == 0 ? _SG_IO_TMO : cmd->timeout_ms;
+        /* _now_ms() is truncated, round up so it never expires early */
+        cmd->deadline_ms = _now_ms() + timeout_ms + 1;
+        cmd->next = NULL;
+
+        result = engine->backend->submit(engine->priv, cmd);
+        if (result != 0) {
+            _sg_async_finish(engine, cmd, result);
+            continue;
+        }
+        cmd->next = engine->in_flight;
+        engine->in_flight = cmd;
+        engine->in_flight_count++;
+    }
+}
+
+static void _sg_async_expire(struct _sg_async *engine, uint64_t now) {
+    struct _sg_async_cmd **pp = &engine->in_flight;
+    struct _sg_async_cmd *cmd = NULL;
+
+    while (*pp != NULL) {
+        cmd = *pp;
+        if (cmd->deadline_ms > now) {
+            pp = &cmd->next;
+            continue;
+        }
+        if (!engine->backend->abandon(engine->priv, cmd)) {
+            /* Wait for it to complete on its own */
+            cmd->deadline_ms = UINT64_MAX;
+            pp = &cmd->next;
+            continue;
+        }
+        *pp = cmd->next;
+        engine->in_flight_count--;
+        _sg_async_finish(engine, cmd, ETIMEDOUT);
+    }
+}
+
+int _sg_async_run(char *err_msg, struct _sg_async *engine) {
+    int rc = LSM_ERR_OK;
+    int reap_errno = 0;
+    struct _sg_async_cmd *cmd = NULL;
+    uint64_t now = 0;
+    uint64_t next_deadline = 0;
+    int wait_ms = 0;
+    char strerr_buff[_LSM_ERR_MSG_LEN];
+
+    assert(err_msg != NULL);
+    assert(engine != NULL);
+
+    while ((engine->queue_head != NULL) || (engine->in_flight != NULL)) {
+        _sg_async_fill(engine);
+        if (engine->in_flight == NULL)
+            continue;
+
+        next_deadline = UINT64_MAX;
+        for (cmd = engine->in_flight; cmd != NULL; cmd = cmd->next) {
+            if (cmd->deadline_ms < next_deadline)
+                next_deadline = cmd->deadline_ms;
+        }
+        now = _now_ms();
+        if (next_deadline == UINT64_MAX)
+            wait_ms = -1;
+        else if (next_deadline <= now)
+            wait_ms = 0;
+        else if (next_deadline - now > INT_MAX)
+            wait_ms = INT_MAX;
+        else
+            wait_ms = (int)(next_deadline - now);
+
+        reap_errno = engine->backend->reap(engine->priv, engine, wait_ms);
+        if (reap_errno != 0) {
+            rc = LSM_ERR_LIB_BUG;
+            _lsm_err_msg_set(
+                err_msg, "Failed to wait SCSI commands: error %d(%s)",
+                reap_errno,
+                error_to_str(reap_errno, strerr_buff, _LSM_ERR_MSG_LEN));
+            goto out;
+        }
+        _sg_async_expire(engine, _now_ms());
+    }
+
+out:
+    return rc;
+}
+
+static void _sg_native_hdr_init(struct sg_io_hdr *hdr,
+                                struct _sg_async_cmd *cmd, uint8_t *data,
+                                uint8_t *sense_data) {
+    memset(hdr, 0, sizeof(struct sg_io_hdr));
+    memset(sense_data, 0, _SG_T10_SPC_SENSE_DATA_MAX_LEN);
+    if ((cmd->direction == _SG_IO_RECV_DATA) && (data != NULL))
+        memset(data, 0, cmd->data_len);
+
+    hdr->interface_id = 'S'; /* 'S' for SCSI generic */
+    hdr->cmdp = cmd->cdb;
+    hdr->cmd_len = cmd->cdb_len;
+    hdr->sbp = sense_data;
+    hdr->mx_sb_len = _SG_T10_SPC_SENSE_DATA_MAX_LEN;
+    if (cmd->direction == _SG_IO_RECV_DATA)
+        hdr->dxfer_direction = SG_DXFER_FROM_DEV;
+    else if (cmd->direction == _SG_IO_SEND_DATA)
+        hdr->dxfer_direction = SG_DXFER_TO_DEV;
+    else
+        hdr->dxfer_direction = SG_DXFER_NONE;
+
+    if (data != NULL)
+        hdr->dxferp = data;
+    hdr->dxfer_len = cmd->data_len;
+    hdr->timeout = cmd->timeout_ms == 0 ? _SG_IO_TMO : cmd->timeout_ms;
+}
+
+static int _sg_native_result(struct sg_io_hdr *hdr, int ioctl_errno) {
+    if (hdr->sb_len_wr != 0)
+        /* It might possible we got "NO SENSE" */
+        return -1;
+    if (ioctl_errno != 0)
+        return ioctl_errno;
+    if (hdr->host_status == _SG_HOST_STATUS_TIME_OUT)
+        return ETIMEDOUT;
+    if ((hdr->info & SG_INFO_OK_MASK) != SG_INFO_OK)
+        return EIO;
+    return 0;
+}
+
+static bool _sg_native_is_sg(int fd) {
+    struct stat st;
+
+    if (fstat(fd, &st) != 0)
+        return false;
+    return S_ISCHR(st.st_mode) && (major(st.st_rdev) == SCSI_GENERIC_MAJOR);
+}
+
+static int _sg_native_submit(void *priv, struct _sg_async_cmd *cmd) {
+    struct _sg_native *native = (struct _sg_native *)priv;
+    int rc = 0;
+
+    if (_sg_native_is_sg(cmd->fd)) {
+        rc = _sg_native_sg_write(native, cmd);
+        /* EDOM means the sg device has too many commands queued, let a
+         * worker wait for it instead.
+         */
+        if ((rc != EDOM) && (rc != EAGAIN))
+            return rc;
+    }
+    return _sg_native_worker_queue(native, cmd);
+}
+
+static int _sg_native_sg_write(struct _sg_native *native,
+                               struct _sg_async_cmd *cmd) {
+    struct _sg_native_req *req = NULL;
+    int rc = 0;
+
+    req = (struct _sg_native_req *)calloc(1, sizeof(struct _sg_native_req));
+    if (req == NULL)
+        return ENOMEM;
+
+    if ((cmd->data_len > 0) && (cmd->data != NULL)) {
+        req->bounce = (uint8_t *)malloc(cmd->data_len);
+        if (req->bounce == NULL) {
+            free(req);
+            return ENOMEM;
+        }
+        if (cmd->direction == _SG_IO_SEND_DATA)
+            memcpy(req->bounce, cmd->data, cmd->data_len);
+    }
+
+    _sg_native_hdr_init(&req->hdr, cmd, req->bounce, req->sense_data);
+    req->hdr.usr_ptr = req;
+
+    if (write(cmd->fd, &req->hdr, sizeof(struct sg_io_hdr)) < 0) {
+        rc = errno;
+        free(req->bounce);
+        free(req);
+        return rc;
+    }
+
+    req->cmd = cmd;
+    req->fd = cmd->fd;
+    req->next = native->reqs;
+    native->reqs = req;
+    native->req_count++;
+    cmd->backend_data = req;
+    return 0;
+}
+
+static void _sg_native_req_free(struct _sg_native *native,
+                                struct _sg_native_req *req) {
+    struct _sg_native_req **pp = NULL;
+
+    for (pp = &native->reqs; *pp != NULL; pp = &(*pp)->next) {
+        if (*pp == req) {
+            *pp = req->next;
+            native->req_count--;
+            break;
+        }
+    }
+    free(req->bounce);
+    free(req);
+}
+
+static void _sg_native_sg_read(struct _sg_native *native,
+                               struct _sg_async *engine, int fd) {
+    struct sg_io_hdr hdr;
+    struct _sg_native_req *req = NULL;
+    struct _sg_async_cmd *cmd = NULL;
+    int result = 0;
+
+    memset(&hdr, 0, sizeof(struct sg_io_hdr));
+    hdr.interface_id = 'S';
+
+    if (read(fd, &hdr, sizeof(struct sg_io_hdr)) < 0) {
+        if ((errno != EAGAIN) && (errno != EINTR))
+            _sg_native_sg_fail(native, engine, fd, errno);
+        return;
+    }
+
+    for (req = native->reqs; req != NULL; req = req->next) {
+        if (req == hdr.usr_ptr)
+            break;
+    }
+    if (req == NULL)
+        return;
+
+    cmd = req->cmd;
+    if (cmd != NULL) {
+        result = _sg_native_result(&hdr, 0);
+        if ((cmd->direction == _SG_IO_RECV_DATA) && (req->bounce != NULL))
+            memcpy(cmd->data, req->bounce, cmd->data_len);
+        memcpy(cmd->sense_data, req->sense_data,
+               _SG_T10_SPC_SENSE_DATA_MAX_LEN);
+        cmd->backend_data = NULL;
+    }
+    _sg_native_req_free(native, req);
+    if (cmd != NULL)
+        _sg_async_complete(engine, cmd, result);
+}
+
+static void _sg_native_sg_fail(struct _sg_native *native,
+                               struct _sg_async *engine, int fd, int result) {
+    struct _sg_native_req *req = NULL;
+    struct _sg_async_cmd *cmd = NULL;
+    bool found = true;
+
+    while (found) {
+        found = false;
+        for (req = native->reqs; req != NULL; req = req->next) {
+            if (req->fd == fd) {
+                found = true;
+                break;
+            }
+        }
+        if (found) {
+            cmd = req->cmd;
+            _sg_native_req_free(native, req);
+            if (cmd != NULL) {
+                cmd->backend_data = NULL;
+                _sg_async_complete(engine, cmd, result);
+            }
+        }
+    }
+}
+
+static int _sg_native_worker_queue(struct _sg_native *native,
+                                   struct _sg_async_cmd *cmd) {
+    int rc = 0;
+
+    cmd->backend_data = NULL;
+    cmd->next = NULL;
+
+    pthread_mutex_lock(&native->lock);
+    if ((native->worker_count <= native->worker_busy) &&
+        (native->worker_count < native->worker_max)) {
+        rc = pthread_create(&native->workers[native->worker_count], NULL,
+                            _sg_native_worker, native);
+        if (rc == 0)
+            native->worker_count++;
+        else if (native->worker_count > 0)
+            /* Existing workers will get to it */
+            rc = 0;
+    }
+    if (rc == 0) {
+        if (native->todo_tail == NULL)
+            native->todo_head = cmd;
+        else
+            native->todo_tail->next = cmd;
+        native->todo_tail = cmd;
+        native->worker_busy++;
+        pthread_cond_signal(&native->cond);
+    }
+    pthread_mutex_unlock(&native->lock);
+    return rc;
+}
+
+static void *_sg_native_worker(void *arg) {
+    struct _sg_native *native = (struct _sg_native *)arg;
+    struct _sg_async_cmd *cmd = NULL;
+    struct sg_io_hdr hdr;
+    int ioctl_errno = 0;
+
+    pthread_mutex_lock(&native->lock);
+    while (true) {
+        while ((native->stop == false) && (native->todo_head == NULL))
+            pthread_cond_wait(&native->cond, &native->lock);
+        if (native->todo_head == NULL)
+            break;
+
+        cmd = native->todo_head;
+        native->todo_head = cmd->next;
+        if (native->todo_head == NULL)
+            native->todo_tail = NULL;
+        pthread_mutex_unlock(&native->lock);
+
+        _sg_native_hdr_init(&hdr, cmd, cmd->data, cmd->sense_data);
+        ioctl_errno = 0;
+        if (ioctl(cmd->fd, SG_IO, &hdr) != 0)
+            ioctl_errno = errno;
+        cmd->result = _sg_native_result(&hdr, ioctl_errno);
+
+        pthread_mutex_lock(&native->lock);
+        cmd->next = native->done;
+        native->done = cmd;
+        /* Pipe full means a wake up is pending already */
+        if (write(native->wake_fds[1], "", 1) < 0) {
+        }
+    }
+    pthread_mutex_unlock(&native->lock);
+    return NULL;
+}
+
+static int _sg_native_reap(void *priv, struct _sg_async *engine,
+                           int timeout_ms) {
+    struct _sg_native *native = (struct _sg_native *)priv;
+    struct pollfd *fds = NULL;
+    nfds_t fd_count = 1;
+    nfds_t i = 0;
+    struct _sg_native_req *req = NULL;
+    struct _sg_async_cmd *done = NULL;
+    struct _sg_async_cmd *cmd = NULL;
+    char drain[64];
+    int rc = 0;
+
+    fds = (struct pollfd *)calloc(native->req_count + 1,
+                                  sizeof(struct pollfd));
+    if (fds == NULL)
+        return ENOMEM;
+
+    fds[0].fd = native->wake_fds[0];
+    fds[0].events = POLLIN;
+    for (req = native->reqs; req != NULL; req = req->next) {
+        for (i = 1; i < fd_count; ++i) {
+            if (fds[i].fd == req->fd)
+                break;
+        }
+        if (i == fd_count) {
+            fds[fd_count].fd = req->fd;
+            fds[fd_count].events = POLLIN;
+            fd_count++;
+        }
+    }
+
+    if (poll(fds, fd_count, timeout_ms) < 0) {
+        if (errno != EINTR)
+            rc = errno;
+        goto out;
+    }
+
+    if (fds[0].revents != 0) {
+        while (read(native->wake_fds[0], drain, sizeof(drain)) > 0) {
+        }
+        pthread_mutex_lock(&native->lock);
+        done = native->done;
+        native->done = NULL;
+        pthread_mutex_unlock(&native->lock);
+        while (done != NULL) {
+            cmd = done;
+            done = cmd->next;
+            pthread_mutex_lock(&native->lock);
+            native->worker_busy--;
+            pthread_mutex_unlock(&native->lock);
+            _sg_async_complete(engine, cmd, cmd->result);
+        }
+    }
+
+    for (i = 1; i < fd_count; ++i) {
+        if (fds[i].revents & POLLIN)
+            _sg_native_sg_read(native, engine, fds[i].fd);
+        else if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+            _sg_native_sg_fail(native, engine, fds[i].fd, EIO);
+    }
+
+out:
+    free(fds);
+    return rc;
+}
+
+static bool _sg_native_abandon(void *priv, struct _sg_async_cmd *cmd) {
+    struct _sg_native_req *req = (struct _sg_native_req *)cmd->backend_data;
+
+    (void)priv;
+
+    /* Blocking SG_IO in worker thread cannot be stopped, it is aborted by
+     * kernel at the same timeout anyway.
+     */
+    if (req == NULL)
+        return false;
+
+    /* Read back and dropped later by _sg_native_sg_read() */
+    req->cmd = NULL;
+    cmd->backend_data = NULL;
+    return true;
+}
+
+static void _sg_native_free(void *priv) {
+    struct _sg_native *native = (struct _sg_native *)priv;
+    struct _sg_native_req *req = NULL;
+    uint32_t i = 0;
+
+    pthread_mutex_lock(&native->lock);
+    native->stop = true;
+    pthread_cond_broadcast(&native->cond);
+    pthread_mutex_unlock(&native->lock);
+
+    for (i = 0; i < native->worker_count; ++i)
+        pthread_join(native->workers[i], NULL);
+
+    while (native->reqs != NULL) {
+        req = native->reqs;
+        native->reqs = req->next;
+        free(req->bounce);
+        free(req);
+    }
+
+    if (native->wake_fds[0] >= 0)
+        close(native->wake_fds[0]);
+    if (native->wake_fds[1] >= 0)
+        close(native->wake_fds[1]);
+    pthread_cond_destroy(&native->cond);
+    pthread_mutex_destroy(&native->lock);
+    free(native);
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Asynchronous SCSI command engine.
+ *
+ * Keeps up to 'max_in_flight' SCSI commands running at the same time, across
+ * any number of devices, each with its own timeout:
+ *
+ *      struct _sg_async *engine = NULL;
+ *
+ *      _good(_sg_async_new(err_msg, 0, &engine), rc, out);
+ *      for (i = 0; i < count; ++i) {
+ *          ... fill cmds[i] ...
+ *          _sg_async_submit(engine, &cmds[i]);
+ *      }
+ *      _good(_sg_async_run(err_msg, engine), rc, out);
+ *      for (i = 0; i < count; ++i)
+ *          rc = _sg_io_result_check(err_msg, "INQUIRY", cmds[i].result,
+ *                                   cmds[i].sense_data);
+ *      ...
+ *      _sg_async_free(engine);
+ *
+ * The 'done' callback of each command is invoked by _sg_async_run() in the
+ * calling thread, and could submit follow-up commands.  One engine should be
+ * used by one thread at a time.
+ *
+ * The device layer underneath is a struct _sg_async_backend.  The native one
+ * sends commands to SCSI generic character devices (/dev/sgN) with the
+ * asynchronous write()/read() interface of sg driver v3.  Other file
+ * descriptors, like /dev/sdX, only support the blocking SG_IO ioctl, for
+ * them the command runs in a worker thread of the native backend.
+ * The bsg devices are not supported as they only take SG_IO v4.
+ *
+ * Tests could plug in their own backend, see libsg_fake.h.
+ */
+
+#ifndef _LIBSG_ASYNC_H_
+#define _LIBSG_ASYNC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "libsg.h"
+#include "libstoragemgmt/libstoragemgmt_common.h"
+
+/* SPC-5 rev 07 4.2.1 - The longest fixed length CDB is 16 bytes */
+#define _SG_ASYNC_CDB_MAX_LEN 16
+
+/* Maximum commands in flight when 0 is given to _sg_async_new() */
+#define _SG_ASYNC_DEFAULT_IN_FLIGHT 64
+
+struct _sg_async;
+
+struct _sg_async_cmd {
+    /* Set by caller before _sg_async_submit() */
+    int fd;
+    uint8_t cdb[_SG_ASYNC_CDB_MAX_LEN];
+    uint8_t cdb_len;
+    uint8_t *data;
+    uint32_t data_len;
+    int direction;
+    /* ^ _SG_IO_RECV_DATA, _SG_IO_SEND_DATA or _SG_IO_NO_DATA */
+    uint32_t timeout_ms;
+    /* ^ 0 means _SG_IO_TMO */
+    void (*done)(struct _sg_async_cmd *cmd, void *user_data);
+    /* ^ Could be NULL */
+    void *user_data;
+
+    /* Set by engine before 'done' is invoked.
+     * Same as the return of blocking SG_IO in libsg.c: 0 if pass, -1 means
+     * got sense_data, errno otherwise. ETIMEDOUT if no reply in time.
+     */
+    int result;
+    uint8_t sense_data[_SG_T10_SPC_SENSE_DATA_MAX_LEN];
+
+    /* Private to engine and backend */
+    struct _sg_async_cmd *next;
+    uint64_t deadline_ms;
+    void *backend_data;
+};
+
+/*
+ * Device layer of the engine. All functions are invoked from the thread
+ * running _sg_async_run() or _sg_async_free().
+ */
+struct _sg_async_backend {
+    /*
+     * Start given command without waiting for it.
+     * Return 0 or errno, in which case the command completes with that
+     * errno as result.
+     */
+    int (*submit)(void *priv, struct _sg_async_cmd *cmd);
+    /*
+     * Wait at most 'timeout_ms' milliseconds, -1 for no limit, for commands
+     * to complete and report each of them via _sg_async_complete().
+     * Return 0 or errno.
+     */
+    int (*reap)(void *priv, struct _sg_async *engine, int timeout_ms);
+    /*
+     * Invoked when a command passed its deadline. Return true if the backend
+     * will not touch the command or its buffers any more. Return false if the
+     * command cannot be stopped, the engine then waits for its completion.
+     */
+    bool (*abandon)(void *priv, struct _sg_async_cmd *cmd);
+    /*
+     * Invoked by _sg_async_free() once no command is in flight.
+     */
+    void (*free)(void *priv);
+};
+
+/*
+ * Create engine with the native backend.
+ * max_in_flight:   0 means _SG_ASYNC_DEFAULT_IN_FLIGHT.
+ */
+LSM_DLL_LOCAL int _sg_async_new(char *err_msg, uint32_t max_in_flight,
+                                struct _sg_async **engine);
+
+/*
+ * Create engine with given backend. The 'priv' is passed to backend
+ * functions, and is freed by backend->free() in _sg_async_free().
+ */
+LSM_DLL_LOCAL int
+_sg_async_new_with_backend(char *err_msg, uint32_t max_in_flight,
+                           const struct _sg_async_backend *backend, void *priv,
+                           struct _sg_async **engine);
+
+/*
+ * Abandon or wait for the commands still in flight and free the engine.
+ * Commands still queued are dropped without their 'done' invoked.
+ */
+LSM_DLL_LOCAL void _sg_async_free(struct _sg_async *engine);
+
+/*
+ * Queue the command. Caller should keep 'cmd' and 'cmd->data' untouched until
+ * the 'done' of it is invoked or _sg_async_run() returns.
+ */
+LSM_DLL_LOCAL void _sg_async_submit(struct _sg_async *engine,
+                                    struct _sg_async_cmd *cmd);
+
+/*
+ * Run queued commands, including the ones submitted by 'done' callbacks,
+ * until all of them completed.
+ * Failure of a command is not an error here, check 'result' of it.
+ * Error is only returned if the backend failed, commands in flight are then
+ * left to _sg_async_free().
+ */
+LSM_DLL_LOCAL int _sg_async_run(char *err_msg, struct _sg_async *engine);
+
+/*
+ * For backends: report completion of a command. Should only be invoked
+ * from backend->reap().
+ */
+LSM_DLL_LOCAL void _sg_async_complete(struct _sg_async *engine,
+                                      struct _sg_async_cmd *cmd, int result);
+
+#endif /* End of _LIBSG_ASYNC_H_ */
@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Test of the asynchronous SCSI command engine, using the fake backend of
+ * libsg_fake.h.  Checks that:
+ *
+ *  - commands to several devices overlap, up to max_in_flight,
+ *  - a command without reply ends with ETIMEDOUT at its own timeout,
+ *  - sense data reaches _sg_io_result_check(),
+ *  - 'done' callbacks could submit follow-up commands.
+ *
+ * Then runs one command through the native backend against /dev/null, which
+ * rejects SG_IO.
+ *
+ * These functions are internal to the library, so the test is linked with
+ * the library sources instead of the shared library.
+ *
+ * Usage: libsg_async_test
+ * No SCSI device is required.
+ */
+
+#include "libsg.h"
+#include "libsg_async.h"
+#include "libsg_fake.h"
+#include "utils.h"
+
+#include "libstoragemgmt/libstoragemgmt_error.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <scsi/scsi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TEST_DEV_COUNT  3
+#define TEST_CMD_PER_DEV 50
+#define TEST_IN_FLIGHT  16
+#define TEST_DELAY_MS   20
+#define TEST_HANG_MS    50
+#define TEST_CHAIN_LEN  5
+
+static int failures = 0;
+
+static double now_ms(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void check(int ok, const char *what, const char *err_msg) {
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n    error: %s\n", what,
+                err_msg && err_msg[0] ? err_msg : "(none)");
+        failures++;
+    }
+}
+
+static void inquiry_init(struct _sg_async_cmd *cmd, int fd, uint8_t *data,
+                         uint32_t data_len) {
+    memset(cmd, 0, sizeof(struct _sg_async_cmd));
+    cmd->fd = fd;
+    cmd->cdb[0] = INQUIRY;
+    cmd->cdb[1] = 1; /* EVPD */
+    cmd->cdb[2] = 0x83;
+    cmd->cdb[4] = data_len & 0xff;
+    cmd->cdb_len = 6;
+    cmd->data = data;
+    cmd->data_len = data_len;
+    cmd->direction = _SG_IO_RECV_DATA;
+}
+
+static struct _sg_async *fake_engine(struct _sg_fake **fake,
+                                     uint32_t max_in_flight) {
+    struct _sg_async *engine = NULL;
+    char err_msg[_LSM_ERR_MSG_LEN];
+
+    *fake = _sg_fake_new();
+    if ((*fake == NULL) ||
+        (_sg_async_new_with_backend(err_msg, max_in_flight, &_sg_fake_backend,
+                                    *fake, &engine) != LSM_ERR_OK)) {
+        fprintf(stderr, "Failed to create engine\n");
+        exit(EXIT_FAILURE);
+    }
+    return engine;
+}
+
+static void test_concurrency(void) {
+    struct _sg_async *engine = NULL;
+    struct _sg_fake *fake = NULL;
+    struct _sg_async_cmd cmds[TEST_DEV_COUNT * TEST_CMD_PER_DEV];
+    uint8_t data[TEST_DEV_COUNT * TEST_CMD_PER_DEV][8];
+    struct _sg_fake_reply reply;
+    uint8_t page[8];
+    char err_msg[_LSM_ERR_MSG_LEN];
+    char what[64];
+    double start = 0;
+    double elapsed = 0;
+    int dev = 0;
+    int i = 0;
+    int ok = 1;
+
+    engine = fake_engine(&fake, TEST_IN_FLIGHT);
+    memset(&reply, 0, sizeof(reply));
+    reply.delay_ms = TEST_DELAY_MS;
+    reply.data = page;
+    reply.data_len = sizeof(page);
+    for (dev = 0; dev < TEST_DEV_COUNT; ++dev) {
+        memset(page, 0, sizeof(page));
+        page[1] = 0x83;
+        page[4] = dev + 1;
+        _sg_fake_reply_add(fake, dev + 100, INQUIRY, 0x83, 0, &reply);
+    }
+
+    for (i = 0; i < TEST_DEV_COUNT * TEST_CMD_PER_DEV; ++i) {
+        inquiry_init(&cmds[i], i % TEST_DEV_COUNT + 100, data[i],
+                     sizeof(data[i]));
+        _sg_async_submit(engine, &cmds[i]);
+    }
+
+    err_msg[0] = '\0';
+    start = now_ms();
+    check(_sg_async_run(err_msg, engine) == LSM_ERR_OK, "run", err_msg);
+    elapsed = now_ms() - start;
+
+    for (i = 0; i < TEST_DEV_COUNT * TEST_CMD_PER_DEV; ++i) {
+        if ((cmds[i].result != 0) || (data[i][1] != 0x83) ||
+            (data[i][4] != i % TEST_DEV_COUNT + 1))
+            ok = 0;
+    }
+    check(ok, "every command got the reply of its own device", NULL);
+    check(_sg_fake_submitted_get(fake) == TEST_DEV_COUNT * TEST_CMD_PER_DEV,
+          "every command submitted", NULL);
+    snprintf(what, sizeof(what), "%" PRIu32 " commands in flight at most",
+             _sg_fake_max_in_flight_get(fake));
+    check(_sg_fake_max_in_flight_get(fake) == TEST_IN_FLIGHT, what, NULL);
+    /* Sequential run would take 150 * 20ms = 3s, overlapped one 200ms */
+    snprintf(what, sizeof(what), "commands overlap, took %.0fms", elapsed);
+    check(elapsed < TEST_DEV_COUNT * TEST_CMD_PER_DEV * TEST_DELAY_MS / 4,
+          what, NULL);
+
+    _sg_async_free(engine);
+}
+
+static void test_timeout(void) {
+    struct _sg_async *engine = NULL;
+    struct _sg_fake *fake = NULL;
+    struct _sg_async_cmd hung;
+    struct _sg_async_cmd fine;
+    uint8_t data[2][8];
+    struct _sg_fake_reply reply;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    char what[64];
+    double start = 0;
+    double elapsed = 0;
+
+    engine = fake_engine(&fake, 0);
+    memset(&reply, 0, sizeof(reply));
+    reply.hang = true;
+    _sg_fake_reply_add(fake, 1, -1, -1, 0, &reply);
+    reply.hang = false;
+    reply.delay_ms = 5;
+    _sg_fake_reply_add(fake, 2, -1, -1, 0, &reply);
+
+    inquiry_init(&hung, 1, data[0], sizeof(data[0]));
+    hung.timeout_ms = TEST_HANG_MS;
+    inquiry_init(&fine, 2, data[1], sizeof(data[1]));
+    _sg_async_submit(engine, &hung);
+    _sg_async_submit(engine, &fine);
+
+    err_msg[0] = '\0';
+    start = now_ms();
+    check(_sg_async_run(err_msg, engine) == LSM_ERR_OK, "run", err_msg);
+    elapsed = now_ms() - start;
+
+    check(fine.result == 0, "command with reply passes", NULL);
+    check(hung.result == ETIMEDOUT, "command without reply times out", NULL);
+    snprintf(what, sizeof(what), "timeout honoured, took %.0fms", elapsed);
+    check((elapsed >= TEST_HANG_MS) && (elapsed < TEST_HANG_MS * 10), what,
+          NULL);
+    check(_sg_fake_abandoned_get(fake) == 1, "timed out command abandoned",
+          NULL);
+    err_msg[0] = '\0';
+    check(_sg_io_result_check(err_msg, "INQUIRY", hung.result,
+                              hung.sense_data) == LSM_ERR_TIMEOUT,
+          "timeout reported as LSM_ERR_TIMEOUT", err_msg);
+
+    _sg_async_free(engine);
+}
+
+static void test_sense(void) {
+    struct _sg_async *engine = NULL;
+    struct _sg_fake *fake = NULL;
+    struct _sg_async_cmd cmds[3];
+    uint8_t data[3][8];
+    struct _sg_fake_reply reply;
+    /* Fixed format sense data, sense key at byte 2 */
+    uint8_t sense[18] = {0x70, 0, 0, 0, 0, 0, 0, 10};
+    char err_msg[_LSM_ERR_MSG_LEN];
+    int i = 0;
+
+    engine = fake_engine(&fake, 0);
+    memset(&reply, 0, sizeof(reply));
+    reply.result = -1;
+    reply.sense_data = sense;
+    reply.sense_len = sizeof(sense);
+    sense[2] = 0x05; /* ILLEGAL REQUEST */
+    _sg_fake_reply_add(fake, 1, -1, -1, 0, &reply);
+    sense[2] = 0x01; /* RECOVERED ERROR */
+    _sg_fake_reply_add(fake, 2, -1, -1, 0, &reply);
+
+    for (i = 0; i < 3; ++i) {
+        inquiry_init(&cmds[i], i + 1, data[i], sizeof(data[i]));
+        _sg_async_submit(engine, &cmds[i]);
+    }
+
+    err_msg[0] = '\0';
+    check(_sg_async_run(err_msg, engine) == LSM_ERR_OK, "run", err_msg);
+
+    err_msg[0] = '\0';
+    check(_sg_io_result_check(err_msg, "INQUIRY", cmds[0].result,
+                              cmds[0].sense_data) == LSM_ERR_LIB_BUG,
+          "ILLEGAL REQUEST is an error", err_msg);
+    err_msg[0] = '\0';
+    check(_sg_io_result_check(err_msg, "INQUIRY", cmds[1].result,
+                              cmds[1].sense_data) == LSM_ERR_OK,
+          "RECOVERED ERROR is not an error", err_msg);
+    check(cmds[2].result == ENXIO, "command without matching reply fails",
+          NULL);
+
+    _sg_async_free(engine);
+}
+
+struct chain {
+    struct _sg_async *engine;
+    struct _sg_async_cmd cmd;
+    uint8_t data[8];
+    int done_count;
+};
+
+static void chain_done(struct _sg_async_cmd *cmd, void *user_data) {
+    struct chain *chain = (struct chain *)user_data;
+
+    if (++chain->done_count < TEST_CHAIN_LEN) {
+        inquiry_init(cmd, 1, chain->data, sizeof(chain->data));
+        cmd->done = chain_done;
+        cmd->user_data = chain;
+        _sg_async_submit(chain->engine, cmd);
+    }
+}
+
+static void test_chain(void) {
+    struct _sg_fake *fake = NULL;
+    struct _sg_fake_reply reply;
+    struct chain chain;
+    char err_msg[_LSM_ERR_MSG_LEN];
+
+    memset(&chain, 0, sizeof(chain));
+    chain.engine = fake_engine(&fake, 0);
+    memset(&reply, 0, sizeof(reply));
+    reply.delay_ms = 1;
+    _sg_fake_reply_add(fake, -1, -1, -1, 0, &reply);
+
+    inquiry_init(&chain.cmd, 1, chain.data, sizeof(chain.data));
+    chain.cmd.done = chain_done;
+    chain.cmd.user_data = &chain;
+    _sg_async_submit(chain.engine, &chain.cmd);
+
+    err_msg[0] = '\0';
+    check(_sg_async_run(err_msg, chain.engine) == LSM_ERR_OK, "run",
+          err_msg);
+    check(chain.done_count == TEST_CHAIN_LEN,
+          "follow-up commands submitted from done callback", NULL);
+
+    _sg_async_free(chain.engine);
+}
+
+static void test_native(void) {
+    struct _sg_async *engine = NULL;
+    struct _sg_async_cmd cmd;
+    uint8_t data[8];
+    char err_msg[_LSM_ERR_MSG_LEN];
+    int fd = open("/dev/null", O_RDONLY);
+
+    if (fd < 0) {
+        check(0, "open /dev/null", strerror(errno));
+        return;
+    }
+    err_msg[0] = '\0';
+    check(_sg_async_new(err_msg, 0, &engine) == LSM_ERR_OK, "native engine",
+          err_msg);
+    if (engine != NULL) {
+        inquiry_init(&cmd, fd, data, sizeof(data));
+        _sg_async_submit(engine, &cmd);
+        check(_sg_async_run(err_msg, engine) == LSM_ERR_OK, "native run",
+              err_msg);
+        check((cmd.result != 0) && (cmd.result != -1),
+              "SG_IO on /dev/null fails with errno", NULL);
+        _sg_async_free(engine);
+    }
+    close(fd);
+}
+
+int main(void) {
+    test_concurrency();
+    test_timeout();
+    test_sense();
+    test_chain();
+    test_native();
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "libsg_fake.h"
+#include "utils.h"
+
+#include <errno.h>
+#include <glib.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+struct _sg_fake_rule {
+    int fd;
+    int opcode;
+    int page_code;
+    uint32_t count;
+    struct _sg_fake_reply reply;
+    struct _sg_fake_rule *next;
+};
+
+struct _sg_fake_rule_list {
+    struct _sg_fake_rule *head;
+};
+
+struct _sg_fake_pending {
+    struct _sg_async_cmd *cmd;
+    const struct _sg_fake_reply *reply;
+    /* ^ NULL means ENXIO */
+    uint64_t due_ms;
+    struct _sg_fake_pending *next;
+};
+
+struct _sg_fake {
+    struct _sg_fake_rule *rules;
+    /* Device path to struct _sg_fake_rule_list */
+    GHashTable *path_rules;
+    struct _sg_fake_pending *pending;
+    /* Rules used up, kept as pending commands might still refer them */
+    struct _sg_fake_rule *used;
+    uint32_t in_flight;
+    uint32_t max_in_flight;
+    uint32_t submitted;
+    uint32_t abandoned;
+};
+
+static uint64_t _now_ms(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void _sg_fake_rule_free(struct _sg_fake_rule *rule) {
+    free((void *)rule->reply.data);
+    free((void *)rule->reply.sense_data);
+    free(rule);
+}
+
+static void _sg_fake_rule_list_free(void *data) {
+    struct _sg_fake_rule_list *list = (struct _sg_fake_rule_list *)data;
+    struct _sg_fake_rule *rule = NULL;
+
+    while (list->head != NULL) {
+        rule = list->head;
+        list->head = rule->next;
+        _sg_fake_rule_free(rule);
+    }
+    free(list);
+}
+
+static bool _sg_fake_match(int want, int got) {
+    return (want == -1) || (want == got);
+}
+
+/*
+ * Return the pointer to the first rule of 'head' list matching 'cmd', which
+ * points to NULL if none.
+ */
+static struct _sg_fake_rule **_sg_fake_rule_find(struct _sg_fake_rule **head,
+                                                 struct _sg_async_cmd *cmd) {
+    struct _sg_fake_rule **pp = NULL;
+    struct _sg_fake_rule *rule = NULL;
+
+    for (pp = head; *pp != NULL; pp = &(*pp)->next) {
+        rule = *pp;
+        if (_sg_fake_match(rule->fd, cmd->fd) &&
+            _sg_fake_match(rule->opcode, cmd->cdb[0]) &&
+            _sg_fake_match(rule->page_code,
+                           cmd->cdb_len > 2 ? cmd->cdb[2] : -1))
+            break;
+    }
+    return pp;
+}
+
+/*
+ * Return the rule list of the device 'fd' was opened from, NULL if none.
+ */
+static struct _sg_fake_rule_list *_sg_fake_path_rules(struct _sg_fake *fake,
+                                                      int fd) {
+    char fd_path[64];
+    char path[PATH_MAX];
+    ssize_t len = 0;
+    size_t root_len = strlen(_fs_root_get());
+
+    if (g_hash_table_size(fake->path_rules) == 0)
+        return NULL;
+
+    snprintf(fd_path, sizeof(fd_path), "/proc/self/fd/%d", fd);
+    len = readlink(fd_path, path, sizeof(path) - 1);
+    if (len < 0)
+        return NULL;
+    path[len] = '\0';
+    if (((size_t)len < root_len) ||
+        (strncmp(path, _fs_root_get(), root_len) != 0))
+        return NULL;
+    return (struct _sg_fake_rule_list *)g_hash_table_lookup(fake->path_rules,
+                                                            path + root_len);
+}
+
+static int _sg_fake_submit(void *priv, struct _sg_async_cmd *cmd) {
+    struct _sg_fake *fake = (struct _sg_fake *)priv;
+    struct _sg_fake_rule **pp = NULL;
+    struct _sg_fake_rule *rule = NULL;
+    struct _sg_fake_pending *pending = NULL;
+    struct _sg_fake_rule_list *list = NULL;
+
+    pending = (struct _sg_fake_pending *)calloc(
+        1, sizeof(struct _sg_fake_pending));
+    if (pending == NULL)
+        return ENOMEM;
+
+    list = _sg_fake_path_rules(fake, cmd->fd);
+    if (list != NULL)
+        pp = _sg_fake_rule_find(&list->head, cmd);
+    if ((pp == NULL) || (*pp == NULL))
+        pp = _sg_fake_rule_find(&fake->rules, cmd);
+
+    pending->cmd = cmd;
+    pending->due_ms = _now_ms();
+    if (*pp != NULL) {
+        rule = *pp;
+        pending->reply = &rule->reply;
+        if (rule->reply.hang)
+            pending->due_ms = UINT64_MAX;
+        else
+            pending->due_ms += rule->reply.delay_ms;
+        if ((rule->count != 0) && (--rule->count == 0)) {
+            *pp = rule->next;
+            rule->next = fake->used;
+            fake->used = rule;
+        }
+    }
+
+    pending->next = fake->pending;
+    fake->pending = pending;
+    cmd->backend_data = pending;
+
+    fake->submitted++;
+    fake->in_flight++;
+    if (fake->in_flight > fake->max_in_flight)
+        fake->max_in_flight = fake->in_flight;
+    return 0;
+}
+
+static void _sg_fake_pending_del(struct _sg_fake *fake,
+                                 struct _sg_fake_pending *pending) {
+    struct _sg_fake_pending **pp = NULL;
+
+    for (pp = &fake->pending; *pp != NULL; pp = &(*pp)->next) {
+        if (*pp == pending) {
+            *pp = pending->next;
+            fake->in_flight--;
+            break;
+        }
+    }
+    free(pending);
+}
+
+static int _sg_fake_reap(void *priv, struct _sg_async *engine,
+                         int timeout_ms) {
+    struct _sg_fake *fake = (struct _sg_fake *)priv;
+    struct _sg_fake_pending *pending = NULL;
+    const struct _sg_fake_reply *reply = NULL;
+    struct _sg_async_cmd *cmd = NULL;
+    uint64_t now = _now_ms();
+    uint64_t next_due = UINT64_MAX;
+    uint64_t wait_ms = 0;
+    uint32_t len = 0;
+    bool found = true;
+
+    for (pending = fake->pending; pending != NULL; pending = pending->next) {
+        if (pending->due_ms < next_due)
+            next_due = pending->due_ms;
+    }
+    if ((next_due == UINT64_MAX) && (timeout_ms < 0))
+        /* Nothing would ever complete */
+        return EDEADLK;
+
+    if (next_due > now) {
+        wait_ms = next_due - now;
+        if ((timeout_ms >= 0) && ((uint64_t)timeout_ms < wait_ms))
+            wait_ms = timeout_ms;
+        poll(NULL, 0, (int)wait_ms);
+        now = _now_ms();
+    }
+
+    while (found) {
+        found = false;
+        for (pending = fake->pending; pending != NULL;
+             pending = pending->next) {
+            if (pending->due_ms <= now) {
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            break;
+
+        cmd = pending->cmd;
+        reply = pending->reply;
+        _sg_fake_pending_del(fake, pending);
+        cmd->backend_data = NULL;
+        if (reply == NULL) {
+            _sg_async_complete(engine, cmd, ENXIO);
+            continue;
+        }
+        if ((reply->data != NULL) && (cmd->data != NULL)) {
+            len = reply->data_len < cmd->data_len ? reply->data_len
+                                                  : cmd->data_len;
+            memcpy(cmd->data, reply->data, len);
+        }
+        if (reply->sense_data != NULL) {
+            len = reply->sense_len < _SG_T10_SPC_SENSE_DATA_MAX_LEN
+                      ? reply->sense_len
+                      : _SG_T10_SPC_SENSE_DATA_MAX_LEN;
+            memcpy(cmd->sense_data, reply->sense_data, len);
+        }
+        if (reply->handler != NULL)
+            _sg_async_complete(engine, cmd,
+                               reply->handler(cmd, reply->handler_data));
+        else
+            _sg_async_complete(engine, cmd, reply->result);
+    }
+    return 0;
+}
+
+static bool _sg_fake_abandon(void *priv, struct _sg_async_cmd *cmd) {
+    struct _sg_fake *fake = (struct _sg_fake *)priv;
+
+    _sg_fake_pending_del(fake, (struct _sg_fake_pending *)cmd->backend_data);
+    cmd->backend_data = NULL;
+    fake->abandoned++;
+    return true;
+}
+
+static void _sg_fake_free(void *priv) {
+    struct _sg_fake *fake = (struct _sg_fake *)priv;
+    struct _sg_fake_rule *rule = NULL;
+    struct _sg_fake_pending *pending = NULL;
+
+    if (fake == NULL)
+        return;
+
+    while (fake->pending != NULL) {
+        pending = fake->pending;
+        fake->pending = pending->next;
+        free(pending);
+    }
+    while (fake->rules != NULL) {
+        rule = fake->rules;
+        fake->rules = rule->next;
+        _sg_fake_rule_free(rule);
+    }
+    while (fake->used != NULL) {
+        rule = fake->used;
+        fake->used = rule->next;
+        _sg_fake_rule_free(rule);
+    }
+    g_hash_table_destroy(fake->path_rules);
+    free(fake);
+}
+
+const struct _sg_async_backend _sg_fake_backend = {
+    _sg_fake_submit,
+    _sg_fake_reap,
+    _sg_fake_abandon,
+    _sg_fake_free,
+};
+
+struct _sg_fake *_sg_fake_new(void) {
+    struct _sg_fake *fake = NULL;
+
+    fake = (struct _sg_fake *)calloc(1, sizeof(struct _sg_fake));
+    if (fake == NULL)
+        return NULL;
+    fake->path_rules = g_hash_table_new_full(g_str_hash, g_str_equal, free,
+                                             _sg_fake_rule_list_free);
+    if (fake->path_rules == NULL) {
+        free(fake);
+        return NULL;
+    }
+    return fake;
+}
+
+/*
+ * Copy the reply into a new rule appended to 'head' list.
+ */
+static int _sg_fake_rule_add(struct _sg_fake_rule **head, int fd, int opcode,
+                             int page_code, uint32_t count,
+                             const struct _sg_fake_reply *reply) {
+    struct _sg_fake_rule *rule = NULL;
+    struct _sg_fake_rule **pp = NULL;
+    uint8_t *data = NULL;
+    uint8_t *sense_data = NULL;
+
+    rule = (struct _sg_fake_rule *)calloc(1, sizeof(struct _sg_fake_rule));
+    if (rule == NULL)
+        return ENOMEM;
+
+    rule->fd = fd;
+    rule->opcode = opcode;
+    rule->page_code = page_code;
+    rule->count = count;
+    rule->reply = *reply;
+    rule->reply.data = NULL;
+    rule->reply.sense_data = NULL;
+
+    if ((reply->data != NULL) && (reply->data_len > 0)) {
+        data = (uint8_t *)malloc(reply->data_len);
+        if (data == NULL)
+            goto nomem;
+        memcpy(data, reply->data, reply->data_len);
+        rule->reply.data = data;
+    }
+    if ((reply->sense_data != NULL) && (reply->sense_len > 0)) {
+        sense_data = (uint8_t *)malloc(reply->sense_len);
+        if (sense_data == NULL)
+            goto nomem;
+        memcpy(sense_data, reply->sense_data, reply->sense_len);
+        rule->reply.sense_data = sense_data;
+    }
+
+    /* Keep the order of adding */
+    for (pp = head; *pp != NULL; pp = &(*pp)->next) {
+    }
+    *pp = rule;
+    return 0;
+
+nomem:
+    _sg_fake_rule_free(rule);
+    return ENOMEM;
+}
+
+int _sg_fake_reply_add(struct _sg_fake *fake, int fd, int opcode,
+                       int page_code, uint32_t count,
+                       const struct _sg_fake_reply *reply) {
+    return _sg_fake_rule_add(&fake->rules, fd, opcode, page_code, count,
+                             reply);
+}
+
+int _sg_fake_reply_add_path(struct _sg_fake *fake, const char *path,
+                            int opcode, int page_code, uint32_t count,
+                            const struct _sg_fake_reply *reply) {
+    struct _sg_fake_rule_list *list = NULL;
+    char *key = NULL;
+
+    list = (struct _sg_fake_rule_list *)g_hash_table_lookup(fake->path_rules,
+                                                            path);
+    if (list == NULL) {
+        list = (struct _sg_fake_rule_list *)calloc(
+            1, sizeof(struct _sg_fake_rule_list));
+        key = strdup(path);
+        if ((list == NULL) || (key == NULL)) {
+            free(list);
+            free(key);
+            return ENOMEM;
+        }
+        g_hash_table_insert(fake->path_rules, key, list);
+    }
+    return _sg_fake_rule_add(&list->head, -1, opcode, page_code, count, reply);
+}
+
+uint32_t _sg_fake_max_in_flight_get(struct _sg_fake *fake) {
+    return fake->max_in_flight;
+}
+
+uint32_t _sg_fake_submitted_get(struct _sg_fake *fake) {
+    return fake->submitted;
+}
+
+uint32_t _sg_fake_abandoned_get(struct _sg_fake *fake) {
+    return fake->abandoned;
+}
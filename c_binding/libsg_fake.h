@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Fake backend of the asynchronous SCSI command engine for tests.
+ * Replies canned responses, matched by device, opcode and page code, after a
+ * configurable delay, without touching any device:
+ *
+ *      struct _sg_fake *fake = _sg_fake_new();
+ *      struct _sg_fake_reply reply = {.delay_ms = 20, .data = buff,
+ *                                     .data_len = sizeof(buff)};
+ *
+ *      _sg_fake_reply_add(fake, -1, INQUIRY, 0x83, 0, &reply);
+ *      _sg_async_new_with_backend(err_msg, 16, &_sg_fake_backend, fake,
+ *                                 &engine);
+ *
+ * With _sg_io_backend_set() of libsg.h, it also answers the blocking
+ * commands of the local disk code, for fixtures built under _fs_root_set().
+ *
+ * Not part of the library, only linked into tests and benchmarks.
+ */
+
+#ifndef _LIBSG_FAKE_H_
+#define _LIBSG_FAKE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "libsg_async.h"
+
+struct _sg_fake;
+
+struct _sg_fake_reply {
+    uint32_t delay_ms;
+    int result;
+    /* ^ Becomes _sg_async_cmd.result */
+    bool hang;
+    /* ^ Never reply, the command only ends by its timeout */
+    const uint8_t *data;
+    uint32_t data_len;
+    /* ^ Copied to command data, truncated to its data_len */
+    const uint8_t *sense_data;
+    uint32_t sense_len;
+    int (*handler)(struct _sg_async_cmd *cmd, void *handler_data);
+    /* ^ Could be NULL.  Invoked after 'data' and 'sense_data' are copied,
+     *   for devices with state, its return becomes _sg_async_cmd.result
+     *   instead of 'result'.
+     */
+    void *handler_data;
+};
+
+extern const struct _sg_async_backend _sg_fake_backend;
+
+/*
+ * Return NULL if no memory. Freed by _sg_async_free() of the engine using it.
+ */
+struct _sg_fake *_sg_fake_new(void);
+
+/*
+ * Reply to commands matching 'fd', CDB opcode and page code (CDB byte 2),
+ * -1 for any. The first matching rule added is used, and is removed after
+ * 'count' uses, 0 for unlimited. Reply buffers are copied.
+ * Command matching no rule completes with ENXIO.
+ * Return 0 or errno.
+ */
+int _sg_fake_reply_add(struct _sg_fake *fake, int fd, int opcode,
+                       int page_code, uint32_t count,
+                       const struct _sg_fake_reply *reply);
+
+/*
+ * Same as _sg_fake_reply_add(), but for commands sent to file descriptor
+ * opened from 'path', like "/dev/sda", resolved under _fs_root_get() of
+ * utils.h.  These rules take precedence over the ones of _sg_fake_reply_add().
+ * Return 0 or errno.
+ */
+int _sg_fake_reply_add_path(struct _sg_fake *fake, const char *path,
+                            int opcode, int page_code, uint32_t count,
+                            const struct _sg_fake_reply *reply);
+
+/*
+ * Highest number of commands the fake had in flight at the same time.
+ */
+uint32_t _sg_fake_max_in_flight_get(struct _sg_fake *fake);
+
+uint32_t _sg_fake_submitted_get(struct _sg_fake *fake);
+
+uint32_t _sg_fake_abandoned_get(struct _sg_fake *fake);
+
+#endif /* End of _LIBSG_FAKE_H_ */
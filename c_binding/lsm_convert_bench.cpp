@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Microbenchmark of the JSON and conversion layers: Payload::serialize(),
+ * Payload::deserialize(), volume_to_value(), value_array_to_volumes(),
+ * capabilities_to_value() and value_to_nfs_export(), for 10, 1000 and
+ * 100000 records.  Reports nanoseconds and heap allocations per record.
+ *
+ * Allocations are counted by replacing malloc(), calloc() and realloc(),
+ * which also sees the allocations of operator new, strdup() and libraries,
+ * so only builds against glibc count them.
+ *
+ * These functions are internal to the library, so the benchmark is linked
+ * with the library sources instead of the shared library.
+ *
+ * Usage: lsm_convert_bench [max_records]
+ */
+
+#include "libstoragemgmt/libstoragemgmt_capabilities.h"
+#include "libstoragemgmt/libstoragemgmt_nfsexport.h"
+#include "libstoragemgmt/libstoragemgmt_plug_interface.h"
+#include "libstoragemgmt/libstoragemgmt_volumes.h"
+#include "lsm_convert.hpp"
+#include "lsm_datatypes.hpp"
+#include "lsm_ipc.hpp"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Records converted per measurement, at least, for stable timings */
+#define BENCH_MIN_RECORDS 200000
+
+static uint64_t alloc_count = 0;
+
+#ifdef __GLIBC__
+#define BENCH_COUNTS_ALLOCS 1
+
+extern "C" {
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) {
+    alloc_count++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+    alloc_count++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    alloc_count++;
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+#define BENCH_COUNTS_ALLOCS 0
+#endif
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * Measures one benchmark run.  Everything between start() and stop() is
+ * accounted to the given number of records.
+ */
+class Measure {
+  public:
+    Measure() : ns(0), allocs(0), records(0), t0(0), a0(0) {}
+
+    void start() {
+        a0 = alloc_count;
+        t0 = now_ns();
+    }
+
+    void stop(uint64_t count) {
+        ns += now_ns() - t0;
+        allocs += alloc_count - a0;
+        records += count;
+    }
+
+    void report(const char *name, uint32_t size) {
+        if (BENCH_COUNTS_ALLOCS) {
+            printf("%-24s %8" PRIu32 " %12.1f %14.2f\n", name, size,
+                   (double)ns / records, (double)allocs / records);
+        } else {
+            printf("%-24s %8" PRIu32 " %12.1f %14s\n", name, size,
+                   (double)ns / records, "n/a");
+        }
+        fflush(stdout);
+    }
+
+  private:
+    uint64_t ns;
+    uint64_t allocs;
+    uint64_t records;
+    uint64_t t0;
+    uint64_t a0;
+};
+
+static lsm_volume **volumes_alloc(uint32_t count) {
+    lsm_volume **vols = lsm_volume_record_array_alloc(count);
+    char id[64];
+    char name[64];
+    char vpd83[33];
+
+    for (uint32_t i = 0; vols && i < count; ++i) {
+        snprintf(id, sizeof(id), "VOL_ID_%08" PRIu32, i);
+        snprintf(name, sizeof(name), "bench volume %" PRIu32, i);
+        snprintf(vpd83, sizeof(vpd83), "600508b1%024" PRIx32, i);
+        vols[i] =
+            lsm_volume_record_alloc(id, name, vpd83, 512, 2097152 + i,
+                                    LSM_VOLUME_ADMIN_STATE_ENABLED, "sim-01",
+                                    "POOL_ID_00000001", "plugin data");
+        if (vols[i] == NULL) {
+            fprintf(stderr, "Failed to allocate volumes\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return vols;
+}
+
+static lsm_nfs_export *nfs_export_alloc(uint32_t i) {
+    lsm_string_list *root = lsm_string_list_alloc(0);
+    lsm_string_list *rw = lsm_string_list_alloc(0);
+    lsm_string_list *ro = lsm_string_list_alloc(0);
+    lsm_nfs_export *exp = NULL;
+    char id[64];
+    char path[64];
+
+    snprintf(id, sizeof(id), "EXP_ID_%08" PRIu32, i);
+    snprintf(path, sizeof(path), "/export/bench/%" PRIu32, i);
+    lsm_string_list_append(root, "192.168.0.1");
+    lsm_string_list_append(rw, "192.168.0.0/24");
+    lsm_string_list_append(rw, "10.0.0.0/8");
+    lsm_string_list_append(ro, "*");
+
+    exp = lsm_nfs_export_record_alloc(
+        id, "FS_ID_00000001", path, "sys", root, rw, ro,
+        LSM_NFS_EXPORT_ANON_UID_GID_NA, LSM_NFS_EXPORT_ANON_UID_GID_NA, "sync",
+        NULL);
+    lsm_string_list_free(root);
+    lsm_string_list_free(rw);
+    lsm_string_list_free(ro);
+    if (exp == NULL) {
+        fprintf(stderr, "Failed to allocate NFS export\n");
+        exit(EXIT_FAILURE);
+    }
+    return exp;
+}
+
+static void bench_volumes(uint32_t size, uint32_t reps) {
+    lsm_volume **vols = volumes_alloc(size);
+    Measure to_value, serialize, deserialize, to_volumes;
+
+    for (uint32_t r = 0; r < reps; ++r) {
+        std::vector<Value> values;
+        std::string json;
+        lsm_volume **converted = NULL;
+        uint32_t count = 0;
+
+        to_value.start();
+        values.reserve(size);
+        for (uint32_t i = 0; i < size; ++i) {
+            values.push_back(volume_to_value(vols[i]));
+        }
+        to_value.stop(size);
+
+        Value array(values);
+
+        serialize.start();
+        json = Payload::serialize(array);
+        serialize.stop(size);
+
+        deserialize.start();
+        Value parsed = Payload::deserialize(json);
+        deserialize.stop(size);
+
+        to_volumes.start();
+        if (value_array_to_volumes(parsed, &converted, &count) != LSM_ERR_OK ||
+            count != size) {
+            fprintf(stderr, "value_array_to_volumes() failed\n");
+            exit(EXIT_FAILURE);
+        }
+        to_volumes.stop(size);
+
+        lsm_volume_record_array_free(converted, count);
+    }
+
+    to_value.report("volume_to_value", size);
+    serialize.report("Payload::serialize", size);
+    deserialize.report("Payload::deserialize", size);
+    to_volumes.report("value_array_to_volumes", size);
+
+    lsm_volume_record_array_free(vols, size);
+}
+
+static void bench_capabilities(uint32_t size, uint32_t reps) {
+    lsm_storage_capabilities *cap = lsm_capability_record_alloc(NULL);
+    Measure to_value;
+
+    if (cap == NULL) {
+        fprintf(stderr, "Failed to allocate capabilities\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t t = 0; t < LSM_CAP_MAX; ++t) {
+        lsm_capability_set(cap, (lsm_capability_type)t, LSM_CAP_SUPPORTED);
+    }
+
+    /* Every converted value is destroyed in the loop, as the handlers do */
+    for (uint32_t r = 0; r < reps; ++r) {
+        to_value.start();
+        for (uint32_t i = 0; i < size; ++i) {
+            Value v = capabilities_to_value(cap);
+        }
+        to_value.stop(size);
+    }
+    to_value.report("capabilities_to_value", size);
+
+    lsm_capability_record_free(cap);
+}
+
+static void bench_nfs_exports(uint32_t size, uint32_t reps) {
+    std::vector<Value> values;
+    std::vector<lsm_nfs_export *> converted(size, NULL);
+    Measure to_export;
+
+    values.reserve(size);
+    for (uint32_t i = 0; i < size; ++i) {
+        lsm_nfs_export *exp = nfs_export_alloc(i);
+        values.push_back(nfs_export_to_value(exp));
+        lsm_nfs_export_record_free(exp);
+    }
+
+    for (uint32_t r = 0; r < reps; ++r) {
+        to_export.start();
+        for (uint32_t i = 0; i < size; ++i) {
+            converted[i] = value_to_nfs_export(values[i]);
+        }
+        to_export.stop(size);
+
+        for (uint32_t i = 0; i < size; ++i) {
+            lsm_nfs_export_record_free(converted[i]);
+        }
+    }
+    to_export.report("value_to_nfs_export", size);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t max_records = 100000;
+
+    if (argc > 1) {
+        max_records = strtoul(argv[1], NULL, 10);
+    }
+
+    printf("%-24s %8s %12s %14s\n", "benchmark", "records", "ns/record",
+           "allocs/record");
+
+    for (uint32_t size = 10; size <= max_records; size *= 100) {
+        uint32_t reps = size < BENCH_MIN_RECORDS ? BENCH_MIN_RECORDS / size : 1;
+
+        bench_volumes(size, reps);
+        bench_capabilities(size, reps);
+        bench_nfs_exports(size, reps);
+    }
+    return EXIT_SUCCESS;
+}
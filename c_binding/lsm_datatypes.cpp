@@ -192,6 +192,23 @@ lsm_connect *connection_get() {
     return c;
 }
 
+void request_free(lsm_request *r) {
+    if (LSM_IS_REQUEST(r)) {
+        r->magic = LSM_DEL_MAGIC(LSM_REQUEST_MAGIC);
+
+        if (r->error) {
+            lsm_error_free(r->error);
+            r->error = NULL;
+        }
+
+        delete (r->response);
+        r->response = NULL;
+        r->next = NULL;
+
+        free(r);
+    }
+}
+
 void connection_free(lsm_connect *c) {
     if (LSM_IS_CONNECT(c)) {
 
@@ -218,6 +235,13 @@ void connection_free(lsm_connect *c) {
             c->raw_uri = NULL;
         }
 
+        while (c->requests) {
+            lsm_request *r = c->requests;
+            c->requests = r->next;
+            request_free(r);
+        }
+        c->requests_tail = NULL;
+
         free(c);
     }
 }
@@ -192,6 +192,7 @@ struct LSM_DLL_LOCAL _lsm_plugin {
     struct lsm_fs_ops_v1 *fs_ops;     /**< Callbacks for fs ops */
     struct lsm_ops_v1_2 *ops_v1_2;    /**< Callbacks for v1.2 ops */
     struct lsm_ops_v1_3 *ops_v1_3;    /**< Callbacks for v1.3 ops */
+    struct _lsm_plugin_jobs *jobs; /**< Job executor, NULL until first job */
 };
 
 /**
@@ -199,12 +200,16 @@ struct LSM_DLL_LOCAL _lsm_plugin {
  * opaque data type for the library.
  */
 struct LSM_DLL_LOCAL _lsm_connect {
-    uint32_t magic;   /**< Magic, used for structure validation */
-    uint32_t flags;   /**< Flags for the connection */
-    xmlURIPtr uri;    /**< URI */
-    char *raw_uri;    /**< Raw URI string */
-    lsm_error *error; /**< Error information */
-    Ipc *tp;          /**< IPC transport */
+    uint32_t magic;        /**< Magic, used for structure validation */
+    uint32_t flags;        /**< Flags for the connection */
+    xmlURIPtr uri;         /**< URI */
+    char *raw_uri;         /**< Raw URI string */
+    lsm_error *error;      /**< Error information */
+    Ipc *tp;               /**< IPC transport */
+    lsm_request *requests; /**< Asynchronous requests, submission order */
+    lsm_request *requests_tail; /**< Last request, appends are O(1) */
+    lsm_rpc_timing_cb timing_cb; /**< RPC timing callback, NULL if off */
+    void *timing_data;           /**< User data passed to timing_cb */
 };
 
 #define LSM_ERROR_MAGIC   0xAA7A000C
@@ -311,6 +316,39 @@ struct LSM_DLL_LOCAL _lsm_battery {
     char *plugin_data;
 };
 
+#define LSM_REQUEST_MAGIC   0xAA7A0014
+#define LSM_IS_REQUEST(obj) MAGIC_CHECK(obj, LSM_REQUEST_MAGIC)
+
+/**
+ * Kind of result an asynchronous request will produce, used to select the
+ * converter when the caller retrieves the result.
+ */
+typedef enum {
+    LSM_REQUEST_TYPE_VOLUMES = 1, /**< Array of volumes */
+    LSM_REQUEST_TYPE_POOLS = 2,   /**< Array of pools */
+    LSM_REQUEST_TYPE_VOLUME = 3,  /**< [job, volume] pair */
+    LSM_REQUEST_TYPE_JOB = 4,     /**< Job id or null */
+} lsm_request_type;
+
+/**
+ * Asynchronous request submitted on a connection.  Responses arrive in
+ * submission order, so requests are kept in a singly linked list hanging off
+ * the connection.
+ */
+struct LSM_DLL_LOCAL _lsm_request {
+    uint32_t magic;        /**< Magic, used for struct validation */
+    lsm_request_type type; /**< Expected result type */
+    int done;              /**< Non-zero when the response was received */
+    int orphaned;          /**< Freed by caller before completion */
+    int rc;                /**< Error code returned by plugin */
+    lsm_error *error;      /**< Error information when rc != LSM_ERR_OK */
+    Value *response;       /**< Result when rc == LSM_ERR_OK */
+    lsm_request *next;     /**< Next request on the same connection */
+};
+
+#define LSM_PLUGIN_JOB_MAGIC   0xAA7A0015
+#define LSM_IS_PLUGIN_JOB(obj) MAGIC_CHECK(obj, LSM_PLUGIN_JOB_MAGIC)
+
 /**
  * Returns a pointer to a newly created connection structure.
  * @return NULL on memory exhaustion, else new connection.
@@ -323,6 +361,12 @@ lsm_connect LSM_DLL_LOCAL *connection_get();
  */
 void LSM_DLL_LOCAL connection_free(lsm_connect *c);
 
+/**
+ * De-allocates an asynchronous request.
+ * @param r     Request to free.
+ */
+void LSM_DLL_LOCAL request_free(lsm_request *r);
+
 /**
  * Loads the requester driver specified in the uri.
  * @param c             Connection
@@ -342,6 +386,12 @@ char LSM_DLL_LOCAL *capability_string(lsm_storage_capabilities *c);
 
 const char LSM_DLL_LOCAL *uds_path(void);
 
+/**
+ * Suffix of the plugin description cache files lsmd writes next to each
+ * plugin socket, see lsm_available_plugins_list().
+ */
+#define LSM_PLUGIN_INFO_SUFFIX ".info"
+
 /**
  * Take a character string and tries to convert to a number.
  * Note: Number is defined as what is acceptable for JSON number.  The number
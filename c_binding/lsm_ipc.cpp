@@ -37,6 +37,7 @@
 #include "config.h"
 #endif
 
+#include "lsm_trace.hpp"
 #include "lsm_value_jsmn.hpp"
 
 static std::string zero_pad_num(unsigned int num) {
@@ -45,9 +46,9 @@ static std::string zero_pad_num(unsigned int num) {
     return ss.str();
 }
 
-Transport::Transport() : s(-1) {}
+Transport::Transport() : s(-1), tx(0), rx(0) {}
 
-Transport::Transport(int socket_desc) : s(socket_desc) {}
+Transport::Transport(int socket_desc) : s(socket_desc), tx(0), rx(0) {}
 
 int Transport::msg_send(const std::string &msg, int &error_code) {
     int rc = -1;
@@ -71,6 +72,7 @@ int Transport::msg_send(const std::string &msg, int &error_code) {
         }
 
         if ((written == msg_size) && error_code == 0) {
+            tx += msg_size;
             rc = 0;
         }
     }
@@ -103,21 +105,66 @@ static std::string string_read(int fd, size_t count, int &error_code) {
         throw EOFException("");
 }
 
-std::string Transport::msg_recv(int &error_code) {
+std::string Transport::msg_recv(int &error_code, struct timespec *hdr_ts) {
     std::string msg;
     error_code = 0;
     unsigned long int payload_len = 0;
     std::string len = string_read(s, HDR_LEN, error_code); // Read the length
+    if (hdr_ts) {
+        clock_gettime(CLOCK_MONOTONIC, hdr_ts);
+    }
     if (len.size() && error_code == 0) {
         payload_len = strtoul(len.c_str(), NULL, 10);
         if (payload_len < 0x80000000) { /* Should be big enough */
             msg = string_read(s, payload_len, error_code);
+            rx += HDR_LEN + payload_len;
         }
         // fprintf(stderr, "<<< %s\n", msg.c_str());
     }
     return msg;
 }
 
+bool Transport::msg_recv_buffered(std::string &msg, bool block) {
+    char buff[4096];
+
+    while (true) {
+        if (rbuf.size() >= (size_t)HDR_LEN) {
+            unsigned long int payload_len =
+                strtoul(rbuf.substr(0, HDR_LEN).c_str(), NULL, 10);
+
+            if (payload_len >= 0x80000000) {
+                throw EOFException("Invalid message length");
+            }
+
+            if (rbuf.size() >= (HDR_LEN + payload_len)) {
+                msg = rbuf.substr(HDR_LEN, payload_len);
+                rbuf.erase(0, HDR_LEN + payload_len);
+                rx += HDR_LEN + payload_len;
+                return true;
+            }
+        }
+
+        ssize_t rd = recv(s, buff, sizeof(buff), block ? 0 : MSG_DONTWAIT);
+        if (rd > 0) {
+            rbuf.append(buff, rd);
+        } else if (rd == 0) {
+            throw EOFException("");
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return false;
+        } else {
+            throw EOFException("");
+        }
+    }
+}
+
+int Transport::fd() const { return s; }
+
+uint64_t Transport::bytes_sent() const { return tx; }
+
+uint64_t Transport::bytes_received() const { return rx; }
+
 int Transport::socket_get(const std::string &path, int &error_code) {
     int sfd = socket(AF_UNIX, SOCK_STREAM, 0);
     int rc = -1;
@@ -186,24 +233,61 @@ Ipc::Ipc(std::string socket_path) {
 
 Ipc::~Ipc() { t.close(); }
 
+static uint64_t ns_elapsed(struct timespec &from, const struct timespec &to) {
+    uint64_t ns = (uint64_t)(to.tv_sec - from.tv_sec) * 1000000000ULL +
+                  to.tv_nsec - from.tv_nsec;
+    from = to;
+    return ns;
+}
+
 void Ipc::requestSend(const std::string request, const Value &params,
-                      int32_t id) {
+                      int32_t id, const std::string &trace_id,
+                      lsm_rpc_timing *timing) {
     int rc = 0;
     int ec = 0;
     std::map<std::string, Value> v;
+    struct timespec mark;
+    struct timespec now;
+
+    if (timing) {
+        clock_gettime(CLOCK_MONOTONIC, &mark);
+    }
 
     v["method"] = Value(request);
     v["id"] = Value(id);
     v["params"] = params;
 
+    std::string tid;
+    if (trace_enabled()) {
+        tid = trace_id.empty() ? trace_id_new() : trace_id;
+        v["trace_id"] = Value(tid);
+    }
+
+    TraceSpan span("send ", request, tid);
+    if (!tid.empty()) {
+        trace_flow(tid, true);
+    }
+
     Value req(v);
-    rc = t.msg_send(Payload::serialize(req), ec);
+    std::string msg = Payload::serialize(req);
+    if (timing) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        timing->encode_ns = ns_elapsed(mark, now);
+        timing->request_bytes = msg.size();
+    }
+
+    rc = t.msg_send(msg, ec);
 
     if (rc != 0) {
         std::string em =
             std::string("Error sending message: errno ") + ::to_string(ec);
         throw LsmException((int)LSM_ERR_TRANSPORT_COMMUNICATION, em);
     }
+
+    if (timing) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        timing->send_ns = ns_elapsed(mark, now);
+    }
 }
 
 void Ipc::errorSend(int error_code, std::string msg, std::string debug,
@@ -254,8 +338,53 @@ void Ipc::responseSend(const Value &response, uint32_t id) {
     }
 }
 
-Value Ipc::responseRead() {
-    Value r = readRequest();
+Value Ipc::responseRead(lsm_rpc_timing *timing) {
+    if (!timing) {
+        Value r = readRequest();
+        return responseParse(r);
+    }
+
+    /* Same as readRequest(), with each stage timed */
+    struct timespec mark;
+    struct timespec now;
+    int ec = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &mark);
+    std::string resp = t.msg_recv(ec, &now);
+    if (ec != 0) {
+        /* Failed read, no stage to record, fail as the untimed path does */
+        Value r = Payload::deserialize(resp);
+        return responseParse(r);
+    }
+    timing->wait_ns = ns_elapsed(mark, now);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    timing->recv_ns = ns_elapsed(mark, now);
+    timing->response_bytes = resp.size();
+
+    Value r = Payload::deserialize(resp);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    timing->parse_ns = ns_elapsed(mark, now);
+
+    return responseParse(r);
+}
+
+bool Ipc::responseReadBuffered(Value &response, bool block) {
+    std::string msg;
+
+    if (t.msg_recv_buffered(msg, block)) {
+        response = Payload::deserialize(msg);
+        return true;
+    }
+    return false;
+}
+
+int Ipc::fd() const { return t.fd(); }
+
+uint64_t Ipc::bytesSent() const { return t.bytes_sent(); }
+
+uint64_t Ipc::bytesReceived() const { return t.bytes_received(); }
+
+Value Ipc::responseParse(Value &r) {
     if (r.hasKey(std::string("result"))) {
         return r.getValue("result");
     } else {
@@ -268,7 +397,16 @@ Value Ipc::responseRead() {
     }
 }
 
-Value Ipc::rpc(const std::string &request, const Value &params, int32_t id) {
-    requestSend(request, params, id);
-    return responseRead();
+Value Ipc::rpc(const std::string &request, const Value &params, int32_t id,
+               lsm_rpc_timing *timing) {
+    std::string trace_id;
+
+    if (trace_enabled()) {
+        trace_id = trace_id_new();
+    }
+
+    TraceSpan span("rpc ", request, trace_id);
+
+    requestSend(request, params, id, trace_id, timing);
+    return responseRead(timing);
 }
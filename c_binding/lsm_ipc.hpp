@@ -20,11 +20,13 @@
 #define LSM_IPC_H
 
 #include "libstoragemgmt/libstoragemgmt_common.h"
+#include "libstoragemgmt/libstoragemgmt_types.h"
 #include <map>
 #include <sstream>
 #include <stdexcept>
 #include <stdint.h>
 #include <string>
+#include <time.h>
 #include <vector>
 
 #ifdef HAVE_CONFIG_H
@@ -75,9 +77,40 @@ class LSM_DLL_LOCAL Transport {
      * Note: A zero read indicates that the transport was closed by other side,
      *       no error code will be set in that case.
      * @param error_code    (0 on success, else errno)
+     * @param hdr_ts        If not NULL, set to CLOCK_MONOTONIC time at which
+     *                      the message header arrived
      * @return Message on success else 0 size with error_code set (not if EOF)
      */
-    std::string msg_recv(int &error_code);
+    std::string msg_recv(int &error_code, struct timespec *hdr_ts = NULL);
+
+    /**
+     * Receives a message using an internal buffer so that partially arrived
+     * messages can be picked up on a later call.
+     * Note: Must not be mixed with msg_recv() while a partial message is
+     *       buffered.
+     * @param[out]  msg     Complete message when we return true
+     * @param[in]   block   If false, return as soon as the socket has no more
+     *                      data available.
+     * @return true if a complete message was placed in msg, else false.
+     *         EOFException on EOF or socket error.
+     */
+    bool msg_recv_buffered(std::string &msg, bool block);
+
+    /**
+     * Socket descriptor used by this transport.
+     * @return socket descriptor, -1 if closed.
+     */
+    int fd() const;
+
+    /**
+     * Total bytes of complete messages sent, headers included.
+     */
+    uint64_t bytes_sent() const;
+
+    /**
+     * Total bytes of complete messages received, headers included.
+     */
+    uint64_t bytes_received() const;
 
     /**
      * Creates a connected socket (AF_UNIX) to the specified path
@@ -94,7 +127,10 @@ class LSM_DLL_LOCAL Transport {
     void close();
 
   private:
-    int s; // Socket descriptor
+    int s;            // Socket descriptor
+    std::string rbuf; // Partially received data for msg_recv_buffered()
+    uint64_t tx;      // Bytes sent
+    uint64_t rx;      // Bytes received
 };
 
 /**
@@ -407,9 +443,15 @@ class LSM_DLL_LOCAL Ipc {
      * @param request       IPC function name
      * @param params        Parameters
      * @param id            Request ID
+     * @param trace_id      Trace id to put in the request when tracing is
+     *                      enabled, a new one is created when empty
+     * @param timing        If not NULL, encode_ns, send_ns and request_bytes
+     *                      are filled in
      */
     void requestSend(const std::string request, const Value &params,
-                     int32_t id = 100);
+                     int32_t id = 100,
+                     const std::string &trace_id = std::string(),
+                     lsm_rpc_timing *timing = NULL);
     /**
      * Reads a request
      * @returns Value
@@ -425,9 +467,11 @@ class LSM_DLL_LOCAL Ipc {
 
     /**
      * Read a response
+     * @param timing        If not NULL, wait_ns, recv_ns, parse_ns and
+     *                      response_bytes are filled in
      * @return Value of response
      */
-    Value responseRead();
+    Value responseRead(lsm_rpc_timing *timing = NULL);
 
     /**
      * Send an error
@@ -444,10 +488,44 @@ class LSM_DLL_LOCAL Ipc {
      * @param request           Function method
      * @param params            Function parameters
      * @param id                Id of request
+     * @param timing            If not NULL, filled in with the time spent in
+     *                          each stage, method and rc are left alone
      * @return Result of the operation.
      */
     Value rpc(const std::string &request, const Value &params,
-              int32_t id = 100);
+              int32_t id = 100, lsm_rpc_timing *timing = NULL);
+
+    /**
+     * Read a response without blocking if one is not fully available yet.
+     * @param[out]  response    Raw response envelope, see responseParse()
+     * @param[in]   block       Wait for a complete response if true
+     * @return true when response was filled in, else false
+     */
+    bool responseReadBuffered(Value &response, bool block);
+
+    /**
+     * Extract the result from a response envelope.
+     * @param r     Response envelope as read from the transport
+     * @return Result of the operation, LsmException if the plugin returned
+     *         an error.
+     */
+    static Value responseParse(Value &r);
+
+    /**
+     * File descriptor of the underlying transport, suitable for poll/epoll.
+     * @return file descriptor
+     */
+    int fd() const;
+
+    /**
+     * Total bytes sent over the transport.
+     */
+    uint64_t bytesSent() const;
+
+    /**
+     * Total bytes received over the transport.
+     */
+    uint64_t bytesReceived() const;
 
   private:
     Transport t;
@@ -25,6 +25,7 @@
 #include <libudev.h>
 #include <limits.h>
 #include <math.h> /* For log10() */
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -35,14 +36,17 @@
 #include <unistd.h>
 
 #include "libata.h"
+#include "libblk.h"
 #include "libfc.h"
 #include "libiscsi.h"
 #include "libsas.h"
 #include "libses.h"
 #include "libsg.h"
+#include "libsg_async.h"
 #include "libstoragemgmt/libstoragemgmt.h"
 #include "libstoragemgmt/libstoragemgmt_error.h"
 #include "libstoragemgmt/libstoragemgmt_plug_interface.h"
+#include "lsm_local_disk.h"
 #include "utils.h"
 
 #define _LSM_MAX_SERIAL_NUM_LEN 253
@@ -59,11 +63,10 @@
 #define _SD_PATH_FORMAT      "/dev/%s"
 #define _MAX_SD_PATH_STR_LEN 128 + _MAX_SD_NAME_STR_LEN
 
-#define _SYSFS_VPD80_PATH_FORMAT      "/sys/block/%s/device/vpd_pg80"
-#define _MAX_SYSFS_VPD80_PATH_STR_LEN 128 + _MAX_SD_NAME_STR_LEN
-
-#define _SYSFS_VPD83_PATH_FORMAT      "/sys/block/%s/device/vpd_pg83"
-#define _MAX_SYSFS_VPD83_PATH_STR_LEN 128 + _MAX_SD_NAME_STR_LEN
+/* Attributes of /sys/block/sdX/device */
+#define _SYSFS_VPD80_ATTR_NAME    "vpd_pg80"
+#define _SYSFS_VPD83_ATTR_NAME    "vpd_pg83"
+#define _SYSFS_SAS_ADDR_ATTR_NAME "sas_address"
 
 #define _SYSFS_BLK_PATH_FORMAT      "/sys/block/%s"
 #define _MAX_SYSFS_BLK_PATH_STR_LEN 128 + _MAX_SD_NAME_STR_LEN
@@ -127,16 +130,23 @@ struct t10_proto_port_mode_sub_page_hdr {
 
 #pragma pack(pop)
 
-static int _sysfs_serial_num_of_sd_name(char *err_msg, const char *sd_name,
-                                        uint8_t *serial_num);
-static int _sysfs_vpd_pg80_data_get(char *err_msg, const char *sd_name,
-                                    uint8_t *vpd_data, ssize_t *read_size);
-static int _sysfs_vpd83_naa_of_sd_name(char *err_msg, const char *sd_name,
-                                       char *vpd83);
+/*
+ * Open /sys/block/<sd_name>/device for the _sysfs_*() functions below, so
+ * that all the sysfs attributes of one disk are read relative to it.
+ * Caller should close() 'dev_dir_fd'.
+ * Return LSM_ERR_NOT_FOUND_DISK or LSM_ERR_LIB_BUG or LSM_ERR_OK.
+ */
+static int _sysfs_dev_dir_open(char *err_msg, const char *sd_name,
+                               int *dev_dir_fd);
+static int _sysfs_serial_num_get(char *err_msg, int dev_dir_fd,
+                                 const char *sd_name, uint8_t *serial_num);
+static int _sysfs_vpd_data_get(char *err_msg, int dev_dir_fd,
+                               const char *sd_name, const char *attr_name,
+                               uint8_t *vpd_data, ssize_t *read_size);
+static int _sysfs_vpd83_naa_get(char *err_msg, int dev_dir_fd,
+                                const char *sd_name, char *vpd83);
 static int _udev_vpd83_of_sd_name(char *err_msg, const char *sd_name,
                                   char *vpd83);
-static int _sysfs_vpd_pg83_data_get(char *err_msg, const char *sd_name,
-                                    uint8_t *vpd_data, ssize_t *read_size);
 /*
  * Use /sys/block/sdx/device/sas_address to retrieve sas address of certain
  * disk.
@@ -145,112 +155,125 @@ static int _sysfs_vpd_pg83_data_get(char *err_msg, const char *sd_name,
  *  * sysfs file content has strlen as _SYSFS_SAS_ADDR_LEN
  *  * sysfs file content start with '0x'.
  */
-static void _sysfs_sas_addr_get(const char *blk_name, char *tp_sas_addr);
+static void _sysfs_sas_addr_get(int dev_dir_fd, char *tp_sas_addr);
+
+/*
+ * Shared by the public functions and _local_disk_info_collect(), which passes
+ * the 'dev_dir_fd' it opened once for all the attributes of the disk.
+ * On failure '*serial_num' or '*vpd83' is NULL.
+ */
+static int _serial_num_of_sd_name(char *err_msg, int dev_dir_fd,
+                                  const char *sd_name, char **serial_num);
+static int _vpd83_of_sd_name(char *err_msg, int dev_dir_fd,
+                             const char *sd_name, char **vpd83);
 
 static int _ses_ctrl(const char *disk_path, lsm_error **lsm_err, int action,
                      int action_type);
 
+static int _ses_ctrl_batch(lsm_string_list *disk_paths, lsm_error **lsm_err,
+                           int action, int action_type);
+
 /*
  * `tp_sas_addr` should be char[_SG_T10_SPL_SAS_ADDR_LEN]
+ * 'dev_dir_fd' is from _sysfs_dev_dir_open(), -1 to let this function open
+ * it for sd disks.
  */
-static int _sas_addr_get(char *err_msg, const char *disk_path,
+static int _sas_addr_get(char *err_msg, const char *disk_path, int dev_dir_fd,
                          char *tp_sas_addr);
 
+static int _led_status_get(char *err_msg, const char *disk_path,
+                           int dev_dir_fd, uint32_t *led_status);
+
 /*
- * Retrieve the content of /sys/block/sda/device/vpd_pg80 file.
- * No argument checker here, assume all non-NULL and vpd_data is
- * char[_SG_T10_SPC_VPD_MAX_LEN]
+ * The _*_of_fd() functions below query the disk through a file descriptor
+ * opened by _sg_io_open_ro(), so that several of them could share it.
  */
-static int _sysfs_vpd_pg80_data_get(char *err_msg, const char *sd_name,
-                                    uint8_t *vpd_data, ssize_t *read_size) {
-    int file_rc = 0;
-    char sysfs_path[_MAX_SYSFS_VPD80_PATH_STR_LEN];
-    char sysfs_blk_path[_MAX_SYSFS_BLK_PATH_STR_LEN];
+static int _rpm_of_fd(char *err_msg, int fd, int32_t *rpm);
+
+/*
+ * The 'vpd_data' is the Block Device Characteristics VPD page.
+ */
+static int _rpm_of_vpd_data(char *err_msg, uint8_t *vpd_data, int32_t *rpm);
+
+static int _link_type_of_fd(char *err_msg, int fd,
+                            lsm_disk_link_type *link_type);
+
+/*
+ * Same as _link_type_of_fd() once the Supported VPD Pages page was read,
+ * 'ata_info' tells whether it lists the ATA Information page.
+ */
+static int _link_type_of_fd_sup(char *err_msg, int fd, bool ata_info,
+                                lsm_disk_link_type *link_type);
+
+static int _health_status_of_fd(char *err_msg, int fd,
+                                lsm_disk_link_type link_type,
+                                int32_t *health_status);
+
+/*
+ * disk_path and dev_dir_fd are only used to find the SAS address of SAS
+ * disks, see _sas_addr_get().
+ */
+static int _link_speed_of_fd(char *err_msg, const char *disk_path,
+                             int dev_dir_fd, int fd,
+                             lsm_disk_link_type link_type,
+                             uint32_t *link_speed);
+
+static int _sysfs_dev_dir_open(char *err_msg, const char *sd_name,
+                               int *dev_dir_fd) {
+    char sysfs_path[_MAX_SYSFS_BLK_PATH_STR_LEN];
     char strerr_buff[_LSM_ERR_MSG_LEN];
 
-    memset(vpd_data, 0, _SG_T10_SPC_VPD_MAX_LEN);
+    snprintf(sysfs_path, _MAX_SYSFS_BLK_PATH_STR_LEN,
+             _SYSFS_BLK_PATH_FORMAT "/device", sd_name);
 
-    /*
-     * Check the existence of disk vis /sys/block/sdX folder.
-     */
-    snprintf(sysfs_blk_path, _MAX_SYSFS_BLK_PATH_STR_LEN,
-             _SYSFS_BLK_PATH_FORMAT, sd_name);
-    if (!_file_exists(sysfs_blk_path)) {
+    *dev_dir_fd = _sysfs_dir_open(sysfs_path);
+    if (*dev_dir_fd >= 0)
+        return LSM_ERR_OK;
+
+    if (errno == ENOENT) {
         _lsm_err_msg_set(err_msg, "Disk %s not found", sd_name);
         return LSM_ERR_NOT_FOUND_DISK;
     }
-
-    snprintf(sysfs_path, _MAX_SYSFS_VPD80_PATH_STR_LEN,
-             _SYSFS_VPD80_PATH_FORMAT, sd_name);
-
-    file_rc =
-        _read_file(sysfs_path, vpd_data, read_size, _SG_T10_SPC_VPD_MAX_LEN);
-    if (file_rc != 0) {
-        if (file_rc == ENOENT) {
-            _lsm_err_msg_set(err_msg, "File '%s' not exist", sysfs_path);
-            return LSM_ERR_NO_SUPPORT;
-        } else if (file_rc == EINVAL) {
-            _lsm_err_msg_set(err_msg,
-                             "Read error on File '%s': "
-                             "invalid argument",
-                             sysfs_path);
-            return LSM_ERR_NO_SUPPORT;
-        } else {
-            _lsm_err_msg_set(
-                err_msg,
-                "BUG: Unknown error %d(%s) from "
-                "_read_file().",
-                file_rc, error_to_str(file_rc, strerr_buff, _LSM_ERR_MSG_LEN));
-            return LSM_ERR_LIB_BUG;
-        }
-    }
-    return LSM_ERR_OK;
+    _lsm_err_msg_set(err_msg, "BUG: Unknown error %d(%s) when opening %s",
+                     errno, error_to_str(errno, strerr_buff, _LSM_ERR_MSG_LEN),
+                     sysfs_path);
+    return LSM_ERR_LIB_BUG;
 }
 
 /*
- * Retrieve the content of /sys/block/sda/device/vpd_pg83 file.
+ * Retrieve the content of /sys/block/sda/device/<attr_name> file, like
+ * vpd_pg80 or vpd_pg83.
  * No argument checker here, assume all non-NULL and vpd_data is
  * char[_SG_T10_SPC_VPD_MAX_LEN]
  */
-static int _sysfs_vpd_pg83_data_get(char *err_msg, const char *sd_name,
-                                    uint8_t *vpd_data, ssize_t *read_size) {
+static int _sysfs_vpd_data_get(char *err_msg, int dev_dir_fd,
+                               const char *sd_name, const char *attr_name,
+                               uint8_t *vpd_data, ssize_t *read_size) {
     int file_rc = 0;
-    char sysfs_path[_MAX_SYSFS_VPD83_PATH_STR_LEN];
-    char sysfs_blk_path[_MAX_SYSFS_BLK_PATH_STR_LEN];
     char strerr_buff[_LSM_ERR_MSG_LEN];
 
     memset(vpd_data, 0, _SG_T10_SPC_VPD_MAX_LEN);
 
-    /*
-     * Check the existence of disk vis /sys/block/sdX folder.
-     */
-    snprintf(sysfs_blk_path, _MAX_SYSFS_BLK_PATH_STR_LEN,
-             _SYSFS_BLK_PATH_FORMAT, sd_name);
-    if (!_file_exists(sysfs_blk_path)) {
-        _lsm_err_msg_set(err_msg, "Disk %s not found", sd_name);
-        return LSM_ERR_NOT_FOUND_DISK;
-    }
-
-    snprintf(sysfs_path, _MAX_SYSFS_VPD83_PATH_STR_LEN,
-             _SYSFS_VPD83_PATH_FORMAT, sd_name);
-
-    file_rc =
-        _read_file(sysfs_path, vpd_data, read_size, _SG_T10_SPC_VPD_MAX_LEN);
+    file_rc = _sysfs_attr_read(dev_dir_fd, attr_name, vpd_data, read_size,
+                               _SG_T10_SPC_VPD_MAX_LEN);
     if (file_rc != 0) {
         if (file_rc == ENOENT) {
-            _lsm_err_msg_set(err_msg, "File '%s' not exist", sysfs_path);
+            _lsm_err_msg_set(err_msg,
+                             "File '" _SYSFS_BLK_PATH_FORMAT
+                             "/device/%s' not exist",
+                             sd_name, attr_name);
             return LSM_ERR_NO_SUPPORT;
         } else if (file_rc == EINVAL) {
             _lsm_err_msg_set(err_msg,
-                             "Read error on File '%s': "
-                             "invalid argument",
-                             sysfs_path);
+                             "Read error on File '" _SYSFS_BLK_PATH_FORMAT
+                             "/device/%s': invalid argument",
+                             sd_name, attr_name);
             return LSM_ERR_NO_SUPPORT;
         } else {
             _lsm_err_msg_set(
                 err_msg,
                 "BUG: Unknown error %d(%s) from "
-                "_read_file().",
+                "_sysfs_attr_read().",
                 file_rc, error_to_str(file_rc, strerr_buff, _LSM_ERR_MSG_LEN));
             return LSM_ERR_LIB_BUG;
         }
@@ -259,7 +282,7 @@ static int _sysfs_vpd_pg83_data_get(char *err_msg, const char *sd_name,
 }
 
 /*
- * Parse _SYSFS_VPD83_PATH_FORMAT file for VPD83 NAA ID.
+ * Parse _SYSFS_VPD83_ATTR_NAME file for VPD83 NAA ID.
  * When no such sysfs file found, return LSM_ERR_NO_SUPPORT.
  * When VPD83 page does not have NAA ID, return LSM_ERR_OK and vpd83 as empty
  * string.
@@ -268,11 +291,10 @@ static int _sysfs_vpd_pg83_data_get(char *err_msg, const char *sd_name,
  * the check.
  * The maximum *sd_name strlen is (_MAX_SD_NAME_STR_LEN - 1), assuming caller
  * did the check.
- * Return LSM_ERR_NO_MEMORY or LSM_ERR_NO_SUPPORT or LSM_ERR_LIB_BUG or
- *        LSM_ERR_NOT_FOUND_DISK
+ * Return LSM_ERR_NO_MEMORY or LSM_ERR_NO_SUPPORT or LSM_ERR_LIB_BUG
  */
-static int _sysfs_vpd83_naa_of_sd_name(char *err_msg, const char *sd_name,
-                                       char *vpd83) {
+static int _sysfs_vpd83_naa_get(char *err_msg, int dev_dir_fd,
+                                const char *sd_name, char *vpd83) {
     ssize_t read_size = 0;
     struct _sg_t10_vpd83_naa_header *naa_header = NULL;
     int rc = LSM_ERR_OK;
@@ -284,14 +306,15 @@ static int _sysfs_vpd83_naa_of_sd_name(char *err_msg, const char *sd_name,
     memset(vpd83, 0, _LSM_MAX_VPD83_ID_LEN);
 
     if (sd_name == NULL) {
-        _lsm_err_msg_set(err_msg, "_sysfs_vpd83_naa_of_sd_name(): "
+        _lsm_err_msg_set(err_msg, "_sysfs_vpd83_naa_get(): "
                                   "Input sd_name argument is NULL");
         rc = LSM_ERR_LIB_BUG;
         goto out;
     }
 
-    _good(_sysfs_vpd_pg83_data_get(err_msg, sd_name, vpd_data, &read_size), rc,
-          out);
+    _good(_sysfs_vpd_data_get(err_msg, dev_dir_fd, sd_name,
+                              _SYSFS_VPD83_ATTR_NAME, vpd_data, &read_size),
+          rc, out);
 
     _good(_sg_parse_vpd_83(err_msg, vpd_data, &dps, &dp_count), rc, out);
 
@@ -333,7 +356,7 @@ out:
 }
 
 /*
- * Parse _SYSFS_VPD80_PATH_FORMAT file for VPD80 serial number.
+ * Parse _SYSFS_VPD80_ATTR_NAME file for VPD80 serial number.
  * When no such sysfs file found, return LSM_ERR_NO_SUPPORT.
  * When VPD80 page does not have a serial number, return LSM_ERR_OK and
  * serial_num as an empty string.
@@ -342,24 +365,24 @@ out:
  * did the check.
  * The maximum *sd_name strlen is (_MAX_SD_NAME_STR_LEN - 1), assuming caller
  * did the check.
- * Return LSM_ERR_NO_MEMORY or LSM_ERR_NO_SUPPORT or LSM_ERR_LIB_BUG or
- *        LSM_ERR_NOT_FOUND_DISK
+ * Return LSM_ERR_NO_MEMORY or LSM_ERR_NO_SUPPORT or LSM_ERR_LIB_BUG
  */
-static int _sysfs_serial_num_of_sd_name(char *err_msg, const char *sd_name,
-                                        uint8_t *serial_num) {
+static int _sysfs_serial_num_get(char *err_msg, int dev_dir_fd,
+                                 const char *sd_name, uint8_t *serial_num) {
     ssize_t read_size = 0;
     int rc = LSM_ERR_OK;
     uint8_t vpd_data[_SG_T10_SPC_VPD_MAX_LEN];
 
     if (sd_name == NULL) {
-        _lsm_err_msg_set(err_msg, "_sysfs_serial_num_of_sd_name(): "
+        _lsm_err_msg_set(err_msg, "_sysfs_serial_num_get(): "
                                   "Input sd_name argument is NULL");
         rc = LSM_ERR_LIB_BUG;
         goto out;
     }
 
-    _good(_sysfs_vpd_pg80_data_get(err_msg, sd_name, vpd_data, &read_size), rc,
-          out);
+    _good(_sysfs_vpd_data_get(err_msg, dev_dir_fd, sd_name,
+                              _SYSFS_VPD80_ATTR_NAME, vpd_data, &read_size),
+          rc, out);
 
     _good(_sg_parse_vpd_80(err_msg, vpd_data, serial_num,
                            _LSM_MAX_SERIAL_NUM_LEN),
@@ -533,45 +556,179 @@ out:
     return rc;
 }
 
-int lsm_local_disk_serial_num_get(const char *disk_path, char **serial_num,
-                                  lsm_error **lsm_err) {
-    uint8_t tmp_serial_num[_LSM_MAX_SERIAL_NUM_LEN];
-    char *trimmed_serial_num = NULL;
-    const char *sd_name = NULL;
+/*
+ * Entry of the sorted index used by lsm_local_disk_vpd83_bulk_search() to
+ * map a vpd83 back to its position in the requested list.
+ */
+struct _vpd83_bulk_entry {
+    const char *vpd83;
+    uint32_t index;
+};
+
+static int _vpd83_bulk_entry_cmp(const void *a, const void *b) {
+    const struct _vpd83_bulk_entry *x = (const struct _vpd83_bulk_entry *)a;
+    const struct _vpd83_bulk_entry *y = (const struct _vpd83_bulk_entry *)b;
+    int rc = strcmp(x->vpd83, y->vpd83);
+
+    if (rc != 0)
+        return rc;
+    /* Keep duplicated vpd83s in request order */
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+static int _vpd83_bulk_key_cmp(const void *key, const void *entry) {
+    return strcmp((const char *)key,
+                  ((const struct _vpd83_bulk_entry *)entry)->vpd83);
+}
+
+int lsm_local_disk_vpd83_bulk_search(lsm_string_list *vpd83_list,
+                                     lsm_string_list ***disk_path_lists,
+                                     lsm_error **lsm_err) {
     int rc = LSM_ERR_OK;
+    uint32_t i = 0;
+    uint32_t count = 0;
+    const char *vpd83 = NULL;
+    const char *disk_path = NULL;
     char err_msg[_LSM_ERR_MSG_LEN];
+    lsm_string_list *disk_paths = NULL;
+    lsm_string_list **path_lists = NULL;
+    struct _vpd83_bulk_entry *entries = NULL;
+    struct _vpd83_bulk_entry *match = NULL;
+    char *tmp_vpd83 = NULL;
+    lsm_error *tmp_lsm_err = NULL;
 
     _lsm_err_msg_clear(err_msg);
 
-    rc = _check_null_ptr(err_msg, 3 /* arg_count */, disk_path, serial_num,
-                         lsm_err);
+    rc = _check_null_ptr(err_msg, 3 /* argument count */, vpd83_list,
+                         disk_path_lists, lsm_err);
 
     if (rc != LSM_ERR_OK) {
-        if (serial_num != NULL)
-            *serial_num = NULL;
+        if (disk_path_lists != NULL)
+            *disk_path_lists = NULL;
 
         goto out;
     }
 
-    *serial_num = NULL;
     *lsm_err = NULL;
-
-    if (!_file_exists(disk_path)) {
-        rc = LSM_ERR_NOT_FOUND_DISK;
-        _lsm_err_msg_set(err_msg, "Disk %s not found", disk_path);
+    *disk_path_lists = NULL;
+    count = lsm_string_list_size(vpd83_list);
+
+    /* One extra element so a zero sized request still gets an array */
+    path_lists = (lsm_string_list **)calloc(count + 1,
+                                            sizeof(lsm_string_list *));
+    entries = (struct _vpd83_bulk_entry *)calloc(
+        count + 1, sizeof(struct _vpd83_bulk_entry));
+    if ((path_lists == NULL) || (entries == NULL)) {
+        rc = LSM_ERR_NO_MEMORY;
         goto out;
     }
 
-    if (strncmp(disk_path, "/dev/sd", strlen("/dev/sd")) != 0) {
-        rc = LSM_ERR_NO_SUPPORT;
-        _lsm_err_msg_set(err_msg, "we only support disk path start with "
-                                  "'/dev/sd' today");
+    _lsm_string_list_foreach(vpd83_list, i, vpd83) {
+        if (strlen(vpd83) >= _LSM_MAX_VPD83_ID_LEN) {
+            _lsm_err_msg_set(err_msg,
+                             "Provided vpd83 string '%s' exceeded the "
+                             "maximum string length for SCSI VPD83 NAA ID "
+                             "%d, current %zd",
+                             vpd83, _LSM_MAX_VPD83_ID_LEN - 1, strlen(vpd83));
+            rc = LSM_ERR_INVALID_ARGUMENT;
+            goto out;
+        }
+        path_lists[i] = lsm_string_list_alloc(0 /* no pre-allocation */);
+        if (path_lists[i] == NULL) {
+            rc = LSM_ERR_NO_MEMORY;
+            goto out;
+        }
+        entries[i].vpd83 = vpd83;
+        entries[i].index = i;
+    }
+
+    if (count == 0)
+        goto out;
+
+    qsort(entries, count, sizeof(struct _vpd83_bulk_entry),
+          _vpd83_bulk_entry_cmp);
+
+    rc = lsm_local_disk_list(&disk_paths, &tmp_lsm_err);
+    if (rc != LSM_ERR_OK) {
+        snprintf(err_msg, _LSM_ERR_MSG_LEN, "%s",
+                 lsm_error_message_get(tmp_lsm_err));
+        lsm_error_free(tmp_lsm_err);
         goto out;
     }
 
-    sd_name = disk_path + strlen("/dev/");
+    /* Each disk is queried once, whatever the number of requested vpd83s */
+    _lsm_string_list_foreach(disk_paths, i, disk_path) {
+        if (lsm_local_disk_vpd83_get(disk_path, &tmp_vpd83, &tmp_lsm_err) !=
+            LSM_ERR_OK) {
+            lsm_error_free(tmp_lsm_err);
+            continue;
+        }
+        if (tmp_vpd83 == NULL) {
+            rc = LSM_ERR_LIB_BUG;
+            _lsm_err_msg_set(err_msg,
+                             "BUG: lsm_local_disk_vpd83_get() on "
+                             "'%s',return NULL for vpd83 and LSM_ERR_OK",
+                             disk_path);
+            goto out;
+        }
+        match = (struct _vpd83_bulk_entry *)bsearch(
+            tmp_vpd83, entries, count, sizeof(struct _vpd83_bulk_entry),
+            _vpd83_bulk_key_cmp);
+        if (match != NULL) {
+            /* bsearch() may land on any of the duplicated vpd83s */
+            while ((match > entries) &&
+                   (strcmp((match - 1)->vpd83, tmp_vpd83) == 0))
+                --match;
+            for (; (match < entries + count) &&
+                   (strcmp(match->vpd83, tmp_vpd83) == 0);
+                 ++match) {
+                if (lsm_string_list_append(path_lists[match->index],
+                                           disk_path) != 0) {
+                    rc = LSM_ERR_NO_MEMORY;
+                    goto out;
+                }
+            }
+        }
+        free(tmp_vpd83);
+        tmp_vpd83 = NULL;
+    }
+
+out:
+    if (disk_paths != NULL)
+        lsm_string_list_free(disk_paths);
+
+    free(tmp_vpd83);
+    free(entries);
+
+    if (rc == LSM_ERR_OK) {
+        *disk_path_lists = path_lists;
+    } else {
+        /* Error found, clean up */
+
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+
+        if (path_lists != NULL) {
+            for (i = 0; i < count; ++i) {
+                if (path_lists[i] != NULL)
+                    lsm_string_list_free(path_lists[i]);
+            }
+            free(path_lists);
+        }
+    }
+
+    return rc;
+}
+
+static int _serial_num_of_sd_name(char *err_msg, int dev_dir_fd,
+                                  const char *sd_name, char **serial_num) {
+    uint8_t tmp_serial_num[_LSM_MAX_SERIAL_NUM_LEN];
+    char *trimmed_serial_num = NULL;
+    int rc = LSM_ERR_OK;
+
+    *serial_num = NULL;
 
-    rc = _sysfs_serial_num_of_sd_name(err_msg, sd_name, tmp_serial_num);
+    rc = _sysfs_serial_num_get(err_msg, dev_dir_fd, sd_name, tmp_serial_num);
     if (rc != LSM_ERR_OK)
         goto out;
 
@@ -597,6 +754,54 @@ int lsm_local_disk_serial_num_get(const char *disk_path, char **serial_num,
     }
 
 out:
+    return rc;
+}
+
+int lsm_local_disk_serial_num_get(const char *disk_path, char **serial_num,
+                                  lsm_error **lsm_err) {
+    const char *sd_name = NULL;
+    int rc = LSM_ERR_OK;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    int dev_dir_fd = -1;
+
+    _lsm_err_msg_clear(err_msg);
+
+    rc = _check_null_ptr(err_msg, 3 /* arg_count */, disk_path, serial_num,
+                         lsm_err);
+
+    if (rc != LSM_ERR_OK) {
+        if (serial_num != NULL)
+            *serial_num = NULL;
+
+        goto out;
+    }
+
+    *serial_num = NULL;
+    *lsm_err = NULL;
+
+    if (!_file_exists(disk_path)) {
+        rc = LSM_ERR_NOT_FOUND_DISK;
+        _lsm_err_msg_set(err_msg, "Disk %s not found", disk_path);
+        goto out;
+    }
+
+    if (strncmp(disk_path, "/dev/sd", strlen("/dev/sd")) != 0) {
+        rc = LSM_ERR_NO_SUPPORT;
+        _lsm_err_msg_set(err_msg, "we only support disk path start with "
+                                  "'/dev/sd' today");
+        goto out;
+    }
+
+    sd_name = disk_path + strlen("/dev/");
+
+    _good(_sysfs_dev_dir_open(err_msg, sd_name, &dev_dir_fd), rc, out);
+
+    rc = _serial_num_of_sd_name(err_msg, dev_dir_fd, sd_name, serial_num);
+
+out:
+    if (dev_dir_fd >= 0)
+        close(dev_dir_fd);
+
     if (rc != LSM_ERR_OK) {
         if (lsm_err != NULL)
             *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
@@ -610,12 +815,37 @@ out:
     return rc;
 }
 
+static int _vpd83_of_sd_name(char *err_msg, int dev_dir_fd,
+                             const char *sd_name, char **vpd83) {
+    char tmp_vpd83[_LSM_MAX_VPD83_ID_LEN];
+    int rc = LSM_ERR_OK;
+
+    *vpd83 = NULL;
+
+    rc = _sysfs_vpd83_naa_get(err_msg, dev_dir_fd, sd_name, tmp_vpd83);
+    if (rc == LSM_ERR_NO_SUPPORT)
+        /* Try udev if kernel does not expose vpd83 */
+        rc = _udev_vpd83_of_sd_name(err_msg, sd_name, tmp_vpd83);
+
+    if (rc != LSM_ERR_OK)
+        goto out;
+
+    if (tmp_vpd83[0] != '\0') {
+        *vpd83 = strdup(tmp_vpd83);
+        if (*vpd83 == NULL)
+            rc = LSM_ERR_NO_MEMORY;
+    }
+
+out:
+    return rc;
+}
+
 int lsm_local_disk_vpd83_get(const char *disk_path, char **vpd83,
                              lsm_error **lsm_err) {
-    char tmp_vpd83[_LSM_MAX_VPD83_ID_LEN];
     const char *sd_name = NULL;
     int rc = LSM_ERR_OK;
     char err_msg[_LSM_ERR_MSG_LEN];
+    int dev_dir_fd = -1;
 
     _lsm_err_msg_clear(err_msg);
 
@@ -646,21 +876,14 @@ int lsm_local_disk_vpd83_get(const char *disk_path, char **vpd83,
 
     sd_name = disk_path + strlen("/dev/");
 
-    rc = _sysfs_vpd83_naa_of_sd_name(err_msg, sd_name, tmp_vpd83);
-    if (rc == LSM_ERR_NO_SUPPORT)
-        /* Try udev if kernel does not expose vpd83 */
-        rc = _udev_vpd83_of_sd_name(err_msg, sd_name, tmp_vpd83);
-
-    if (rc != LSM_ERR_OK)
-        goto out;
+    _good(_sysfs_dev_dir_open(err_msg, sd_name, &dev_dir_fd), rc, out);
 
-    if (tmp_vpd83[0] != '\0') {
-        *vpd83 = strdup(tmp_vpd83);
-        if (*vpd83 == NULL)
-            rc = LSM_ERR_NO_MEMORY;
-    }
+    rc = _vpd83_of_sd_name(err_msg, dev_dir_fd, sd_name, vpd83);
 
 out:
+    if (dev_dir_fd >= 0)
+        close(dev_dir_fd);
+
     if (rc != LSM_ERR_OK) {
         if (lsm_err != NULL)
             *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
@@ -674,24 +897,21 @@ out:
     return rc;
 }
 
-int lsm_local_disk_rpm_get(const char *disk_path, int32_t *rpm,
-                           lsm_error **lsm_err) {
+static int _rpm_of_fd(char *err_msg, int fd, int32_t *rpm) {
     uint8_t vpd_data[_SG_T10_SPC_VPD_MAX_LEN];
-    int fd = -1;
-    char err_msg[_LSM_ERR_MSG_LEN];
     int rc = LSM_ERR_OK;
-    struct t10_sbc_vpd_bdc *bdc = NULL;
-
-    rc = _check_null_ptr(err_msg, 3 /* arg_count */, disk_path, rpm, lsm_err);
-    if (rc != LSM_ERR_OK) {
-        goto out;
-    }
-
-    _lsm_err_msg_clear(err_msg);
 
-    _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
     _good(_sg_io_vpd(err_msg, fd, _SG_T10_SBC_VPD_BLK_DEV_CHA, vpd_data), rc,
           out);
+    rc = _rpm_of_vpd_data(err_msg, vpd_data, rpm);
+
+out:
+    return rc;
+}
+
+static int _rpm_of_vpd_data(char *err_msg, uint8_t *vpd_data, int32_t *rpm) {
+    int rc = LSM_ERR_OK;
+    struct t10_sbc_vpd_bdc *bdc = NULL;
 
     bdc = (struct t10_sbc_vpd_bdc *)vpd_data;
     if (bdc->pg_code != _SG_T10_SBC_VPD_BLK_DEV_CHA) {
@@ -713,12 +933,32 @@ int lsm_local_disk_rpm_get(const char *disk_path, int32_t *rpm,
         *rpm = LSM_DISK_RPM_NON_ROTATING_MEDIUM;
 
 out:
-    if (fd >= 0)
-        close(fd);
+    return rc;
+}
 
-    if (rc != LSM_ERR_OK) {
-        if (lsm_err != NULL)
-            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+int lsm_local_disk_rpm_get(const char *disk_path, int32_t *rpm,
+                           lsm_error **lsm_err) {
+    int fd = -1;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    int rc = LSM_ERR_OK;
+
+    rc = _check_null_ptr(err_msg, 3 /* arg_count */, disk_path, rpm, lsm_err);
+    if (rc != LSM_ERR_OK) {
+        goto out;
+    }
+
+    _lsm_err_msg_clear(err_msg);
+
+    _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
+    _good(_rpm_of_fd(err_msg, fd, rpm), rc, out);
+
+out:
+    if (fd >= 0)
+        close(fd);
+
+    if (rc != LSM_ERR_OK) {
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
         if (rpm != NULL)
             *rpm = LSM_DISK_RPM_UNKNOWN;
     }
@@ -727,15 +967,7 @@ out:
 }
 
 int lsm_local_disk_list(lsm_string_list **disk_paths, lsm_error **lsm_err) {
-    struct udev *udev = NULL;
-    struct udev_enumerate *udev_enum = NULL;
-    struct udev_list_entry *udev_devs = NULL;
-    struct udev_list_entry *udev_list = NULL;
-    struct udev_device *udev_dev = NULL;
     char err_msg[_LSM_ERR_MSG_LEN];
-    int udev_rc = 0;
-    const char *udev_path = NULL;
-    const char *disk_path = NULL;
     int rc = LSM_ERR_OK;
 
     _lsm_err_msg_clear(err_msg);
@@ -756,85 +988,16 @@ int lsm_local_disk_list(lsm_string_list **disk_paths, lsm_error **lsm_err) {
         goto out;
     }
 
-    udev = udev_new();
-    if (udev == NULL) {
-        rc = LSM_ERR_NO_MEMORY;
-        goto out;
-    }
-    udev_enum = udev_enumerate_new(udev);
-    if (udev_enum == NULL) {
-        rc = LSM_ERR_NO_MEMORY;
-        goto out;
-    }
-
-    udev_rc = udev_enumerate_add_match_subsystem(udev_enum, "block");
-    if (udev_rc != 0) {
-        rc = LSM_ERR_LIB_BUG;
-        _lsm_err_msg_set(err_msg,
-                         "udev_enumerate_scan_subsystems() failed "
-                         "with %d",
-                         udev_rc);
-        goto out;
-    }
-    udev_rc = udev_enumerate_add_match_property(udev_enum, "DEVTYPE", "disk");
-    if (udev_rc != 0) {
-        rc = LSM_ERR_LIB_BUG;
-        _lsm_err_msg_set(err_msg,
-                         "udev_enumerate_add_match_property() failed "
-                         "with %d",
-                         udev_rc);
-        goto out;
-    }
-
-    udev_rc = udev_enumerate_scan_devices(udev_enum);
-    if (udev_rc != 0) {
-        rc = LSM_ERR_LIB_BUG;
-        _lsm_err_msg_set(err_msg,
-                         "udev_enumerate_scan_devices() failed "
-                         "with %d",
-                         udev_rc);
-        goto out;
-    }
-
-    udev_devs = udev_enumerate_get_list_entry(udev_enum);
-    if (udev_devs == NULL)
-        goto out;
-
-    udev_list_entry_foreach(udev_list, udev_devs) {
-        udev_path = udev_list_entry_get_name(udev_list);
-        if (udev_path == NULL)
-            continue;
-        udev_dev = udev_device_new_from_syspath(udev, udev_path);
-        if (udev_dev == NULL) {
-            rc = LSM_ERR_NO_MEMORY;
-            goto out;
-        }
-        disk_path = udev_device_get_devnode(udev_dev);
-        if (disk_path == NULL) {
-            udev_device_unref(udev_dev);
-            continue;
-        }
-        if ((strncmp(disk_path, "/dev/sd", strlen("/dev/sd")) == 0) ||
-            (strncmp(disk_path, "/dev/nvme", strlen("/dev/nvme")) == 0)) {
-
-            if (_file_exists(disk_path)) {
-                rc = lsm_string_list_append(*disk_paths, disk_path);
-                if (rc != LSM_ERR_OK) {
-                    udev_device_unref(udev_dev);
-                    goto out;
-                }
-            }
-        }
-        udev_device_unref(udev_dev);
+    /* Reading the names in /sys/block is much cheaper than creating a udev
+     * device for every block device, udev is only needed without sysfs.
+     */
+    rc = _blk_disk_list_sysfs(err_msg, *disk_paths);
+    if (rc == LSM_ERR_NO_SUPPORT) {
+        _lsm_err_msg_clear(err_msg);
+        rc = _blk_disk_list_udev(err_msg, *disk_paths);
     }
 
 out:
-    if (udev != NULL)
-        udev_unref(udev);
-
-    if (udev_enum != NULL)
-        udev_enumerate_unref(udev_enum);
-
     if (rc != LSM_ERR_OK) {
         if ((disk_paths != NULL) && (*disk_paths != NULL)) {
             lsm_string_list_free(*disk_paths);
@@ -852,6 +1015,19 @@ out:
  *  * Based on that data, decide what type of device it is.
  *  * Request health status the appropriate way.
  */
+static int _health_status_of_fd(char *err_msg, int fd,
+                                lsm_disk_link_type link_type,
+                                int32_t *health_status) {
+    if (link_type == LSM_DISK_LINK_TYPE_ATA)
+        return _sg_ata_health_status(err_msg, fd, health_status);
+    if (link_type == LSM_DISK_LINK_TYPE_SAS)
+        return _sg_sas_health_status(err_msg, fd, health_status);
+
+    _lsm_err_msg_set(err_msg, "Device link type %d is not supported yet",
+                     link_type);
+    return LSM_ERR_NO_SUPPORT;
+}
+
 int lsm_local_disk_health_status_get(const char *disk_path,
                                      int32_t *health_status,
                                      lsm_error **lsm_err) {
@@ -867,26 +1043,10 @@ int lsm_local_disk_health_status_get(const char *disk_path,
 
     *lsm_err = NULL;
 
-    rc = lsm_local_disk_link_type_get(disk_path, &link_type, lsm_err);
-
-    if (rc != LSM_ERR_OK) {
-        _lsm_err_msg_set(err_msg, "%s", lsm_error_message_get(*lsm_err));
-        lsm_error_free(*lsm_err);
-        goto out;
-    }
-
     _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
-
-    if (link_type == LSM_DISK_LINK_TYPE_ATA) {
-        _good(_sg_ata_health_status(err_msg, fd, health_status), rc, out);
-    } else if (link_type == LSM_DISK_LINK_TYPE_SAS) {
-        _good(_sg_sas_health_status(err_msg, fd, health_status), rc, out);
-    } else {
-        rc = LSM_ERR_NO_SUPPORT;
-        _lsm_err_msg_set(err_msg, "Device link type %d is not supported yet",
-                         link_type);
-        goto out;
-    }
+    _good(_link_type_of_fd(err_msg, fd, &link_type), rc, out);
+    _good(_health_status_of_fd(err_msg, fd, link_type, health_status), rc,
+          out);
 
 out:
     if (rc != LSM_ERR_OK) {
@@ -914,13 +1074,28 @@ out:
  *  * As fallback, we use 'Protocol Specific Port mode page' seeking for
  *    'PROTOCOL IDENTIFIER' also.
  */
-int lsm_local_disk_link_type_get(const char *disk_path,
-                                 lsm_disk_link_type *link_type,
-                                 lsm_error **lsm_err) {
+static int _link_type_of_fd(char *err_msg, int fd,
+                            lsm_disk_link_type *link_type) {
     unsigned char vpd_sup_data[_SG_T10_SPC_VPD_MAX_LEN];
+    int rc = LSM_ERR_OK;
+
+    *link_type = LSM_DISK_LINK_TYPE_NO_SUPPORT;
+
+    _good(_sg_io_vpd(err_msg, fd, _SG_T10_SPC_VPD_SUP_VPD_PGS, vpd_sup_data),
+          rc, out);
+
+    rc = _link_type_of_fd_sup(
+        err_msg, fd,
+        _sg_is_vpd_page_supported(vpd_sup_data, _SG_T10_SPC_VPD_ATA_INFO),
+        link_type);
+
+out:
+    return rc;
+}
+
+static int _link_type_of_fd_sup(char *err_msg, int fd, bool ata_info,
+                                lsm_disk_link_type *link_type) {
     unsigned char vpd_di_data[_SG_T10_SPC_VPD_MAX_LEN];
-    int fd = -1;
-    char err_msg[_LSM_ERR_MSG_LEN];
     int rc = LSM_ERR_OK;
     struct _sg_t10_vpd83_dp **dps = NULL;
     uint16_t dp_count = 0;
@@ -931,21 +1106,9 @@ int lsm_local_disk_link_type_get(const char *disk_path,
     struct t10_proto_port_mode_page_0_hdr *page_0_hdr = NULL;
     struct t10_proto_port_mode_sub_page_hdr *sub_page_hdr = NULL;
 
-    _lsm_err_msg_clear(err_msg);
-
-    _good(_check_null_ptr(err_msg, 3 /* arg_count */, disk_path, link_type,
-                          lsm_err),
-          rc, out);
-
     *link_type = LSM_DISK_LINK_TYPE_NO_SUPPORT;
-    *lsm_err = NULL;
-
-    _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
-    _good(_sg_io_vpd(err_msg, fd, _SG_T10_SPC_VPD_SUP_VPD_PGS, vpd_sup_data),
-          rc, out);
 
-    if (_sg_is_vpd_page_supported(vpd_sup_data, _SG_T10_SPC_VPD_ATA_INFO) ==
-        true) {
+    if (ata_info) {
         *link_type = LSM_DISK_LINK_TYPE_ATA;
         goto out;
     }
@@ -1006,12 +1169,35 @@ int lsm_local_disk_link_type_get(const char *disk_path,
     }
 
 out:
-    if (fd >= 0)
-        close(fd);
-
     if (dps != NULL)
         _sg_t10_vpd83_dp_array_free(dps, dp_count);
 
+    return rc;
+}
+
+int lsm_local_disk_link_type_get(const char *disk_path,
+                                 lsm_disk_link_type *link_type,
+                                 lsm_error **lsm_err) {
+    int fd = -1;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    int rc = LSM_ERR_OK;
+
+    _lsm_err_msg_clear(err_msg);
+
+    _good(_check_null_ptr(err_msg, 3 /* arg_count */, disk_path, link_type,
+                          lsm_err),
+          rc, out);
+
+    *link_type = LSM_DISK_LINK_TYPE_NO_SUPPORT;
+    *lsm_err = NULL;
+
+    _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
+    _good(_link_type_of_fd(err_msg, fd, link_type), rc, out);
+
+out:
+    if (fd >= 0)
+        close(fd);
+
     if (rc != LSM_ERR_OK) {
         if (lsm_err != NULL)
             *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
@@ -1053,7 +1239,7 @@ static int _ses_ctrl(const char *disk_path, lsm_error **lsm_err, int action,
     _good(_check_null_ptr(err_msg, 2 /* arg_count */, disk_path, lsm_err), rc,
           out);
 
-    _good(_sas_addr_get(err_msg, disk_path, tp_sas_addr), rc, out);
+    _good(_sas_addr_get(err_msg, disk_path, -1, tp_sas_addr), rc, out);
 
     /* SEND DIAGNOSTIC
      * SES-3, 6.1.3 Enclosure Control diagnostic page
@@ -1070,48 +1256,103 @@ out:
     return rc;
 }
 
-static void _sysfs_sas_addr_get(const char *blk_name, char *tp_sas_addr) {
+int lsm_local_disk_ident_led_on_batch(lsm_string_list *disk_paths,
+                                      lsm_error **lsm_err) {
+    return _ses_ctrl_batch(disk_paths, lsm_err, _SES_DEV_CTRL_RQST_IDENT,
+                           _SES_CTRL_SET);
+}
+
+int lsm_local_disk_ident_led_off_batch(lsm_string_list *disk_paths,
+                                       lsm_error **lsm_err) {
+    return _ses_ctrl_batch(disk_paths, lsm_err, _SES_DEV_CTRL_RQST_IDENT,
+                           _SES_CTRL_CLEAR);
+}
+
+int lsm_local_disk_fault_led_on_batch(lsm_string_list *disk_paths,
+                                      lsm_error **lsm_err) {
+    return _ses_ctrl_batch(disk_paths, lsm_err, _SES_DEV_CTRL_RQST_FAULT,
+                           _SES_CTRL_SET);
+}
+
+int lsm_local_disk_fault_led_off_batch(lsm_string_list *disk_paths,
+                                       lsm_error **lsm_err) {
+    return _ses_ctrl_batch(disk_paths, lsm_err, _SES_DEV_CTRL_RQST_FAULT,
+                           _SES_CTRL_CLEAR);
+}
+
+static int _ses_ctrl_batch(lsm_string_list *disk_paths, lsm_error **lsm_err,
+                           int action, int action_type) {
+    int rc = LSM_ERR_OK;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    char tp_sas_addr[_SG_T10_SPL_SAS_ADDR_LEN];
+    lsm_string_list *tp_sas_addrs = NULL;
+    const char *disk_path = NULL;
+    uint32_t i = 0;
+
+    _lsm_err_msg_clear(err_msg);
+
+    _good(_check_null_ptr(err_msg, 2 /* arg_count */, disk_paths, lsm_err),
+          rc, out);
+
+    tp_sas_addrs = lsm_string_list_alloc(0 /* no pre-allocation */);
+    _alloc_null_check(err_msg, tp_sas_addrs, rc, out);
+
+    /* Resolve all disks first, so nothing is changed if any one fails */
+    _lsm_string_list_foreach(disk_paths, i, disk_path) {
+        _good(_sas_addr_get(err_msg, disk_path, -1, tp_sas_addr), rc, out);
+        if (lsm_string_list_append(tp_sas_addrs, tp_sas_addr) != 0) {
+            rc = LSM_ERR_NO_MEMORY;
+            _lsm_err_msg_set(err_msg, "No memory");
+            goto out;
+        }
+    }
+
+    /* SEND DIAGNOSTIC once per enclosure
+     * SES-3, 6.1.3 Enclosure Control diagnostic page
+     * SES-3, Table 78 — Device Slot control element
+     */
+    _good(_ses_dev_slot_ctrl_batch(err_msg, tp_sas_addrs, action, action_type),
+          rc, out);
+
+out:
+    if (tp_sas_addrs != NULL)
+        lsm_string_list_free(tp_sas_addrs);
+    if (rc != LSM_ERR_OK) {
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+    }
+    return rc;
+}
+
+static void _sysfs_sas_addr_get(int dev_dir_fd, char *tp_sas_addr) {
     char sysfs_sas_addr[_SYSFS_SAS_ADDR_LEN];
-    char *sysfs_sas_path = NULL;
     ssize_t read_size = -1;
     int tmp_rc = 0;
 
-    assert(blk_name != NULL);
     assert(tp_sas_addr != NULL);
 
     memset(sysfs_sas_addr, 0, _SYSFS_SAS_ADDR_LEN);
     memset(tp_sas_addr, 0, _SG_T10_SPL_SAS_ADDR_LEN);
 
-    sysfs_sas_path = (char *)malloc(sizeof(char) *
-                                    (strlen("/sys/block//device/sas_address") +
-                                     strlen(blk_name) + 1 /* trailing \0 */));
-    if (sysfs_sas_path == NULL)
-        goto out;
-
-    sprintf(sysfs_sas_path, "/sys/block/%s/device/sas_address", blk_name);
-    if (!_file_exists(sysfs_sas_path))
-        goto out;
-
-    tmp_rc = _read_file(sysfs_sas_path, (uint8_t *)sysfs_sas_addr, &read_size,
-                        _SYSFS_SAS_ADDR_LEN);
+    tmp_rc = _sysfs_attr_read(dev_dir_fd, _SYSFS_SAS_ADDR_ATTR_NAME,
+                              (uint8_t *)sysfs_sas_addr, &read_size,
+                              _SYSFS_SAS_ADDR_LEN);
     /* As sysfs entry has trailing '\n', we should get EFBIG here */
     if (tmp_rc != EFBIG)
-        goto out;
+        return;
 
     if (strncmp(sysfs_sas_addr, "0x", strlen("0x")) != 0)
-        goto out;
+        return;
 
     memcpy(tp_sas_addr, sysfs_sas_addr + strlen("0x"),
            _SG_T10_SPL_SAS_ADDR_LEN);
-
-out:
-    free(sysfs_sas_path);
 }
 
-static int _sas_addr_get(char *err_msg, const char *disk_path,
+static int _sas_addr_get(char *err_msg, const char *disk_path, int dev_dir_fd,
                          char *tp_sas_addr) {
     int rc = LSM_ERR_OK;
     int fd = -1;
+    int tmp_dir_fd = -1;
 
     assert(disk_path != NULL);
     assert(tp_sas_addr != NULL);
@@ -1121,10 +1362,17 @@ static int _sas_addr_get(char *err_msg, const char *disk_path,
     /* TODO(Gris Ge): Add support of NVMe enclosure */
 
     /* Try use sysfs first to get SAS address. */
-    if ((strlen(disk_path) > strlen("/dev/")) &&
+    if ((dev_dir_fd < 0) && (strlen(disk_path) > strlen("/dev/")) &&
         (strncmp(disk_path, "/dev/", strlen("/dev/")) == 0) &&
-        (strncmp(disk_path + strlen("/dev/"), "sd", strlen("sd")) == 0))
-        _sysfs_sas_addr_get(disk_path + strlen("/dev/"), tp_sas_addr);
+        (strncmp(disk_path + strlen("/dev/"), "sd", strlen("sd")) == 0)) {
+        /* Missing sysfs directory just means falling back to SCSI */
+        if (_sysfs_dev_dir_open(err_msg, disk_path + strlen("/dev/"),
+                                &tmp_dir_fd) == LSM_ERR_OK)
+            dev_dir_fd = tmp_dir_fd;
+        _lsm_err_msg_clear(err_msg);
+    }
+    if (dev_dir_fd >= 0)
+        _sysfs_sas_addr_get(dev_dir_fd, tp_sas_addr);
 
     if (tp_sas_addr[0] == '\0') {
         _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
@@ -1134,24 +1382,19 @@ static int _sas_addr_get(char *err_msg, const char *disk_path,
 out:
     if (fd >= 0)
         close(fd);
+    if (tmp_dir_fd >= 0)
+        close(tmp_dir_fd);
     return rc;
 }
 
-int LSM_DLL_EXPORT lsm_local_disk_led_status_get(const char *disk_path,
-                                                 uint32_t *led_status,
-                                                 lsm_error **lsm_err) {
+static int _led_status_get(char *err_msg, const char *disk_path,
+                           int dev_dir_fd, uint32_t *led_status) {
     int rc = LSM_ERR_OK;
-    char err_msg[_LSM_ERR_MSG_LEN];
     char tp_sas_addr[_SG_T10_SPL_SAS_ADDR_LEN];
     struct _ses_dev_slot_status status;
 
-    _lsm_err_msg_clear(err_msg);
-
-    _good(_check_null_ptr(err_msg, 3 /* arg_count */, disk_path, led_status,
-                          lsm_err),
-          rc, out);
-
-    _good(_sas_addr_get(err_msg, disk_path, tp_sas_addr), rc, out);
+    _good(_sas_addr_get(err_msg, disk_path, dev_dir_fd, tp_sas_addr), rc,
+          out);
 
     _good(_ses_status_get(err_msg, tp_sas_addr, &status), rc, out);
 
@@ -1167,6 +1410,26 @@ int LSM_DLL_EXPORT lsm_local_disk_led_status_get(const char *disk_path,
     else
         *led_status |= LSM_DISK_LED_STATUS_IDENT_OFF;
 
+out:
+    if (rc != LSM_ERR_OK)
+        *led_status = LSM_DISK_LED_STATUS_UNKNOWN;
+    return rc;
+}
+
+int LSM_DLL_EXPORT lsm_local_disk_led_status_get(const char *disk_path,
+                                                 uint32_t *led_status,
+                                                 lsm_error **lsm_err) {
+    int rc = LSM_ERR_OK;
+    char err_msg[_LSM_ERR_MSG_LEN];
+
+    _lsm_err_msg_clear(err_msg);
+
+    _good(_check_null_ptr(err_msg, 3 /* arg_count */, disk_path, led_status,
+                          lsm_err),
+          rc, out);
+
+    _good(_led_status_get(err_msg, disk_path, -1, led_status), rc, out);
+
 out:
     if (rc != LSM_ERR_OK) {
         if (led_status != NULL)
@@ -1177,60 +1440,32 @@ out:
     return rc;
 }
 
-int lsm_local_disk_link_speed_get(const char *disk_path, uint32_t *link_speed,
-                                  lsm_error **lsm_err) {
+static int _link_speed_of_fd(char *err_msg, const char *disk_path,
+                             int dev_dir_fd, int fd,
+                             lsm_disk_link_type link_type,
+                             uint32_t *link_speed) {
     int rc = LSM_ERR_OK;
-    int tmp_rc = LSM_ERR_OK;
-    lsm_error *tmp_lsm_err = NULL;
-    lsm_disk_link_type link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
-    int fd = -1;
-    char err_msg[_LSM_ERR_MSG_LEN];
     uint8_t vpd_data[_SG_T10_SPC_VPD_MAX_LEN];
     struct _sg_t10_vpd_ata_info *ata_info = NULL;
     uint8_t sas_mode_sense[_SG_T10_SPC_MODE_SENSE_MAX_LEN];
     char sas_addr[_SG_T10_SPL_SAS_ADDR_LEN];
     unsigned int host_no = UINT_MAX;
 
-    _lsm_err_msg_clear(err_msg);
-    rc = _check_null_ptr(err_msg, 3 /* argument count */, disk_path, link_speed,
-                         lsm_err);
-
-    if (rc != LSM_ERR_OK) {
-        /* set output pointers to NULL if possible when facing error in case
-         * application use output memory.
-         */
-        if (link_speed != NULL)
-            *link_speed = LSM_DISK_LINK_SPEED_UNKNOWN;
-
-        goto out;
-    }
-
     /* Workflow:
-     *  * Use lsm_local_disk_link_type_get() to find out link type:
-     *      * SATA
-     *          check vpd89(ATA Information VPD page) for
-     *          "IDENTIFY DEVICE data" ACS word 77 CURRENT NEGOTIATED SERIAL ATA
-     *          SIGNAL SPEED.
-     *      * SAS
-     *          SCSI MODE SENSE page 19h Protocol Specific Port,
-     *          subpage 01h Phy Control And Discover
-     *      * FC
-     *          Use SCSI_IOCTL_GET_BUS_NUMBER IOCTL to get SCSI host number,
-     *          then check file: /sys/class/fc_host/host9/speed
+     *  * SATA
+     *      check vpd89(ATA Information VPD page) for
+     *      "IDENTIFY DEVICE data" ACS word 77 CURRENT NEGOTIATED SERIAL ATA
+     *      SIGNAL SPEED.
+     *  * SAS
+     *      SCSI MODE SENSE page 19h Protocol Specific Port,
+     *      subpage 01h Phy Control And Discover
+     *  * FC
+     *      Use SCSI_IOCTL_GET_BUS_NUMBER IOCTL to get SCSI host number,
+     *      then check file: /sys/class/fc_host/host9/speed
      */
-
-    tmp_rc = lsm_local_disk_link_type_get(disk_path, &link_type, &tmp_lsm_err);
-    if (tmp_rc != LSM_ERR_OK) {
-        rc = tmp_rc;
-        _lsm_err_msg_set(err_msg, "%s", lsm_error_message_get(tmp_lsm_err));
-        lsm_error_free(tmp_lsm_err);
-        goto out;
-    }
-
     switch (link_type) {
     case LSM_DISK_LINK_TYPE_ATA:
         /* Check VPD 0x89(ATA Information VPD page) which is mandatory page */
-        _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
         _good(_sg_io_vpd(err_msg, fd, _SG_T10_SPC_VPD_ATA_INFO, vpd_data), rc,
               out);
         ata_info = (struct _sg_t10_vpd_ata_info *)vpd_data;
@@ -1239,8 +1474,8 @@ int lsm_local_disk_link_speed_get(const char *disk_path, uint32_t *link_speed,
             rc, out);
         break;
     case LSM_DISK_LINK_TYPE_SAS:
-        _good(_sas_addr_get(err_msg, disk_path, sas_addr), rc, out);
-        _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
+        _good(_sas_addr_get(err_msg, disk_path, dev_dir_fd, sas_addr), rc,
+              out);
         _good(_sg_io_mode_sense(err_msg, fd, _SCSI_MODE_SENSE_PSP_PAGE_CODE,
                                 _SCSI_MODE_SENSE_SAS_PHY_SUB_PAGE_CODE,
                                 sas_mode_sense),
@@ -1249,12 +1484,10 @@ int lsm_local_disk_link_speed_get(const char *disk_path, uint32_t *link_speed,
               rc, out);
         break;
     case LSM_DISK_LINK_TYPE_FC:
-        _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
         _good(_sg_host_no(err_msg, fd, &host_no), rc, out);
         _good(_fc_host_speed_get(err_msg, host_no, link_speed), rc, out);
         break;
     case LSM_DISK_LINK_TYPE_ISCSI:
-        _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
         _good(_sg_host_no(err_msg, fd, &host_no), rc, out);
         _good(_iscsi_host_speed_get(err_msg, host_no, link_speed), rc, out);
         break;
@@ -1265,6 +1498,36 @@ int lsm_local_disk_link_speed_get(const char *disk_path, uint32_t *link_speed,
         goto out;
     }
 
+out:
+    return rc;
+}
+
+int lsm_local_disk_link_speed_get(const char *disk_path, uint32_t *link_speed,
+                                  lsm_error **lsm_err) {
+    int rc = LSM_ERR_OK;
+    lsm_disk_link_type link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
+    int fd = -1;
+    char err_msg[_LSM_ERR_MSG_LEN];
+
+    _lsm_err_msg_clear(err_msg);
+    rc = _check_null_ptr(err_msg, 3 /* argument count */, disk_path, link_speed,
+                         lsm_err);
+
+    if (rc != LSM_ERR_OK) {
+        /* set output pointers to NULL if possible when facing error in case
+         * application use output memory.
+         */
+        if (link_speed != NULL)
+            *link_speed = LSM_DISK_LINK_SPEED_UNKNOWN;
+
+        goto out;
+    }
+
+    _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
+    _good(_link_type_of_fd(err_msg, fd, &link_type), rc, out);
+    _good(_link_speed_of_fd(err_msg, disk_path, -1, fd, link_type, link_speed),
+          rc, out);
+
 out:
     if (rc != LSM_ERR_OK) {
         if (lsm_err != NULL)
@@ -1279,3 +1542,453 @@ out:
 
     return rc;
 }
+
+int _local_disk_health_sample(char *err_msg, const char *disk_path,
+                              lsm_disk_link_type *link_type,
+                              uint32_t *link_speed, int32_t *health_status) {
+    int rc = LSM_ERR_OK;
+    int fd = -1;
+
+    assert(err_msg != NULL);
+    assert(disk_path != NULL);
+    assert(link_type != NULL);
+    assert(link_speed != NULL);
+    assert(health_status != NULL);
+
+    *link_speed = LSM_DISK_LINK_SPEED_UNKNOWN;
+    *health_status = LSM_DISK_HEALTH_STATUS_UNKNOWN;
+
+    _good(_sg_io_open_ro(err_msg, disk_path, &fd), rc, out);
+    if (*link_type == LSM_DISK_LINK_TYPE_UNKNOWN) {
+        rc = _link_type_of_fd(err_msg, fd, link_type);
+        if (rc != LSM_ERR_OK) {
+            *link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
+            goto out;
+        }
+    }
+    if (_link_speed_of_fd(err_msg, disk_path, -1, fd, *link_type,
+                          link_speed) != LSM_ERR_OK)
+        *link_speed = LSM_DISK_LINK_SPEED_UNKNOWN;
+    rc = _health_status_of_fd(err_msg, fd, *link_type, health_status);
+    if (rc != LSM_ERR_OK)
+        *health_status = LSM_DISK_HEALTH_STATUS_UNKNOWN;
+
+out:
+    if (fd >= 0)
+        close(fd);
+    return rc;
+}
+
+#define _LSM_LOCAL_DISK_INFO_MAGIC 0xAA7A0017
+#define _LSM_LOCAL_DISK_INFO_DEFAULT_WORKERS 16
+/* Disks opened at the same time by _local_disk_info_prefetch() */
+#define _LSM_LOCAL_DISK_INFO_PREFETCH_DISKS 32
+
+#define _LSM_IS_LOCAL_DISK_INFO(obj)                                           \
+    ((obj) != NULL && (obj)->magic == _LSM_LOCAL_DISK_INFO_MAGIC)
+
+struct _lsm_local_disk_info {
+    uint32_t magic;
+    char *disk_path;
+    char *vpd83;
+    char *serial_num;
+    int32_t rpm;
+    lsm_disk_link_type link_type;
+    uint32_t link_speed;
+    int32_t health_status;
+    uint32_t led_status;
+};
+
+/* What _local_disk_info_prefetch() learned of one disk */
+struct _local_disk_info_pre {
+    bool sup_done; /* 'ata_info' is valid */
+    bool ata_info; /* ATA Information VPD page is supported */
+    bool rpm_done; /* info->rpm is final */
+};
+
+/* SCSI commands of one disk sent by _local_disk_info_prefetch() */
+struct _local_disk_info_cmds {
+    lsm_local_disk_info *info;
+    struct _local_disk_info_pre *pre;
+    struct _sg_async *engine;
+    int fd;
+    struct _sg_async_cmd sup_cmd;
+    struct _sg_async_cmd bdc_cmd;
+    uint8_t *sup_data; /* uint8_t[_SG_T10_SPC_VPD_MAX_LEN] */
+    uint8_t bdc_data[_SG_T10_SBC_VPD_BLK_DEV_CHA_MAX_LEN];
+};
+
+/* Shared by the workers of lsm_local_disk_info_list() */
+struct _local_disk_info_queue {
+    pthread_mutex_t lock;
+    uint32_t next;
+    uint32_t count;
+    lsm_local_disk_info **infos;
+    struct _local_disk_info_pre *pres;
+};
+
+static lsm_local_disk_info *_local_disk_info_alloc(const char *disk_path) {
+    lsm_local_disk_info *info = NULL;
+
+    info = (lsm_local_disk_info *)calloc(1, sizeof(lsm_local_disk_info));
+    if (info == NULL)
+        return NULL;
+
+    info->disk_path = strdup(disk_path);
+    if (info->disk_path == NULL) {
+        free(info);
+        return NULL;
+    }
+    info->magic = _LSM_LOCAL_DISK_INFO_MAGIC;
+    info->rpm = LSM_DISK_RPM_UNKNOWN;
+    info->link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
+    info->link_speed = LSM_DISK_LINK_SPEED_UNKNOWN;
+    info->health_status = LSM_DISK_HEALTH_STATUS_UNKNOWN;
+    info->led_status = LSM_DISK_LED_STATUS_UNKNOWN;
+    return info;
+}
+
+static void _local_disk_info_bdc_done(struct _sg_async_cmd *cmd,
+                                      void *user_data) {
+    struct _local_disk_info_cmds *cmds =
+        (struct _local_disk_info_cmds *)user_data;
+    char err_msg[_LSM_ERR_MSG_LEN];
+
+    /* A failed command is retried by _rpm_of_fd() for its error handling */
+    if (cmd->result != 0)
+        return;
+    if (_rpm_of_vpd_data(err_msg, cmds->bdc_data, &cmds->info->rpm) !=
+        LSM_ERR_OK)
+        cmds->info->rpm = LSM_DISK_RPM_UNKNOWN;
+    cmds->pre->rpm_done = true;
+}
+
+static void _local_disk_info_sup_done(struct _sg_async_cmd *cmd,
+                                      void *user_data) {
+    struct _local_disk_info_cmds *cmds =
+        (struct _local_disk_info_cmds *)user_data;
+
+    if (cmd->result != 0)
+        return;
+    cmds->pre->sup_done = true;
+    cmds->pre->ata_info =
+        _sg_is_vpd_page_supported(cmds->sup_data, _SG_T10_SPC_VPD_ATA_INFO);
+
+    if (!_sg_is_vpd_page_supported(cmds->sup_data,
+                                   _SG_T10_SBC_VPD_BLK_DEV_CHA)) {
+        /* Same as _rpm_of_fd() failing with LSM_ERR_NO_SUPPORT */
+        cmds->info->rpm = LSM_DISK_RPM_UNKNOWN;
+        cmds->pre->rpm_done = true;
+        return;
+    }
+    _sg_io_vpd_cmd_init(&cmds->bdc_cmd, cmds->fd, _SG_T10_SBC_VPD_BLK_DEV_CHA,
+                        cmds->bdc_data);
+    cmds->bdc_cmd.done = _local_disk_info_bdc_done;
+    cmds->bdc_cmd.user_data = cmds;
+    _sg_async_submit(cmds->engine, &cmds->bdc_cmd);
+}
+
+/*
+ * Read the Supported VPD Pages page of every disk, then the Block Device
+ * Characteristics page of those listing it, with many commands in flight
+ * from the calling thread.  The workers then skip these two pages.  Disks
+ * are opened _LSM_LOCAL_DISK_INFO_PREFETCH_DISKS at a time.  A disk whose
+ * command failed is left to the blocking code path of the workers.
+ */
+static void _local_disk_info_prefetch(struct _local_disk_info_queue *queue) {
+    char err_msg[_LSM_ERR_MSG_LEN];
+    struct _local_disk_info_cmds *cmds = NULL;
+    struct _local_disk_info_cmds *cur = NULL;
+    struct _sg_async *engine = NULL;
+    bool shared = false;
+    uint32_t first = 0;
+    uint32_t n = 0;
+    uint32_t i = 0;
+
+    _lsm_err_msg_clear(err_msg);
+
+    cmds = (struct _local_disk_info_cmds *)calloc(
+        _LSM_LOCAL_DISK_INFO_PREFETCH_DISKS,
+        sizeof(struct _local_disk_info_cmds));
+    if (cmds == NULL)
+        return;
+    for (i = 0; i < _LSM_LOCAL_DISK_INFO_PREFETCH_DISKS; ++i) {
+        cmds[i].fd = -1;
+        cmds[i].sup_data = (uint8_t *)malloc(_SG_T10_SPC_VPD_MAX_LEN);
+        if (cmds[i].sup_data == NULL)
+            goto out;
+    }
+
+    if (_sg_io_batch_begin(err_msg, &engine, &shared) != LSM_ERR_OK)
+        goto out;
+
+    for (first = 0; first < queue->count; first += n) {
+        n = queue->count - first;
+        if (n > _LSM_LOCAL_DISK_INFO_PREFETCH_DISKS)
+            n = _LSM_LOCAL_DISK_INFO_PREFETCH_DISKS;
+
+        for (i = 0; i < n; ++i) {
+            cur = &cmds[i];
+            cur->info = queue->infos[first + i];
+            cur->pre = &queue->pres[first + i];
+            cur->engine = engine;
+            if (_sg_io_open_ro(err_msg, cur->info->disk_path, &cur->fd) !=
+                LSM_ERR_OK) {
+                cur->fd = -1;
+                continue;
+            }
+            _sg_io_vpd_cmd_init(&cur->sup_cmd, cur->fd,
+                                _SG_T10_SPC_VPD_SUP_VPD_PGS, cur->sup_data);
+            cur->sup_cmd.done = _local_disk_info_sup_done;
+            cur->sup_cmd.user_data = cur;
+            _sg_async_submit(engine, &cur->sup_cmd);
+        }
+        if (_sg_async_run(err_msg, engine) != LSM_ERR_OK)
+            break;
+        for (i = 0; i < n; ++i) {
+            if (cmds[i].fd >= 0)
+                close(cmds[i].fd);
+            cmds[i].fd = -1;
+        }
+    }
+
+    /* Waits for the commands left in flight by a failed _sg_async_run() */
+    _sg_io_batch_end(engine, shared);
+
+out:
+    for (i = 0; i < _LSM_LOCAL_DISK_INFO_PREFETCH_DISKS; ++i) {
+        if (cmds[i].fd >= 0)
+            close(cmds[i].fd);
+        free(cmds[i].sup_data);
+    }
+    free(cmds);
+}
+
+/*
+ * Fill all the attributes of one disk, opening it only once for all the
+ * SCSI commands and its sysfs directory only once for all the sysfs
+ * attributes. Attributes which could not be queried keep their unknown
+ * value. The ones already found by _local_disk_info_prefetch() are not
+ * queried again.
+ */
+static void _local_disk_info_collect(lsm_local_disk_info *info,
+                                     struct _local_disk_info_pre *pre) {
+    char err_msg[_LSM_ERR_MSG_LEN];
+    const char *sd_name = NULL;
+    int dev_dir_fd = -1;
+    int fd = -1;
+    int rc = LSM_ERR_OK;
+
+    _lsm_err_msg_clear(err_msg);
+
+    /* Both are read from sysfs or udev when possible */
+    if (strncmp(info->disk_path, "/dev/sd", strlen("/dev/sd")) == 0) {
+        sd_name = info->disk_path + strlen("/dev/");
+        if (_sysfs_dev_dir_open(err_msg, sd_name, &dev_dir_fd) ==
+            LSM_ERR_OK) {
+            _vpd83_of_sd_name(err_msg, dev_dir_fd, sd_name, &info->vpd83);
+            _serial_num_of_sd_name(err_msg, dev_dir_fd, sd_name,
+                                   &info->serial_num);
+        }
+    }
+    /* Queried from the enclosure, not from the disk */
+    _led_status_get(err_msg, info->disk_path, dev_dir_fd, &info->led_status);
+
+    if (_sg_io_open_ro(err_msg, info->disk_path, &fd) != LSM_ERR_OK)
+        goto out;
+
+    if (!pre->rpm_done && (_rpm_of_fd(err_msg, fd, &info->rpm) != LSM_ERR_OK))
+        info->rpm = LSM_DISK_RPM_UNKNOWN;
+
+    if (pre->sup_done)
+        rc = _link_type_of_fd_sup(err_msg, fd, pre->ata_info,
+                                  &info->link_type);
+    else
+        rc = _link_type_of_fd(err_msg, fd, &info->link_type);
+    if (rc != LSM_ERR_OK) {
+        info->link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
+        goto out;
+    }
+    if (_link_speed_of_fd(err_msg, info->disk_path, dev_dir_fd, fd,
+                          info->link_type,
+                          &info->link_speed) != LSM_ERR_OK)
+        info->link_speed = LSM_DISK_LINK_SPEED_UNKNOWN;
+    if (_health_status_of_fd(err_msg, fd, info->link_type,
+                             &info->health_status) != LSM_ERR_OK)
+        info->health_status = LSM_DISK_HEALTH_STATUS_UNKNOWN;
+
+out:
+    if (fd >= 0)
+        close(fd);
+    if (dev_dir_fd >= 0)
+        close(dev_dir_fd);
+}
+
+static void *_local_disk_info_worker(void *data) {
+    struct _local_disk_info_queue *queue =
+        (struct _local_disk_info_queue *)data;
+    uint32_t i = 0;
+
+    while (1) {
+        pthread_mutex_lock(&queue->lock);
+        i = queue->next++;
+        pthread_mutex_unlock(&queue->lock);
+        if (i >= queue->count)
+            break;
+        _local_disk_info_collect(queue->infos[i], &queue->pres[i]);
+    }
+    return NULL;
+}
+
+int lsm_local_disk_info_list(uint32_t worker_count,
+                             lsm_local_disk_info ***infos, uint32_t *count,
+                             lsm_error **lsm_err) {
+    int rc = LSM_ERR_OK;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    lsm_string_list *disk_paths = NULL;
+    lsm_error *tmp_lsm_err = NULL;
+    struct _local_disk_info_queue queue;
+    pthread_t *workers = NULL;
+    uint32_t started = 0;
+    uint32_t i = 0;
+
+    _lsm_err_msg_clear(err_msg);
+    memset(&queue, 0, sizeof(queue));
+
+    rc = _check_null_ptr(err_msg, 3 /* argument count */, infos, count,
+                         lsm_err);
+    if (rc != LSM_ERR_OK) {
+        if (infos != NULL)
+            *infos = NULL;
+        if (count != NULL)
+            *count = 0;
+        goto out;
+    }
+
+    *infos = NULL;
+    *count = 0;
+    *lsm_err = NULL;
+
+    rc = lsm_local_disk_list(&disk_paths, &tmp_lsm_err);
+    if (rc != LSM_ERR_OK) {
+        _lsm_err_msg_set(err_msg, "%s", lsm_error_message_get(tmp_lsm_err));
+        lsm_error_free(tmp_lsm_err);
+        goto out;
+    }
+
+    queue.count = lsm_string_list_size(disk_paths);
+    queue.infos = (lsm_local_disk_info **)calloc(
+        queue.count + 1, sizeof(lsm_local_disk_info *));
+    _alloc_null_check(err_msg, queue.infos, rc, out);
+
+    for (i = 0; i < queue.count; ++i) {
+        queue.infos[i] =
+            _local_disk_info_alloc(lsm_string_list_elem_get(disk_paths, i));
+        _alloc_null_check(err_msg, queue.infos[i], rc, out);
+    }
+    queue.pres = (struct _local_disk_info_pre *)calloc(
+        queue.count + 1, sizeof(struct _local_disk_info_pre));
+    _alloc_null_check(err_msg, queue.pres, rc, out);
+
+    if (queue.count > 0)
+        _local_disk_info_prefetch(&queue);
+
+    if (worker_count == 0)
+        worker_count = _LSM_LOCAL_DISK_INFO_DEFAULT_WORKERS;
+    if (worker_count > queue.count)
+        worker_count = queue.count;
+
+    pthread_mutex_init(&queue.lock, NULL);
+
+    /* The calling thread is one of the workers */
+    if (worker_count > 1) {
+        workers = (pthread_t *)calloc(worker_count - 1, sizeof(pthread_t));
+        for (; (workers != NULL) && (started < worker_count - 1); ++started) {
+            /* Carry on with fewer workers if no more threads are allowed */
+            if (pthread_create(&workers[started], NULL,
+                               _local_disk_info_worker, &queue) != 0)
+                break;
+        }
+    }
+    _local_disk_info_worker(&queue);
+    for (i = 0; i < started; ++i)
+        pthread_join(workers[i], NULL);
+
+    pthread_mutex_destroy(&queue.lock);
+
+out:
+    free(workers);
+    free(queue.pres);
+    if (disk_paths != NULL)
+        lsm_string_list_free(disk_paths);
+
+    if (rc == LSM_ERR_OK) {
+        *infos = queue.infos;
+        *count = queue.count;
+    } else {
+        lsm_local_disk_info_array_free(queue.infos, queue.count);
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+    }
+    return rc;
+}
+
+void lsm_local_disk_info_array_free(lsm_local_disk_info **infos,
+                                    uint32_t count) {
+    uint32_t i = 0;
+
+    if (infos == NULL)
+        return;
+
+    for (i = 0; i < count; ++i) {
+        if (!_LSM_IS_LOCAL_DISK_INFO(infos[i]))
+            continue;
+        infos[i]->magic = 0;
+        free(infos[i]->disk_path);
+        free(infos[i]->vpd83);
+        free(infos[i]->serial_num);
+        free(infos[i]);
+    }
+    free(infos);
+}
+
+const char *lsm_local_disk_info_disk_path_get(lsm_local_disk_info *info) {
+    return _LSM_IS_LOCAL_DISK_INFO(info) ? info->disk_path : NULL;
+}
+
+const char *lsm_local_disk_info_vpd83_get(lsm_local_disk_info *info) {
+    if (!_LSM_IS_LOCAL_DISK_INFO(info))
+        return NULL;
+    return info->vpd83 != NULL ? info->vpd83 : "";
+}
+
+const char *lsm_local_disk_info_serial_num_get(lsm_local_disk_info *info) {
+    if (!_LSM_IS_LOCAL_DISK_INFO(info))
+        return NULL;
+    return info->serial_num != NULL ? info->serial_num : "";
+}
+
+int32_t lsm_local_disk_info_rpm_get(lsm_local_disk_info *info) {
+    return _LSM_IS_LOCAL_DISK_INFO(info) ? info->rpm : LSM_DISK_RPM_UNKNOWN;
+}
+
+lsm_disk_link_type
+lsm_local_disk_info_link_type_get(lsm_local_disk_info *info) {
+    return _LSM_IS_LOCAL_DISK_INFO(info) ? info->link_type
+                                         : LSM_DISK_LINK_TYPE_UNKNOWN;
+}
+
+uint32_t lsm_local_disk_info_link_speed_get(lsm_local_disk_info *info) {
+    return _LSM_IS_LOCAL_DISK_INFO(info) ? info->link_speed
+                                         : LSM_DISK_LINK_SPEED_UNKNOWN;
+}
+
+int32_t lsm_local_disk_info_health_status_get(lsm_local_disk_info *info) {
+    return _LSM_IS_LOCAL_DISK_INFO(info) ? info->health_status
+                                         : LSM_DISK_HEALTH_STATUS_UNKNOWN;
+}
+
+uint32_t lsm_local_disk_info_led_status_get(lsm_local_disk_info *info) {
+    return _LSM_IS_LOCAL_DISK_INFO(info) ? info->led_status
+                                         : LSM_DISK_LED_STATUS_UNKNOWN;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _LSM_LOCAL_DISK_H_
+#define _LSM_LOCAL_DISK_H_
+
+#include <stdint.h>
+
+#include "libstoragemgmt/libstoragemgmt_common.h"
+#include "libstoragemgmt/libstoragemgmt_types.h"
+
+/*
+ * Preconditions:
+ *  err_msg != NULL
+ *  disk_path != NULL
+ *  link_type != NULL
+ *  link_speed != NULL
+ *  health_status != NULL
+ *
+ * Query the link speed and health status of one disk, opening it only once.
+ * The link type is only derived from the VPD pages when '*link_type' is
+ * LSM_DISK_LINK_TYPE_UNKNOWN, so callers sampling the same disk again could
+ * pass the one of the previous call.  On failure to derive it, '*link_type'
+ * is set to LSM_DISK_LINK_TYPE_UNKNOWN.  Failing to query the link speed
+ * only sets '*link_speed' to LSM_DISK_LINK_SPEED_UNKNOWN.
+ * Return:
+ *  Same as lsm_local_disk_health_status_get().
+ */
+LSM_DLL_LOCAL int _local_disk_health_sample(char *err_msg,
+                                            const char *disk_path,
+                                            lsm_disk_link_type *link_type,
+                                            uint32_t *link_speed,
+                                            int32_t *health_status);
+
+#endif /* End of _LSM_LOCAL_DISK_H_ */
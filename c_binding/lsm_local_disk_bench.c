@@ -0,0 +1,760 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Benchmark of the local disk queries against simulated SAS disks and SES
+ * enclosures, no hardware required.
+ *
+ * A fixture of /sys and /dev is built in a temporary directory used by
+ * _fs_root_set(), the SCSI commands are answered by the fake backend of
+ * libsg_fake.h via _sg_io_backend_set():
+ *
+ *  - /sys/block/sdX/device/{vpd_pg80,vpd_pg83,sas_address} and /dev/sdX for
+ *    each disk, which all reply the same VPD, MODE SENSE and LOG SENSE data,
+ *  - /sys/class/bsg/N:0:0:0/device/type and /dev/bsg/N:0:0:0 for each
+ *    enclosure, which replies SES pages holding the SAS addresses of its
+ *    share of the disks.
+ *
+ * lsm_local_disk_list() lists the fixture disks, then each query runs on
+ * every disk for a few rounds, the first round of
+ * lsm_local_disk_led_status_get() includes scanning the enclosures.
+ * A local disk sampler is started once, its first round is timed, then
+ * lookups of its shared memory table are timed along the other queries.
+ * Reports microseconds and SCSI commands per disk.  The results are checked
+ * against the fixture, any mismatch fails the benchmark.
+ *
+ * These functions are internal to the library, so the benchmark is linked
+ * with the library sources instead of the shared library.
+ *
+ * Usage: lsm_local_disk_bench [disk_count] [enclosure_count] [rounds]
+ */
+
+#include "libsg.h"
+#include "libsg_fake.h"
+#include "utils.h"
+
+#include "libstoragemgmt/libstoragemgmt.h"
+
+#include <endian.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <scsi/scsi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_DISK_COUNT       1000
+#define BENCH_ENC_COUNT        20
+#define BENCH_ROUNDS           3
+#define BENCH_NAA_BASE         0x5000c50000000000ULL
+#define BENCH_RPM              7200
+#define BENCH_SES_GEN_CODE     1
+#define BENCH_RECV_DIAG_OPCODE 0x1c
+#define BENCH_SEND_DIAG_OPCODE 0x1d
+#define BENCH_SES_ADD_DP_LEN   36
+#define BENCH_PATH_MAX         256
+#define BENCH_PAGE_MAX         0xffff
+/* Long enough for the sampler to run only its first round */
+#define BENCH_SAMPLER_INTERVAL_MS 3600000
+
+typedef int (*bench_query)(const char *disk_path, uint32_t i);
+
+/* Enclosure status page, updated by SEND DIAGNOSTIC control pages */
+struct bench_enc {
+    uint8_t *status;
+    uint32_t status_len;
+    uint32_t slot_count;
+};
+
+static char root[] = "/tmp/lsm_local_disk_bench.XXXXXX";
+static struct _sg_fake *fake = NULL;
+static uint32_t disk_count = BENCH_DISK_COUNT;
+static uint32_t enc_count = BENCH_ENC_COUNT;
+static struct bench_enc *encs = NULL;
+static lsm_local_disk_health_table *health_table = NULL;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void die(const char *what) {
+    fprintf(stderr, "%s failed: %s\n", what, strerror(errno));
+    exit(EXIT_FAILURE);
+}
+
+/* Same naming as the sd driver: sda .. sdz, sdaa .. sdzz, sdaaa .. */
+static void disk_name(uint32_t i, char *name) {
+    char suffix[8];
+    int len = 0;
+    int j = 0;
+
+    do {
+        suffix[len++] = 'a' + i % 26;
+        i /= 26;
+    } while (i-- > 0);
+
+    strcpy(name, "sd");
+    for (j = 0; j < len; ++j)
+        name[2 + j] = suffix[len - 1 - j];
+    name[2 + len] = '\0';
+}
+
+static uint64_t disk_naa(uint32_t i) { return BENCH_NAA_BASE + i * 4; }
+
+static uint64_t disk_sas_addr(uint32_t i) { return disk_naa(i) + 1; }
+
+static void fixture_mkdir(const char *path) {
+    char full_path[PATH_MAX];
+    char *p = NULL;
+
+    snprintf(full_path, sizeof(full_path), "%s%s", root, path);
+    for (p = full_path + strlen(root) + 1; *p != '\0'; ++p) {
+        if (*p != '/')
+            continue;
+        *p = '\0';
+        if ((mkdir(full_path, 0755) != 0) && (errno != EEXIST))
+            die("mkdir");
+        *p = '/';
+    }
+    if ((mkdir(full_path, 0755) != 0) && (errno != EEXIST))
+        die("mkdir");
+}
+
+static void fixture_write(const char *path, const void *data, size_t len) {
+    char full_path[PATH_MAX];
+    int fd = -1;
+
+    snprintf(full_path, sizeof(full_path), "%s%s", root, path);
+    fd = open(full_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        die("open");
+    if ((len > 0) && (write(fd, data, len) != (ssize_t)len))
+        die("write");
+    close(fd);
+}
+
+static void fixture_disk(uint32_t i) {
+    char name[16];
+    char path[BENCH_PATH_MAX];
+    char sas_addr[32];
+    uint8_t vpd80[4 + 20];
+    uint8_t vpd83[4 + 4 + 8];
+    uint64_t naa_be = htobe64(disk_naa(i));
+
+    disk_name(i, name);
+
+    snprintf(path, sizeof(path), "/sys/block/%s/device", name);
+    fixture_mkdir(path);
+
+    /* SPC-5 Unit Serial Number VPD page */
+    memset(vpd80, 0, sizeof(vpd80));
+    vpd80[1] = 0x80;
+    snprintf((char *)vpd80 + 4, sizeof(vpd80) - 4, "BENCH%010" PRIu32, i);
+    vpd80[3] = strlen((char *)vpd80 + 4);
+    snprintf(path, sizeof(path), "/sys/block/%s/device/vpd_pg80", name);
+    fixture_write(path, vpd80, 4 + vpd80[3]);
+
+    /* Device Identification VPD page with NAA logical unit designator */
+    memset(vpd83, 0, sizeof(vpd83));
+    vpd83[1] = 0x83;
+    vpd83[3] = sizeof(vpd83) - 4;
+    vpd83[4] = 0x01; /* Binary */
+    vpd83[5] = 0x03; /* Logical unit, NAA */
+    vpd83[7] = 8;
+    memcpy(vpd83 + 8, &naa_be, 8);
+    snprintf(path, sizeof(path), "/sys/block/%s/device/vpd_pg83", name);
+    fixture_write(path, vpd83, sizeof(vpd83));
+
+    snprintf(sas_addr, sizeof(sas_addr), "0x%016" PRIx64 "\n",
+             disk_sas_addr(i));
+    snprintf(path, sizeof(path), "/sys/block/%s/device/sas_address", name);
+    fixture_write(path, sas_addr, strlen(sas_addr));
+
+    /* The bsg of disk, skipped when searching enclosures */
+    snprintf(path, sizeof(path), "/sys/class/bsg/%" PRIu32 ":0:0:0/device",
+             enc_count + i);
+    fixture_mkdir(path);
+    snprintf(path, sizeof(path), "/sys/class/bsg/%" PRIu32 ":0:0:0/device/type",
+             enc_count + i);
+    fixture_write(path, "0\n", 2);
+
+    snprintf(path, sizeof(path), "/dev/%s", name);
+    fixture_write(path, NULL, 0);
+}
+
+static void reply_add(const char *path, int opcode, int page_code,
+                      const uint8_t *data, uint32_t data_len,
+                      int (*handler)(struct _sg_async_cmd *cmd, void *data),
+                      void *handler_data) {
+    struct _sg_fake_reply reply;
+    int rc = 0;
+
+    memset(&reply, 0, sizeof(reply));
+    reply.data = data;
+    reply.data_len = data_len;
+    reply.handler = handler;
+    reply.handler_data = handler_data;
+    if (path == NULL)
+        rc = _sg_fake_reply_add(fake, -1, opcode, page_code, 0, &reply);
+    else
+        rc = _sg_fake_reply_add_path(fake, path, opcode, page_code, 0, &reply);
+    if (rc != 0) {
+        errno = rc;
+        die("_sg_fake_reply_add");
+    }
+}
+
+static int ses_status_reply(struct _sg_async_cmd *cmd, void *data) {
+    struct bench_enc *bench_enc = (struct bench_enc *)data;
+
+    memcpy(cmd->data, bench_enc->status,
+           bench_enc->status_len < cmd->data_len ? bench_enc->status_len
+                                                 : cmd->data_len);
+    return 0;
+}
+
+/*
+ * Apply the RQST IDENT and RQST FAULT bits of selected slot elements of the
+ * control page to the status page.
+ */
+static int ses_ctrl_reply(struct _sg_async_cmd *cmd, void *data) {
+    struct bench_enc *bench_enc = (struct bench_enc *)data;
+    uint8_t *ctrl = NULL;
+    uint8_t *status = NULL;
+    uint32_t i = 0;
+
+    for (i = 1; i <= bench_enc->slot_count; ++i) {
+        if (8 + 4 * i + 4 > cmd->data_len)
+            break;
+        ctrl = cmd->data + 8 + 4 * i;
+        status = bench_enc->status + 8 + 4 * i;
+        if (!(ctrl[0] & 0x80))
+            continue;
+        status[2] = (status[2] & ~0x02) | (ctrl[2] & 0x02);
+        status[3] = (status[3] & ~0x20) | (ctrl[3] & 0x20);
+    }
+    return 0;
+}
+
+/*
+ * SES-3 pages of enclosure holding disks [first, first + slot_count), as
+ * one array device slot element per disk.
+ */
+static void fixture_enclosure(uint32_t enc, uint32_t first,
+                              uint32_t slot_count) {
+    char path[BENCH_PATH_MAX];
+    char bsg_path[BENCH_PATH_MAX];
+    uint8_t *page = NULL;
+    uint8_t *dp = NULL;
+    uint32_t gen_be = htobe32(BENCH_SES_GEN_CODE);
+    uint64_t sas_be = 0;
+    uint32_t len = 0;
+    uint32_t i = 0;
+    struct bench_enc *bench_enc = &encs[enc];
+
+    page = (uint8_t *)calloc(1, BENCH_PAGE_MAX);
+    if (page == NULL)
+        die("calloc");
+
+    snprintf(path, sizeof(path), "/sys/class/bsg/%" PRIu32 ":0:0:0/device",
+             enc);
+    fixture_mkdir(path);
+    snprintf(path, sizeof(path), "/sys/class/bsg/%" PRIu32 ":0:0:0/device/type",
+             enc);
+    fixture_write(path, "13\n", 3);
+    snprintf(bsg_path, sizeof(bsg_path), "/dev/bsg/%" PRIu32 ":0:0:0", enc);
+    fixture_write(bsg_path, NULL, 0);
+
+    /* Configuration page: one enclosure, one type descriptor header */
+    memset(page, 0, BENCH_PAGE_MAX);
+    page[0] = 0x01;
+    memcpy(page + 4, &gen_be, 4);
+    page[8 + 2] = 1;
+    page[8 + 3] = 36;
+    page[8 + 40] = 0x17; /* Array device slot */
+    page[8 + 41] = slot_count;
+    len = 8 + 40 + 4;
+    page[2] = (len - 4) >> 8;
+    page[3] = (len - 4) & 0xff;
+    reply_add(bsg_path, BENCH_RECV_DIAG_OPCODE, 0x01, page, len, NULL, NULL);
+
+    /* Status page: overall element then all slots, all LEDs off */
+    len = 8 + 4 * (slot_count + 1);
+    bench_enc->status = (uint8_t *)calloc(1, len);
+    if (bench_enc->status == NULL)
+        die("calloc");
+    bench_enc->status_len = len;
+    bench_enc->slot_count = slot_count;
+    bench_enc->status[0] = 0x02;
+    bench_enc->status[2] = (len - 4) >> 8;
+    bench_enc->status[3] = (len - 4) & 0xff;
+    memcpy(bench_enc->status + 4, &gen_be, 4);
+    reply_add(bsg_path, BENCH_RECV_DIAG_OPCODE, 0x02, NULL, 0,
+              ses_status_reply, bench_enc);
+
+    /* Additional element status page: SAS descriptor of each slot */
+    memset(page, 0, BENCH_PAGE_MAX);
+    page[0] = 0x0a;
+    memcpy(page + 4, &gen_be, 4);
+    for (i = 0; i < slot_count; ++i) {
+        dp = page + 8 + BENCH_SES_ADD_DP_LEN * i;
+        dp[0] = 0x16; /* EIP, SAS */
+        dp[1] = BENCH_SES_ADD_DP_LEN - 2;
+        dp[2] = 1; /* Element index includes overall elements */
+        dp[3] = i + 1;
+        dp[4] = 1; /* One phy */
+        sas_be = htobe64(disk_sas_addr(first + i));
+        memcpy(dp + 8 + 12, &sas_be, 8);
+    }
+    len = 8 + BENCH_SES_ADD_DP_LEN * slot_count;
+    page[2] = (len - 4) >> 8;
+    page[3] = (len - 4) & 0xff;
+    reply_add(bsg_path, BENCH_RECV_DIAG_OPCODE, 0x0a, page, len, NULL, NULL);
+
+    reply_add(bsg_path, BENCH_SEND_DIAG_OPCODE, -1, NULL, 0, ses_ctrl_reply,
+              bench_enc);
+
+    free(page);
+}
+
+static void fixture_replies(void) {
+    /* Supported VPD pages, no ATA information page */
+    const uint8_t vpd00[] = {0, 0x00, 0, 4, 0x00, 0x80, 0x83, 0xb1};
+    /* Block Device Characteristics VPD page */
+    const uint8_t vpdb1[] = {0,    0xb1, 0, 0x3c, BENCH_RPM >> 8,
+                             BENCH_RPM & 0xff};
+    /* Device Identification VPD page with SAS target port designator */
+    const uint8_t vpd83[] = {0,    0x83, 0,    12,   0x61, 0x93, 0, 8,
+                             0x50, 0x00, 0xc5, 0x00, 0,    0,    0, 1};
+    /* MODE SENSE(10) header, Informational Exceptions Control page, MRIE 0 */
+    const uint8_t ie_mode[] = {0, 18, 0, 0, 0, 0, 0, 0,
+                               0x1c, 0x0a, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    /* Informational Exceptions log page, ASC 0 */
+    const uint8_t ie_log[] = {0x2f, 0, 0, 8, 0, 0, 0x03, 4, 0, 0, 0x26, 0};
+
+    reply_add(NULL, INQUIRY, 0x00, vpd00, sizeof(vpd00), NULL, NULL);
+    reply_add(NULL, INQUIRY, 0xb1, vpdb1, sizeof(vpdb1), NULL, NULL);
+    reply_add(NULL, INQUIRY, 0x83, vpd83, sizeof(vpd83), NULL, NULL);
+    reply_add(NULL, MODE_SENSE_10, 0x1c, ie_mode, sizeof(ie_mode), NULL, NULL);
+    reply_add(NULL, LOG_SENSE, 0x40 | 0x2f, ie_log, sizeof(ie_log), NULL, NULL);
+}
+
+static void fixture_build(void) {
+    uint32_t enc = 0;
+    uint32_t first = 0;
+    uint32_t slot_count = 0;
+    uint32_t i = 0;
+    char err_msg[_LSM_ERR_MSG_LEN];
+
+    if (mkdtemp(root) == NULL)
+        die("mkdtemp");
+    fixture_mkdir("/dev/bsg");
+    fixture_mkdir("/sys/class/bsg");
+
+    fake = _sg_fake_new();
+    encs = (struct bench_enc *)calloc(enc_count, sizeof(struct bench_enc));
+    if ((fake == NULL) || (encs == NULL))
+        die("_sg_fake_new");
+
+    for (i = 0; i < disk_count; ++i)
+        fixture_disk(i);
+    for (enc = 0; enc < enc_count; ++enc) {
+        first = disk_count * enc / enc_count;
+        slot_count = disk_count * (enc + 1) / enc_count - first;
+        fixture_enclosure(enc, first, slot_count);
+    }
+    fixture_replies();
+
+    if ((_fs_root_set(root) != LSM_ERR_OK) ||
+        (_sg_io_backend_set(err_msg, &_sg_fake_backend, fake) != LSM_ERR_OK)) {
+        fprintf(stderr, "Failed to use fixture: %s\n", err_msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void fixture_remove(void) {
+    char cmd[BENCH_PATH_MAX];
+
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", root);
+    if (system(cmd) != 0)
+        fprintf(stderr, "Failed to remove %s\n", root);
+}
+
+static int check_rc(int rc, lsm_error *lsm_err, const char *disk_path) {
+    if (rc != LSM_ERR_OK) {
+        fprintf(stderr, "%s: error %d: %s\n", disk_path, rc,
+                lsm_err ? lsm_error_message_get(lsm_err) : "");
+    }
+    if (lsm_err != NULL)
+        lsm_error_free(lsm_err);
+    return rc;
+}
+
+static int query_serial_num(const char *disk_path, uint32_t i) {
+    lsm_error *lsm_err = NULL;
+    char *serial_num = NULL;
+    char expected[32];
+    int rc = 0;
+
+    rc = lsm_local_disk_serial_num_get(disk_path, &serial_num, &lsm_err);
+    if (check_rc(rc, lsm_err, disk_path) != LSM_ERR_OK)
+        return rc;
+    snprintf(expected, sizeof(expected), "BENCH%010" PRIu32, i);
+    rc = strcmp(serial_num, expected) == 0 ? 0 : -1;
+    free(serial_num);
+    return rc;
+}
+
+static int query_vpd83(const char *disk_path, uint32_t i) {
+    lsm_error *lsm_err = NULL;
+    char *vpd83 = NULL;
+    char expected[32];
+    int rc = 0;
+
+    rc = lsm_local_disk_vpd83_get(disk_path, &vpd83, &lsm_err);
+    if (check_rc(rc, lsm_err, disk_path) != LSM_ERR_OK)
+        return rc;
+    snprintf(expected, sizeof(expected), "%016" PRIx64, disk_naa(i));
+    rc = strcmp(vpd83, expected) == 0 ? 0 : -1;
+    free(vpd83);
+    return rc;
+}
+
+static int query_rpm(const char *disk_path, uint32_t i) {
+    lsm_error *lsm_err = NULL;
+    int32_t rpm = 0;
+    int rc = 0;
+
+    (void)i;
+    rc = lsm_local_disk_rpm_get(disk_path, &rpm, &lsm_err);
+    if (check_rc(rc, lsm_err, disk_path) != LSM_ERR_OK)
+        return rc;
+    return rpm == BENCH_RPM ? 0 : -1;
+}
+
+static int query_link_type(const char *disk_path, uint32_t i) {
+    lsm_error *lsm_err = NULL;
+    lsm_disk_link_type link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
+    int rc = 0;
+
+    (void)i;
+    rc = lsm_local_disk_link_type_get(disk_path, &link_type, &lsm_err);
+    if (check_rc(rc, lsm_err, disk_path) != LSM_ERR_OK)
+        return rc;
+    return link_type == LSM_DISK_LINK_TYPE_SAS ? 0 : -1;
+}
+
+static int query_health(const char *disk_path, uint32_t i) {
+    lsm_error *lsm_err = NULL;
+    int32_t health_status = LSM_DISK_HEALTH_STATUS_UNKNOWN;
+    int rc = 0;
+
+    (void)i;
+    rc = lsm_local_disk_health_status_get(disk_path, &health_status,
+                                          &lsm_err);
+    if (check_rc(rc, lsm_err, disk_path) != LSM_ERR_OK)
+        return rc;
+    return health_status == LSM_DISK_HEALTH_STATUS_GOOD ? 0 : -1;
+}
+
+static int query_health_table(const char *disk_path, uint32_t i) {
+    lsm_error *lsm_err = NULL;
+    int32_t health_status = LSM_DISK_HEALTH_STATUS_UNKNOWN;
+    lsm_disk_link_type link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
+    uint32_t link_speed = 0;
+    uint64_t sample_time = 0;
+    int rc = 0;
+
+    (void)i;
+    rc = lsm_local_disk_health_table_get(health_table, disk_path,
+                                         &health_status, &link_type,
+                                         &link_speed, &sample_time, &lsm_err);
+    if (check_rc(rc, lsm_err, disk_path) != LSM_ERR_OK)
+        return rc;
+    return (health_status == LSM_DISK_HEALTH_STATUS_GOOD) &&
+                   (link_type == LSM_DISK_LINK_TYPE_SAS) && (sample_time > 0)
+               ? 0
+               : -1;
+}
+
+static int led_status_check(const char *disk_path, uint32_t expected) {
+    lsm_error *lsm_err = NULL;
+    uint32_t led_status = 0;
+    int rc = 0;
+
+    rc = lsm_local_disk_led_status_get(disk_path, &led_status, &lsm_err);
+    if (check_rc(rc, lsm_err, disk_path) != LSM_ERR_OK)
+        return rc;
+    return led_status == expected ? 0 : -1;
+}
+
+static int query_led_status(const char *disk_path, uint32_t i) {
+    (void)i;
+    return led_status_check(disk_path, LSM_DISK_LED_STATUS_FAULT_OFF |
+                                           LSM_DISK_LED_STATUS_IDENT_OFF);
+}
+
+static int query_led_ident_on(const char *disk_path, uint32_t i) {
+    (void)i;
+    return led_status_check(disk_path, LSM_DISK_LED_STATUS_FAULT_OFF |
+                                           LSM_DISK_LED_STATUS_IDENT_ON);
+}
+
+static void bench(const char *name, bench_query query,
+                  lsm_string_list *disk_paths, uint32_t round) {
+    uint64_t start = 0;
+    uint64_t ns = 0;
+    uint32_t submitted = _sg_fake_submitted_get(fake);
+    uint32_t i = 0;
+
+    start = now_ns();
+    for (i = 0; i < disk_count; ++i) {
+        if (query(lsm_string_list_elem_get(disk_paths, i), i) != 0) {
+            fprintf(stderr, "%s: wrong result for %s\n", name,
+                    lsm_string_list_elem_get(disk_paths, i));
+            fixture_remove();
+            exit(EXIT_FAILURE);
+        }
+    }
+    ns = now_ns() - start;
+
+    printf("%-28s %6" PRIu32 " %10.1f %12.1f %10.2f\n", name, round,
+           (double)ns / 1e6, (double)ns / 1e3 / disk_count,
+           (double)(_sg_fake_submitted_get(fake) - submitted) / disk_count);
+    fflush(stdout);
+}
+
+static void bench_led_batch(const char *name,
+                            int (*batch)(lsm_string_list *disk_paths,
+                                         lsm_error **lsm_err),
+                            lsm_string_list *disk_paths, uint32_t round) {
+    lsm_error *lsm_err = NULL;
+    uint64_t start = 0;
+    uint64_t ns = 0;
+    uint32_t submitted = _sg_fake_submitted_get(fake);
+    int rc = 0;
+
+    start = now_ns();
+    rc = batch(disk_paths, &lsm_err);
+    ns = now_ns() - start;
+    if (check_rc(rc, lsm_err, "all disks") != LSM_ERR_OK) {
+        fixture_remove();
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%-28s %6" PRIu32 " %10.1f %12.1f %10.2f\n", name, round,
+           (double)ns / 1e6, (double)ns / 1e3 / disk_count,
+           (double)(_sg_fake_submitted_get(fake) - submitted) / disk_count);
+    fflush(stdout);
+}
+
+/*
+ * lsm_local_disk_info_list() with the default worker count, its first
+ * SCSI commands go through the engine of _sg_io_backend_set() in one batch.
+ */
+static void bench_info_list(uint32_t round) {
+    lsm_local_disk_info **infos = NULL;
+    lsm_error *lsm_err = NULL;
+    uint32_t submitted = _sg_fake_submitted_get(fake);
+    uint32_t count = 0;
+    uint64_t start = 0;
+    uint64_t ns = 0;
+    uint32_t i = 0;
+    int rc = 0;
+
+    start = now_ns();
+    rc = lsm_local_disk_info_list(0, &infos, &count, &lsm_err);
+    ns = now_ns() - start;
+    if (check_rc(rc, lsm_err, "all disks") != LSM_ERR_OK) {
+        fixture_remove();
+        exit(EXIT_FAILURE);
+    }
+    rc = count == disk_count ? 0 : -1;
+    for (i = 0; (rc == 0) && (i < count); ++i) {
+        if ((lsm_local_disk_info_rpm_get(infos[i]) != BENCH_RPM) ||
+            (lsm_local_disk_info_link_type_get(infos[i]) !=
+             LSM_DISK_LINK_TYPE_SAS) ||
+            (lsm_local_disk_info_health_status_get(infos[i]) !=
+             LSM_DISK_HEALTH_STATUS_GOOD))
+            rc = -1;
+    }
+    lsm_local_disk_info_array_free(infos, count);
+    if (rc != 0) {
+        fprintf(stderr, "info_list: wrong result\n");
+        fixture_remove();
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%-28s %6" PRIu32 " %10.1f %12.1f %10.2f\n", "info_list", round,
+           (double)ns / 1e6, (double)ns / 1e3 / disk_count,
+           (double)(_sg_fake_submitted_get(fake) - submitted) / disk_count);
+    fflush(stdout);
+}
+
+/*
+ * lsm_local_disk_list() reads the fixture /sys/block, sorted by name.
+ */
+static void bench_disk_list(uint32_t round) {
+    lsm_string_list *found = NULL;
+    lsm_error *lsm_err = NULL;
+    uint64_t start = 0;
+    uint64_t ns = 0;
+    uint32_t i = 0;
+    int rc = 0;
+
+    start = now_ns();
+    rc = lsm_local_disk_list(&found, &lsm_err);
+    ns = now_ns() - start;
+    if (check_rc(rc, lsm_err, "all disks") != LSM_ERR_OK) {
+        fixture_remove();
+        exit(EXIT_FAILURE);
+    }
+    rc = lsm_string_list_size(found) == disk_count ? 0 : -1;
+    for (i = 1; (rc == 0) && (i < disk_count); ++i)
+        if (strcmp(lsm_string_list_elem_get(found, i - 1),
+                   lsm_string_list_elem_get(found, i)) >= 0)
+            rc = -1;
+    lsm_string_list_free(found);
+    if (rc != 0) {
+        fprintf(stderr, "disk_list: wrong result\n");
+        fixture_remove();
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%-28s %6" PRIu32 " %10.1f %12.1f %10.2f\n", "disk_list", round,
+           (double)ns / 1e6, (double)ns / 1e3 / disk_count, 0.0);
+    fflush(stdout);
+}
+
+/*
+ * Start a sampler publishing to a shared memory object of this process and
+ * time its first round, which samples every disk with the default worker
+ * count.
+ */
+static lsm_local_disk_sampler *bench_sampler_start(void) {
+    lsm_local_disk_sampler *sampler = NULL;
+    lsm_error *lsm_err = NULL;
+    char shm_name[32];
+    uint32_t submitted = _sg_fake_submitted_get(fake);
+    uint64_t start = 0;
+    uint64_t ns = 0;
+    int rc = 0;
+
+    snprintf(shm_name, sizeof(shm_name), "/lsm_local_disk_bench.%d",
+             (int)getpid());
+    start = now_ns();
+    rc = lsm_local_disk_sampler_start(shm_name, BENCH_SAMPLER_INTERVAL_MS, 0,
+                                      0, &sampler, &lsm_err);
+    if (check_rc(rc, lsm_err, shm_name) != LSM_ERR_OK) {
+        fixture_remove();
+        exit(EXIT_FAILURE);
+    }
+    lsm_err = NULL;
+    rc = lsm_local_disk_health_table_open(shm_name, &health_table, &lsm_err);
+    if (check_rc(rc, lsm_err, shm_name) != LSM_ERR_OK) {
+        fixture_remove();
+        exit(EXIT_FAILURE);
+    }
+    while (lsm_local_disk_health_table_generation_get(health_table) == 0)
+        usleep(100);
+    ns = now_ns() - start;
+
+    printf("%-28s %6d %10.1f %12.1f %10.2f\n", "sampler_round", 1,
+           (double)ns / 1e6, (double)ns / 1e3 / disk_count,
+           (double)(_sg_fake_submitted_get(fake) - submitted) / disk_count);
+    fflush(stdout);
+    return sampler;
+}
+
+int main(int argc, char *argv[]) {
+    lsm_string_list *disk_paths = NULL;
+    lsm_local_disk_sampler *sampler = NULL;
+    char name[16];
+    char disk_path[32];
+    char err_msg[_LSM_ERR_MSG_LEN];
+    uint32_t rounds = BENCH_ROUNDS;
+    uint32_t round = 0;
+    uint32_t i = 0;
+
+    if (argc > 1)
+        disk_count = strtoul(argv[1], NULL, 10);
+    if (argc > 2)
+        enc_count = strtoul(argv[2], NULL, 10);
+    if (argc > 3)
+        rounds = strtoul(argv[3], NULL, 10);
+    if ((disk_count == 0) || (enc_count == 0) || (enc_count > disk_count) ||
+        (disk_count / enc_count > UINT8_MAX - 1)) {
+        fprintf(stderr, "Invalid disk or enclosure count\n");
+        return EXIT_FAILURE;
+    }
+
+    fixture_build();
+
+    disk_paths = lsm_string_list_alloc(0);
+    if (disk_paths == NULL)
+        die("lsm_string_list_alloc");
+    for (i = 0; i < disk_count; ++i) {
+        disk_name(i, name);
+        snprintf(disk_path, sizeof(disk_path), "/dev/%s", name);
+        if (lsm_string_list_append(disk_paths, disk_path) != LSM_ERR_OK)
+            die("lsm_string_list_append");
+    }
+
+    printf("%" PRIu32 " disks in %" PRIu32 " enclosures\n", disk_count,
+           enc_count);
+    printf("%-28s %6s %10s %12s %10s\n", "query", "round", "ms", "us/disk",
+           "cmds/disk");
+
+    sampler = bench_sampler_start();
+
+    for (round = 1; round <= rounds; ++round) {
+        bench_disk_list(round);
+        bench("serial_num_get", query_serial_num, disk_paths, round);
+        bench("vpd83_get", query_vpd83, disk_paths, round);
+        bench("rpm_get", query_rpm, disk_paths, round);
+        bench("link_type_get", query_link_type, disk_paths, round);
+        bench("health_status_get", query_health, disk_paths, round);
+        bench("health_table_get", query_health_table, disk_paths, round);
+        bench("led_status_get", query_led_status, disk_paths, round);
+        bench_info_list(round);
+        bench_led_batch("ident_led_on_batch",
+                        lsm_local_disk_ident_led_on_batch, disk_paths, round);
+        bench("led_status_get(ident on)", query_led_ident_on, disk_paths,
+              round);
+        bench_led_batch("ident_led_off_batch",
+                        lsm_local_disk_ident_led_off_batch, disk_paths, round);
+    }
+
+    lsm_local_disk_health_table_close(health_table);
+    lsm_local_disk_sampler_stop(sampler);
+    lsm_string_list_free(disk_paths);
+    _sg_io_backend_set(err_msg, NULL, NULL);
+    _fs_root_set(NULL);
+    fixture_remove();
+    for (i = 0; i < enc_count; ++i)
+        free(encs[i].status);
+    free(encs);
+    return EXIT_SUCCESS;
+}
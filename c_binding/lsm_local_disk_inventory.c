@@ -0,0 +1,590 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <libudev.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libstoragemgmt/libstoragemgmt.h"
+#include "libstoragemgmt/libstoragemgmt_error.h"
+#include "libstoragemgmt/libstoragemgmt_plug_interface.h"
+#include "utils.h"
+
+#define _LSM_LOCAL_DISK_INVENTORY_MAGIC 0xAA7A0016
+
+#define _LSM_IS_LOCAL_DISK_INVENTORY(obj)                                      \
+    ((obj) != NULL && (obj)->magic == _LSM_LOCAL_DISK_INVENTORY_MAGIC)
+
+enum _inv_attr_type {
+    _INV_ATTR_VPD83 = 0,
+    _INV_ATTR_SERIAL_NUM,
+    _INV_ATTR_LINK_TYPE,
+    _INV_ATTR_RPM,
+    _INV_ATTR_COUNT,
+};
+
+/*
+ * Result of one lsm_local_disk_*_get() call.  Only results which cannot
+ * change without a udev event are cached: success and LSM_ERR_NO_SUPPORT.
+ */
+struct _inv_attr {
+    bool cached;
+    int rc;
+    char *err_msg;
+    char *str;
+    int32_t num;
+};
+
+struct _inv_disk {
+    uint64_t gen; /* Tells a re-added disk apart from the old entry */
+    struct _inv_attr attrs[_INV_ATTR_COUNT];
+};
+
+struct _lsm_local_disk_inventory {
+    uint32_t magic;
+    pthread_mutex_t lock;
+    struct udev *udev;
+    struct udev_monitor *udev_mon;
+    /* disk path -> struct _inv_disk */
+    GHashTable *disks;
+    uint64_t disk_gen;
+};
+
+static bool _is_local_disk_path(const char *disk_path);
+static void _inv_attr_clear(struct _inv_attr *attr);
+static int _inv_attr_copy(struct _inv_attr *dst, const struct _inv_attr *src);
+static void _inv_disk_free(void *data);
+static int _inv_disk_add(lsm_local_disk_inventory *inv,
+                         const char *disk_path);
+static int _inv_rescan(lsm_local_disk_inventory *inv, char *err_msg);
+static int _inv_sync(lsm_local_disk_inventory *inv, char *err_msg);
+static int _inv_attr_query(enum _inv_attr_type type, const char *disk_path,
+                           struct _inv_attr *attr, lsm_error **lsm_err);
+static int _inv_attr_get(lsm_local_disk_inventory *inventory,
+                         const char *disk_path, enum _inv_attr_type type,
+                         struct _inv_attr *attr, lsm_error **lsm_err);
+
+/* Same filter as lsm_local_disk_list() */
+static bool _is_local_disk_path(const char *disk_path) {
+    return (disk_path != NULL) &&
+           ((strncmp(disk_path, "/dev/sd", strlen("/dev/sd")) == 0) ||
+            (strncmp(disk_path, "/dev/nvme", strlen("/dev/nvme")) == 0));
+}
+
+static void _inv_attr_clear(struct _inv_attr *attr) {
+    free(attr->err_msg);
+    free(attr->str);
+    memset(attr, 0, sizeof(struct _inv_attr));
+}
+
+/* Copy rc, num and both strings of src, dst is cleared on failure */
+static int _inv_attr_copy(struct _inv_attr *dst, const struct _inv_attr *src) {
+    memset(dst, 0, sizeof(struct _inv_attr));
+    dst->rc = src->rc;
+    dst->num = src->num;
+    if (src->str != NULL) {
+        dst->str = strdup(src->str);
+        if (dst->str == NULL)
+            goto nomem;
+    }
+    if (src->err_msg != NULL) {
+        dst->err_msg = strdup(src->err_msg);
+        if (dst->err_msg == NULL)
+            goto nomem;
+    }
+    return LSM_ERR_OK;
+
+nomem:
+    _inv_attr_clear(dst);
+    return LSM_ERR_NO_MEMORY;
+}
+
+static void _inv_disk_free(void *data) {
+    struct _inv_disk *disk = (struct _inv_disk *)data;
+    int i = 0;
+
+    if (disk == NULL)
+        return;
+
+    for (i = 0; i < _INV_ATTR_COUNT; ++i)
+        _inv_attr_clear(&disk->attrs[i]);
+    free(disk);
+}
+
+/*
+ * Add or replace the entry of disk_path with one holding nothing cached.
+ */
+static int _inv_disk_add(lsm_local_disk_inventory *inv,
+                         const char *disk_path) {
+    struct _inv_disk *disk = NULL;
+    char *key = NULL;
+
+    disk = (struct _inv_disk *)calloc(1, sizeof(struct _inv_disk));
+    key = strdup(disk_path);
+    if ((disk == NULL) || (key == NULL)) {
+        free(disk);
+        free(key);
+        return LSM_ERR_NO_MEMORY;
+    }
+    disk->gen = ++inv->disk_gen;
+    g_hash_table_replace(inv->disks, key, disk);
+    return LSM_ERR_OK;
+}
+
+static int _inv_rescan(lsm_local_disk_inventory *inv, char *err_msg) {
+    int rc = LSM_ERR_OK;
+    uint32_t i = 0;
+    const char *disk_path = NULL;
+    lsm_string_list *disk_paths = NULL;
+    lsm_error *lsm_err = NULL;
+
+    rc = lsm_local_disk_list(&disk_paths, &lsm_err);
+    if (rc != LSM_ERR_OK) {
+        _lsm_err_msg_set(err_msg, "%s", lsm_error_message_get(lsm_err));
+        lsm_error_free(lsm_err);
+        return rc;
+    }
+
+    g_hash_table_remove_all(inv->disks);
+    _lsm_string_list_foreach(disk_paths, i, disk_path) {
+        rc = _inv_disk_add(inv, disk_path);
+        if (rc != LSM_ERR_OK)
+            break;
+    }
+    lsm_string_list_free(disk_paths);
+    return rc;
+}
+
+/*
+ * Apply the pending udev events.  The monitor socket is non-blocking, so
+ * when nothing happened since the last call this costs a single failing
+ * recvmsg().
+ */
+static int _inv_sync(lsm_local_disk_inventory *inv, char *err_msg) {
+    struct udev_device *udev_dev = NULL;
+    const char *disk_path = NULL;
+    const char *action = NULL;
+    int rc = LSM_ERR_OK;
+
+    while ((udev_dev = udev_monitor_receive_device(inv->udev_mon)) != NULL) {
+        disk_path = udev_device_get_devnode(udev_dev);
+        action = udev_device_get_action(udev_dev);
+        if (_is_local_disk_path(disk_path) && (action != NULL)) {
+            if (strcmp(action, "remove") == 0) {
+                g_hash_table_remove(inv->disks, disk_path);
+            } else {
+                /* "add", "change", "move", "online", etc: whatever we
+                 * cached might be stale.
+                 */
+                rc = _inv_disk_add(inv, disk_path);
+                if (rc != LSM_ERR_OK) {
+                    _lsm_err_msg_set(err_msg, "No memory");
+                    udev_device_unref(udev_dev);
+                    break;
+                }
+            }
+        }
+        udev_device_unref(udev_dev);
+    }
+    return rc;
+}
+
+static int _inv_attr_query(enum _inv_attr_type type, const char *disk_path,
+                           struct _inv_attr *attr, lsm_error **lsm_err) {
+    int rc = LSM_ERR_LIB_BUG;
+    lsm_disk_link_type link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
+
+    switch (type) {
+    case _INV_ATTR_VPD83:
+        rc = lsm_local_disk_vpd83_get(disk_path, &attr->str, lsm_err);
+        break;
+    case _INV_ATTR_SERIAL_NUM:
+        rc = lsm_local_disk_serial_num_get(disk_path, &attr->str, lsm_err);
+        break;
+    case _INV_ATTR_LINK_TYPE:
+        rc = lsm_local_disk_link_type_get(disk_path, &link_type, lsm_err);
+        attr->num = link_type;
+        break;
+    case _INV_ATTR_RPM:
+        rc = lsm_local_disk_rpm_get(disk_path, &attr->num, lsm_err);
+        break;
+    default:
+        *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(
+            rc, "BUG: Got unknown inventory attribute type");
+    }
+    attr->rc = rc;
+    return rc;
+}
+
+/*
+ * Fill attr with a copy of the given attribute of disk_path, querying it
+ * only when not cached yet.  Disk paths not found in the inventory, like
+ * /dev/disk/by-id links, are queried every time.
+ * The query may take seconds on a busy disk, so it runs without
+ * inventory->lock.  The result is only cached when the entry it was
+ * queried for is still in the inventory afterwards.
+ * On success, attr->str should be freed by free().
+ */
+static int _inv_attr_get(lsm_local_disk_inventory *inventory,
+                         const char *disk_path, enum _inv_attr_type type,
+                         struct _inv_attr *attr, lsm_error **lsm_err) {
+    int rc = LSM_ERR_OK;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    struct _inv_disk *disk = NULL;
+    struct _inv_attr *cached = NULL;
+    uint64_t gen = 0;
+
+    _lsm_err_msg_clear(err_msg);
+    memset(attr, 0, sizeof(struct _inv_attr));
+
+    rc = _check_null_ptr(err_msg, 2 /* argument count */, disk_path,
+                         lsm_err);
+    if (rc != LSM_ERR_OK)
+        goto out;
+
+    *lsm_err = NULL;
+
+    if (!_LSM_IS_LOCAL_DISK_INVENTORY(inventory)) {
+        rc = LSM_ERR_INVALID_ARGUMENT;
+        _lsm_err_msg_set(err_msg, "Invalid inventory");
+        goto out;
+    }
+
+    pthread_mutex_lock(&inventory->lock);
+
+    rc = _inv_sync(inventory, err_msg);
+    if (rc != LSM_ERR_OK) {
+        pthread_mutex_unlock(&inventory->lock);
+        goto out;
+    }
+
+    disk = (struct _inv_disk *)g_hash_table_lookup(inventory->disks,
+                                                   disk_path);
+    if ((disk != NULL) && disk->attrs[type].cached) {
+        cached = &disk->attrs[type];
+        rc = cached->rc;
+        if (rc != LSM_ERR_OK) {
+            _lsm_err_msg_set(err_msg, "%s",
+                             cached->err_msg != NULL ? cached->err_msg : "");
+        } else {
+            attr->num = cached->num;
+            if (cached->str != NULL) {
+                attr->str = strdup(cached->str);
+                if (attr->str == NULL) {
+                    rc = LSM_ERR_NO_MEMORY;
+                    _lsm_err_msg_set(err_msg, "No memory");
+                }
+            }
+        }
+        pthread_mutex_unlock(&inventory->lock);
+        goto out;
+    }
+    if (disk != NULL)
+        gen = disk->gen;
+    pthread_mutex_unlock(&inventory->lock);
+
+    rc = _inv_attr_query(type, disk_path, attr, lsm_err);
+    if ((gen == 0) || ((rc != LSM_ERR_OK) && (rc != LSM_ERR_NO_SUPPORT)))
+        return rc;
+
+    if ((rc != LSM_ERR_OK) && (lsm_error_message_get(*lsm_err) != NULL)) {
+        attr->err_msg = strdup(lsm_error_message_get(*lsm_err));
+        if (attr->err_msg == NULL)
+            return rc;
+    }
+
+    pthread_mutex_lock(&inventory->lock);
+    disk = (struct _inv_disk *)g_hash_table_lookup(inventory->disks,
+                                                   disk_path);
+    if ((disk != NULL) && (disk->gen == gen) && !disk->attrs[type].cached) {
+        cached = &disk->attrs[type];
+        _inv_attr_clear(cached);
+        if (_inv_attr_copy(cached, attr) == LSM_ERR_OK)
+            cached->cached = true;
+    }
+    pthread_mutex_unlock(&inventory->lock);
+
+    free(attr->err_msg);
+    attr->err_msg = NULL;
+    return rc;
+
+out:
+    if ((rc != LSM_ERR_OK) && (lsm_err != NULL))
+        *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+    attr->rc = rc;
+    return rc;
+}
+
+int lsm_local_disk_inventory_alloc(lsm_local_disk_inventory **inventory,
+                                   lsm_error **lsm_err) {
+    int rc = LSM_ERR_OK;
+    int udev_rc = 0;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    lsm_local_disk_inventory *inv = NULL;
+
+    _lsm_err_msg_clear(err_msg);
+
+    rc = _check_null_ptr(err_msg, 2 /* argument count */, inventory, lsm_err);
+    if (rc != LSM_ERR_OK) {
+        if (inventory != NULL)
+            *inventory = NULL;
+        goto out;
+    }
+
+    *inventory = NULL;
+    *lsm_err = NULL;
+
+    inv = (lsm_local_disk_inventory *)calloc(
+        1, sizeof(lsm_local_disk_inventory));
+    _alloc_null_check(err_msg, inv, rc, out);
+
+    inv->magic = _LSM_LOCAL_DISK_INVENTORY_MAGIC;
+    pthread_mutex_init(&inv->lock, NULL);
+    inv->disks =
+        g_hash_table_new_full(g_str_hash, g_str_equal, free, _inv_disk_free);
+    _alloc_null_check(err_msg, inv->disks, rc, out);
+
+    inv->udev = udev_new();
+    _alloc_null_check(err_msg, inv->udev, rc, out);
+
+    /* Listen before the initial scan, so no event is lost in between */
+    inv->udev_mon = udev_monitor_new_from_netlink(inv->udev, "udev");
+    if (inv->udev_mon == NULL) {
+        rc = LSM_ERR_NO_SUPPORT;
+        _lsm_err_msg_set(err_msg, "Failed to create udev monitor");
+        goto out;
+    }
+    udev_rc = udev_monitor_filter_add_match_subsystem_devtype(
+        inv->udev_mon, "block", "disk");
+    if (udev_rc != 0) {
+        rc = LSM_ERR_LIB_BUG;
+        _lsm_err_msg_set(err_msg,
+                         "udev_monitor_filter_add_match_subsystem_devtype() "
+                         "failed with %d",
+                         udev_rc);
+        goto out;
+    }
+    udev_rc = udev_monitor_enable_receiving(inv->udev_mon);
+    if (udev_rc != 0) {
+        rc = LSM_ERR_NO_SUPPORT;
+        _lsm_err_msg_set(err_msg,
+                         "udev_monitor_enable_receiving() failed with %d",
+                         udev_rc);
+        goto out;
+    }
+
+    rc = _inv_rescan(inv, err_msg);
+
+out:
+    if (rc == LSM_ERR_OK) {
+        *inventory = inv;
+    } else {
+        lsm_local_disk_inventory_free(inv);
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+    }
+    return rc;
+}
+
+void lsm_local_disk_inventory_free(lsm_local_disk_inventory *inventory) {
+    if (!_LSM_IS_LOCAL_DISK_INVENTORY(inventory))
+        return;
+
+    inventory->magic = 0;
+    if (inventory->disks != NULL)
+        g_hash_table_destroy(inventory->disks);
+    if (inventory->udev_mon != NULL)
+        udev_monitor_unref(inventory->udev_mon);
+    if (inventory->udev != NULL)
+        udev_unref(inventory->udev);
+    pthread_mutex_destroy(&inventory->lock);
+    free(inventory);
+}
+
+int lsm_local_disk_inventory_fd_get(lsm_local_disk_inventory *inventory) {
+    if (!_LSM_IS_LOCAL_DISK_INVENTORY(inventory))
+        return -1;
+    return udev_monitor_get_fd(inventory->udev_mon);
+}
+
+int lsm_local_disk_inventory_refresh(lsm_local_disk_inventory *inventory,
+                                     lsm_error **lsm_err) {
+    int rc = LSM_ERR_OK;
+    char err_msg[_LSM_ERR_MSG_LEN];
+
+    _lsm_err_msg_clear(err_msg);
+
+    if (lsm_err == NULL)
+        return LSM_ERR_INVALID_ARGUMENT;
+
+    *lsm_err = NULL;
+
+    if (!_LSM_IS_LOCAL_DISK_INVENTORY(inventory)) {
+        *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(LSM_ERR_INVALID_ARGUMENT,
+                                               "Invalid inventory");
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    pthread_mutex_lock(&inventory->lock);
+    /* Pending events are stale after the rescan, drop them */
+    rc = _inv_sync(inventory, err_msg);
+    if (rc == LSM_ERR_OK)
+        rc = _inv_rescan(inventory, err_msg);
+    pthread_mutex_unlock(&inventory->lock);
+
+    if (rc != LSM_ERR_OK)
+        *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+    return rc;
+}
+
+int lsm_local_disk_inventory_list(lsm_local_disk_inventory *inventory,
+                                  lsm_string_list **disk_paths,
+                                  lsm_error **lsm_err) {
+    int rc = LSM_ERR_OK;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    GHashTableIter iter;
+    void *key = NULL;
+    GList *keys = NULL;
+    GList *cur = NULL;
+
+    _lsm_err_msg_clear(err_msg);
+
+    rc = _check_null_ptr(err_msg, 2 /* argument count */, disk_paths,
+                         lsm_err);
+    if (rc != LSM_ERR_OK) {
+        if (disk_paths != NULL)
+            *disk_paths = NULL;
+        goto out;
+    }
+
+    *disk_paths = NULL;
+    *lsm_err = NULL;
+
+    if (!_LSM_IS_LOCAL_DISK_INVENTORY(inventory)) {
+        rc = LSM_ERR_INVALID_ARGUMENT;
+        _lsm_err_msg_set(err_msg, "Invalid inventory");
+        goto out;
+    }
+
+    *disk_paths = lsm_string_list_alloc(0 /* no pre-allocation */);
+    _alloc_null_check(err_msg, *disk_paths, rc, out);
+
+    pthread_mutex_lock(&inventory->lock);
+    rc = _inv_sync(inventory, err_msg);
+    if (rc == LSM_ERR_OK) {
+        g_hash_table_iter_init(&iter, inventory->disks);
+        while (g_hash_table_iter_next(&iter, &key, NULL))
+            keys = g_list_prepend(keys, key);
+        /* Same order as lsm_local_disk_list() gives on most systems */
+        keys = g_list_sort(keys, (GCompareFunc)strcmp);
+        for (cur = keys; cur != NULL; cur = cur->next) {
+            if (lsm_string_list_append(*disk_paths,
+                                       (const char *)cur->data) != 0) {
+                rc = LSM_ERR_NO_MEMORY;
+                _lsm_err_msg_set(err_msg, "No memory");
+                break;
+            }
+        }
+        g_list_free(keys);
+    }
+    pthread_mutex_unlock(&inventory->lock);
+
+out:
+    if (rc != LSM_ERR_OK) {
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+        if ((disk_paths != NULL) && (*disk_paths != NULL)) {
+            lsm_string_list_free(*disk_paths);
+            *disk_paths = NULL;
+        }
+    }
+    return rc;
+}
+
+int lsm_local_disk_inventory_vpd83_get(lsm_local_disk_inventory *inventory,
+                                       const char *disk_path, char **vpd83,
+                                       lsm_error **lsm_err) {
+    struct _inv_attr attr;
+    int rc = LSM_ERR_OK;
+
+    if (vpd83 == NULL) {
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(LSM_ERR_INVALID_ARGUMENT,
+                                                   "vpd83 is NULL");
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+    rc = _inv_attr_get(inventory, disk_path, _INV_ATTR_VPD83, &attr, lsm_err);
+    *vpd83 = attr.str;
+    return rc;
+}
+
+int lsm_local_disk_inventory_serial_num_get(
+    lsm_local_disk_inventory *inventory, const char *disk_path,
+    char **serial_num, lsm_error **lsm_err) {
+    struct _inv_attr attr;
+    int rc = LSM_ERR_OK;
+
+    if (serial_num == NULL) {
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(LSM_ERR_INVALID_ARGUMENT,
+                                                   "serial_num is NULL");
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+    rc = _inv_attr_get(inventory, disk_path, _INV_ATTR_SERIAL_NUM, &attr,
+                       lsm_err);
+    *serial_num = attr.str;
+    return rc;
+}
+
+int lsm_local_disk_inventory_link_type_get(
+    lsm_local_disk_inventory *inventory, const char *disk_path,
+    lsm_disk_link_type *link_type, lsm_error **lsm_err) {
+    struct _inv_attr attr;
+    int rc = LSM_ERR_OK;
+
+    if (link_type == NULL) {
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(LSM_ERR_INVALID_ARGUMENT,
+                                                   "link_type is NULL");
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+    rc = _inv_attr_get(inventory, disk_path, _INV_ATTR_LINK_TYPE, &attr,
+                       lsm_err);
+    *link_type = (rc == LSM_ERR_OK) ? (lsm_disk_link_type)attr.num
+                                    : LSM_DISK_LINK_TYPE_UNKNOWN;
+    return rc;
+}
+
+int lsm_local_disk_inventory_rpm_get(lsm_local_disk_inventory *inventory,
+                                     const char *disk_path, int32_t *rpm,
+                                     lsm_error **lsm_err) {
+    struct _inv_attr attr;
+    int rc = LSM_ERR_OK;
+
+    if (rpm == NULL) {
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(LSM_ERR_INVALID_ARGUMENT,
+                                                   "rpm is NULL");
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+    rc = _inv_attr_get(inventory, disk_path, _INV_ATTR_RPM, &attr, lsm_err);
+    *rpm = (rc == LSM_ERR_OK) ? attr.num : LSM_DISK_RPM_UNKNOWN;
+    return rc;
+}
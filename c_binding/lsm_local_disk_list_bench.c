@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Benchmark of the two ways lsm_local_disk_list() could enumerate the local
+ * disks of this host: reading /sys/block and udev enumerate.
+ *
+ * Each one runs for a number of iterations, the cost of udev grows with the
+ * count of all block devices (dm, loop, partitions), not only the listed
+ * disks.  Both must find the same disks, otherwise the benchmark fails.
+ *
+ * These functions are internal to the library, so the benchmark is linked
+ * with the library sources instead of the shared library.
+ *
+ * Usage: lsm_local_disk_list_bench [iterations]
+ */
+
+#include "libblk.h"
+#include "utils.h"
+
+#include "libstoragemgmt/libstoragemgmt.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ITERATIONS 200
+
+typedef int (*bench_list)(char *err_msg, lsm_string_list *disk_paths);
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int path_cmp(const void *a, const void *b) {
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/*
+ * Return the disk paths of the last iteration, exit on failure.
+ */
+static lsm_string_list *bench(const char *name, bench_list list,
+                              uint32_t iterations) {
+    char err_msg[_LSM_ERR_MSG_LEN];
+    lsm_string_list *disk_paths = NULL;
+    uint64_t start = 0;
+    uint64_t ns = 0;
+    uint32_t i = 0;
+    int rc = LSM_ERR_OK;
+
+    start = now_ns();
+    for (i = 0; i < iterations; ++i) {
+        if (disk_paths != NULL)
+            lsm_string_list_free(disk_paths);
+        disk_paths = lsm_string_list_alloc(0);
+        if (disk_paths == NULL) {
+            fprintf(stderr, "No memory\n");
+            exit(EXIT_FAILURE);
+        }
+        _lsm_err_msg_clear(err_msg);
+        rc = list(err_msg, disk_paths);
+        if (rc != LSM_ERR_OK) {
+            fprintf(stderr, "%s failed %d: %s\n", name, rc, err_msg);
+            exit(EXIT_FAILURE);
+        }
+    }
+    ns = now_ns() - start;
+
+    printf("%-8s %8" PRIu32 " %8" PRIu32 " %12.1f\n", name, iterations,
+           lsm_string_list_size(disk_paths), (double)ns / 1e3 / iterations);
+    return disk_paths;
+}
+
+/*
+ * Return 0 if both hold the same paths, in any order.
+ */
+static int same_disks(lsm_string_list *a, lsm_string_list *b) {
+    uint32_t count = lsm_string_list_size(a);
+    const char **sorted_a = NULL;
+    const char **sorted_b = NULL;
+    uint32_t i = 0;
+    int rc = 0;
+
+    if (count != lsm_string_list_size(b))
+        return -1;
+    if (count == 0)
+        return 0;
+
+    sorted_a = (const char **)malloc(sizeof(char *) * count);
+    sorted_b = (const char **)malloc(sizeof(char *) * count);
+    if ((sorted_a == NULL) || (sorted_b == NULL)) {
+        rc = -1;
+        goto out;
+    }
+    for (i = 0; i < count; ++i) {
+        sorted_a[i] = lsm_string_list_elem_get(a, i);
+        sorted_b[i] = lsm_string_list_elem_get(b, i);
+    }
+    qsort(sorted_a, count, sizeof(char *), path_cmp);
+    qsort(sorted_b, count, sizeof(char *), path_cmp);
+    for (i = 0; i < count; ++i) {
+        if (strcmp(sorted_a[i], sorted_b[i]) != 0) {
+            fprintf(stderr, "Mismatch: %s %s\n", sorted_a[i], sorted_b[i]);
+            rc = -1;
+            break;
+        }
+    }
+
+out:
+    free(sorted_a);
+    free(sorted_b);
+    return rc;
+}
+
+int main(int argc, char *argv[]) {
+    lsm_string_list *sysfs_paths = NULL;
+    lsm_string_list *udev_paths = NULL;
+    uint32_t iterations = BENCH_ITERATIONS;
+    int rc = EXIT_SUCCESS;
+
+    if (argc > 1)
+        iterations = strtoul(argv[1], NULL, 10);
+    if (iterations == 0) {
+        fprintf(stderr, "Invalid iteration count\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-8s %8s %8s %12s\n", "method", "calls", "disks", "us/call");
+    sysfs_paths = bench("sysfs", _blk_disk_list_sysfs, iterations);
+    udev_paths = bench("udev", _blk_disk_list_udev, iterations);
+
+    if (same_disks(sysfs_paths, udev_paths) != 0) {
+        fprintf(stderr, "sysfs and udev found different disks\n");
+        rc = EXIT_FAILURE;
+    }
+
+    lsm_string_list_free(sysfs_paths);
+    lsm_string_list_free(udev_paths);
+    return rc;
+}
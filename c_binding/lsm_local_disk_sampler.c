@@ -0,0 +1,714 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glib.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "libstoragemgmt/libstoragemgmt.h"
+#include "libstoragemgmt/libstoragemgmt_error.h"
+#include "libstoragemgmt/libstoragemgmt_plug_interface.h"
+#include "lsm_local_disk.h"
+#include "utils.h"
+
+#define _LSM_LOCAL_DISK_SAMPLER_MAGIC      0xAA7A0018
+#define _LSM_LOCAL_DISK_HEALTH_TABLE_MAGIC 0xAA7A0019
+
+#define _LSM_IS_LOCAL_DISK_SAMPLER(obj)                                        \
+    ((obj) != NULL && (obj)->magic == _LSM_LOCAL_DISK_SAMPLER_MAGIC)
+
+#define _LSM_IS_LOCAL_DISK_HEALTH_TABLE(obj)                                   \
+    ((obj) != NULL && (obj)->magic == _LSM_LOCAL_DISK_HEALTH_TABLE_MAGIC)
+
+#define _SAMPLER_DEFAULT_WORKERS 16
+
+/*
+ * Layout of the shared memory object, readers of other library versions
+ * refuse it unless all of magic, version and entry size match.
+ */
+#define _SAMPLER_SHM_MAGIC   0x4C534D48 /* "LSMH" */
+#define _SAMPLER_SHM_VERSION 1
+/* Disks beyond this count are not published */
+#define _SAMPLER_SHM_ENTRY_MAX 4096
+/* Disks whose path does not fit are not published */
+#define _SAMPLER_DISK_PATH_LEN 64
+
+/*
+ * Readers give up with LSM_ERR_TIMEOUT after this many attempts of reading
+ * while the sampler is publishing, the publishing only copies memory.
+ */
+#define _SAMPLER_READ_RETRY_MAX 10000
+
+struct _sampler_shm_entry {
+    char disk_path[_SAMPLER_DISK_PATH_LEN];
+    int32_t rc;
+    int32_t health_status;
+    int32_t link_type;
+    uint32_t link_speed;
+    uint64_t sample_time;
+};
+
+/*
+ * 'seq' is odd while the sampler is writing.  Readers copy what they need,
+ * then retry if 'seq' was odd or changed meanwhile, so the sampler never
+ * waits for readers and readers never take a lock.
+ */
+struct _sampler_shm {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_size;
+    uint32_t entry_max;
+    uint64_t seq;
+    uint64_t generation;
+    /* ^ Count of rounds published */
+    uint32_t entry_count;
+    uint32_t interval_ms;
+    uint32_t stopped;
+    uint32_t reserved;
+    struct _sampler_shm_entry entries[];
+    /* ^ Sorted by disk_path */
+};
+
+#define _SAMPLER_SHM_SIZE                                                      \
+    (sizeof(struct _sampler_shm) +                                             \
+     sizeof(struct _sampler_shm_entry) * _SAMPLER_SHM_ENTRY_MAX)
+
+struct _lsm_local_disk_sampler {
+    uint32_t magic;
+    char *shm_name;
+    struct _sampler_shm *shm;
+    uint32_t interval_ms;
+    uint32_t jitter_ms;
+    uint32_t worker_count;
+    unsigned int seed;
+    /* disk path -> lsm_disk_link_type of previous round, only touched by
+     * the sampler thread.
+     */
+    GHashTable *link_types;
+    /* Round results, published by copying into shm */
+    struct _sampler_shm_entry *entries;
+    pthread_t thread;
+    bool thread_started;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool stopping;
+};
+
+struct _lsm_local_disk_health_table {
+    uint32_t magic;
+    const struct _sampler_shm *shm;
+};
+
+/* Shared by the workers of one sampling round */
+struct _sampler_round {
+    pthread_mutex_t lock;
+    uint32_t next;
+    uint32_t count;
+    struct _sampler_shm_entry *entries;
+    lsm_disk_link_type *link_types;
+};
+
+static int _shm_name_check(char *err_msg, const char *shm_name);
+static int _entry_cmp(const void *a, const void *b);
+static int _entry_key_cmp(const void *key, const void *entry);
+static uint64_t _ms_to_ns(uint32_t ms);
+static void _shm_publish(struct _sampler_shm *shm,
+                         const struct _sampler_shm_entry *entries,
+                         uint32_t count, bool stopped);
+static void *_sampler_round_worker(void *data);
+static void _sampler_round_run(lsm_local_disk_sampler *sampler);
+static void *_sampler_main(void *data);
+static void _sampler_free(lsm_local_disk_sampler *sampler);
+
+static int _shm_name_check(char *err_msg, const char *shm_name) {
+    if ((shm_name[0] != '/') || (shm_name[1] == '\0') ||
+        (strchr(shm_name + 1, '/') != NULL) ||
+        (strlen(shm_name) > NAME_MAX)) {
+        _lsm_err_msg_set(err_msg,
+                         "Invalid shared memory name '%s', should be "
+                         "'/' followed by up to %d characters but '/'",
+                         shm_name, NAME_MAX - 1);
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+    return LSM_ERR_OK;
+}
+
+static int _entry_cmp(const void *a, const void *b) {
+    return strncmp(((const struct _sampler_shm_entry *)a)->disk_path,
+                   ((const struct _sampler_shm_entry *)b)->disk_path,
+                   _SAMPLER_DISK_PATH_LEN);
+}
+
+static int _entry_key_cmp(const void *key, const void *entry) {
+    return strncmp((const char *)key,
+                   ((const struct _sampler_shm_entry *)entry)->disk_path,
+                   _SAMPLER_DISK_PATH_LEN);
+}
+
+static uint64_t _ms_to_ns(uint32_t ms) {
+    return (uint64_t)ms * 1000000ULL;
+}
+
+static void _shm_publish(struct _sampler_shm *shm,
+                         const struct _sampler_shm_entry *entries,
+                         uint32_t count, bool stopped) {
+    uint64_t seq = shm->seq;
+
+    __atomic_store_n(&shm->seq, seq + 1, __ATOMIC_RELAXED);
+    /* Readers seeing any of the writes below also see the odd seq */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if (entries != NULL) {
+        memcpy(shm->entries, entries,
+               sizeof(struct _sampler_shm_entry) * count);
+        shm->entry_count = count;
+        shm->generation++;
+    }
+    if (stopped)
+        shm->stopped = 1;
+
+    __atomic_store_n(&shm->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static void *_sampler_round_worker(void *data) {
+    struct _sampler_round *round = (struct _sampler_round *)data;
+    struct _sampler_shm_entry *entry = NULL;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    uint32_t i = 0;
+
+    while (1) {
+        pthread_mutex_lock(&round->lock);
+        i = round->next++;
+        pthread_mutex_unlock(&round->lock);
+        if (i >= round->count)
+            break;
+        entry = &round->entries[i];
+        _lsm_err_msg_clear(err_msg);
+        entry->rc = _local_disk_health_sample(
+            err_msg, entry->disk_path, &round->link_types[i],
+            &entry->link_speed, &entry->health_status);
+        entry->link_type = round->link_types[i];
+        entry->sample_time = (uint64_t)time(NULL);
+    }
+    return NULL;
+}
+
+/*
+ * Sample all the local disks and publish the results.  A round failing to
+ * list the disks publishes nothing, readers notice it by 'sample_time'.
+ */
+static void _sampler_round_run(lsm_local_disk_sampler *sampler) {
+    struct _sampler_round round;
+    lsm_string_list *disk_paths = NULL;
+    lsm_error *lsm_err = NULL;
+    GHashTable *link_types = NULL;
+    const char *disk_path = NULL;
+    pthread_t *workers = NULL;
+    uint32_t worker_count = sampler->worker_count;
+    uint32_t started = 0;
+    uint32_t i = 0;
+    void *cached = NULL;
+
+    memset(&round, 0, sizeof(round));
+
+    if (lsm_local_disk_list(&disk_paths, &lsm_err) != LSM_ERR_OK) {
+        lsm_error_free(lsm_err);
+        return;
+    }
+
+    round.entries = sampler->entries;
+    round.link_types = (lsm_disk_link_type *)calloc(
+        _SAMPLER_SHM_ENTRY_MAX, sizeof(lsm_disk_link_type));
+    link_types = g_hash_table_new_full(g_str_hash, g_str_equal, free, NULL);
+    if ((round.link_types == NULL) || (link_types == NULL))
+        goto out;
+
+    memset(round.entries, 0,
+           sizeof(struct _sampler_shm_entry) * _SAMPLER_SHM_ENTRY_MAX);
+    for (i = 0; (i < lsm_string_list_size(disk_paths)) &&
+                (round.count < _SAMPLER_SHM_ENTRY_MAX);
+         ++i) {
+        disk_path = lsm_string_list_elem_get(disk_paths, i);
+        if (strlen(disk_path) >= _SAMPLER_DISK_PATH_LEN)
+            continue;
+        snprintf(round.entries[round.count].disk_path,
+                 _SAMPLER_DISK_PATH_LEN, "%s", disk_path);
+        if (g_hash_table_lookup_extended(sampler->link_types, disk_path,
+                                         NULL, &cached))
+            round.link_types[round.count] =
+                (lsm_disk_link_type)GPOINTER_TO_INT(cached);
+        else
+            round.link_types[round.count] = LSM_DISK_LINK_TYPE_UNKNOWN;
+        ++round.count;
+    }
+
+    if (worker_count > round.count)
+        worker_count = round.count;
+
+    pthread_mutex_init(&round.lock, NULL);
+
+    /* The sampler thread is one of the workers */
+    if (worker_count > 1) {
+        workers = (pthread_t *)calloc(worker_count - 1, sizeof(pthread_t));
+        for (; (workers != NULL) && (started < worker_count - 1); ++started) {
+            /* Carry on with fewer workers if no more threads are allowed */
+            if (pthread_create(&workers[started], NULL,
+                               _sampler_round_worker, &round) != 0)
+                break;
+        }
+    }
+    _sampler_round_worker(&round);
+    for (i = 0; i < started; ++i)
+        pthread_join(workers[i], NULL);
+
+    pthread_mutex_destroy(&round.lock);
+
+    /* Only keep the link type of disks still present and sampled fine, so
+     * a disk replaced under the same name is probed again.
+     */
+    for (i = 0; i < round.count; ++i) {
+        if ((round.entries[i].rc != LSM_ERR_OK) &&
+            (round.entries[i].rc != LSM_ERR_NO_SUPPORT))
+            continue;
+        if (round.link_types[i] == LSM_DISK_LINK_TYPE_UNKNOWN)
+            continue;
+        disk_path = strdup(round.entries[i].disk_path);
+        if (disk_path == NULL)
+            continue;
+        g_hash_table_replace(link_types, (void *)disk_path,
+                             GINT_TO_POINTER(round.link_types[i]));
+    }
+    g_hash_table_destroy(sampler->link_types);
+    sampler->link_types = link_types;
+    link_types = NULL;
+
+    qsort(round.entries, round.count, sizeof(struct _sampler_shm_entry),
+          _entry_cmp);
+    _shm_publish(sampler->shm, round.entries, round.count, false);
+
+out:
+    free(workers);
+    free(round.link_types);
+    if (link_types != NULL)
+        g_hash_table_destroy(link_types);
+    lsm_string_list_free(disk_paths);
+}
+
+static void *_sampler_main(void *data) {
+    lsm_local_disk_sampler *sampler = (lsm_local_disk_sampler *)data;
+    struct timespec deadline;
+    uint64_t ns = 0;
+    uint32_t delay_ms = 0;
+
+    pthread_mutex_lock(&sampler->lock);
+    while (!sampler->stopping) {
+        pthread_mutex_unlock(&sampler->lock);
+
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        _sampler_round_run(sampler);
+
+        delay_ms = sampler->interval_ms;
+        if (sampler->jitter_ms > 0)
+            delay_ms += rand_r(&sampler->seed) % (sampler->jitter_ms + 1);
+        /* Rounds start at a fixed pace, however long sampling takes */
+        ns = (uint64_t)deadline.tv_nsec + _ms_to_ns(delay_ms);
+        deadline.tv_sec += ns / 1000000000ULL;
+        deadline.tv_nsec = ns % 1000000000ULL;
+
+        pthread_mutex_lock(&sampler->lock);
+        while (!sampler->stopping) {
+            if (pthread_cond_timedwait(&sampler->cond, &sampler->lock,
+                                       &deadline) == ETIMEDOUT)
+                break;
+        }
+    }
+    pthread_mutex_unlock(&sampler->lock);
+    return NULL;
+}
+
+static void _sampler_free(lsm_local_disk_sampler *sampler) {
+    sampler->magic = 0;
+    if (sampler->shm != NULL)
+        munmap(sampler->shm, _SAMPLER_SHM_SIZE);
+    if (sampler->link_types != NULL)
+        g_hash_table_destroy(sampler->link_types);
+    pthread_cond_destroy(&sampler->cond);
+    pthread_mutex_destroy(&sampler->lock);
+    free(sampler->entries);
+    free(sampler->shm_name);
+    free(sampler);
+}
+
+int lsm_local_disk_sampler_start(const char *shm_name, uint32_t interval_ms,
+                                 uint32_t jitter_ms, uint32_t worker_count,
+                                 lsm_local_disk_sampler **sampler,
+                                 lsm_error **lsm_err) {
+    int rc = LSM_ERR_OK;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    char strerr_buff[_LSM_ERR_MSG_LEN];
+    lsm_local_disk_sampler *smp = NULL;
+    pthread_condattr_t cond_attr;
+    void *shm = MAP_FAILED;
+    int shm_fd = -1;
+    int errno_save = 0;
+
+    _lsm_err_msg_clear(err_msg);
+
+    rc = _check_null_ptr(err_msg, 3 /* argument count */, shm_name, sampler,
+                         lsm_err);
+    if (rc != LSM_ERR_OK) {
+        if (sampler != NULL)
+            *sampler = NULL;
+        goto out;
+    }
+
+    *sampler = NULL;
+    *lsm_err = NULL;
+
+    _good(_shm_name_check(err_msg, shm_name), rc, out);
+    if (interval_ms == 0) {
+        rc = LSM_ERR_INVALID_ARGUMENT;
+        _lsm_err_msg_set(err_msg, "Sampling interval should not be 0");
+        goto out;
+    }
+
+    smp = (lsm_local_disk_sampler *)calloc(1, sizeof(lsm_local_disk_sampler));
+    _alloc_null_check(err_msg, smp, rc, out);
+
+    smp->magic = _LSM_LOCAL_DISK_SAMPLER_MAGIC;
+    smp->interval_ms = interval_ms;
+    smp->jitter_ms = jitter_ms;
+    smp->worker_count =
+        worker_count == 0 ? _SAMPLER_DEFAULT_WORKERS : worker_count;
+    smp->seed = (unsigned int)time(NULL) ^ (unsigned int)getpid();
+    pthread_mutex_init(&smp->lock, NULL);
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&smp->cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+
+    smp->shm_name = strdup(shm_name);
+    _alloc_null_check(err_msg, smp->shm_name, rc, out);
+    smp->link_types =
+        g_hash_table_new_full(g_str_hash, g_str_equal, free, NULL);
+    _alloc_null_check(err_msg, smp->link_types, rc, out);
+    smp->entries = (struct _sampler_shm_entry *)calloc(
+        _SAMPLER_SHM_ENTRY_MAX, sizeof(struct _sampler_shm_entry));
+    _alloc_null_check(err_msg, smp->entries, rc, out);
+
+    /* Readers still mapping the one of a previous sampler keep it until they
+     * close it, they notice it was replaced by its 'stopped' flag.
+     */
+    shm_unlink(shm_name);
+    shm_fd = shm_open(shm_name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    /* Readable by all, whatever the umask of the process */
+    if ((shm_fd < 0) || (fchmod(shm_fd, 0644) != 0) ||
+        (ftruncate(shm_fd, _SAMPLER_SHM_SIZE) != 0)) {
+        errno_save = errno;
+        rc = ((errno_save == EACCES) || (errno_save == EPERM))
+                 ? LSM_ERR_PERMISSION_DENIED
+                 : LSM_ERR_LIB_BUG;
+        _lsm_err_msg_set(err_msg,
+                         "Failed to create shared memory '%s': error (%d)%s",
+                         shm_name, errno_save,
+                         error_to_str(errno_save, strerr_buff,
+                                      _LSM_ERR_MSG_LEN));
+        goto out;
+    }
+    shm = mmap(NULL, _SAMPLER_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+               shm_fd, 0);
+    if (shm == MAP_FAILED) {
+        errno_save = errno;
+        rc = errno_save == ENOMEM ? LSM_ERR_NO_MEMORY : LSM_ERR_LIB_BUG;
+        _lsm_err_msg_set(err_msg,
+                         "Failed to map shared memory '%s': error (%d)%s",
+                         shm_name, errno_save,
+                         error_to_str(errno_save, strerr_buff,
+                                      _LSM_ERR_MSG_LEN));
+        goto out;
+    }
+    smp->shm = (struct _sampler_shm *)shm;
+    /* ftruncate() zeroed it, readers refuse it until magic is set */
+    smp->shm->version = _SAMPLER_SHM_VERSION;
+    smp->shm->entry_size = sizeof(struct _sampler_shm_entry);
+    smp->shm->entry_max = _SAMPLER_SHM_ENTRY_MAX;
+    smp->shm->interval_ms = interval_ms;
+    __atomic_store_n(&smp->shm->magic, _SAMPLER_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    if (pthread_create(&smp->thread, NULL, _sampler_main, smp) != 0) {
+        rc = LSM_ERR_NO_MEMORY;
+        _lsm_err_msg_set(err_msg, "Failed to create sampler thread");
+        goto out;
+    }
+    smp->thread_started = true;
+
+out:
+    if (shm_fd >= 0)
+        close(shm_fd);
+
+    if (rc == LSM_ERR_OK) {
+        *sampler = smp;
+    } else {
+        if (shm_fd >= 0)
+            shm_unlink(shm_name);
+        if (smp != NULL)
+            _sampler_free(smp);
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+    }
+    return rc;
+}
+
+void lsm_local_disk_sampler_stop(lsm_local_disk_sampler *sampler) {
+    if (!_LSM_IS_LOCAL_DISK_SAMPLER(sampler))
+        return;
+
+    if (sampler->thread_started) {
+        pthread_mutex_lock(&sampler->lock);
+        sampler->stopping = true;
+        pthread_cond_signal(&sampler->cond);
+        pthread_mutex_unlock(&sampler->lock);
+        pthread_join(sampler->thread, NULL);
+    }
+    _shm_publish(sampler->shm, NULL, 0, true);
+    shm_unlink(sampler->shm_name);
+    _sampler_free(sampler);
+}
+
+int lsm_local_disk_health_table_open(const char *shm_name,
+                                     lsm_local_disk_health_table **table,
+                                     lsm_error **lsm_err) {
+    int rc = LSM_ERR_OK;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    char strerr_buff[_LSM_ERR_MSG_LEN];
+    lsm_local_disk_health_table *tbl = NULL;
+    const struct _sampler_shm *shm = MAP_FAILED;
+    struct stat shm_stat;
+    int shm_fd = -1;
+    int errno_save = 0;
+
+    _lsm_err_msg_clear(err_msg);
+
+    rc = _check_null_ptr(err_msg, 3 /* argument count */, shm_name, table,
+                         lsm_err);
+    if (rc != LSM_ERR_OK) {
+        if (table != NULL)
+            *table = NULL;
+        goto out;
+    }
+
+    *table = NULL;
+    *lsm_err = NULL;
+
+    _good(_shm_name_check(err_msg, shm_name), rc, out);
+
+    shm_fd = shm_open(shm_name, O_RDONLY, 0);
+    if ((shm_fd < 0) || (fstat(shm_fd, &shm_stat) != 0)) {
+        errno_save = errno;
+        if (errno_save == ENOENT)
+            rc = LSM_ERR_DAEMON_NOT_RUNNING;
+        else if (errno_save == EACCES)
+            rc = LSM_ERR_PERMISSION_DENIED;
+        else
+            rc = LSM_ERR_LIB_BUG;
+        _lsm_err_msg_set(err_msg,
+                         "Failed to open shared memory '%s': error (%d)%s",
+                         shm_name, errno_save,
+                         error_to_str(errno_save, strerr_buff,
+                                      _LSM_ERR_MSG_LEN));
+        goto out;
+    }
+    /* Also refuse a sampler still between shm_open() and ftruncate() */
+    if ((size_t)shm_stat.st_size != _SAMPLER_SHM_SIZE) {
+        rc = LSM_ERR_NO_SUPPORT;
+        _lsm_err_msg_set(err_msg,
+                         "Shared memory '%s' has unexpected size %jd",
+                         shm_name, (intmax_t)shm_stat.st_size);
+        goto out;
+    }
+
+    shm = (const struct _sampler_shm *)mmap(NULL, _SAMPLER_SHM_SIZE,
+                                            PROT_READ, MAP_SHARED, shm_fd, 0);
+    if (shm == MAP_FAILED) {
+        errno_save = errno;
+        rc = errno_save == ENOMEM ? LSM_ERR_NO_MEMORY : LSM_ERR_LIB_BUG;
+        _lsm_err_msg_set(err_msg,
+                         "Failed to map shared memory '%s': error (%d)%s",
+                         shm_name, errno_save,
+                         error_to_str(errno_save, strerr_buff,
+                                      _LSM_ERR_MSG_LEN));
+        goto out;
+    }
+    if ((__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) !=
+         _SAMPLER_SHM_MAGIC) ||
+        (shm->version != _SAMPLER_SHM_VERSION) ||
+        (shm->entry_size != sizeof(struct _sampler_shm_entry)) ||
+        (shm->entry_max != _SAMPLER_SHM_ENTRY_MAX)) {
+        rc = LSM_ERR_NO_SUPPORT;
+        _lsm_err_msg_set(err_msg,
+                         "Shared memory '%s' is not of a supported local "
+                         "disk sampler",
+                         shm_name);
+        goto out;
+    }
+
+    tbl = (lsm_local_disk_health_table *)calloc(
+        1, sizeof(lsm_local_disk_health_table));
+    _alloc_null_check(err_msg, tbl, rc, out);
+    tbl->magic = _LSM_LOCAL_DISK_HEALTH_TABLE_MAGIC;
+    tbl->shm = shm;
+
+out:
+    if (shm_fd >= 0)
+        close(shm_fd);
+
+    if (rc == LSM_ERR_OK) {
+        *table = tbl;
+    } else {
+        if (shm != MAP_FAILED)
+            munmap((void *)shm, _SAMPLER_SHM_SIZE);
+        if (lsm_err != NULL)
+            *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+    }
+    return rc;
+}
+
+void lsm_local_disk_health_table_close(lsm_local_disk_health_table *table) {
+    if (!_LSM_IS_LOCAL_DISK_HEALTH_TABLE(table))
+        return;
+
+    table->magic = 0;
+    munmap((void *)table->shm, _SAMPLER_SHM_SIZE);
+    free(table);
+}
+
+uint64_t
+lsm_local_disk_health_table_generation_get(lsm_local_disk_health_table *table) {
+    if (!_LSM_IS_LOCAL_DISK_HEALTH_TABLE(table))
+        return 0;
+    return __atomic_load_n(&table->shm->generation, __ATOMIC_RELAXED);
+}
+
+int lsm_local_disk_health_table_get(lsm_local_disk_health_table *table,
+                                    const char *disk_path,
+                                    int32_t *health_status,
+                                    lsm_disk_link_type *link_type,
+                                    uint32_t *link_speed,
+                                    uint64_t *sample_time,
+                                    lsm_error **lsm_err) {
+    int rc = LSM_ERR_OK;
+    char err_msg[_LSM_ERR_MSG_LEN];
+    const struct _sampler_shm *shm = NULL;
+    const struct _sampler_shm_entry *found = NULL;
+    struct _sampler_shm_entry entry;
+    uint32_t entry_count = 0;
+    uint32_t stopped = 0;
+    uint64_t seq = 0;
+    uint32_t retry = 0;
+
+    _lsm_err_msg_clear(err_msg);
+    memset(&entry, 0, sizeof(entry));
+
+    rc = _check_null_ptr(err_msg, 6 /* argument count */, disk_path,
+                         health_status, link_type, link_speed, sample_time,
+                         lsm_err);
+    if (rc != LSM_ERR_OK)
+        goto out;
+
+    *lsm_err = NULL;
+
+    if (!_LSM_IS_LOCAL_DISK_HEALTH_TABLE(table)) {
+        rc = LSM_ERR_INVALID_ARGUMENT;
+        _lsm_err_msg_set(err_msg, "Invalid local disk health table");
+        goto out;
+    }
+    shm = table->shm;
+
+    for (retry = 0; retry < _SAMPLER_READ_RETRY_MAX; ++retry) {
+        seq = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+        if (seq % 2 == 1) {
+            sched_yield();
+            continue;
+        }
+        stopped = shm->stopped;
+        entry_count = shm->entry_count;
+        /* Could be torn, only trusted once seq is checked again */
+        if (entry_count > _SAMPLER_SHM_ENTRY_MAX)
+            entry_count = _SAMPLER_SHM_ENTRY_MAX;
+        found = (const struct _sampler_shm_entry *)bsearch(
+            disk_path, shm->entries, entry_count,
+            sizeof(struct _sampler_shm_entry), _entry_key_cmp);
+        if (found != NULL)
+            memcpy(&entry, found, sizeof(entry));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&shm->seq, __ATOMIC_RELAXED) == seq)
+            break;
+    }
+
+    if (retry == _SAMPLER_READ_RETRY_MAX) {
+        found = NULL;
+        rc = LSM_ERR_TIMEOUT;
+        _lsm_err_msg_set(err_msg,
+                         "Local disk sampler kept updating the table");
+        goto out;
+    }
+    if (stopped) {
+        found = NULL;
+        rc = LSM_ERR_DAEMON_NOT_RUNNING;
+        _lsm_err_msg_set(err_msg, "Local disk sampler was stopped");
+        goto out;
+    }
+    if (found == NULL) {
+        rc = LSM_ERR_NOT_FOUND_DISK;
+        _lsm_err_msg_set(err_msg, "Disk %s was not sampled", disk_path);
+        goto out;
+    }
+
+    rc = entry.rc;
+    if (rc != LSM_ERR_OK)
+        _lsm_err_msg_set(err_msg, "Sampling disk %s failed with error %d",
+                         disk_path, rc);
+
+out:
+    if (health_status != NULL)
+        *health_status = rc == LSM_ERR_OK ? entry.health_status
+                                          : LSM_DISK_HEALTH_STATUS_UNKNOWN;
+    if (link_type != NULL)
+        *link_type =
+            found != NULL ? entry.link_type : LSM_DISK_LINK_TYPE_UNKNOWN;
+    if (link_speed != NULL)
+        *link_speed =
+            found != NULL ? entry.link_speed : LSM_DISK_LINK_SPEED_UNKNOWN;
+    if (sample_time != NULL)
+        *sample_time = found != NULL ? entry.sample_time : 0;
+
+    if ((rc != LSM_ERR_OK) && (lsm_err != NULL))
+        *lsm_err = LSM_ERROR_CREATE_PLUGIN_MSG(rc, err_msg);
+    return rc;
+}
@@ -21,9 +21,13 @@
 #include "libstoragemgmt/libstoragemgmt_plug_interface.h"
 #include "libstoragemgmt/libstoragemgmt_types.h"
 #include <dirent.h>
+#include <errno.h>
 #include <libxml/uri.h>
+#include <poll.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <time.h>
 
 #include "lsm_convert.hpp"
 #include "lsm_datatypes.hpp"
@@ -243,26 +247,61 @@ static lsm_error_number log_exception(lsm_connect *c, lsm_error_number error,
     return error;
 }
 
+static lsm_request *request_pending_first(lsm_connect *c) {
+    lsm_request *r = c->requests;
+
+    while (r && r->done) {
+        r = r->next;
+    }
+    return r;
+}
+
 static int rpc(lsm_connect *c, const char *method, const Value &parameters,
                Value &response) throw() {
+    int rc = LSM_ERR_OK;
+    lsm_rpc_timing timing;
+    lsm_rpc_timing *tp = NULL;
+
+    /*
+     * Responses come back in request order, so a blocking call can't be
+     * issued until every asynchronous request on this connection is answered.
+     */
+    if (request_pending_first(c)) {
+        return log_exception(c, LSM_ERR_INVALID_ARGUMENT,
+                             "Asynchronous requests outstanding", NULL);
+    }
+
+    if (c->timing_cb) {
+        memset(&timing, 0, sizeof(timing));
+        timing.method = method;
+        tp = &timing;
+    }
+
     try {
-        response = c->tp->rpc(method, parameters);
+        response = c->tp->rpc(method, parameters, 100, tp);
     } catch (const ValueException &ve) {
-        return log_exception(c, LSM_ERR_TRANSPORT_SERIALIZATION,
-                             "Serialization error", ve.what());
+        rc = log_exception(c, LSM_ERR_TRANSPORT_SERIALIZATION,
+                           "Serialization error", ve.what());
     } catch (const LsmException &le) {
-        return log_exception(c, (lsm_error_number)le.error_code, le.what(),
-                             NULL);
+        rc = log_exception(c, (lsm_error_number)le.error_code, le.what(),
+                           NULL);
     } catch (const EOFException &eof) {
-        return log_exception(c, LSM_ERR_TRANSPORT_COMMUNICATION, "Plug-in died",
-                             "Check syslog");
+        rc = log_exception(c, LSM_ERR_TRANSPORT_COMMUNICATION, "Plug-in died",
+                           "Check syslog");
     } catch (...) {
-        return log_exception(c, LSM_ERR_LIB_BUG, "Unexpected exception",
-                             "Unknown exception");
+        rc = log_exception(c, LSM_ERR_LIB_BUG, "Unexpected exception",
+                           "Unknown exception");
     }
-    return LSM_ERR_OK;
+
+    if (tp) {
+        timing.rc = rc;
+        c->timing_cb(tp, c->timing_data);
+    }
+    return rc;
 }
 
+static int request_drain(lsm_connect *c);
+
 static int job_check(lsm_connect *c, int rc, Value &response, char **job) {
     try {
         if (LSM_ERR_OK == rc) {
@@ -326,8 +365,13 @@ int lsm_connect_close(lsm_connect *c, lsm_flag flags) {
     Value parameters(p);
     Value response;
 
+    // Collect anything still in flight so the plugin sees a clean shutdown
+    int rc = request_drain(c);
+
     // No response data needed on plugin_unregister
-    int rc = rpc(c, "plugin_unregister", parameters, response);
+    if (LSM_ERR_OK == rc) {
+        rc = rpc(c, "plugin_unregister", parameters, response);
+    }
 
     // Free the connection.
     connection_free(c);
@@ -382,18 +426,152 @@ int lsm_plugin_info_get(lsm_connect *c, char **desc, char **version,
     return rc;
 }
 
+/*
+ * lsmd leaves "<socket>.info" next to each plugin socket holding the plugin
+ * description and version on separate lines.  Only trust it when it is at
+ * least as new as the socket, otherwise the plugin may have been replaced.
+ */
+static bool plugin_info_cache_read(const char *uds_dir, const char *name,
+                                   std::string &desc, std::string &version) {
+    bool rc = false;
+    char *sock_file = NULL;
+    char *info_file = NULL;
+    struct stat sock_st;
+    struct stat info_st;
+    FILE *f = NULL;
+
+    if (asprintf(&sock_file, "%s/%s", uds_dir, name) == -1) {
+        return false;
+    }
+
+    if (asprintf(&info_file, "%s/%s" LSM_PLUGIN_INFO_SUFFIX, uds_dir,
+                 name) == -1) {
+        free(sock_file);
+        return false;
+    }
+
+    if (stat(sock_file, &sock_st) == 0 && stat(info_file, &info_st) == 0 &&
+        (info_st.st_mtim.tv_sec > sock_st.st_mtim.tv_sec ||
+         (info_st.st_mtim.tv_sec == sock_st.st_mtim.tv_sec &&
+          info_st.st_mtim.tv_nsec >= sock_st.st_mtim.tv_nsec))) {
+        f = fopen(info_file, "re");
+        if (f) {
+            char line[1024];
+            if (fgets(line, sizeof(line), f)) {
+                line[strcspn(line, "\n")] = '\0';
+                desc = line;
+                if (fgets(line, sizeof(line), f)) {
+                    line[strcspn(line, "\n")] = '\0';
+                    version = line;
+                    rc = true;
+                }
+            }
+            fclose(f);
+        }
+    }
+
+    free(sock_file);
+    free(info_file);
+    return rc;
+}
+
+struct LSM_DLL_LOCAL plugin_probe {
+    std::string name;
+    lsm_connect *c;
+    bool done;
+    bool ok;
+    std::string desc;
+    std::string version;
+};
+
+/*
+ * Issue plugin_info to every probe at once and gather the replies as they
+ * arrive, so the total wait is the slowest plugin rather than the sum.
+ */
+static void plugin_info_collect(std::vector<plugin_probe> &probes,
+                                int timeout_ms) {
+    std::vector<struct pollfd> pfds;
+    std::vector<size_t> idx;
+    size_t pending = 0;
+    struct timespec start;
+    struct timespec now;
+
+    for (size_t i = 0; i < probes.size(); ++i) {
+        plugin_probe &p = probes[i];
+        if (p.done) {
+            continue;
+        }
+        try {
+            p.c->tp->requestSend("plugin_info", _create_flag_param(0));
+            ++pending;
+        } catch (const std::exception &e) {
+            p.done = true;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while (pending) {
+        pfds.clear();
+        idx.clear();
+        for (size_t i = 0; i < probes.size(); ++i) {
+            if (!probes[i].done) {
+                struct pollfd pfd = {probes[i].c->tp->fd(), POLLIN, 0};
+                pfds.push_back(pfd);
+                idx.push_back(i);
+            }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long elapsed = (now.tv_sec - start.tv_sec) * 1000 +
+                       (now.tv_nsec - start.tv_nsec) / 1000000;
+        if (elapsed >= timeout_ms) {
+            break;
+        }
+
+        int n = poll(&pfds[0], pfds.size(), (int)(timeout_ms - elapsed));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+
+        for (size_t i = 0; i < pfds.size(); ++i) {
+            if (!pfds[i].revents) {
+                continue;
+            }
+
+            plugin_probe &p = probes[idx[i]];
+            try {
+                Value envelope;
+                if (!p.c->tp->responseReadBuffered(envelope, false)) {
+                    continue;
+                }
+                std::vector<Value> j = Ipc::responseParse(envelope).asArray();
+                p.desc = j[0].asString();
+                p.version = j[1].asString();
+                p.ok = true;
+            } catch (const std::exception &e) {
+                // Plugin which cannot describe itself is left out, same as
+                // the sequential lookup did.
+            }
+            p.done = true;
+            --pending;
+        }
+    }
+}
+
 int lsm_available_plugins_list(const char *sep, lsm_string_list **plugins,
                                lsm_flag flags) {
     int rc = LSM_ERR_OK;
     DIR *dirp = NULL;
     struct dirent *dp = NULL;
-    lsm_connect *c = NULL;
     lsm_error_ptr e = NULL;
-    char *desc = NULL;
-    char *version = NULL;
     char *s = NULL;
     const char *uds_dir = uds_path();
     lsm_string_list *plugin_list = NULL;
+    std::vector<plugin_probe> probes;
 
     if (CHECK_STR(sep) || CHECK_RP(plugins) || LSM_FLAG_UNUSED_CHECK(flags)) {
         return LSM_ERR_INVALID_ARGUMENT;
@@ -413,52 +591,15 @@ int lsm_available_plugins_list(const char *sep, lsm_string_list **plugins,
             }
             // Check to see if we have a socket
             if (DT_SOCK == dp->d_type) {
-                c = connection_get();
-                if (c) {
-                    rc = driver_load(c, dp->d_name, NULL, 30000, &e, 0, 0);
-                    if (LSM_ERR_OK == rc) {
-                        // Get the plugin information
-                        rc = lsm_plugin_info_get(c, &desc, &version, 0);
-                        if (LSM_ERR_OK == rc) {
-                            int format =
-                                asprintf(&s, "%s%s%s", desc, sep, version);
-                            free(desc);
-                            desc = NULL;
-                            free(version);
-                            version = NULL;
-
-                            if (-1 == format) {
-                                rc = LSM_ERR_NO_MEMORY;
-                                break;
-                            }
-
-                            rc = lsm_string_list_append(plugin_list, s);
-                            free(s);
-                            s = NULL;
-                            if (LSM_ERR_OK != rc) {
-                                break;
-                            }
-                        }
-                    } else {
-                        break;
-                    }
-
-                    connection_free(c);
-                    c = NULL;
-                }
+                plugin_probe p;
+                p.name = dp->d_name;
+                p.c = NULL;
+                p.done = false;
+                p.ok = false;
+                probes.push_back(p);
             }
         } /* for(;;) */
 
-        if (e) {
-            lsm_error_free(e);
-            e = NULL;
-        }
-
-        if (c) {
-            connection_free(c);
-            c = NULL;
-        }
-
         if (-1 == closedir(dirp)) {
             // log the error
             rc = LSM_ERR_LIB_BUG;
@@ -469,6 +610,52 @@ int lsm_available_plugins_list(const char *sep, lsm_string_list **plugins,
         rc = LSM_ERR_LIB_BUG;
     }
 
+    for (size_t i = 0; LSM_ERR_OK == rc && i < probes.size(); ++i) {
+        plugin_probe &p = probes[i];
+
+        if (plugin_info_cache_read(uds_dir, p.name.c_str(), p.desc,
+                                   p.version)) {
+            p.done = p.ok = true;
+            continue;
+        }
+
+        p.c = connection_get();
+        if (!p.c) {
+            rc = LSM_ERR_NO_MEMORY;
+            break;
+        }
+
+        rc = driver_load(p.c, p.name.c_str(), NULL, 30000, &e, 0, 0);
+        if (e) {
+            lsm_error_free(e);
+            e = NULL;
+        }
+    }
+
+    if (LSM_ERR_OK == rc) {
+        plugin_info_collect(probes, 30000);
+    }
+
+    for (size_t i = 0; i < probes.size(); ++i) {
+        plugin_probe &p = probes[i];
+
+        if (LSM_ERR_OK == rc && p.ok) {
+            if (-1 == asprintf(&s, "%s%s%s", p.desc.c_str(), sep,
+                               p.version.c_str())) {
+                rc = LSM_ERR_NO_MEMORY;
+            } else {
+                rc = lsm_string_list_append(plugin_list, s);
+                free(s);
+                s = NULL;
+            }
+        }
+
+        if (p.c) {
+            connection_free(p.c);
+            p.c = NULL;
+        }
+    }
+
     if (LSM_ERR_OK == rc) {
         *plugins = plugin_list;
     } else {
@@ -749,6 +936,42 @@ int lsm_capabilities(lsm_connect *c, lsm_system *system,
     return rc;
 }
 
+static int get_pool_array(lsm_connect *c, int rc, Value &response,
+                          lsm_pool **pools[], uint32_t *count) {
+    if (LSM_ERR_OK != rc || Value::array_t != response.valueType()) {
+        return rc;
+    }
+
+    try {
+        std::vector<Value> pl = response.asArray();
+
+        if (pl.size()) {
+            *pools = lsm_pool_record_array_alloc(pl.size());
+            if (!*pools) {
+                return LSM_ERR_NO_MEMORY;
+            }
+            *count = pl.size();
+
+            for (size_t i = 0; i < pl.size(); ++i) {
+                (*pools)[i] = value_to_pool(pl[i]);
+                if (!(*pools)[i]) {
+                    rc = LSM_ERR_NO_MEMORY;
+                    break;
+                }
+            }
+        }
+    } catch (const ValueException &ve) {
+        rc = log_exception(c, LSM_ERR_PLUGIN_BUG, "Unexpected type", ve.what());
+    }
+
+    if (LSM_ERR_OK != rc && *pools) {
+        lsm_pool_record_array_free(*pools, *count);
+        *pools = NULL;
+        *count = 0;
+    }
+    return rc;
+}
+
 int lsm_pool_list(lsm_connect *c, char *search_key, char *search_value,
                   lsm_pool **poolArray[], uint32_t *count, lsm_flag flags) {
     int rc = LSM_ERR_OK;
@@ -761,52 +984,20 @@ int lsm_pool_list(lsm_connect *c, char *search_key, char *search_value,
     *count = 0;
     *poolArray = NULL;
 
-    try {
-        std::map<std::string, Value> p;
-
-        rc = add_search_params(p, search_key, search_value, POOL_SEARCH_KEYS,
-                               POOL_SEARCH_KEYS_COUNT);
-        if (LSM_ERR_OK != rc) {
-            return rc;
-        }
-
-        p["flags"] = Value(flags);
-        Value parameters(p);
-        Value response;
-
-        rc = rpc(c, "pools", parameters, response);
-        if (LSM_ERR_OK == rc && Value::array_t == response.valueType()) {
-            std::vector<Value> pools = response.asArray();
-
-            *count = pools.size();
-
-            if (pools.size()) {
-                *poolArray = lsm_pool_record_array_alloc(pools.size());
+    std::map<std::string, Value> p;
 
-                for (size_t i = 0; i < pools.size(); ++i) {
-                    (*poolArray)[i] = value_to_pool(pools[i]);
-                    if (!(*poolArray)[i]) {
-                        rc = LSM_ERR_NO_MEMORY;
-                        goto error;
-                    }
-                }
-            }
-        }
-    } catch (const ValueException &ve) {
-        rc = log_exception(c, LSM_ERR_PLUGIN_BUG, "Unexpected type", ve.what());
-        goto error;
+    rc = add_search_params(p, search_key, search_value, POOL_SEARCH_KEYS,
+                           POOL_SEARCH_KEYS_COUNT);
+    if (LSM_ERR_OK != rc) {
+        return rc;
     }
 
-out:
-    return rc;
+    p["flags"] = Value(flags);
+    Value parameters(p);
+    Value response;
 
-error:
-    if (*poolArray && *count) {
-        lsm_pool_record_array_free(*poolArray, *count);
-        *poolArray = NULL;
-        *count = 0;
-    }
-    goto out;
+    rc = rpc(c, "pools", parameters, response);
+    return get_pool_array(c, rc, response, poolArray, count);
 }
 
 int lsm_pool_member_info(lsm_connect *c, lsm_pool *pool,
@@ -2627,3 +2818,388 @@ int lsm_volume_read_cache_policy_update(lsm_connect *c, lsm_volume *volume,
     // No response data.
     return rpc(c, "volume_read_cache_policy_update", parameters, response);
 }
+
+/*
+ * Asynchronous requests.
+ *
+ * Requests are written to the plugin immediately and their responses are
+ * collected by lsm_connect_process() whenever the connection file descriptor
+ * becomes readable.  Plugins answer strictly in order, so each response is
+ * matched to the oldest request on the connection which is not yet done.
+ */
+
+static int request_submit(lsm_connect *c, const char *method,
+                          const Value &parameters, lsm_request_type type,
+                          lsm_request **req) {
+    lsm_request *r = (lsm_request *)calloc(1, sizeof(lsm_request));
+
+    if (!r) {
+        return LSM_ERR_NO_MEMORY;
+    }
+
+    r->magic = LSM_REQUEST_MAGIC;
+    r->type = type;
+
+    try {
+        c->tp->requestSend(method, parameters);
+    } catch (const ValueException &ve) {
+        request_free(r);
+        return log_exception(c, LSM_ERR_TRANSPORT_SERIALIZATION,
+                             "Serialization error", ve.what());
+    } catch (const LsmException &le) {
+        request_free(r);
+        return log_exception(c, (lsm_error_number)le.error_code, le.what(),
+                             NULL);
+    } catch (...) {
+        request_free(r);
+        return log_exception(c, LSM_ERR_LIB_BUG, "Unexpected exception",
+                             "Unknown exception");
+    }
+
+    // Append, responses are matched in submission order
+    if (c->requests_tail) {
+        c->requests_tail->next = r;
+    } else {
+        c->requests = r;
+    }
+    c->requests_tail = r;
+    *req = r;
+    return LSM_ERR_OK;
+}
+
+static void request_unlink(lsm_connect *c, lsm_request *r) {
+    lsm_request **cur = &c->requests;
+    lsm_request *prev = NULL;
+
+    while (*cur) {
+        if (*cur == r) {
+            *cur = r->next;
+            if (c->requests_tail == r) {
+                c->requests_tail = prev;
+            }
+            r->next = NULL;
+            break;
+        }
+        prev = *cur;
+        cur = &(*cur)->next;
+    }
+}
+
+/**
+ * Stores the result of the oldest pending request.  Returns 1 if the caller
+ * can collect it, 0 if it was orphaned and so released here.
+ */
+static uint32_t request_complete(lsm_connect *c, lsm_request *r,
+                                 Value &envelope) {
+    try {
+        Value result = Ipc::responseParse(envelope);
+        r->response = new Value(result);
+        r->rc = LSM_ERR_OK;
+    } catch (const LsmException &le) {
+        r->rc = le.error_code;
+        r->error = lsm_error_create((lsm_error_number)le.error_code, le.what(),
+                                    NULL, le.debug.c_str(), NULL, 0);
+    } catch (const ValueException &ve) {
+        r->rc = LSM_ERR_TRANSPORT_SERIALIZATION;
+        r->error = lsm_error_create(LSM_ERR_TRANSPORT_SERIALIZATION,
+                                    "Serialization error", ve.what(), NULL,
+                                    NULL, 0);
+    } catch (const std::bad_alloc &ba) {
+        r->rc = LSM_ERR_NO_MEMORY;
+    }
+
+    r->done = 1;
+
+    if (r->orphaned) {
+        request_unlink(c, r);
+        request_free(r);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Fails every pending request.  Returns how many of them the caller can
+ * collect.
+ */
+static uint32_t request_fail_pending(lsm_connect *c, int code,
+                                     const char *msg) {
+    lsm_request *r = NULL;
+    uint32_t failed = 0;
+
+    while ((r = request_pending_first(c)) != NULL) {
+        r->rc = code;
+        r->error = lsm_error_create((lsm_error_number)code, msg, NULL, NULL,
+                                    NULL, 0);
+        r->done = 1;
+
+        if (r->orphaned) {
+            request_unlink(c, r);
+            request_free(r);
+        } else {
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+static int request_read(lsm_connect *c, bool block, uint32_t *completed) {
+    lsm_request *r = NULL;
+    int rc = LSM_ERR_OK;
+
+    try {
+        while ((r = request_pending_first(c)) != NULL) {
+            Value envelope;
+
+            if (!c->tp->responseReadBuffered(envelope, block)) {
+                break;
+            }
+            *completed += request_complete(c, r, envelope);
+        }
+    } catch (const EOFException &eof) {
+        *completed += request_fail_pending(
+            c, LSM_ERR_TRANSPORT_COMMUNICATION, "Plug-in died");
+        rc = log_exception(c, LSM_ERR_TRANSPORT_COMMUNICATION, "Plug-in died",
+                           "Check syslog");
+    } catch (const ValueException &ve) {
+        *completed += request_fail_pending(
+            c, LSM_ERR_TRANSPORT_SERIALIZATION, "Serialization error");
+        rc = log_exception(c, LSM_ERR_TRANSPORT_SERIALIZATION,
+                           "Serialization error", ve.what());
+    }
+    return rc;
+}
+
+static int request_drain(lsm_connect *c) {
+    uint32_t completed = 0;
+    return request_read(c, true, &completed);
+}
+
+/**
+ * Validates a request before handing back its result and logs any plugin
+ * supplied error against the connection.
+ */
+#define REQUEST_RESULT_SETUP(c, r, t)                                          \
+    do {                                                                       \
+        CONN_SETUP(c);                                                         \
+        if (!LSM_IS_REQUEST(r) || (r)->type != (t) || !(r)->done) {            \
+            return LSM_ERR_INVALID_ARGUMENT;                                   \
+        }                                                                      \
+        if (LSM_ERR_OK != (r)->rc) {                                           \
+            if ((r)->error) {                                                  \
+                lsm_error_log(c, (r)->error);                                  \
+                (r)->error = NULL;                                             \
+            }                                                                  \
+            return (r)->rc;                                                    \
+        }                                                                      \
+    } while (0)
+
+int lsm_connect_fd_get(lsm_connect *c, int *fd, lsm_flag flags) {
+    CONN_SETUP(c);
+
+    if (!fd || LSM_FLAG_UNUSED_CHECK(flags) || !c->tp) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    *fd = c->tp->fd();
+    return LSM_ERR_OK;
+}
+
+int lsm_connect_process(lsm_connect *c, uint32_t *completed, lsm_flag flags) {
+    CONN_SETUP(c);
+
+    if (!completed || LSM_FLAG_UNUSED_CHECK(flags)) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    *completed = 0;
+    return request_read(c, false, completed);
+}
+
+int lsm_request_done(lsm_request *req, int *done) {
+    if (!LSM_IS_REQUEST(req) || !done) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    *done = req->done ? 1 : 0;
+    return LSM_ERR_OK;
+}
+
+int lsm_request_free(lsm_connect *c, lsm_request *req) {
+    CONN_SETUP(c);
+
+    if (!LSM_IS_REQUEST(req)) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    if (req->done) {
+        request_unlink(c, req);
+        request_free(req);
+    } else {
+        // Response is still to come, release it when it arrives
+        req->orphaned = 1;
+    }
+    return LSM_ERR_OK;
+}
+
+int lsm_volume_list_async(lsm_connect *c, const char *search_key,
+                          const char *search_value, lsm_request **req,
+                          lsm_flag flags) {
+    CONN_SETUP(c);
+
+    if (CHECK_RP(req) || LSM_FLAG_UNUSED_CHECK(flags)) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    std::map<std::string, Value> p;
+    p["flags"] = Value(flags);
+
+    int rc = add_search_params(p, search_key, search_value, VOLUME_SEARCH_KEYS,
+                               VOLUME_SEARCH_KEYS_COUNT);
+    if (LSM_ERR_OK != rc) {
+        return rc;
+    }
+
+    return request_submit(c, "volumes", Value(p), LSM_REQUEST_TYPE_VOLUMES,
+                          req);
+}
+
+int lsm_pool_list_async(lsm_connect *c, const char *search_key,
+                        const char *search_value, lsm_request **req,
+                        lsm_flag flags) {
+    CONN_SETUP(c);
+
+    if (CHECK_RP(req) || LSM_FLAG_UNUSED_CHECK(flags)) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    std::map<std::string, Value> p;
+    p["flags"] = Value(flags);
+
+    int rc = add_search_params(p, search_key, search_value, POOL_SEARCH_KEYS,
+                               POOL_SEARCH_KEYS_COUNT);
+    if (LSM_ERR_OK != rc) {
+        return rc;
+    }
+
+    return request_submit(c, "pools", Value(p), LSM_REQUEST_TYPE_POOLS, req);
+}
+
+int lsm_volume_create_async(lsm_connect *c, lsm_pool *pool,
+                            const char *volume_name, uint64_t size,
+                            lsm_volume_provision_type provisioning,
+                            lsm_request **req, lsm_flag flags) {
+    CONN_SETUP(c);
+
+    if (!LSM_IS_POOL(pool) || CHECK_STR(volume_name) || !size ||
+        CHECK_RP(req) || LSM_FLAG_UNUSED_CHECK(flags)) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    std::map<std::string, Value> p;
+    p["pool"] = pool_to_value(pool);
+    p["volume_name"] = Value(volume_name);
+    p["size_bytes"] = Value(size);
+    p["provisioning"] = Value((int32_t)provisioning);
+    p["flags"] = Value(flags);
+
+    return request_submit(c, "volume_create", Value(p), LSM_REQUEST_TYPE_VOLUME,
+                          req);
+}
+
+int lsm_volume_resize_async(lsm_connect *c, lsm_volume *volume,
+                            uint64_t new_size, lsm_request **req,
+                            lsm_flag flags) {
+    CONN_SETUP(c);
+
+    if (!LSM_IS_VOL(volume) || !new_size || CHECK_RP(req) ||
+        LSM_FLAG_UNUSED_CHECK(flags)) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    if ((new_size / volume->block_size) == volume->number_of_blocks) {
+        return LSM_ERR_NO_STATE_CHANGE;
+    }
+
+    std::map<std::string, Value> p;
+    p["volume"] = volume_to_value(volume);
+    p["new_size_bytes"] = Value(new_size);
+    p["flags"] = Value(flags);
+
+    return request_submit(c, "volume_resize", Value(p), LSM_REQUEST_TYPE_VOLUME,
+                          req);
+}
+
+int lsm_volume_delete_async(lsm_connect *c, lsm_volume *volume,
+                            lsm_request **req, lsm_flag flags) {
+    CONN_SETUP(c);
+
+    if (!LSM_IS_VOL(volume) || CHECK_RP(req) || LSM_FLAG_UNUSED_CHECK(flags)) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    return request_submit(c, "volume_delete",
+                          _create_volume_flag_param(volume, flags),
+                          LSM_REQUEST_TYPE_JOB, req);
+}
+
+int lsm_request_volumes_get(lsm_connect *c, lsm_request *req,
+                            lsm_volume **volumes[], uint32_t *count) {
+    REQUEST_RESULT_SETUP(c, req, LSM_REQUEST_TYPE_VOLUMES);
+
+    if (CHECK_RP(volumes) || !count) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    *count = 0;
+    return get_volume_array(c, LSM_ERR_OK, *req->response, volumes, count);
+}
+
+int lsm_request_pools_get(lsm_connect *c, lsm_request *req,
+                          lsm_pool **pools[], uint32_t *count) {
+    REQUEST_RESULT_SETUP(c, req, LSM_REQUEST_TYPE_POOLS);
+
+    if (CHECK_RP(pools) || !count) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    *count = 0;
+    return get_pool_array(c, LSM_ERR_OK, *req->response, pools, count);
+}
+
+int lsm_request_volume_get(lsm_connect *c, lsm_request *req,
+                           lsm_volume **volume, char **job) {
+    int rc = LSM_ERR_OK;
+    REQUEST_RESULT_SETUP(c, req, LSM_REQUEST_TYPE_VOLUME);
+
+    if (CHECK_RP(volume) || CHECK_RP(job)) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    *volume = (lsm_volume *)parse_job_response(c, *req->response, rc, job,
+                                               (convert)value_to_volume);
+    return rc;
+}
+
+int lsm_request_job_get(lsm_connect *c, lsm_request *req, char **job) {
+    REQUEST_RESULT_SETUP(c, req, LSM_REQUEST_TYPE_JOB);
+
+    if (CHECK_RP(job)) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    return job_check(c, LSM_ERR_OK, *req->response, job);
+}
+
+int lsm_connect_rpc_timing_cb_set(lsm_connect *c, lsm_rpc_timing_cb cb,
+                                  void *user_data, lsm_flag flags) {
+    CONN_SETUP(c);
+
+    if (LSM_FLAG_UNUSED_CHECK(flags)) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    c->timing_cb = cb;
+    c->timing_data = user_data;
+    return LSM_ERR_OK;
+}
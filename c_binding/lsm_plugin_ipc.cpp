@@ -32,16 +32,25 @@
 #include "lsm_convert.hpp"
 #include "lsm_datatypes.hpp"
 #include "lsm_ipc.hpp"
+#include "lsm_trace.hpp"
 #include "util/qparams.h"
+#include <algorithm>
+#include <deque>
 #include <errno.h>
+#include <inttypes.h>
 #include <libxml/uri.h>
+#include <map>
+#include <pthread.h>
 #include <string.h>
 #include <syslog.h>
+#include <time.h>
 
 #define UNUSED(x) (void)(x)
 
 // Forward decl.
 static int lsm_plugin_run(lsm_plugin_ptr plug);
+static int handle_plugin_stats(lsm_plugin_ptr p, Value &params,
+                               Value &response);
 static void get_batteries(int rc, lsm_battery *bs[], uint32_t count,
                           Value &response);
 static int handle_batteries(lsm_plugin_ptr p, Value &params, Value &response);
@@ -174,12 +183,425 @@ void *lsm_private_data_get(lsm_plugin_ptr plug) {
     return plug->private_data;
 }
 
+/* Jobs running at the same time, further jobs wait in the queue */
+#define LSM_PLUGIN_JOB_WORKERS   4
+#define LSM_PLUGIN_JOB_ID_PREFIX "LSM_PLUGIN_JOB_"
+
+/**
+ * Job run by the executor on behalf of the plug-in.
+ */
+struct LSM_DLL_LOCAL _lsm_plugin_job {
+    uint32_t magic;                   /**< Magic, used for struct validation */
+    lsm_plugin_ptr plug;              /**< Plug-in the job belongs to */
+    char *id;                         /**< Job id given to the client */
+    lsm_plug_job_work work;           /**< Work to run */
+    void *data;                       /**< Passed to work */
+    lsm_plug_job_data_free data_free; /**< Frees data, may be NULL */
+    int running;                      /**< Non-zero while work runs */
+    int done;                         /**< Non-zero once work returned */
+    int cancelled;                    /**< Freed by client or unregistering */
+    int orphaned;                     /**< Freed by client while running */
+    uint8_t percent;                  /**< Progress reported by work */
+    int rc;                           /**< Return code of work */
+    char *err_msg;                    /**< Error message set by work */
+    lsm_data_type result_type;        /**< Type of result */
+    void *result;                     /**< Result set by work */
+};
+
+/**
+ * Job executor of a plug-in, created on first job submission.  Everything
+ * in here and the state of its jobs is protected by lock.
+ */
+struct LSM_DLL_LOCAL _lsm_plugin_jobs {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;  /**< Signalled on new job and on stop */
+    std::map<std::string, lsm_plugin_job *> jobs; /**< Jobs not freed yet */
+    std::deque<lsm_plugin_job *> queue; /**< Jobs waiting for a worker */
+    std::vector<pthread_t> workers;
+    size_t idle;          /**< Workers waiting for a job */
+    uint64_t last_id;     /**< Number of the last job id handed out */
+    bool stopping;        /**< Plug-in is unregistering */
+};
+
+static pthread_mutex_t plugin_jobs_create_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool plugin_job_result_valid(lsm_data_type t, void *value) {
+    switch (t) {
+    case (LSM_DATA_TYPE_VOLUME):
+        return LSM_IS_VOL((lsm_volume *)value);
+    case (LSM_DATA_TYPE_FS):
+        return LSM_IS_FS((lsm_fs *)value);
+    case (LSM_DATA_TYPE_SS):
+        return LSM_IS_SS((lsm_fs_ss *)value);
+    case (LSM_DATA_TYPE_POOL):
+        return LSM_IS_POOL((lsm_pool *)value);
+    default:
+        return false;
+    }
+}
+
+static void plugin_job_result_free(lsm_data_type t, void *value) {
+    switch (t) {
+    case (LSM_DATA_TYPE_VOLUME):
+        lsm_volume_record_free((lsm_volume *)value);
+        break;
+    case (LSM_DATA_TYPE_FS):
+        lsm_fs_record_free((lsm_fs *)value);
+        break;
+    case (LSM_DATA_TYPE_SS):
+        lsm_fs_ss_record_free((lsm_fs_ss *)value);
+        break;
+    case (LSM_DATA_TYPE_POOL):
+        lsm_pool_record_free((lsm_pool *)value);
+        break;
+    default:
+        break;
+    }
+}
+
+static void plugin_job_destroy(lsm_plugin_job *job) {
+    if (job->data_free) {
+        job->data_free(job->data);
+    }
+    if (job->result) {
+        plugin_job_result_free(job->result_type, job->result);
+    }
+    free(job->err_msg);
+    free(job->id);
+    job->magic = LSM_DEL_MAGIC(LSM_PLUGIN_JOB_MAGIC);
+    free(job);
+}
+
+static void *plugin_job_worker(void *arg) {
+    lsm_plugin_ptr p = (lsm_plugin_ptr)arg;
+    struct _lsm_plugin_jobs *jobs = p->jobs;
+    lsm_plugin_job *job = NULL;
+    int rc = LSM_ERR_OK;
+
+    pthread_mutex_lock(&jobs->lock);
+    while (true) {
+        while (jobs->queue.empty() && !jobs->stopping) {
+            jobs->idle++;
+            pthread_cond_wait(&jobs->cond, &jobs->lock);
+            jobs->idle--;
+        }
+        /* Jobs still queued are dropped by plugin_jobs_stop() */
+        if (jobs->stopping) {
+            break;
+        }
+
+        job = jobs->queue.front();
+        jobs->queue.pop_front();
+        job->running = 1;
+        pthread_mutex_unlock(&jobs->lock);
+
+        rc = job->work(p, job, job->data);
+
+        pthread_mutex_lock(&jobs->lock);
+        job->running = 0;
+        job->done = 1;
+        job->rc = rc;
+        if (LSM_ERR_OK == rc) {
+            job->percent = 100;
+        }
+        if (job->orphaned) {
+            plugin_job_destroy(job);
+        }
+    }
+    pthread_mutex_unlock(&jobs->lock);
+    return NULL;
+}
+
+static struct _lsm_plugin_jobs *plugin_jobs_get(lsm_plugin_ptr p) {
+    pthread_mutex_lock(&plugin_jobs_create_lock);
+    if (NULL == p->jobs) {
+        struct _lsm_plugin_jobs *jobs = new (std::nothrow) _lsm_plugin_jobs;
+        if (jobs) {
+            pthread_mutex_init(&jobs->lock, NULL);
+            pthread_cond_init(&jobs->cond, NULL);
+            jobs->idle = 0;
+            jobs->last_id = 0;
+            jobs->stopping = false;
+            p->jobs = jobs;
+        }
+    }
+    pthread_mutex_unlock(&plugin_jobs_create_lock);
+    return p->jobs;
+}
+
+/**
+ * Cancels every job and waits for the workers to exit, then frees the jobs
+ * left and the executor.
+ */
+static void plugin_jobs_stop(lsm_plugin_ptr p) {
+    struct _lsm_plugin_jobs *jobs = p->jobs;
+    std::map<std::string, lsm_plugin_job *>::iterator i;
+
+    if (NULL == jobs) {
+        return;
+    }
+
+    pthread_mutex_lock(&jobs->lock);
+    jobs->stopping = true;
+    for (i = jobs->jobs.begin(); i != jobs->jobs.end(); ++i) {
+        i->second->cancelled = 1;
+    }
+    pthread_cond_broadcast(&jobs->cond);
+    pthread_mutex_unlock(&jobs->lock);
+
+    for (size_t w = 0; w < jobs->workers.size(); ++w) {
+        pthread_join(jobs->workers[w], NULL);
+    }
+
+    for (i = jobs->jobs.begin(); i != jobs->jobs.end(); ++i) {
+        plugin_job_destroy(i->second);
+    }
+
+    pthread_cond_destroy(&jobs->cond);
+    pthread_mutex_destroy(&jobs->lock);
+    delete jobs;
+    p->jobs = NULL;
+}
+
+/**
+ * Answers job_status for jobs of the executor.
+ * @return false if job_id is not one of them, else true with rc set.
+ */
+static bool plugin_job_status(lsm_plugin_ptr p, const std::string &job_id,
+                              lsm_job_status *status, uint8_t *percent,
+                              lsm_data_type *t, void **value, int *rc) {
+    struct _lsm_plugin_jobs *jobs = p->jobs;
+    std::map<std::string, lsm_plugin_job *>::iterator i;
+    lsm_plugin_job *job = NULL;
+    std::string err_msg;
+
+    if (NULL == jobs) {
+        return false;
+    }
+
+    pthread_mutex_lock(&jobs->lock);
+    i = jobs->jobs.find(job_id);
+    if (i == jobs->jobs.end()) {
+        pthread_mutex_unlock(&jobs->lock);
+        return false;
+    }
+
+    job = i->second;
+    *rc = LSM_ERR_OK;
+    *value = NULL;
+    *t = LSM_DATA_TYPE_NONE;
+    if (!job->done) {
+        *status = LSM_JOB_INPROGRESS;
+        *percent = job->percent;
+    } else if (LSM_ERR_OK == job->rc) {
+        *status = LSM_JOB_COMPLETE;
+        *percent = 100;
+        if (job->result) {
+            *t = job->result_type;
+            *value = lsm_data_type_copy(job->result_type, job->result);
+            if (NULL == *value) {
+                *rc = LSM_ERR_NO_MEMORY;
+            }
+        }
+    } else {
+        *rc = job->rc;
+        err_msg = job->err_msg ? job->err_msg : "Job failed";
+    }
+    pthread_mutex_unlock(&jobs->lock);
+
+    if (!err_msg.empty()) {
+        lsm_log_error_basic(p, (lsm_error_number)*rc, err_msg.c_str());
+    }
+    return true;
+}
+
+/**
+ * Answers job_free for jobs of the executor.  A running job is cancelled and
+ * freed by its worker once work returns.
+ * @return false if job_id is not one of them.
+ */
+static bool plugin_job_free(lsm_plugin_ptr p, const std::string &job_id) {
+    struct _lsm_plugin_jobs *jobs = p->jobs;
+    std::map<std::string, lsm_plugin_job *>::iterator i;
+    lsm_plugin_job *job = NULL;
+
+    if (NULL == jobs) {
+        return false;
+    }
+
+    pthread_mutex_lock(&jobs->lock);
+    i = jobs->jobs.find(job_id);
+    if (i == jobs->jobs.end()) {
+        pthread_mutex_unlock(&jobs->lock);
+        return false;
+    }
+
+    job = i->second;
+    jobs->jobs.erase(i);
+    if (job->running) {
+        job->cancelled = 1;
+        job->orphaned = 1;
+        job = NULL;
+    } else if (!job->done) {
+        jobs->queue.erase(
+            std::find(jobs->queue.begin(), jobs->queue.end(), job));
+    }
+    pthread_mutex_unlock(&jobs->lock);
+
+    if (job) {
+        plugin_job_destroy(job);
+    }
+    return true;
+}
+
+int lsm_plugin_job_submit(lsm_plugin_ptr plug, lsm_plug_job_work work,
+                          void *data, lsm_plug_job_data_free data_free,
+                          char **job_id) {
+    struct _lsm_plugin_jobs *jobs = NULL;
+    lsm_plugin_job *job = NULL;
+    char id[64];
+    pthread_t worker;
+    int rc = LSM_ERR_OK;
+
+    if (!LSM_IS_PLUGIN(plug) || NULL == work || NULL == job_id) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    *job_id = NULL;
+    jobs = plugin_jobs_get(plug);
+    job = (lsm_plugin_job *)calloc(1, sizeof(lsm_plugin_job));
+    if (NULL == jobs || NULL == job) {
+        free(job);
+        return LSM_ERR_NO_MEMORY;
+    }
+
+    job->magic = LSM_PLUGIN_JOB_MAGIC;
+    job->plug = plug;
+    job->work = work;
+    job->data = data;
+    job->data_free = data_free;
+
+    pthread_mutex_lock(&jobs->lock);
+    snprintf(id, sizeof(id), LSM_PLUGIN_JOB_ID_PREFIX "%" PRIu64,
+             ++jobs->last_id);
+    job->id = strdup(id);
+    *job_id = strdup(id);
+
+    if (NULL == job->id || NULL == *job_id) {
+        rc = LSM_ERR_NO_MEMORY;
+    } else {
+        jobs->jobs[id] = job;
+        jobs->queue.push_back(job);
+
+        /* Start another worker unless an idle one can take the job */
+        if (jobs->queue.size() > jobs->idle &&
+            jobs->workers.size() < LSM_PLUGIN_JOB_WORKERS) {
+            if (0 == pthread_create(&worker, NULL, plugin_job_worker, plug)) {
+                jobs->workers.push_back(worker);
+            } else if (jobs->workers.empty()) {
+                jobs->jobs.erase(id);
+                jobs->queue.pop_back();
+                rc = LSM_ERR_NO_MEMORY;
+            }
+        }
+        if (LSM_ERR_OK == rc) {
+            pthread_cond_signal(&jobs->cond);
+        }
+    }
+    pthread_mutex_unlock(&jobs->lock);
+
+    if (LSM_ERR_OK != rc) {
+        /* Data stays with the caller */
+        job->data_free = NULL;
+        plugin_job_destroy(job);
+        free(*job_id);
+        *job_id = NULL;
+    }
+    return rc;
+}
+
+int lsm_plugin_job_progress_set(lsm_plugin_job *job, uint8_t percent) {
+    if (!LSM_IS_PLUGIN_JOB(job) || percent > 100) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    pthread_mutex_lock(&job->plug->jobs->lock);
+    job->percent = percent;
+    pthread_mutex_unlock(&job->plug->jobs->lock);
+    return LSM_ERR_OK;
+}
+
+int lsm_plugin_job_cancelled(lsm_plugin_job *job) {
+    int cancelled = 0;
+
+    if (LSM_IS_PLUGIN_JOB(job)) {
+        pthread_mutex_lock(&job->plug->jobs->lock);
+        cancelled = job->cancelled;
+        pthread_mutex_unlock(&job->plug->jobs->lock);
+    }
+    return cancelled;
+}
+
+int lsm_plugin_job_result_set(lsm_plugin_job *job, lsm_data_type t,
+                              void *value) {
+    void *copy = NULL;
+    void *old = NULL;
+    lsm_data_type old_type = LSM_DATA_TYPE_NONE;
+
+    if (!LSM_IS_PLUGIN_JOB(job) ||
+        (value && !plugin_job_result_valid(t, value))) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    if (value) {
+        copy = lsm_data_type_copy(t, value);
+        if (NULL == copy) {
+            return LSM_ERR_NO_MEMORY;
+        }
+    }
+
+    pthread_mutex_lock(&job->plug->jobs->lock);
+    old = job->result;
+    old_type = job->result_type;
+    job->result = copy;
+    job->result_type = copy ? t : LSM_DATA_TYPE_NONE;
+    pthread_mutex_unlock(&job->plug->jobs->lock);
+
+    if (old) {
+        plugin_job_result_free(old_type, old);
+    }
+    return LSM_ERR_OK;
+}
+
+int lsm_plugin_job_error_set(lsm_plugin_job *job, const char *msg) {
+    char *copy = NULL;
+
+    if (!LSM_IS_PLUGIN_JOB(job) || NULL == msg) {
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    copy = strdup(msg);
+    if (NULL == copy) {
+        return LSM_ERR_NO_MEMORY;
+    }
+
+    pthread_mutex_lock(&job->plug->jobs->lock);
+    std::swap(job->err_msg, copy);
+    pthread_mutex_unlock(&job->plug->jobs->lock);
+
+    free(copy);
+    return LSM_ERR_OK;
+}
+
 static void lsm_plugin_free(lsm_plugin_ptr p, lsm_flag flags) {
     if (LSM_IS_PLUGIN(p)) {
 
         delete (p->tp);
         p->tp = NULL;
 
+        /* Job work may use plug-in private data freed by unreg */
+        plugin_jobs_stop(p);
+
         if (p->unreg) {
             p->unreg(p, flags);
         }
@@ -403,7 +825,12 @@ static int handle_job_status(lsm_plugin_ptr p, Value &params, Value &response) {
     void *value = NULL;
     int rc = LSM_ERR_NO_SUPPORT;
 
-    if (p && p->mgmt_ops && p->mgmt_ops->job_status) {
+    if (p && Value::string_t == params["job_id"].valueType() &&
+        LSM_FLAG_EXPECTED_TYPE(params) &&
+        plugin_job_status(p, params["job_id"].asString(), &status, &percent,
+                          &t, &value, &rc)) {
+        /* Job run by the executor, answered without the plug-in */
+    } else if (p && p->mgmt_ops && p->mgmt_ops->job_status) {
 
         if (Value::string_t != params["job_id"].valueType() &&
             !LSM_FLAG_EXPECTED_TYPE(params)) {
@@ -415,39 +842,37 @@ static int handle_job_status(lsm_plugin_ptr p, Value &params, Value &response) {
             rc =
                 p->mgmt_ops->job_status(p, job_id.c_str(), &status, &percent,
                                         &t, &value, LSM_FLAG_GET_VALUE(params));
+        }
+    }
 
-            if (LSM_ERR_OK == rc) {
-                std::vector<Value> result;
+    if (LSM_ERR_OK == rc) {
+        std::vector<Value> result;
 
-                result.push_back(Value((int32_t)status));
-                result.push_back(Value(percent));
+        result.push_back(Value((int32_t)status));
+        result.push_back(Value(percent));
 
-                if (NULL == value) {
-                    result.push_back(Value());
-                } else {
-                    if (LSM_DATA_TYPE_VOLUME == t &&
-                        LSM_IS_VOL((lsm_volume *)value)) {
-                        result.push_back(volume_to_value((lsm_volume *)value));
-                        lsm_volume_record_free((lsm_volume *)value);
-                    } else if (LSM_DATA_TYPE_FS == t &&
-                               LSM_IS_FS((lsm_fs *)value)) {
-                        result.push_back(fs_to_value((lsm_fs *)value));
-                        lsm_fs_record_free((lsm_fs *)value);
-                    } else if (LSM_DATA_TYPE_SS == t &&
-                               LSM_IS_SS((lsm_fs_ss *)value)) {
-                        result.push_back(ss_to_value((lsm_fs_ss *)value));
-                        lsm_fs_ss_record_free((lsm_fs_ss *)value);
-                    } else if (LSM_DATA_TYPE_POOL == t &&
-                               LSM_IS_POOL((lsm_pool *)value)) {
-                        result.push_back(pool_to_value((lsm_pool *)value));
-                        lsm_pool_record_free((lsm_pool *)value);
-                    } else {
-                        rc = LSM_ERR_PLUGIN_BUG;
-                    }
-                }
-                response = Value(result);
+        if (NULL == value) {
+            result.push_back(Value());
+        } else {
+            if (LSM_DATA_TYPE_VOLUME == t && LSM_IS_VOL((lsm_volume *)value)) {
+                result.push_back(volume_to_value((lsm_volume *)value));
+                lsm_volume_record_free((lsm_volume *)value);
+            } else if (LSM_DATA_TYPE_FS == t && LSM_IS_FS((lsm_fs *)value)) {
+                result.push_back(fs_to_value((lsm_fs *)value));
+                lsm_fs_record_free((lsm_fs *)value);
+            } else if (LSM_DATA_TYPE_SS == t &&
+                       LSM_IS_SS((lsm_fs_ss *)value)) {
+                result.push_back(ss_to_value((lsm_fs_ss *)value));
+                lsm_fs_ss_record_free((lsm_fs_ss *)value);
+            } else if (LSM_DATA_TYPE_POOL == t &&
+                       LSM_IS_POOL((lsm_pool *)value)) {
+                result.push_back(pool_to_value((lsm_pool *)value));
+                lsm_pool_record_free((lsm_pool *)value);
+            } else {
+                rc = LSM_ERR_PLUGIN_BUG;
             }
         }
+        response = Value(result);
     }
     return rc;
 }
@@ -471,7 +896,11 @@ static int handle_plugin_info(lsm_plugin_ptr p, Value &params,
 static int handle_job_free(lsm_plugin_ptr p, Value &params, Value &response) {
     int rc = LSM_ERR_NO_SUPPORT;
     UNUSED(response);
-    if (p && p->mgmt_ops && p->mgmt_ops->job_free) {
+    if (p && Value::string_t == params["job_id"].valueType() &&
+        LSM_FLAG_EXPECTED_TYPE(params) &&
+        plugin_job_free(p, params["job_id"].asString())) {
+        rc = LSM_ERR_OK;
+    } else if (p && p->mgmt_ops && p->mgmt_ops->job_free) {
         if (Value::string_t == params["job_id"].valueType() &&
             LSM_FLAG_EXPECTED_TYPE(params)) {
             std::string job_num = params["job_id"].asString();
@@ -2392,6 +2821,7 @@ static std::map<std::string, handler> dispatch =
         "fs_snapshots", ss_list)("time_out_get", handle_get_time_out)(
         "iscsi_chap_auth", iscsi_chap)("job_free", handle_job_free)(
         "job_status", handle_job_status)("plugin_info", handle_plugin_info)(
+        "plugin_stats", handle_plugin_stats)(
         "pools", handle_pools)("target_ports", handle_target_ports)(
         "time_out_set", handle_set_time_out)("plugin_unregister",
                                              handle_unregister)(
@@ -2421,6 +2851,92 @@ static std::map<std::string, handler> dispatch =
         "volume_write_cache_policy_update", handle_volume_wcp_update)(
         "volume_read_cache_policy_update", handle_volume_rcp_update);
 
+/**
+ * Number of latency histogram buckets, bucket i counts calls which took
+ * [2^i, 2^(i+1)) microseconds, the first and last are open ended.
+ */
+#define PLUGIN_STATS_BUCKETS 32
+
+/**
+ * Accounting for one RPC method, reported by plugin_stats.
+ */
+struct LSM_DLL_LOCAL method_stats {
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    uint64_t total_us;
+    uint64_t max_us;
+    uint64_t histogram[PLUGIN_STATS_BUCKETS];
+};
+
+/**
+ * Accounting for every method this plugin process was asked for.
+ */
+static std::map<std::string, method_stats> stats;
+
+static void stats_record(const std::string &method, int rc,
+                         const struct timespec &start, uint64_t bytes_in,
+                         uint64_t bytes_out) {
+    struct timespec end;
+    uint64_t us = 0;
+    uint64_t v = 0;
+    unsigned int bucket = 0;
+    method_stats &m = stats[method];
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    us = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000 +
+         (end.tv_nsec - start.tv_nsec) / 1000;
+
+    for (v = us; v > 1 && bucket < PLUGIN_STATS_BUCKETS - 1; v >>= 1) {
+        bucket++;
+    }
+
+    m.calls++;
+    if (LSM_ERR_OK != rc && LSM_ERR_JOB_STARTED != rc) {
+        m.errors++;
+    }
+    m.bytes_in += bytes_in;
+    m.bytes_out += bytes_out;
+    m.total_us += us;
+    m.max_us = std::max(m.max_us, us);
+    m.histogram[bucket]++;
+}
+
+static int handle_plugin_stats(lsm_plugin_ptr p, Value &params,
+                               Value &response) {
+    std::vector<Value> result;
+    std::map<std::string, method_stats>::const_iterator i;
+
+    UNUSED(p);
+
+    if (!LSM_FLAG_EXPECTED_TYPE(params)) {
+        return LSM_ERR_TRANSPORT_INVALID_ARG;
+    }
+
+    for (i = stats.begin(); i != stats.end(); ++i) {
+        std::map<std::string, Value> m;
+        std::vector<Value> histogram;
+
+        for (unsigned int b = 0; b < PLUGIN_STATS_BUCKETS; ++b) {
+            histogram.push_back(Value(i->second.histogram[b]));
+        }
+
+        m["method"] = Value(i->first);
+        m["calls"] = Value(i->second.calls);
+        m["errors"] = Value(i->second.errors);
+        m["bytes_in"] = Value(i->second.bytes_in);
+        m["bytes_out"] = Value(i->second.bytes_out);
+        m["total_us"] = Value(i->second.total_us);
+        m["max_us"] = Value(i->second.max_us);
+        m["histogram"] = Value(histogram);
+        result.push_back(Value(m));
+    }
+
+    response = Value(result);
+    return LSM_ERR_OK;
+}
+
 static int process_request(lsm_plugin_ptr p, const std::string &method,
                            Value &request, Value &response) {
     int rc = LSM_ERR_LIB_BUG;
@@ -2450,19 +2966,44 @@ static int lsm_plugin_run(lsm_plugin_ptr p) {
                     break;
                 }
 
+                uint64_t rx = p->tp->bytesReceived();
                 Value req = p->tp->readRequest();
                 Value resp;
+                struct timespec start;
+
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                rx = p->tp->bytesReceived() - rx;
 
                 if (req.isValidRequest()) {
                     std::string method = req["method"].asString();
-                    rc = process_request(p, method, req, resp);
+                    uint64_t tx = p->tp->bytesSent();
+                    std::string trace_id;
+
+                    if (trace_enabled() &&
+                        Value::string_t == req["trace_id"].valueType()) {
+                        trace_id = req["trace_id"].asString();
+                    }
 
-                    if (LSM_ERR_OK == rc || LSM_ERR_JOB_STARTED == rc) {
-                        p->tp->responseSend(resp);
-                    } else {
-                        error_send(p, rc);
+                    {
+                        TraceSpan span("dispatch ", method, trace_id);
+                        if (!trace_id.empty()) {
+                            trace_flow(trace_id, false);
+                        }
+                        rc = process_request(p, method, req, resp);
                     }
 
+                    {
+                        TraceSpan span("reply ", method, trace_id);
+                        if (LSM_ERR_OK == rc || LSM_ERR_JOB_STARTED == rc) {
+                            p->tp->responseSend(resp);
+                        } else {
+                            error_send(p, rc);
+                        }
+                    }
+
+                    stats_record(method, rc, start, rx,
+                                 p->tp->bytesSent() - tx);
+
                     if (method == "plugin_unregister") {
                         flags = LSM_FLAG_GET_VALUE(req["params"]);
                         break;
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lsm_trace.hpp"
+#include "lsm_trace_file.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static FILE *trace_file = NULL;
+static pid_t trace_pid = 0;
+static uint64_t trace_seq = 0;
+
+static pthread_once_t trace_once = PTHREAD_ONCE_INIT;
+static bool trace_on = false;
+
+static void trace_env_read(void) {
+    const char *dir = getenv(LSM_TRACE_ENV);
+    trace_on = (dir && *dir);
+}
+
+bool trace_enabled(void) {
+    pthread_once(&trace_once, trace_env_read);
+    return trace_on;
+}
+
+uint64_t trace_now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+std::string trace_id_new(void) {
+    char id[48];
+    uint64_t seq = 0;
+
+    pthread_mutex_lock(&trace_mutex);
+    seq = ++trace_seq;
+    pthread_mutex_unlock(&trace_mutex);
+
+    snprintf(id, sizeof(id), "%x.%" PRIx64 ".%" PRIx64, (unsigned int)getpid(),
+             trace_now_us(), seq);
+    return std::string(id);
+}
+
+static std::string json_escape(const std::string &s) {
+    std::string rc;
+
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = s[i];
+
+        if ('"' == c || '\\' == c) {
+            rc += '\\';
+            rc += c;
+        } else if (c < 0x20) {
+            rc += ' ';
+        } else {
+            rc += c;
+        }
+    }
+    return rc;
+}
+
+/*
+ * Append one event to the trace file of this process, which is (re)opened
+ * on first use after start up or a fork.  The closing ']' of the array is
+ * optional in the trace-event format, so nothing is needed at exit.
+ * Called with trace_mutex held.
+ */
+static void trace_write(const std::string &event) {
+    pid_t pid = getpid();
+
+    if (trace_pid != pid) {
+        if (trace_file) {
+            fclose(trace_file);
+        }
+        trace_pid = pid;
+        trace_file = lsm_trace_file_open(getenv(LSM_TRACE_ENV), pid,
+                                         program_invocation_short_name);
+    }
+
+    if (trace_file) {
+        fprintf(trace_file, "%s,\n", event.c_str());
+        fflush(trace_file);
+    }
+}
+
+static std::string trace_event_common(const char *ph, const std::string &name,
+                                      uint64_t ts) {
+    char buf[128];
+
+    snprintf(buf, sizeof(buf),
+             "\"cat\": \"lsm\", \"ph\": \"%s\", \"ts\": %" PRIu64
+             ", \"pid\": %d, \"tid\": %ld",
+             ph, ts, (int)getpid(), (long)syscall(SYS_gettid));
+    return "{\"name\": \"" + json_escape(name) + "\", " + buf;
+}
+
+void trace_span(const std::string &name, const std::string &trace_id,
+                uint64_t start_us) {
+    char dur[32];
+    std::string e = trace_event_common("X", name, start_us);
+
+    snprintf(dur, sizeof(dur), "%" PRIu64, trace_now_us() - start_us);
+    e += std::string(", \"dur\": ") + dur;
+    if (!trace_id.empty()) {
+        e += ", \"args\": {\"trace_id\": \"" + json_escape(trace_id) + "\"}";
+    }
+    e += "}";
+
+    pthread_mutex_lock(&trace_mutex);
+    trace_write(e);
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+void trace_flow(const std::string &trace_id, bool start) {
+    std::string e =
+        trace_event_common(start ? "s" : "f", "request", trace_now_us());
+
+    e += ", \"id\": \"" + json_escape(trace_id) + "\"";
+    if (!start) {
+        e += ", \"bp\": \"e\"";
+    }
+    e += "}";
+
+    pthread_mutex_lock(&trace_mutex);
+    trace_write(e);
+    pthread_mutex_unlock(&trace_mutex);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSM_TRACE_HPP
+#define LSM_TRACE_HPP
+
+#include "libstoragemgmt/libstoragemgmt_common.h"
+#include <stdint.h>
+#include <string>
+
+/*
+ * Request tracing in Chrome trace-event format.
+ *
+ * When LSM_TRACE_DIR names a writable directory every process involved
+ * (client, lsmd and plug-in) appends its events to
+ * $LSM_TRACE_DIR/lsm-trace-<pid>.json.  The client puts a trace id in each
+ * request envelope and the plug-in runtime tags its events with it, flow
+ * events tie both sides together.  Time stamps come from CLOCK_MONOTONIC so
+ * the files from one host can be loaded into a trace viewer together.
+ */
+#define LSM_TRACE_ENV "LSM_TRACE_DIR"
+
+/**
+ * Check if tracing is enabled for this process.
+ * @return true if LSM_TRACE_DIR is set
+ */
+bool LSM_DLL_LOCAL trace_enabled(void);
+
+/**
+ * Current time in microseconds, on the clock used for trace time stamps.
+ */
+uint64_t LSM_DLL_LOCAL trace_now_us(void);
+
+/**
+ * Create an id which identifies one request across processes.
+ */
+std::string LSM_DLL_LOCAL trace_id_new(void);
+
+/**
+ * Record a completed span.
+ * @param name          Span name
+ * @param trace_id      Request trace id, may be empty
+ * @param start_us      Start of span as returned by trace_now_us()
+ */
+void LSM_DLL_LOCAL trace_span(const std::string &name,
+                              const std::string &trace_id, uint64_t start_us);
+
+/**
+ * Record one end of the arrow joining the client and plug-in spans of a
+ * request, it binds to the span enclosing the current time.
+ * @param trace_id      Request trace id
+ * @param start         true on the sending side, false on the receiving one
+ */
+void LSM_DLL_LOCAL trace_flow(const std::string &trace_id, bool start);
+
+/**
+ * Records a span named kind + what covering the lifetime of the object,
+ * exceptions included.
+ */
+class LSM_DLL_LOCAL TraceSpan {
+  public:
+    TraceSpan(const char *kind, const std::string &what,
+              const std::string &trace_id)
+        : active(trace_enabled()), start(0) {
+        if (active) {
+            n = std::string(kind) + what;
+            id = trace_id;
+            start = trace_now_us();
+        }
+    }
+
+    ~TraceSpan() {
+        if (active) {
+            trace_span(n, id, start);
+        }
+    }
+
+  private:
+    bool active;
+    uint64_t start;
+    std::string n;
+    std::string id;
+};
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lsm_trace_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+FILE *lsm_trace_file_open(const char *dir, pid_t pid, const char *name) {
+    char path[PATH_MAX];
+    struct stat st;
+    FILE *f = NULL;
+    int fd = -1;
+    int err = 0;
+
+    if ((size_t)snprintf(path, sizeof(path), "%s/lsm-trace-%d.json", dir,
+                         (int)pid) >= sizeof(path)) {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+
+    fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (fstat(fd, &st) != 0 || (f = fdopen(fd, "a")) == NULL) {
+        err = errno;
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+
+    if (0 == st.st_size) {
+        fprintf(f,
+                "[\n{\"name\": \"process_name\", \"ph\": \"M\", "
+                "\"pid\": %d, \"args\": {\"name\": \"",
+                (int)pid);
+        /* Process names come from argv[0], keep the JSON valid */
+        for (; *name; ++name) {
+            if ('"' == *name || '\\' == *name) {
+                fputc('\\', f);
+                fputc(*name, f);
+            } else if ((unsigned char)*name < 0x20) {
+                fputc(' ', f);
+            } else {
+                fputc(*name, f);
+            }
+        }
+        fputs("\"}},\n", f);
+        fflush(f);
+    }
+    return f;
+}
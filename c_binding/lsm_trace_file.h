@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSM_TRACE_FILE_H
+#define LSM_TRACE_FILE_H
+
+#include "libstoragemgmt/libstoragemgmt_common.h"
+#include <stdio.h>
+#include <sys/types.h>
+
+/*
+ * Trace file handling shared by the library and lsmd, which builds this file
+ * in as it only links against the exported API.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Open $dir/lsm-trace-<pid>.json for appending.  The opening '[' of the
+ * trace-event array and the record naming the process are only written when
+ * the file is empty, so reopening the file after a fork or a restart with a
+ * recycled pid does not corrupt it.
+ * @param dir           Trace directory, value of LSM_TRACE_DIR
+ * @param pid           Process id the file is named after
+ * @param name          Process name shown by the trace viewer
+ * @return FILE pointer, NULL on error with errno set
+ */
+FILE LSM_DLL_LOCAL *lsm_trace_file_open(const char *dir, pid_t pid,
+                                        const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
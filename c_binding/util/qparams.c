@@ -94,7 +94,7 @@ int append_qparams(struct qparam_set *ps, ...) {
 static int grow_qparam_set(struct qparam_set *ps) {
     if (ps->n >= ps->alloc) {
 
-        void *tmp = realloc(ps->p, ps->alloc * 2);
+        void *tmp = realloc(ps->p, ps->alloc * 2 * sizeof(*(ps->p)));
         if (!tmp) {
             return -1;
         }
@@ -41,6 +41,68 @@
  *   line, hence 128 should works for a long time
  */
 
+/* Set by _fs_root_set(), NULL means '/' */
+static char *_fs_root = NULL;
+
+/*
+ * Store path of 'path' resolved under _fs_root into 'buff'.
+ * Return false and set errno to ENAMETOOLONG if 'buff' is too small.
+ */
+static bool _fs_path(const char *path, char *buff, size_t buff_len) {
+    int len = 0;
+
+    len = snprintf(buff, buff_len, "%s%s", _fs_root, path);
+    if ((len < 0) || ((size_t)len >= buff_len)) {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    return true;
+}
+
+int _fs_root_set(const char *root) {
+    char *tmp_root = NULL;
+
+    if (root != NULL) {
+        assert(root[0] == '/');
+        tmp_root = strdup(root);
+        if (tmp_root == NULL)
+            return LSM_ERR_NO_MEMORY;
+        /* Paths to resolve always start with '/' */
+        while ((strlen(tmp_root) > 0) &&
+               (tmp_root[strlen(tmp_root) - 1] == '/'))
+            tmp_root[strlen(tmp_root) - 1] = '\0';
+    }
+    free(_fs_root);
+    _fs_root = tmp_root;
+    return LSM_ERR_OK;
+}
+
+const char *_fs_root_get(void) { return _fs_root == NULL ? "" : _fs_root; }
+
+int _fs_open(const char *path, int flags) {
+    char full_path[PATH_MAX];
+
+    assert(path != NULL);
+
+    if ((_fs_root == NULL) || (path[0] != '/'))
+        return open(path, flags);
+    if (!_fs_path(path, full_path, sizeof(full_path)))
+        return -1;
+    return open(full_path, flags);
+}
+
+DIR *_fs_opendir(const char *path) {
+    char full_path[PATH_MAX];
+
+    assert(path != NULL);
+
+    if ((_fs_root == NULL) || (path[0] != '/'))
+        return opendir(path);
+    if (!_fs_path(path, full_path, sizeof(full_path)))
+        return NULL;
+    return opendir(full_path);
+}
+
 int _check_null_ptr(char *err_msg, int arg_count, ...) {
     int rc = LSM_ERR_OK;
     va_list arg;
@@ -82,7 +144,7 @@ bool _file_exists(const char *path) {
 
     assert(path != NULL);
 
-    fd = open(path, O_RDONLY);
+    fd = _fs_open(path, O_RDONLY);
     if ((fd == -1) && (errno == ENOENT))
         return false;
 
@@ -92,11 +154,31 @@ bool _file_exists(const char *path) {
     return true;
 }
 
+/*
+ * Read from the beginning of opened file 'fd', same return as _read_file().
+ */
+static int _fd_read(int fd, uint8_t *buff, ssize_t *size, ssize_t max_size) {
+    int rc = 0;
+
+    *size = pread(fd, buff, max_size, 0);
+    if (*size < 0) {
+        rc = errno;
+        buff[0] = '\0';
+    } else {
+        if (*size >= (max_size - 1)) {
+            rc = EFBIG;
+            buff[max_size - 1] = '\0';
+        } else {
+            buff[*size] = '\0';
+        }
+    }
+    return rc;
+}
+
 int _read_file(const char *path, uint8_t *buff, ssize_t *size,
                ssize_t max_size) {
     int fd = -1;
     int rc = 0;
-    int errno_copy = 0;
 
     assert(path != NULL);
     assert(buff != NULL);
@@ -104,24 +186,38 @@ int _read_file(const char *path, uint8_t *buff, ssize_t *size,
 
     *size = 0;
 
-    fd = open(path, O_RDONLY);
+    fd = _fs_open(path, O_RDONLY);
     if (fd < 0)
         return errno;
-    *size = read(fd, buff, max_size);
-    errno_copy = errno;
+    rc = _fd_read(fd, buff, size, max_size);
     close(fd);
+    return rc;
+}
 
-    if (*size < 0) {
-        rc = errno_copy;
-        buff[0] = '\0';
-    } else {
-        if (*size >= (max_size - 1)) {
-            rc = EFBIG;
-            buff[max_size - 1] = '\0';
-        } else {
-            buff[*size] = '\0';
-        }
-    }
+int _sysfs_dir_open(const char *path) {
+    assert(path != NULL);
+
+    return _fs_open(path, O_RDONLY | O_DIRECTORY);
+}
+
+int _sysfs_attr_read(int dir_fd, const char *name, uint8_t *buff,
+                     ssize_t *size, ssize_t max_size) {
+    int fd = -1;
+    int rc = 0;
+
+    assert(dir_fd >= 0);
+    assert(name != NULL);
+    assert(name[0] != '/');
+    assert(buff != NULL);
+    assert(size != NULL);
+
+    *size = 0;
+
+    fd = openat(dir_fd, name, O_RDONLY);
+    if (fd < 0)
+        return errno;
+    rc = _fd_read(fd, buff, size, max_size);
+    close(fd);
     return rc;
 }
 
@@ -20,6 +20,7 @@
 
 #include "libstoragemgmt/libstoragemgmt_error.h"
 
+#include <dirent.h>
 #include <stdbool.h>
 #include <stdio.h>
 
@@ -72,6 +73,39 @@ LSM_DLL_LOCAL int _check_null_ptr(char *err_msg, int arg_count, ...);
  */
 LSM_DLL_LOCAL void _be_raw_to_hex(uint8_t *raw, size_t len, char *out);
 
+/*
+ * Preconditions:
+ *  root == NULL or is absolute path
+ *
+ * Resolve all the absolute /sys and /dev paths used by the local disk code
+ * under given directory instead of '/', NULL to restore.  Tests and
+ * benchmarks use it with a fake sysfs tree.  Not thread safe, should be
+ * invoked before any local disk query.
+ * Return LSM_ERR_NO_MEMORY or LSM_ERR_OK.
+ */
+LSM_DLL_LOCAL int _fs_root_set(const char *root);
+
+/*
+ * Return the directory set by _fs_root_set(), "" if not set.
+ */
+LSM_DLL_LOCAL const char *_fs_root_get(void);
+
+/*
+ * Preconditions:
+ *  path != NULL
+ *
+ * Same as open(2), but absolute path is resolved under _fs_root_get().
+ */
+LSM_DLL_LOCAL int _fs_open(const char *path, int flags);
+
+/*
+ * Preconditions:
+ *  path != NULL
+ *
+ * Same as opendir(3), but absolute path is resolved under _fs_root_get().
+ */
+LSM_DLL_LOCAL DIR *_fs_opendir(const char *path);
+
 /*
  * Preconditions:
  *  path != NULL
@@ -92,6 +126,30 @@ LSM_DLL_LOCAL bool _file_exists(const char *path);
 LSM_DLL_LOCAL int _read_file(const char *path, uint8_t *buff, ssize_t *size,
                              ssize_t max_size);
 
+/*
+ * Preconditions:
+ *  path != NULL
+ *
+ * Open sysfs directory 'path', resolved under _fs_root_get(), for reading
+ * several attributes of one device with _sysfs_attr_read() without walking
+ * the full path each time.  Caller should close() it.
+ * Return the directory file descriptor, or -1 with errno set.
+ */
+LSM_DLL_LOCAL int _sysfs_dir_open(const char *path);
+
+/*
+ * Preconditions:
+ *  dir_fd >= 0
+ *  name != NULL and is relative path
+ *  buff != NULL
+ *  size != NULL
+ *
+ * Same as _read_file(), but 'name' is relative to 'dir_fd' of
+ * _sysfs_dir_open().
+ */
+LSM_DLL_LOCAL int _sysfs_attr_read(int dir_fd, const char *name, uint8_t *buff,
+                                   ssize_t *size, ssize_t max_size);
+
 /*
  * Preconditions:
  * beginning != NULL
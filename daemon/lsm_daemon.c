@@ -21,17 +21,22 @@
 #include <ctype.h>
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <getopt.h>
 #include <grp.h>
+#include <inttypes.h>
 #include <libconfig.h>
 #include <libgen.h>
+#include <libstoragemgmt/libstoragemgmt.h>
 #include <limits.h>
+#include <poll.h>
 #include <pwd.h>
 #include <signal.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/prctl.h>
 #include <sys/queue.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
@@ -40,8 +45,11 @@
 #include <sys/un.h>
 #include <sys/wait.h>
 #include <syslog.h>
+#include <time.h>
 #include <unistd.h>
 
+#include "lsm_trace_file.h"
+
 #define BASE_DIR                       "/var/run/lsm"
 #define SOCKET_DIR                     BASE_DIR "/ipc"
 #define PLUGIN_DIR                     "/usr/bin"
@@ -51,6 +59,15 @@
 #define LSMD_CONF_FILE                 "lsmd.conf"
 #define LSM_CONF_ALLOW_ROOT_OPT_NAME   "allow-plugin-root-privilege"
 #define LSM_CONF_REQUIRE_ROOT_OPT_NAME "require-root-privilege"
+#define PLUGIN_INFO_SUFFIX             ".info"
+#define PLUGIN_INFO_TMO_MS             30000
+#define LSM_TRACE_ENV                  "LSM_TRACE_DIR"
+#define PLUGIN_INFO_REQ                                                        \
+    "{\"method\": \"plugin_info\", \"id\": 100, \"params\": {\"flags\": 0}}"
+
+#define LSM_CONF_HEALTH_INTERVAL_OPT_NAME "local-disk-health-interval"
+#define LSM_CONF_HEALTH_JITTER_OPT_NAME   "local-disk-health-jitter"
+#define LSM_CONF_HEALTH_WORKERS_OPT_NAME  "local-disk-health-workers"
 
 #define max(a, b)                                                              \
     ({                                                                         \
@@ -78,11 +95,27 @@ int plugin_mem_debug = 0;
 int allow_root_plugin = 0;
 int has_root_plugin = 0;
 
+/* Process refreshing the plugin information cache, 0 when not running */
+pid_t info_refresh_pid = 0;
+
+/* Local disk health sampler settings from lsmd.conf, disabled by 0 interval */
+int health_interval_sec = 0;
+int health_jitter_sec = 0;
+int health_workers = 0;
+
+/* Process sampling local disk health, 0 when not running */
+pid_t health_sampler_pid = 0;
+
+/* Chrome trace-event output, see c_binding/lsm_trace.hpp */
+FILE *trace_file = NULL;
+pid_t trace_pid = 0;
+
 /**
  * Each item in plugin list contains this information
  */
 struct plugin {
     char *file_path;
+    char *name;
     int require_root;
     int fd;
     LIST_ENTRY(plugin) pointers;
@@ -321,9 +354,39 @@ int delete_socket(void *p, char *full_name) {
 }
 
 /**
- * Walk the IPC socket directory and remove the socket files.
+ * Callback to remove the plugin information cache files.
+ * @param p             Call back data
+ * @param full_name     Full path an and file name
+ * @return 0 to continue processing, anything else to stop.
+ */
+int delete_plugin_info(void *p, char *full_name) {
+    struct stat statbuf;
+    size_t len = strlen(full_name);
+    size_t ext_len = strlen(PLUGIN_INFO_SUFFIX);
+    int err;
+
+    assert(p == NULL);
+
+    if (len > ext_len &&
+        strcmp(full_name + len - ext_len, PLUGIN_INFO_SUFFIX) == 0 &&
+        !lstat(full_name, &statbuf) && S_ISREG(statbuf.st_mode)) {
+        if (unlink(full_name)) {
+            err = errno;
+            info("Error on unlinking file %s: %s\n", full_name,
+                 strerror(err));
+        }
+    }
+    return 0;
+}
+
+/**
+ * Walk the IPC socket directory and remove the socket files and the plugin
+ * information cached alongside them.
  */
-void clean_sockets(void) { process_directory(socket_dir, NULL, delete_socket); }
+void clean_sockets(void) {
+    process_directory(socket_dir, NULL, delete_socket);
+    process_directory(socket_dir, NULL, delete_plugin_info);
+}
 
 /**
  * Given a socket file name, create the IPC socket.
@@ -394,44 +457,88 @@ void empty_plugin_list(struct plugin_list *list) {
 
         free(item->file_path);
         item->file_path = NULL;
+        free(item->name);
+        item->name = NULL;
         item->fd = INT_MAX;
         free(item);
     }
 }
 
 /**
- * Parse config and seeking provided key name bool
- *  1. Keep value untouched if file not exist
+ * Load config file
+ *  1. Return 0 if file not exist, cfg is left uninitialized
  *  2. If file is not readable, abort via log_and_exit()
- *  3. Keep value untouched if provided key not found
- *  4. Abort via log_and_exit() if no enough memory.
  * @param conf_path     config file path
- * @param key_name      string, searching key
- * @param value         int, output, value of this config key
+ * @param cfg           config_t, output, to be freed by config_destroy() if
+ *                      1 is returned
+ * @return 1 if loaded, 0 if file not exist
  */
 
-void parse_conf_bool(const char *conf_path, const char *key_name, int *value) {
+int conf_load(const char *conf_path, config_t *cfg) {
     if (access(conf_path, F_OK) == -1) {
         /* file not exist. */
-        return;
+        return 0;
     }
-    config_t *cfg = (config_t *)malloc(sizeof(config_t));
-    if (cfg) {
-        config_init(cfg);
-        if (CONFIG_TRUE == config_read_file(cfg, conf_path)) {
-            config_lookup_bool(cfg, key_name, value);
-        } else {
-            log_and_exit("configure %s parsing failed: %s at line %d\n",
-                         conf_path, config_error_text(cfg),
-                         config_error_line(cfg));
-        }
-    } else {
-        log_and_exit(
-            "malloc failure while trying to allocate memory for config_t\n");
+    config_init(cfg);
+    if (CONFIG_TRUE != config_read_file(cfg, conf_path)) {
+        log_and_exit("configure %s parsing failed: %s at line %d\n",
+                     conf_path, config_error_text(cfg),
+                     config_error_line(cfg));
+    }
+    return 1;
+}
+
+/**
+ * Seek provided key name of given type in loaded config.
+ * @param cfg           loaded config
+ * @param key_name      string, searching key
+ * @param type          CONFIG_TYPE_BOOL or CONFIG_TYPE_INT
+ * @return setting, NULL if key not found or of other type
+ */
+
+config_setting_t *conf_setting_get(const config_t *cfg, const char *key_name,
+                                   int type) {
+    config_setting_t *setting = config_lookup(cfg, key_name);
+
+    if ((setting != NULL) && (config_setting_type(setting) != type)) {
+        return NULL;
+    }
+    return setting;
+}
+
+/**
+ * Seek provided key name bool in loaded config, keep value untouched if not
+ * found.
+ * @param cfg           loaded config
+ * @param key_name      string, searching key
+ * @param value         int, output, value of this config key
+ */
+
+void parse_conf_bool(const config_t *cfg, const char *key_name, int *value) {
+    config_setting_t *setting =
+        conf_setting_get(cfg, key_name, CONFIG_TYPE_BOOL);
+
+    if (setting != NULL) {
+        *value = config_setting_get_bool(setting);
     }
+}
+
+/**
+ * Seek provided key name int in loaded config, keep value untouched if not
+ * found.
+ * @param cfg           loaded config
+ * @param key_name      string, searching key
+ * @param value         int, output, value of this config key
+ */
+
+void parse_conf_int(const config_t *cfg, const char *key_name, int *value) {
+    /* config_lookup_int() takes long before libconfig 1.4 */
+    config_setting_t *setting =
+        conf_setting_get(cfg, key_name, CONFIG_TYPE_INT);
 
-    config_destroy(cfg);
-    free(cfg);
+    if (setting != NULL) {
+        *value = config_setting_get_int(setting);
+    }
 }
 
 /**
@@ -457,8 +564,12 @@ int chk_pconf_root_pri(char *plugin_name) {
 
         char *plugin_conf_path =
             path_form(plugin_conf_dir_path, plugin_conf_filename);
-        parse_conf_bool(plugin_conf_path, LSM_CONF_REQUIRE_ROOT_OPT_NAME,
-                        &require_root);
+        config_t cfg;
+        if (conf_load(plugin_conf_path, &cfg)) {
+            parse_conf_bool(&cfg, LSM_CONF_REQUIRE_ROOT_OPT_NAME,
+                            &require_root);
+            config_destroy(&cfg);
+        }
 
         if (require_root == 1 && allow_root_plugin == 0) {
             warn("Plugin %s require root privilege while %s disable globally\n",
@@ -517,16 +628,19 @@ int process_plugin(void *p, char *full_name) {
         plugin_name[no_ext_len] = '\0';
 
     item->file_path = strdup(full_name);
+    item->name = strdup(plugin_name);
     item->fd = setup_socket(plugin_name);
     item->require_root = chk_pconf_root_pri(plugin_name);
     has_root_plugin |= item->require_root;
 
-    if (item->file_path && item->fd >= 0) {
+    if (item->file_path && item->name && item->fd >= 0) {
         LIST_INSERT_HEAD((struct plugin_list *)p, item, pointers);
         info("Plugin %s added\n", full_name);
     } else {
         /* The only real way to get here is failed strdup as
            setup_socket will exit on error. */
+        free(item->file_path);
+        free(item->name);
         free(item);
         item = NULL;
         log_and_exit("strdup failed %s\n", full_name);
@@ -557,6 +671,13 @@ void child_cleanup(void) {
             if (0 == rc && si.si_pid == 0) {
                 break;
             } else {
+                if (si.si_pid == info_refresh_pid) {
+                    info_refresh_pid = 0;
+                }
+                if (si.si_pid == health_sampler_pid) {
+                    health_sampler_pid = 0;
+                    warn("Local disk health sampler exited\n");
+                }
                 if (si.si_code == CLD_EXITED && si.si_status != 0) {
                     info("Plug-in process %d exited with %d\n", si.si_pid,
                          si.si_status);
@@ -570,6 +691,12 @@ void child_cleanup(void) {
  * Closes and frees memory and removes Unix domain sockets.
  */
 void clean_up(void) {
+    if (info_refresh_pid > 0) {
+        /* Don't let a stale refresh write cache files for the new sockets */
+        kill(info_refresh_pid, SIGKILL);
+        waitpid(info_refresh_pid, NULL, 0);
+        info_refresh_pid = 0;
+    }
     empty_plugin_list(&head);
     clean_sockets();
 }
@@ -605,14 +732,86 @@ struct plugin *plugin_lookup(int fd) {
     return NULL;
 }
 
+/**
+ * Current time in microseconds on the clock used for trace time stamps.
+ */
+uint64_t trace_now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * Check if request tracing was asked for.
+ * @return 1 if LSM_TRACE_DIR is set, else 0
+ */
+int trace_enabled(void) {
+    const char *dir = getenv(LSM_TRACE_ENV);
+    return (dir && *dir) ? 1 : 0;
+}
+
+/**
+ * Process id of the client on the other end of a socket.
+ * @param fd            Connected socket
+ * @return pid, 0 if unknown
+ */
+pid_t peer_pid(int fd) {
+    struct ucred cred;
+    socklen_t cred_len = sizeof(cred);
+
+    memset(&cred, 0, sizeof(cred));
+    getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len);
+    return cred.pid;
+}
+
+/**
+ * Record the hand off of a client connection to a plug-in process in
+ * $LSM_TRACE_DIR/lsm-trace-<pid>.json, so it shows up next to the client
+ * and plug-in traces.
+ * @param name          Plug-in socket name
+ * @param start_us      When the connection was accepted
+ * @param client_pid    Process id of the client
+ * @param plugin_pid    Process id of the plug-in started for the client
+ */
+void trace_accept(const char *name, uint64_t start_us, pid_t client_pid,
+                  pid_t plugin_pid) {
+    const char *dir = getenv(LSM_TRACE_ENV);
+    pid_t pid = getpid();
+
+    if (trace_pid != pid) {
+        if (trace_file) {
+            fclose(trace_file);
+        }
+        trace_pid = pid;
+        trace_file = lsm_trace_file_open(dir, pid, "lsmd");
+        if (!trace_file) {
+            info("Unable to open trace file in %s: %s\n", dir,
+                 strerror(errno));
+        }
+    }
+
+    if (trace_file) {
+        fprintf(trace_file,
+                "{\"name\": \"accept %s\", \"cat\": \"lsm\", \"ph\": \"X\", "
+                "\"ts\": %" PRIu64 ", \"dur\": %" PRIu64 ", \"pid\": %d, "
+                "\"tid\": %d, \"args\": {\"client_pid\": %d, "
+                "\"plugin_pid\": %d}},\n",
+                name, start_us, trace_now_us() - start_us, (int)pid, (int)pid,
+                (int)client_pid, (int)plugin_pid);
+        fflush(trace_file);
+    }
+}
+
 /**
  * Does the actual fork and exec of the plug-in
  * @param plugin        Full filename and path of plug-in to exec.
  * @param client_fd     Client connected file descriptor
  * @param require_root  int, indicate whether this plugin require root
  *                      privilege or not
+ * @return process id of the plug-in in the parent
  */
-void exec_plugin(char *plugin, int client_fd, int require_root) {
+pid_t exec_plugin(char *plugin, int client_fd, int require_root) {
     int err = 0;
 
     info("Exec'ing plug-in = %s\n", plugin);
@@ -711,6 +910,337 @@ void exec_plugin(char *plugin, int client_fd, int require_root) {
                          strerror(err));
         }
     }
+    return process;
+}
+
+/**
+ * Parse a JSON string starting at the opening quote, writing the unescaped
+ * value into out.  Newlines are flattened as the cache is line based.
+ * @param s         Pointer to opening quote
+ * @param out       Output buffer
+ * @param out_len   Size of output buffer
+ * @return Pointer just past the closing quote, NULL on malformed input.
+ */
+static const char *json_str_parse(const char *s, char *out, size_t out_len) {
+    size_t o = 0;
+
+    if (*s++ != '"') {
+        return NULL;
+    }
+
+    while (*s && *s != '"') {
+        unsigned int c = (unsigned char)*s++;
+
+        if ('\\' == c) {
+            c = (unsigned char)*s++;
+            switch (c) {
+            case 'b':
+            case 'f':
+            case 'n':
+            case 'r':
+            case 't':
+                c = ' ';
+                break;
+            case 'u':
+                if (strspn(s, "0123456789abcdefABCDEF") < 4 ||
+                    1 != sscanf(s, "%4x", &c)) {
+                    return NULL;
+                }
+                s += 4;
+                break;
+            case '\0':
+                return NULL;
+            }
+        }
+
+        /* Anything escaped past ASCII gets re-encoded as UTF-8 */
+        if (c >= 0x800 && o + 3 < out_len) {
+            out[o++] = 0xE0 | (c >> 12);
+            out[o++] = 0x80 | ((c >> 6) & 0x3F);
+            out[o++] = 0x80 | (c & 0x3F);
+        } else if (c >= 0x80 && c < 0x800 && o + 2 < out_len) {
+            out[o++] = 0xC0 | (c >> 6);
+            out[o++] = 0x80 | (c & 0x3F);
+        } else if (c < 0x80 && o + 1 < out_len) {
+            out[o++] = (char)c;
+        }
+    }
+    out[o] = '\0';
+    return (*s == '"') ? s + 1 : NULL;
+}
+
+/**
+ * Write "<name>.info" holding the description and version reported by the
+ * plug-in, via rename so readers never see a partial file.
+ * @param name      Socket file name of the plug-in
+ * @param resp      plugin_info json response
+ */
+static void plugin_info_write(const char *name, const char *resp) {
+    char desc[512];
+    char version[128];
+    char file_name[PATH_MAX];
+    char tmp_name[PATH_MAX + sizeof(".tmp")];
+    const char *r = strstr(resp, "\"result\"");
+    FILE *f = NULL;
+
+    if (!r || !(r = strchr(r, '['))) {
+        info("Plug-in %s returned no information\n", name);
+        return;
+    }
+
+    r += strspn(r + 1, " \t\r\n") + 1;
+    r = json_str_parse(r, desc, sizeof(desc));
+    if (!r) {
+        return;
+    }
+    r += strspn(r, " \t\r\n,");
+    if (!json_str_parse(r, version, sizeof(version))) {
+        return;
+    }
+
+    snprintf(file_name, sizeof(file_name), "%s/%s" PLUGIN_INFO_SUFFIX,
+             socket_dir, name);
+    snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", file_name);
+
+    f = fopen(tmp_name, "we");
+    if (f) {
+        int failed = (fprintf(f, "%s\n%s\n", desc, version) < 0);
+        failed |= fchmod(fileno(f), S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+        failed |= fclose(f);
+
+        if (failed || rename(tmp_name, file_name)) {
+            info("Unable to write plug-in information %s\n", file_name);
+            unlink(tmp_name);
+        }
+    }
+}
+
+/**
+ * Ask every plug-in for its description and version at once and cache the
+ * answers in the socket directory, so clients listing the available
+ * plug-ins don't have to start each one of them.  Plug-ins requiring root
+ * privilege are not cached.  Runs in the child forked by
+ * refresh_plugin_info().
+ */
+static void plugin_info_gather(void) {
+    struct plugin *plug = NULL;
+    struct pollfd *fds = NULL;
+    struct plugin **plugs = NULL;
+    char **bufs = NULL;
+    size_t *lens = NULL;
+    size_t count = 0;
+    size_t pending = 0;
+    size_t i = 0;
+    char req[128];
+    int req_len = 0;
+    struct timespec start;
+    struct timespec now;
+
+    LIST_FOREACH(plug, &head, pointers) { count++; }
+
+    fds = calloc(count, sizeof(struct pollfd));
+    plugs = calloc(count, sizeof(struct plugin *));
+    bufs = calloc(count, sizeof(char *));
+    lens = calloc(count, sizeof(size_t));
+    if (!fds || !plugs || !bufs || !lens) {
+        log_and_exit("Memory allocation failure!\n");
+    }
+
+    req_len = snprintf(req, sizeof(req), "%010zu%s", strlen(PLUGIN_INFO_REQ),
+                       PLUGIN_INFO_REQ);
+
+    LIST_FOREACH(plug, &head, pointers) {
+        int sv[2];
+
+        fds[i].fd = -1;
+        plugs[i] = plug;
+
+        /*
+         * exec_plugin() decides the privilege of such plug-ins from the
+         * uid of each client, an answer cached from our run could differ
+         * from the one a client gets, so clients keep asking them.
+         */
+        if (plug->require_root) {
+            i++;
+            continue;
+        }
+
+        if (0 == socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv)) {
+            /* Plug-in end must survive the exec */
+            fcntl(sv[1], F_SETFD, 0);
+            exec_plugin(plug->file_path, sv[1], 0);
+
+            if (write(sv[0], req, req_len) == req_len) {
+                fds[i].fd = sv[0];
+                fds[i].events = POLLIN;
+                pending++;
+            } else {
+                close(sv[0]);
+            }
+        }
+        i++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while (pending) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long elapsed = (now.tv_sec - start.tv_sec) * 1000 +
+                       (now.tv_nsec - start.tv_nsec) / 1000000;
+
+        if (elapsed >= PLUGIN_INFO_TMO_MS ||
+            poll(fds, count, PLUGIN_INFO_TMO_MS - elapsed) <= 0) {
+            break;
+        }
+
+        for (i = 0; i < count; ++i) {
+            char chunk[4096];
+            ssize_t got = 0;
+            char *tmp = NULL;
+            int done = 0;
+
+            if (fds[i].fd < 0 || !fds[i].revents) {
+                continue;
+            }
+
+            got = read(fds[i].fd, chunk, sizeof(chunk));
+            if (got > 0) {
+                tmp = realloc(bufs[i], lens[i] + got + 1);
+                if (!tmp) {
+                    log_and_exit("Memory allocation failure!\n");
+                }
+                bufs[i] = tmp;
+                memcpy(bufs[i] + lens[i], chunk, got);
+                lens[i] += got;
+                bufs[i][lens[i]] = '\0';
+
+                if (lens[i] > 10) {
+                    char hdr[11];
+                    memcpy(hdr, bufs[i], 10);
+                    hdr[10] = '\0';
+                    if (lens[i] >= 10 + strtoull(hdr, NULL, 10)) {
+                        plugin_info_write(plugs[i]->name, bufs[i] + 10);
+                        done = 1;
+                    }
+                }
+            } else if (0 == got || (errno != EINTR && errno != EAGAIN)) {
+                info("Plug-in %s did not report information\n",
+                     plugs[i]->file_path);
+                done = 1;
+            }
+
+            if (done) {
+                /* Closing our end lets the plug-in see EOF and exit */
+                close(fds[i].fd);
+                fds[i].fd = -1;
+                pending--;
+            }
+        }
+    }
+
+    for (i = 0; i < count; ++i) {
+        if (fds[i].fd >= 0) {
+            close(fds[i].fd);
+        }
+        free(bufs[i]);
+    }
+    free(fds);
+    free(plugs);
+    free(bufs);
+    free(lens);
+}
+
+/**
+ * Fork a short lived process to rebuild the plugin information cache, which
+ * keeps the main loop free to accept client connections meanwhile.
+ */
+void refresh_plugin_info(void) {
+    pid_t process = fork();
+
+    if (-1 == process) {
+        int err = errno;
+        warn("Unable to refresh plug-in information: %s\n", strerror(err));
+    } else if (process) {
+        info_refresh_pid = process;
+    } else {
+        signal(SIGTERM, SIG_DFL);
+        signal(SIGHUP, SIG_DFL);
+        plugin_info_gather();
+        exit(0);
+    }
+}
+
+/**
+ * Forks the process publishing local disk health into shared memory, so
+ * clients could read it by lsm_local_disk_health_table_open() without
+ * sending any command to the disks.  It is started once, before any
+ * privilege drop of process_plugins(), and survives reloads of plug-ins.
+ */
+void health_sampler_start(void) {
+    pid_t parent = getpid();
+    pid_t process = 0;
+    lsm_local_disk_sampler *sampler = NULL;
+    lsm_error *lsm_err = NULL;
+    sigset_t mask;
+    int sig = 0;
+    int rc = 0;
+
+    if (health_interval_sec <= 0) {
+        return;
+    }
+    if (getuid()) {
+        warn("Local disk health sampler requires root privilege, disks "
+             "will be reported with errors\n");
+    }
+
+    process = fork();
+    if (-1 == process) {
+        int err = errno;
+        warn("Unable to start local disk health sampler: %s\n",
+             strerror(err));
+    } else if (process) {
+        health_sampler_pid = process;
+        info("Local disk health sampler started, interval %d seconds\n",
+             health_interval_sec);
+    } else {
+        /* Block them before the sampler threads inherit the mask */
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGTERM);
+        sigaddset(&mask, SIGHUP);
+        sigprocmask(SIG_BLOCK, &mask, NULL);
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+        if (getppid() != parent) {
+            exit(0);
+        }
+
+        rc = lsm_local_disk_sampler_start(
+            LSM_LOCAL_DISK_HEALTH_SHM_NAME,
+            (uint32_t)health_interval_sec * 1000,
+            (uint32_t)max(health_jitter_sec, 0) * 1000,
+            (uint32_t)max(health_workers, 0), &sampler, &lsm_err);
+        if (rc != LSM_ERR_OK) {
+            warn("Unable to start local disk health sampler: %s\n",
+                 lsm_error_message_get(lsm_err));
+            lsm_error_free(lsm_err);
+            exit(1);
+        }
+
+        /* SIGHUP reloads plug-ins only */
+        do {
+            sigwait(&mask, &sig);
+        } while (sig != SIGTERM);
+
+        lsm_local_disk_sampler_stop(sampler);
+        exit(0);
+    }
+}
+
+void health_sampler_stop(void) {
+    if (health_sampler_pid > 0) {
+        kill(health_sampler_pid, SIGTERM);
+        waitpid(health_sampler_pid, NULL, 0);
+        health_sampler_pid = 0;
+    }
 }
 
 /**
@@ -724,6 +1254,7 @@ void _serving(void) {
     int err = 0;
 
     process_plugins();
+    refresh_plugin_info();
 
     while (serve_state == RUNNING) {
         FD_ZERO(&readfds);
@@ -755,10 +1286,19 @@ void _serving(void) {
             int fd = 0;
             for (fd = 0; fd < nfds; fd++) {
                 if (FD_ISSET(fd, &readfds)) {
+                    uint64_t start = trace_now_us();
                     int cfd = accept(fd, NULL, NULL);
                     if (-1 != cfd) {
                         struct plugin *p = plugin_lookup(fd);
-                        exec_plugin(p->file_path, cfd, p->require_root);
+                        if (trace_enabled()) {
+                            /* Ask before exec_plugin() closes our copy */
+                            pid_t client_pid = peer_pid(cfd);
+                            pid_t pid =
+                                exec_plugin(p->file_path, cfd, p->require_root);
+                            trace_accept(p->name, start, client_pid, pid);
+                        } else {
+                            exec_plugin(p->file_path, cfd, p->require_root);
+                        }
                     } else {
                         err = errno;
                         info("Error on accepting request: %s", strerror(err));
@@ -858,8 +1398,18 @@ int main(int argc, char *argv[]) {
 
     /* Check lsmd.conf */
     char *lsmd_conf_path = path_form(conf_dir, LSMD_CONF_FILE);
-    parse_conf_bool(lsmd_conf_path, (char *)LSM_CONF_ALLOW_ROOT_OPT_NAME,
-                    &allow_root_plugin);
+    config_t lsmd_cfg;
+    if (conf_load(lsmd_conf_path, &lsmd_cfg)) {
+        parse_conf_bool(&lsmd_cfg, LSM_CONF_ALLOW_ROOT_OPT_NAME,
+                        &allow_root_plugin);
+        parse_conf_int(&lsmd_cfg, LSM_CONF_HEALTH_INTERVAL_OPT_NAME,
+                       &health_interval_sec);
+        parse_conf_int(&lsmd_cfg, LSM_CONF_HEALTH_JITTER_OPT_NAME,
+                       &health_jitter_sec);
+        parse_conf_int(&lsmd_cfg, LSM_CONF_HEALTH_WORKERS_OPT_NAME,
+                       &health_workers);
+        config_destroy(&lsmd_cfg);
+    }
     free(lsmd_conf_path);
 
     /* Check to see if we want to check plugin for memory errors */
@@ -881,6 +1431,8 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    health_sampler_start();
     serve();
+    health_sampler_stop();
     return EXIT_SUCCESS;
 }
@@ -418,77 +418,63 @@ def __init__(self, statefile, timeout):
                                    -{ID_FMT_LEN}, {ID_FMT_LEN})
                     parent_lsm_pool_id,
                     pool0.strip_size,
-                    pool1.total_space total_space,
-                    pool1.total_space -
-                    pool2.vol_consumed_size  -
-                    pool3.fs_consumed_size -
-                    pool4.sub_pool_consumed_size free_space,
-                    pool1.data_disk_count,
-                    pool5.disk_count
+                    pool0.total_space,
+                    pool0.total_space -
+                    pool0.vol_consumed_size -
+                    pool0.fs_consumed_size -
+                    pool0.sub_pool_consumed_size free_space,
+                    pool0.data_disk_count,
+                    pool0.disk_count
                 FROM
-                    pools pool0
-                        LEFT JOIN (
-                            SELECT
-                                pool.id,
-                                    ifnull(pool.total_space,
-                                        ifnull(SUM(disk.total_space), 0))
-                                total_space,
-                                COUNT(disk.id) data_disk_count
-                            FROM pools pool
-                                LEFT JOIN disks disk
-                                    ON pool.id = disk.owner_pool_id AND
-                                       disk.role = 'DATA'
-                            GROUP BY
-                                pool.id
-                        ) pool1 ON pool0.id = pool1.id
-
-                        LEFT JOIN (
-                            SELECT
-                                pool.id,
-                                ifnull(SUM(volume.consumed_size), 0)
-                                vol_consumed_size
-                            FROM pools pool
-                                LEFT JOIN volumes volume
-                                    ON volume.pool_id = pool.id
-                            GROUP BY
-                                pool.id
-                        ) pool2 ON pool0.id = pool2.id
-
-                        LEFT JOIN (
-                            SELECT
-                                pool.id,
-                                ifnull(SUM(fs.consumed_size), 0)
-                                fs_consumed_size
-                            FROM pools pool
-                                LEFT JOIN fss fs
-                                    ON fs.pool_id = pool.id
-                            GROUP BY
-                                pool.id
-                        ) pool3 ON pool0.id = pool3.id
-
-                        LEFT JOIN (
-                            SELECT
-                                pool.id,
-                                ifnull(SUM(sub_pool.total_space), 0)
-                                sub_pool_consumed_size
-                            FROM pools pool
-                                LEFT JOIN pools sub_pool
-                                    ON sub_pool.parent_pool_id = pool.id
-                            GROUP BY
-                                pool.id
-                        ) pool4 ON pool0.id = pool4.id
-                        LEFT JOIN (
-                            SELECT
-                                pool.id,
-                                COUNT(disk.id) disk_count
-                            FROM pools pool
-                                LEFT JOIN disks disk
-                                    ON pool.id = disk.owner_pool_id
-                            GROUP BY
-                                pool.id
-                        ) pool5 ON pool0.id = pool5.id
-                GROUP BY
-                    pool0.id;
+                    (
+                        -- Correlated sub-queries so that looking up a
+                        -- single pool only sums up its own members.
+                        SELECT
+                            pool.id,
+                            pool.name,
+                            pool.status,
+                            pool.status_info,
+                            pool.element_type,
+                            pool.unsupported_actions,
+                            pool.raid_type,
+                            pool.member_type,
+                            pool.parent_pool_id,
+                            pool.strip_size,
+                                ifnull(pool.total_space, (
+                                    SELECT ifnull(SUM(disk.total_space), 0)
+                                    FROM disks disk
+                                    WHERE disk.owner_pool_id = pool.id AND
+                                          disk.role = 'DATA'))
+                            total_space,
+                                (
+                                    SELECT ifnull(SUM(volume.consumed_size), 0)
+                                    FROM volumes volume
+                                    WHERE volume.pool_id = pool.id)
+                            vol_consumed_size,
+                                (
+                                    SELECT ifnull(SUM(fs.consumed_size), 0)
+                                    FROM fss fs
+                                    WHERE fs.pool_id = pool.id)
+                            fs_consumed_size,
+                                (
+                                    SELECT ifnull(SUM(sub_pool.total_space), 0)
+                                    FROM pools sub_pool
+                                    WHERE sub_pool.parent_pool_id = pool.id)
+                            sub_pool_consumed_size,
+                                (
+                                    SELECT COUNT(disk.id)
+                                    FROM disks disk
+                                    WHERE disk.owner_pool_id = pool.id AND
+                                          disk.role = 'DATA')
+                            data_disk_count,
+                                (
+                                    SELECT COUNT(disk.id)
+                                    FROM disks disk
+                                    WHERE disk.owner_pool_id = pool.id)
+                            disk_count
+                        FROM
+                            pools pool
+                    ) pool0;
             """
 
         sql_cmd += \
@@ -810,6 +796,41 @@ def __init__(self, statefile, timeout):
                 "Stored simulator state incompatible with "
                 "simulator, please move or delete %s" % self.statefile)
 
+        # Indexes on the foreign key columns used by lookups and by the
+        # ON DELETE CASCADE actions. Created on their own so that statefiles
+        # created by older versions get them as well.
+        sql_cur.executescript(
+            """
+            CREATE INDEX IF NOT EXISTS disks_owner_pool_id
+                ON disks(owner_pool_id);
+            CREATE INDEX IF NOT EXISTS pools_parent_pool_id
+                ON pools(parent_pool_id);
+            CREATE INDEX IF NOT EXISTS volumes_pool_id
+                ON volumes(pool_id, consumed_size);
+            CREATE INDEX IF NOT EXISTS inits_owner_ag_id
+                ON inits(owner_ag_id);
+            CREATE INDEX IF NOT EXISTS vol_masks_vol_id ON vol_masks(vol_id);
+            CREATE INDEX IF NOT EXISTS vol_masks_ag_id ON vol_masks(ag_id);
+            CREATE INDEX IF NOT EXISTS vol_reps_src_vol_id
+                ON vol_reps(src_vol_id);
+            CREATE INDEX IF NOT EXISTS vol_reps_dst_vol_id
+                ON vol_reps(dst_vol_id);
+            CREATE INDEX IF NOT EXISTS fss_pool_id
+                ON fss(pool_id, consumed_size);
+            CREATE INDEX IF NOT EXISTS fs_snaps_fs_id ON fs_snaps(fs_id);
+            CREATE INDEX IF NOT EXISTS fs_clones_src_fs_id
+                ON fs_clones(src_fs_id);
+            CREATE INDEX IF NOT EXISTS fs_clones_dst_fs_id
+                ON fs_clones(dst_fs_id);
+            CREATE INDEX IF NOT EXISTS exps_fs_id ON exps(fs_id);
+            CREATE INDEX IF NOT EXISTS exp_root_hosts_exp_id
+                ON exp_root_hosts(exp_id);
+            CREATE INDEX IF NOT EXISTS exp_rw_hosts_exp_id
+                ON exp_rw_hosts(exp_id);
+            CREATE INDEX IF NOT EXISTS exp_ro_hosts_exp_id
+                ON exp_ro_hosts(exp_id);
+            """)
+
     def _check_version(self):
         sim_syss = self.sim_syss()
         if len(sim_syss) == 0 or not sim_syss[0]:
@@ -1020,12 +1041,13 @@ def check_version_and_init(self):
             self.trans_commit()
             return
 
-    def _sql_exec(self, sql_cmd):
+    def _sql_exec(self, sql_cmd, sql_args=()):
         """
         Execute sql command and get all output.
+        Values of sql_args are bound to the '?' placeholders of sql_cmd.
         """
         sql_cur = self.sql_conn.cursor()
-        sql_cur.execute(sql_cmd)
+        sql_cur.execute(sql_cmd, sql_args)
         self.lastrowid = sql_cur.lastrowid
         return sql_cur.fetchall()
 
@@ -1049,12 +1071,12 @@ def _data_add(self, table_name, data_dict):
         sql_cmd = "INSERT INTO %s (%s) VALUES (%s);" % \
                   (table_name,
                    "'%s'" % ("', '".join(keys)),
-                   "'%s'" % ("', '".join(values)))
-        self._sql_exec(sql_cmd)
+                   ", ".join(["?"] * len(values)))
+        self._sql_exec(sql_cmd, values)
 
-    def _data_find(self, table, condition, flag_unique=False):
+    def _data_find(self, table, condition, sql_args=(), flag_unique=False):
         sql_cmd = "SELECT * FROM %s WHERE %s" % (table, condition)
-        sim_datas = self._sql_exec(sql_cmd)
+        sim_datas = self._sql_exec(sql_cmd, sql_args)
         if flag_unique:
             if len(sim_datas) == 0:
                 return None
@@ -1068,18 +1090,12 @@ def _data_find(self, table, condition, flag_unique=False):
             return sim_datas
 
     def _data_update(self, table, data_id, column_name, value):
-        if value is None:
-            sql_cmd = "UPDATE %s SET %s=NULL WHERE id='%s'" % \
-                (table, column_name, data_id)
-        else:
-            sql_cmd = "UPDATE %s SET %s='%s' WHERE id='%s'" % \
-                (table, column_name, value, data_id)
-
-        self._sql_exec(sql_cmd)
+        sql_cmd = "UPDATE %s SET %s=? WHERE id=?" % (table, column_name)
+        self._sql_exec(sql_cmd, (value, data_id))
 
-    def _data_delete(self, table, condition):
+    def _data_delete(self, table, condition, sql_args=()):
         sql_cmd = "DELETE FROM %s WHERE %s;" % (table, condition)
-        self._sql_exec(sql_cmd)
+        self._sql_exec(sql_cmd, sql_args)
 
     def sim_job_create(self, job_data_type=None, data_id=None):
         """
@@ -1097,14 +1113,14 @@ def sim_job_create(self, job_data_type=None, data_id=None):
         return self.lastrowid
 
     def sim_job_delete(self, sim_job_id):
-        self._data_delete('jobs', 'id="%s"' % sim_job_id)
+        self._data_delete('jobs', 'id=?', (sim_job_id,))
 
     def sim_job_status(self, sim_job_id):
         """
         Return (progress, data_type, data) tuple.
         progress is the integer of percent.
         """
-        sim_job = self._data_find('jobs', 'id=%s' % sim_job_id,
+        sim_job = self._data_find('jobs', 'id=?', (sim_job_id,),
                                   flag_unique=True)
         if sim_job is None:
             raise LsmError(
@@ -1147,7 +1163,7 @@ def lsm_disk_ids_of_pool(self, sim_pool_id):
         return list(
             d['lsm_disk_id']
             for d in self._data_find(
-                'disks_view', 'owner_pool_id="%s"' % sim_pool_id))
+                'disks_view', 'owner_pool_id=?', (sim_pool_id,)))
 
     def sim_disks(self):
         """
@@ -1226,13 +1242,13 @@ def sim_pool_create_sub_pool(self, name, parent_pool_id, size,
 
     def sim_pool_disks_count(self, sim_pool_id):
         return self._sql_exec(
-            "SELECT COUNT(id) FROM disks WHERE owner_pool_id=%s;" %
-            sim_pool_id)[0][0]
+            "SELECT COUNT(id) FROM disks WHERE owner_pool_id=?;",
+            (sim_pool_id,))[0][0]
 
     def sim_pool_data_disks_count(self, sim_pool_id=None):
         return self._sql_exec(
             "SELECT COUNT(id) FROM disks WHERE "
-            "owner_pool_id=%s and role='DATA';" % sim_pool_id)[0][0]
+            "owner_pool_id=? and role='DATA';", (sim_pool_id,))[0][0]
 
     def sim_vols(self, sim_ag_id=None):
         """
@@ -1240,13 +1256,13 @@ def sim_vols(self, sim_ag_id=None):
         """
         if sim_ag_id:
             return self._data_find(
-                'volumes_by_ag_view', 'ag_id=%s' % sim_ag_id)
+                'volumes_by_ag_view', 'ag_id=?', (sim_ag_id,))
         else:
             return self._get_table('volumes_view')
 
     def _sim_data_of_id(self, table_name, data_id, lsm_error_no, data_name):
         sim_data = self._data_find(
-            table_name, 'id=%s' % data_id, flag_unique=True)
+            table_name, 'id=?', (data_id,), flag_unique=True)
         if sim_data is None:
             if lsm_error_no:
                 raise LsmError(
@@ -1322,21 +1338,20 @@ def sim_vol_delete(self, sim_vol_id):
                         "Requested volume has child dependency")
         if sim_vol['is_hw_raid_vol']:
             # Reset disk roles
-            for d in self._data_find('disks_view',
-                                     'owner_pool_id="%s"' % sim_vol["pool_id"]):
+            for d in self._data_find('disks_view', 'owner_pool_id=?',
+                                     (sim_vol["pool_id"],)):
                 self._data_update("disks", d["id"], 'role', None)
 
             # Delete the parent pool instead if found a HW RAID volume.
-            self._data_delete("pools", 'id="%s"' % sim_vol['pool_id'])
+            self._data_delete("pools", 'id=?', (sim_vol['pool_id'],))
         else:
-            self._data_delete("volumes", 'id="%s"' % sim_vol_id)
+            self._data_delete("volumes", 'id=?', (sim_vol_id,))
 
     def sim_vol_mask(self, sim_vol_id, sim_ag_id):
         self.sim_vol_of_id(sim_vol_id)
         self.sim_ag_of_id(sim_ag_id)
         exist_mask = self._data_find(
-            'vol_masks', 'ag_id="%s" AND vol_id="%s"' %
-            (sim_ag_id, sim_vol_id))
+            'vol_masks', 'ag_id=? AND vol_id=?', (sim_ag_id, sim_vol_id))
         if exist_mask:
             raise LsmError(
                 ErrorNumber.NO_STATE_CHANGE,
@@ -1350,10 +1365,11 @@ def sim_vol_mask(self, sim_vol_id, sim_ag_id):
     def sim_vol_unmask(self, sim_vol_id, sim_ag_id):
         self.sim_vol_of_id(sim_vol_id)
         self.sim_ag_of_id(sim_ag_id)
-        condition = 'ag_id="%s" AND vol_id="%s"' % (sim_ag_id, sim_vol_id)
-        exist_mask = self._data_find('vol_masks', condition)
+        condition = 'ag_id=? AND vol_id=?'
+        sql_args = (sim_ag_id, sim_vol_id)
+        exist_mask = self._data_find('vol_masks', condition, sql_args)
         if exist_mask:
-            self._data_delete('vol_masks', condition)
+            self._data_delete('vol_masks', condition, sql_args)
         else:
             raise LsmError(
                 ErrorNumber.NO_STATE_CHANGE,
@@ -1363,12 +1379,12 @@ def sim_vol_unmask(self, sim_vol_id, sim_ag_id):
     def _sim_vol_ids_of_masked_ag(self, sim_ag_id):
         return list(
             m['vol_id'] for m in self._data_find(
-                'vol_masks', 'ag_id="%s"' % sim_ag_id))
+                'vol_masks', 'ag_id=?', (sim_ag_id,)))
 
     def _sim_ag_ids_of_masked_vol(self, sim_vol_id):
         return list(
             m['ag_id'] for m in self._data_find(
-                'vol_masks', 'vol_id="%s"' % sim_vol_id))
+                'vol_masks', 'vol_id=?', (sim_vol_id,)))
 
     def sim_vol_resize(self, sim_vol_id, new_size_bytes):
         new_size_bytes = BackStore._block_rounding(new_size_bytes)
@@ -1412,7 +1428,7 @@ def dst_sim_vol_ids_of_src(self, src_sim_vol_id):
         self.sim_vol_of_id(src_sim_vol_id)
         return list(
             d['dst_vol_id'] for d in self._data_find(
-                'vol_reps', 'src_vol_id="%s"' % src_sim_vol_id))
+                'vol_reps', 'src_vol_id=?', (src_sim_vol_id,)))
 
     def sim_vol_replica(self, src_sim_vol_id, dst_sim_vol_id, rep_type,
                         blk_ranges=None):
@@ -1430,7 +1446,7 @@ def sim_vol_replica(self, src_sim_vol_id, dst_sim_vol_id, rep_type,
 
         cur_src_sim_vol_ids = list(
             r['src_vol_id'] for r in self._data_find(
-                'vol_reps', 'dst_vol_id="%s"' % dst_sim_vol_id))
+                'vol_reps', 'dst_vol_id=?', (dst_sim_vol_id,)))
 
         if len(cur_src_sim_vol_ids) == 1:
             # We already have a relationship, do not need to add more
@@ -1455,7 +1471,7 @@ def sim_vol_src_replica_break(self, src_sim_vol_id):
                 "Provided volume is not a replication source")
 
         self._data_delete(
-            'vol_reps', 'src_vol_id="%s"' % src_sim_vol_id)
+            'vol_reps', 'src_vol_id=?', (src_sim_vol_id,))
 
     def sim_vol_state_change(self, sim_vol_id, new_admin_state):
         sim_vol = self.sim_vol_of_id(sim_vol_id)
@@ -1479,8 +1495,12 @@ def _sim_ag_format(sim_ag):
 
     def sim_ags(self, sim_vol_id=None):
         if sim_vol_id:
-            sim_ags = self._data_find(
-                'ags_by_vol_view', 'vol_id=%s' % sim_vol_id)
+            # Point query per masked access group, ags_by_vol_view would
+            # aggregate the initiators of every access group first.
+            sim_ags = [
+                self._data_find('ags_view', 'id=?', (sim_ag_id,),
+                                flag_unique=True)
+                for sim_ag_id in self._sim_ag_ids_of_masked_vol(sim_vol_id)]
         else:
             sim_ags = self._get_table('ags_view')
 
@@ -1527,7 +1547,7 @@ def sim_ag_delete(self, sim_ag_id):
                 ErrorNumber.IS_MASKED,
                 "Access group has volume masked to")
 
-        self._data_delete('ags', 'id="%s"' % sim_ag_id)
+        self._data_delete('ags', 'id=?', (sim_ag_id,))
 
     def sim_ag_init_add(self, sim_ag_id, init_id, init_type):
         sim_ag = self.sim_ag_of_id(sim_ag_id)
@@ -1556,7 +1576,7 @@ def sim_ag_init_delete(self, sim_ag_id, init_id):
                 ErrorNumber.LAST_INIT_IN_ACCESS_GROUP,
                 "Refused to remove the last initiator from access group")
 
-        self._data_delete('inits', 'id="%s"' % init_id)
+        self._data_delete('inits', 'id=?', (init_id,))
 
     def sim_ag_of_id(self, sim_ag_id):
         sim_ag = self._sim_data_of_id(
@@ -1605,7 +1625,7 @@ def sim_fs_delete(self, sim_fs_id):
                 ErrorNumber.HAS_CHILD_DEPENDENCY,
                 "Requested file system has child dependency")
 
-        self._data_delete("fss", 'id="%s"' % sim_fs_id)
+        self._data_delete("fss", 'id=?', (sim_fs_id,))
 
     def sim_fs_resize(self, sim_fs_id, new_size_bytes):
         new_size_bytes = BackStore._block_rounding(new_size_bytes)
@@ -1635,7 +1655,7 @@ def sim_fs_resize(self, sim_fs_id, new_size_bytes):
 
     def sim_fs_snaps(self, sim_fs_id):
         self.sim_fs_of_id(sim_fs_id)
-        return self._data_find('fs_snaps_view', 'fs_id="%s"' % sim_fs_id)
+        return self._data_find('fs_snaps_view', 'fs_id=?', (sim_fs_id,))
 
     def sim_fs_snap_of_id(self, sim_fs_snap_id, sim_fs_id=None):
         sim_fs_snap = self._sim_data_of_id(
@@ -1676,11 +1696,10 @@ def sim_fs_snap_restore(self, sim_fs_id, sim_fs_snap_id, files,
     def sim_fs_snap_delete(self, sim_fs_snap_id, sim_fs_id):
         self.sim_fs_of_id(sim_fs_id)
         self.sim_fs_snap_of_id(sim_fs_snap_id, sim_fs_id)
-        self._data_delete('fs_snaps', 'id="%s"' % sim_fs_snap_id)
+        self._data_delete('fs_snaps', 'id=?', (sim_fs_snap_id,))
 
     def sim_fs_snap_del_by_fs(self, sim_fs_id):
-        sql_cmd = "DELETE FROM fs_snaps WHERE fs_id='%s';" % sim_fs_id
-        self._sql_exec(sql_cmd)
+        self._data_delete('fs_snaps', 'fs_id=?', (sim_fs_id,))
 
     def sim_fs_clone(self, src_sim_fs_id, dst_sim_fs_id, sim_fs_snap_id):
         self.sim_fs_of_id(src_sim_fs_id)
@@ -1715,10 +1734,10 @@ def clone_dst_sim_fs_ids_of_src(self, src_sim_fs_id):
         self.sim_fs_of_id(src_sim_fs_id)
         return list(
             d['dst_fs_id'] for d in self._data_find(
-                'fs_clones', 'src_fs_id="%s"' % src_sim_fs_id))
+                'fs_clones', 'src_fs_id=?', (src_sim_fs_id,)))
 
     def sim_fs_src_clone_break(self, src_sim_fs_id):
-        self._data_delete('fs_clones', 'src_fs_id="%s"' % src_sim_fs_id)
+        self._data_delete('fs_clones', 'src_fs_id=?', (src_sim_fs_id,))
 
     def _sim_exp_format(self, sim_exp):
         for key_name in ['root_hosts', 'rw_hosts', 'ro_hosts']:
@@ -1793,7 +1812,7 @@ def sim_exp_create(self, sim_fs_id, exp_path, root_hosts, rw_hosts,
 
     def sim_exp_delete(self, sim_exp_id):
         self.sim_exp_of_id(sim_exp_id)
-        self._data_delete('exps', 'id="%s"' % sim_exp_id)
+        self._data_delete('exps', 'id=?', (sim_exp_id,))
 
     def sim_tgts(self):
         """
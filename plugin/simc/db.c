@@ -22,6 +22,7 @@
 #include <sqlite3.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,6 +37,7 @@
 #define _DB_VERSION_CHECK_PASS          0
 #define _DB_VERSION_CHECK_FAIL          1
 #define _DB_VERSION_CHECK_EMPTY         2
+#define _DB_VERSION_CHECK_MIGRATE       3
 #define _SIZE_2TIB_STR                  "2199023255552"
 #define _SIZE_512GIB_STR                "549755813888"
 #define _SIZE_BIG                       "1152921504606846976"
@@ -43,10 +45,55 @@
 #define _POOL_STATUS_OK_STR             "2"
 #define _POOL_MEMBER_TYPE_DISK_STR      "2"
 #define _POOL_MEMBER_TYPE_POOL_STR      "3"
-#define _DISK_ROLE_DATA                 "DATA"
-#define _DISK_ROLE_PARITY               "PARITY"
 #define _VOLUME_RAID_TYPE_OTHER_STR     "22"
 #define _DEFAULT_SYS_READ_CACHE_PCT_STR "10"
+#define _DB_DATA_ADD_MAX_COLUMNS        32
+#define _DB_MMAP_SIZE                   "268435456" /* 256 MiB */
+#define _DB_PRAGMA_INIT                                                        \
+    "PRAGMA journal_mode = WAL;"                                               \
+    "PRAGMA synchronous = NORMAL;"                                             \
+    "PRAGMA mmap_size = " _DB_MMAP_SIZE ";"
+#define _SEED_OBJECT_SIZE               (1024 * 1024 * 1024) /* 1 GiB */
+
+/*
+ * Column indexes of _DB_SIM_VOL_COLUMNS and _DB_SIM_DISK_COLUMNS.
+ */
+enum _db_sim_vol_column {
+    _DB_SIM_VOL_ID = 0,
+    _DB_SIM_VOL_LSM_VOL_ID,
+    _DB_SIM_VOL_NAME,
+    _DB_SIM_VOL_VPD83,
+    _DB_SIM_VOL_TOTAL_SPACE,
+    _DB_SIM_VOL_ADMIN_STATE,
+    _DB_SIM_VOL_LSM_POOL_ID,
+};
+
+enum _db_sim_disk_column {
+    _DB_SIM_DISK_ID = 0,
+    _DB_SIM_DISK_LSM_DISK_ID,
+    _DB_SIM_DISK_NAME,
+    _DB_SIM_DISK_TOTAL_SPACE,
+    _DB_SIM_DISK_DISK_TYPE,
+    _DB_SIM_DISK_ROLE,
+    _DB_SIM_DISK_STATUS,
+    _DB_SIM_DISK_VPD83,
+    _DB_SIM_DISK_RPM,
+    _DB_SIM_DISK_LINK_TYPE,
+    _DB_SIM_DISK_LOCATION,
+};
+
+struct _db_stmt_cache_entry {
+    char *sql;
+    sqlite3_stmt *stmt;
+    bool in_use; /* Handed out by _db_stmt_get(), not yet released */
+};
+
+struct _db_stmt_cache {
+    sqlite3 *db;
+    struct _db_stmt_cache_entry entries[_DB_STMT_CACHE_SIZE];
+    uint32_t next; /* Next eviction candidate */
+    struct _db_stmt_cache *next_cache;
+};
 
 static char _SYS_VERSION[_BUFF_SIZE];
 
@@ -62,12 +109,20 @@ static const uint32_t _SUPPORTED_STRIP_SIZES[] = {
     128 * 1024, 256 * 1024, 512 * 1024, 1024 * 1024,
 };
 
+/* One statement cache per open connection, see _db_stmt_cache_get() */
+static struct _db_stmt_cache *_db_stmt_caches = NULL;
+
 static int _parse_sql_column(void *v, int columne_count, char **values,
                              char **keys);
+static int _db_sql_rc_check(char *err_msg, sqlite3 *db, int sql_rc);
+static const char *_db_column_str(sqlite3_stmt *stmt, int i);
 static int _db_version_check(sqlite3 *db);
 
 static int _db_data_init(char *err_msg, sqlite3 *db);
 
+static int _db_data_seed(char *err_msg, sqlite3 *db,
+                         const struct _db_seed *seed);
+
 static const char *_sys_version(void);
 
 /*
@@ -117,12 +172,36 @@ static int _parse_sql_column(void *v, int columne_count, char **values,
     return 0;
 }
 
+static int _db_sql_rc_check(char *err_msg, sqlite3 *db, int sql_rc) {
+    if ((sql_rc == SQLITE_OK) || (sql_rc == SQLITE_ROW) ||
+        (sql_rc == SQLITE_DONE))
+        return LSM_ERR_OK;
+
+    if (sql_rc == SQLITE_BUSY) {
+        _lsm_err_msg_set(err_msg, "Timeout on locking database");
+        return LSM_ERR_TIMEOUT;
+    }
+    _lsm_err_msg_set(err_msg, "SQLite error %d: %s", sql_rc,
+                     sqlite3_errmsg(db));
+    return LSM_ERR_PLUGIN_BUG;
+}
+
+/*
+ * NULL column is treated as empty string like _parse_sql_column() does.
+ */
+static const char *_db_column_str(sqlite3_stmt *stmt, int i) {
+    const char *value = (const char *)sqlite3_column_text(stmt, i);
+
+    return value == NULL ? "" : value;
+}
+
 static int _db_version_check(sqlite3 *db) {
     int rc = _DB_VERSION_CHECK_FAIL;
     struct _vector *vec = NULL;
     lsm_hash *sim_sys = NULL;
     const char *version = NULL;
     char err_msg[_LSM_ERR_MSG_LEN];
+    sqlite3_stmt *stmt = NULL;
 
     /* We ignore the failure of below command, assigning to rc just to pass
      * convscan */
@@ -137,8 +216,14 @@ static int _db_version_check(sqlite3 *db) {
 
     version = lsm_hash_string_get(sim_sys, "version");
 
-    if ((version != NULL) && (strcmp(version, _sys_version()) == 0))
+    if ((version != NULL) && (strcmp(version, _sys_version()) == 0)) {
         rc = _DB_VERSION_CHECK_PASS;
+        /* Statefile created before pool capacity was kept in pools table */
+        if (sqlite3_prepare_v2(db, "SELECT consumed_space FROM pools;", -1,
+                               &stmt, NULL) != SQLITE_OK)
+            rc = _DB_VERSION_CHECK_MIGRATE;
+        sqlite3_finalize(stmt);
+    }
 
 out:
     _db_sql_exec_vec_free(vec);
@@ -353,6 +438,278 @@ out:
     return rc;
 }
 
+int _db_seed_parse(char *err_msg, const char *seed_str, struct _db_seed *seed) {
+    int rc = LSM_ERR_OK;
+    char tmp_str[_BUFF_SIZE];
+    char *saveptr = NULL;
+    char *item = NULL;
+    char *value_str = NULL;
+    uint32_t value = 0;
+    size_t i = 0;
+    bool found = false;
+    const struct {
+        const char *name;
+        struct _db_seed seed;
+    } profiles[] = {
+        {"small", {1, 64, 4, 1000, 50, 100, 1000, 100, 100}},
+        {"medium", {1, 256, 16, 10000, 500, 1000, 10000, 1000, 1000}},
+        {"large", {4, 1024, 64, 30000, 2000, 4000, 30000, 5000, 5000}},
+    };
+    const struct {
+        const char *name;
+        size_t offset;
+    } types[] = {
+        {"systems", offsetof(struct _db_seed, systems)},
+        {"disks", offsetof(struct _db_seed, disks)},
+        {"pools", offsetof(struct _db_seed, pools)},
+        {"volumes", offsetof(struct _db_seed, volumes)},
+        {"ags", offsetof(struct _db_seed, ags)},
+        {"inits", offsetof(struct _db_seed, inits)},
+        {"masks", offsetof(struct _db_seed, masks)},
+        {"fss", offsetof(struct _db_seed, fss)},
+        {"exports", offsetof(struct _db_seed, exports)},
+    };
+
+    assert(seed_str != NULL);
+    assert(seed != NULL);
+
+    memset(seed, 0, sizeof(struct _db_seed));
+
+    _snprintf_buff(err_msg, rc, out, tmp_str, "%s", seed_str);
+
+    for (item = strtok_r(tmp_str, ",", &saveptr); item != NULL;
+         item = strtok_r(NULL, ",", &saveptr)) {
+        found = false;
+        value_str = strchr(item, ':');
+        if (value_str == NULL) {
+            for (i = 0; i < sizeof(profiles) / sizeof(profiles[0]); ++i) {
+                if (strcmp(item, profiles[i].name) == 0) {
+                    *seed = profiles[i].seed;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                rc = LSM_ERR_INVALID_ARGUMENT;
+                _lsm_err_msg_set(err_msg, "Unknown seed profile '%s'", item);
+                goto out;
+            }
+            continue;
+        }
+        *value_str++ = '\0';
+        _good(_str_to_uint32(err_msg, value_str, &value), rc, out);
+        if (value > _DB_SEED_MAX) {
+            rc = LSM_ERR_INVALID_ARGUMENT;
+            _lsm_err_msg_set(err_msg,
+                             "Seed count of '%s' exceeds the maximum %d",
+                             item, _DB_SEED_MAX);
+            goto out;
+        }
+        for (i = 0; i < sizeof(types) / sizeof(types[0]); ++i) {
+            if (strcmp(item, types[i].name) == 0) {
+                *(uint32_t *)((char *)seed + types[i].offset) = value;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            rc = LSM_ERR_INVALID_ARGUMENT;
+            _lsm_err_msg_set(err_msg, "Unknown seed type '%s'", item);
+            goto out;
+        }
+    }
+
+    /* _db_data_seed() raises the disk count to two disks per pool */
+    if (seed->pools > _DB_SEED_MAX / 2) {
+        rc = LSM_ERR_INVALID_ARGUMENT;
+        _lsm_err_msg_set(err_msg,
+                         "Seed count of 'pools' exceeds the maximum %d, "
+                         "every pool needs two disks",
+                         _DB_SEED_MAX / 2);
+        goto out;
+    }
+
+out:
+    return rc;
+}
+
+/*
+ * Seeded objects are named 'seed_<type>_<n>' and spread round-robin: volumes
+ * and file systems over the seeded pools, initiators over the access groups,
+ * exports over the file systems.  Everything goes through the cached insert
+ * statements of _db_data_add() inside the transaction of _db_init().
+ */
+static int _db_data_seed(char *err_msg, sqlite3 *db,
+                         const struct _db_seed *seed) {
+    int rc = LSM_ERR_OK;
+    struct _db_seed s = *seed;
+    uint64_t *disk_ids = NULL;
+    uint64_t *pool_ids = NULL;
+    uint64_t *vol_ids = NULL;
+    uint64_t *ag_ids = NULL;
+    uint64_t *fs_ids = NULL;
+    uint64_t sim_id = 0;
+    uint32_t i = 0;
+    char name[_BUFF_SIZE];
+    char id_str[_BUFF_SIZE];
+    char id2_str[_BUFF_SIZE];
+    char num_str[_BUFF_SIZE];
+    char vpd_buff[_VPD_83_LEN];
+
+    assert(db != NULL);
+    assert(seed != NULL);
+
+    /* Every seeded pool is a RAID 1 of two seeded disks, volumes and file
+     * systems need a pool, initiators and masks need access groups. */
+    if ((s.pools == 0) && ((s.volumes > 0) || (s.fss > 0)))
+        s.pools = 1;
+    if (s.disks < s.pools * 2)
+        s.disks = s.pools * 2;
+    if ((s.ags == 0) && ((s.inits > 0) || (s.masks > 0)))
+        s.ags = 1;
+    if (s.inits < s.ags)
+        s.inits = s.ags;
+    if ((uint64_t)s.masks > (uint64_t)s.volumes * s.ags)
+        s.masks = s.volumes * s.ags;
+    if ((s.fss == 0) && (s.exports > 0))
+        s.fss = 1;
+
+    disk_ids = (uint64_t *)calloc(s.disks + 1, sizeof(uint64_t));
+    pool_ids = (uint64_t *)calloc(s.pools + 1, sizeof(uint64_t));
+    vol_ids = (uint64_t *)calloc(s.volumes + 1, sizeof(uint64_t));
+    ag_ids = (uint64_t *)calloc(s.ags + 1, sizeof(uint64_t));
+    fs_ids = (uint64_t *)calloc(s.fss + 1, sizeof(uint64_t));
+    if ((disk_ids == NULL) || (pool_ids == NULL) || (vol_ids == NULL) ||
+        (ag_ids == NULL) || (fs_ids == NULL)) {
+        rc = LSM_ERR_NO_MEMORY;
+        _lsm_err_msg_set(err_msg, "No memory");
+        goto out;
+    }
+
+    /* The initial data already holds _SYS_ID */
+    for (i = 2; i <= s.systems; ++i) {
+        _snprintf_buff(err_msg, rc, out, id_str, "sim-%02" PRIu32, i);
+        _snprintf_buff(err_msg, rc, out, num_str, "%d", LSM_SYSTEM_STATUS_OK);
+        _good(_db_data_add(err_msg, db, _DB_TABLE_SYS, "id", id_str, "name",
+                           "LSM simulated storage plug-in", "status", num_str,
+                           "status_info", "", "read_cache_pct",
+                           _DEFAULT_SYS_READ_CACHE_PCT_STR, "version",
+                           _sys_version(), NULL),
+              rc, out);
+    }
+
+    for (i = 0; i < s.disks; ++i) {
+        _snprintf_buff(err_msg, rc, out, name, "Port: %" PRIu32 " Box: 2 Bay: %"
+                       PRIu32, i % 32, i / 32);
+        _snprintf_buff(err_msg, rc, out, id_str, "%d", LSM_DISK_TYPE_SAS);
+        _snprintf_buff(err_msg, rc, out, id2_str, "%d", LSM_DISK_LINK_TYPE_SAS);
+        _snprintf_buff(err_msg, rc, out, num_str, "%d", LSM_DISK_STATUS_OK);
+        _good(_db_data_add(err_msg, db, _DB_TABLE_DISKS, "disk_prefix",
+                           "Seed SAS Disk", "total_space", _SIZE_BIG,
+                           "disk_type", id_str, "status", num_str, "vpd83",
+                           _random_vpd(vpd_buff), "rpm", "15000", "link_type",
+                           id2_str, "location", name, NULL),
+              rc, out);
+        disk_ids[i] = _db_last_rowid(db);
+    }
+
+    for (i = 0; i < s.pools; ++i) {
+        _snprintf_buff(err_msg, rc, out, name, "seed_pool_%" PRIu32, i);
+        _good(_db_pool_create_from_disk(
+                  err_msg, db, name, &disk_ids[i * 2], 2,
+                  LSM_VOLUME_RAID_TYPE_RAID1,
+                  LSM_POOL_ELEMENT_TYPE_FS | LSM_POOL_ELEMENT_TYPE_VOLUME |
+                      LSM_POOL_ELEMENT_TYPE_DELTA,
+                  0 /* No unsupported_actions */, &pool_ids[i],
+                  LSM_VOLUME_VCR_STRIP_SIZE_DEFAULT),
+              rc, out);
+    }
+
+    _snprintf_buff(err_msg, rc, out, num_str, "%" PRIu64,
+                   (uint64_t)_SEED_OBJECT_SIZE);
+    for (i = 0; i < s.volumes; ++i) {
+        _snprintf_buff(err_msg, rc, out, name, "seed_vol_%" PRIu32, i);
+        _snprintf_buff(err_msg, rc, out, id_str, "%" PRIu64,
+                       pool_ids[i % s.pools]);
+        _good(_db_data_add(err_msg, db, _DB_TABLE_VOLS, "vpd83",
+                           _random_vpd(vpd_buff), "name", name, "pool_id",
+                           id_str, "total_space", num_str, "consumed_size",
+                           num_str, "admin_state", "1", "is_hw_raid_vol", "0",
+                           "write_cache_policy",
+                           _DB_DEFAULT_WRITE_CACHE_POLICY, "read_cache_policy",
+                           _DB_DEFAULT_READ_CACHE_POLICY, "phy_disk_cache",
+                           _DB_DEFAULT_PHYSICAL_DISK_CACHE, NULL),
+              rc, out);
+        vol_ids[i] = _db_last_rowid(db);
+    }
+
+    for (i = 0; i < s.ags; ++i) {
+        _snprintf_buff(err_msg, rc, out, name, "seed_ag_%" PRIu32, i);
+        _good(_db_data_add(err_msg, db, _DB_TABLE_AGS, "name", name, NULL), rc,
+              out);
+        ag_ids[i] = _db_last_rowid(db);
+    }
+
+    _snprintf_buff(err_msg, rc, out, id2_str, "%d",
+                   LSM_ACCESS_GROUP_INIT_TYPE_ISCSI_IQN);
+    for (i = 0; i < s.inits; ++i) {
+        _snprintf_buff(err_msg, rc, out, name,
+                       "iqn.2016-01.com.example:seed-init-%" PRIu32, i);
+        _snprintf_buff(err_msg, rc, out, id_str, "%" PRIu64,
+                       ag_ids[i % s.ags]);
+        _good(_db_data_add(err_msg, db, _DB_TABLE_INITS, "id", name,
+                           "init_type", id2_str, "owner_ag_id", id_str, NULL),
+              rc, out);
+    }
+
+    /* Volume i % volumes masked to access group i / volumes, so no pair is
+     * masked twice. */
+    for (i = 0; i < s.masks; ++i) {
+        _snprintf_buff(err_msg, rc, out, id_str, "%" PRIu64,
+                       vol_ids[i % s.volumes]);
+        _snprintf_buff(err_msg, rc, out, id2_str, "%" PRIu64,
+                       ag_ids[i / s.volumes]);
+        _good(_db_data_add(err_msg, db, _DB_TABLE_VOL_MASKS, "vol_id", id_str,
+                           "ag_id", id2_str, NULL),
+              rc, out);
+    }
+
+    for (i = 0; i < s.fss; ++i) {
+        _snprintf_buff(err_msg, rc, out, name, "seed_fs_%" PRIu32, i);
+        _snprintf_buff(err_msg, rc, out, id_str, "%" PRIu64,
+                       pool_ids[i % s.pools]);
+        _good(_db_data_add(err_msg, db, _DB_TABLE_FSS, "name", name,
+                           "total_space", num_str, "consumed_size", num_str,
+                           "free_space", num_str, "pool_id", id_str, NULL),
+              rc, out);
+        fs_ids[i] = _db_last_rowid(db);
+    }
+
+    for (i = 0; i < s.exports; ++i) {
+        _snprintf_buff(err_msg, rc, out, name, "/seed_exp_%" PRIu32, i);
+        _snprintf_buff(err_msg, rc, out, id_str, "%" PRIu64,
+                       fs_ids[i % s.fss]);
+        _good(_db_data_add(err_msg, db, _DB_TABLE_NFS_EXPS, "fs_id", id_str,
+                           "exp_path", name, "anon_uid", "-1", "anon_gid",
+                           "-1", "auth_type", "standard", "options", "", NULL),
+              rc, out);
+        sim_id = _db_last_rowid(db);
+        _snprintf_buff(err_msg, rc, out, id_str, "%" PRIu64, sim_id);
+        _snprintf_buff(err_msg, rc, out, name, "seed-host-%" PRIu32, i);
+        _good(_db_data_add(err_msg, db, _DB_TABLE_NFS_EXP_RW_HOSTS, "host",
+                           name, "exp_id", id_str, NULL),
+              rc, out);
+    }
+
+out:
+    free(disk_ids);
+    free(pool_ids);
+    free(vol_ids);
+    free(ag_ids);
+    free(fs_ids);
+    return rc;
+}
+
 static const char *_sys_version(void) {
     char version_md5[_MD5_HASH_STR_LEN];
 
@@ -554,14 +911,28 @@ out:
     return rc;
 }
 
-int _db_init(char *err_msg, sqlite3 **db, const char *db_file,
-             uint32_t timeout) {
+int _db_mode_parse(char *err_msg, const char *mode_str, int *mode) {
+    assert(mode_str != NULL);
+    assert(mode != NULL);
+
+    if (strcmp(mode_str, "volatile") == 0) {
+        *mode = _DB_MODE_MEMORY_VOLATILE;
+    } else if (strcmp(mode_str, "snapshot") == 0) {
+        *mode = _DB_MODE_MEMORY_SNAPSHOT;
+    } else {
+        _lsm_err_msg_set(err_msg,
+                         "Unknown memory mode '%s', expecting 'volatile' "
+                         "or 'snapshot'",
+                         mode_str);
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+    return LSM_ERR_OK;
+}
+
+static int _db_open(char *err_msg, const char *db_file, uint32_t timeout,
+                    sqlite3 **db) {
     int rc = LSM_ERR_OK;
     int db_rc = SQLITE_OK;
-    struct _vector *vec = NULL;
-    int db_check_rc = _DB_VERSION_CHECK_FAIL;
-
-    assert(db != NULL);
 
     db_rc = sqlite3_open(db_file, db);
     if (db_rc != SQLITE_OK) {
@@ -584,16 +955,112 @@ int _db_init(char *err_msg, sqlite3 **db, const char *db_file,
         goto out;
     }
 
+out:
+    return rc;
+}
+
+/*
+ * Replace the content of dst_db with the one of src_db.  The busy handler of
+ * the file side connection covers statefile locked by other plugin instances.
+ */
+static int _db_backup(char *err_msg, sqlite3 *dst_db, sqlite3 *src_db,
+                      const char *db_file) {
+    int rc = LSM_ERR_OK;
+    int db_rc = SQLITE_OK;
+    sqlite3_backup *backup = NULL;
+
+    backup = sqlite3_backup_init(dst_db, "main", src_db, "main");
+    if (backup == NULL) {
+        rc = LSM_ERR_PLUGIN_BUG;
+        _lsm_err_msg_set(err_msg, "Failed to back up '%s', sqlite error %d: %s",
+                         db_file, sqlite3_errcode(dst_db),
+                         sqlite3_errmsg(dst_db));
+        goto out;
+    }
+
+    /* -1 copies every page in one step */
+    sqlite3_backup_step(backup, -1);
+    db_rc = sqlite3_backup_finish(backup);
+    if (db_rc == SQLITE_BUSY || db_rc == SQLITE_LOCKED) {
+        rc = LSM_ERR_TIMEOUT;
+        _lsm_err_msg_set(err_msg, "Timeout on locking database '%s'", db_file);
+    } else if (db_rc != SQLITE_OK) {
+        rc = LSM_ERR_PLUGIN_BUG;
+        _lsm_err_msg_set(err_msg, "Failed to back up '%s', sqlite error %d: %s",
+                         db_file, db_rc, sqlite3_errmsg(dst_db));
+    }
+
+out:
+    return rc;
+}
+
+int _db_snapshot_save(char *err_msg, sqlite3 *db, const char *db_file,
+                      uint32_t timeout) {
+    int rc = LSM_ERR_OK;
+    sqlite3 *file_db = NULL;
+
+    assert(db != NULL);
+    assert(db_file != NULL);
+
+    _good(_db_open(err_msg, db_file, timeout, &file_db), rc, out);
+    _good(_db_backup(err_msg, file_db, db, db_file), rc, out);
+
+out:
+    sqlite3_close(file_db);
+    return rc;
+}
+
+int _db_init(char *err_msg, sqlite3 **db, const char *db_file,
+             uint32_t timeout, const struct _db_seed *seed, int mode) {
+    int rc = LSM_ERR_OK;
+    struct _vector *vec = NULL;
+    int db_check_rc = _DB_VERSION_CHECK_FAIL;
+    sqlite3 *file_db = NULL;
+
+    assert(db != NULL);
+
+    if (mode == _DB_MODE_FILE) {
+        _good(_db_open(err_msg, db_file, timeout, db), rc, out);
+
+        /* WAL lets readers run alongside the single writer, the mode is
+         * stored in the statefile so only its creator really switches it.
+         */
+        _good(_db_sql_exec(err_msg, *db, _DB_PRAGMA_INIT, NULL), rc, out);
+    } else {
+        _good(_db_open(err_msg, ":memory:", timeout, db), rc, out);
+
+        if ((mode == _DB_MODE_MEMORY_SNAPSHOT) && _file_exists(db_file)) {
+            _good(_db_open(err_msg, db_file, timeout, &file_db), rc, out);
+            _good(_db_backup(err_msg, *db, file_db, db_file), rc, out);
+        }
+    }
+
     sqlite3_exec(*db, _TABLE_INIT, NULL /* callback func */,
                  NULL /* callback func first argument */,
                  NULL /* don't generate error message */);
 
-    _good(_db_sql_trans_begin(err_msg, *db), rc, out);
-
-    /* Check db version */
+    /* Check db version in a read transaction, so registering does not wait
+     * on another plugin instance writing the statefile.  Only an empty or
+     * outdated statefile needs the write lock, check again once holding it
+     * as another instance might have initialized it meanwhile.
+     */
+    _good(_db_sql_trans_begin_read(err_msg, *db), rc, out);
     db_check_rc = _db_version_check(*db);
+    if ((db_check_rc == _DB_VERSION_CHECK_EMPTY) ||
+        (db_check_rc == _DB_VERSION_CHECK_MIGRATE)) {
+        _db_sql_trans_rollback(*db);
+        _good(_db_sql_trans_begin(err_msg, *db), rc, out);
+        db_check_rc = _db_version_check(*db);
+    }
+
     if (db_check_rc == _DB_VERSION_CHECK_EMPTY) {
         _good(_db_data_init(err_msg, *db), rc, out);
+        if (seed != NULL)
+            _good(_db_data_seed(err_msg, *db, seed), rc, out);
+    } else if (db_check_rc == _DB_VERSION_CHECK_MIGRATE) {
+        _good(_db_sql_exec(err_msg, *db, _TABLE_MIGRATE_POOLS_CAPACITY,
+                           NULL /* don't parse output */),
+              rc, out);
     } else if (db_check_rc == _DB_VERSION_CHECK_FAIL) {
         rc = LSM_ERR_INVALID_ARGUMENT;
         _lsm_err_msg_set(err_msg,
@@ -606,10 +1073,14 @@ int _db_init(char *err_msg, sqlite3 **db, const char *db_file,
     _good(_db_sql_trans_commit(err_msg, *db), rc, out);
 
 out:
+    if (file_db != NULL)
+        sqlite3_close(file_db);
+
     if (rc != LSM_ERR_OK) {
         if (*db != NULL) {
-            sqlite3_close(*db);
             _db_sql_trans_rollback(*db);
+            _db_close(*db);
+            *db = NULL;
         }
     }
 
@@ -671,17 +1142,245 @@ void _db_sql_exec_vec_free(struct _vector *vec) {
     _vector_free(vec);
 }
 
+/*
+ * Return the statement cache of db, creating it when create is true.
+ * Return NULL if not found or out of memory.
+ */
+static struct _db_stmt_cache *_db_stmt_cache_get(sqlite3 *db, bool create) {
+    struct _db_stmt_cache *cache = _db_stmt_caches;
+
+    for (; cache != NULL; cache = cache->next_cache) {
+        if (cache->db == db)
+            return cache;
+    }
+
+    if (!create)
+        return NULL;
+
+    cache = (struct _db_stmt_cache *)calloc(1, sizeof(struct _db_stmt_cache));
+    if (cache == NULL)
+        return NULL;
+
+    cache->db = db;
+    cache->next_cache = _db_stmt_caches;
+    _db_stmt_caches = cache;
+    return cache;
+}
+
 void _db_close(sqlite3 *db) {
+    uint32_t i = 0;
+    struct _db_stmt_cache **cur = &_db_stmt_caches;
+    struct _db_stmt_cache *cache = NULL;
+
     assert(db != NULL);
+
+    for (; *cur != NULL; cur = &(*cur)->next_cache) {
+        if ((*cur)->db == db) {
+            cache = *cur;
+            *cur = cache->next_cache;
+            break;
+        }
+    }
+
+    if (cache != NULL) {
+        for (; i < _DB_STMT_CACHE_SIZE; ++i) {
+            sqlite3_finalize(cache->entries[i].stmt);
+            free(cache->entries[i].sql);
+        }
+        free(cache);
+    }
     sqlite3_close(db);
 }
 
+int _db_stmt_get(char *err_msg, sqlite3 *db, const char *sql,
+                 sqlite3_stmt **stmt) {
+    int rc = LSM_ERR_OK;
+    uint32_t i = 0;
+    struct _db_stmt_cache *cache = NULL;
+    struct _db_stmt_cache_entry *entry = NULL;
+    char *sql_copy = NULL;
+
+    assert(db != NULL);
+    assert(sql != NULL);
+    assert(stmt != NULL);
+
+    *stmt = NULL;
+
+    cache = _db_stmt_cache_get(db, true);
+
+    for (; (cache != NULL) && (i < _DB_STMT_CACHE_SIZE); ++i) {
+        entry = &cache->entries[i];
+        if ((entry->sql == NULL) || (strcmp(entry->sql, sql) != 0))
+            continue;
+        if (entry->in_use)
+            /* Nested use of the same sql, prepare an uncached copy */
+            break;
+        entry->in_use = true;
+        *stmt = entry->stmt;
+        return LSM_ERR_OK;
+    }
+    entry = NULL;
+
+    /* Pick a free slot, or evict round-robin.  Statements handed out to a
+     * caller are never evicted, even if not stepped yet. */
+    for (i = 0; (cache != NULL) && (i < _DB_STMT_CACHE_SIZE); ++i) {
+        entry = &cache->entries[(cache->next + i) % _DB_STMT_CACHE_SIZE];
+        if (!entry->in_use)
+            break;
+        entry = NULL;
+    }
+
+    _good(_db_sql_rc_check(err_msg, db,
+                           sqlite3_prepare_v2(db, sql, -1, stmt, NULL)),
+          rc, out);
+
+    if (entry == NULL)
+        /* Every cached statement is in use, or the sql is, hand out an
+         * uncached one which is finalized by _db_stmt_release() */
+        goto out;
+
+    sql_copy = strdup(sql);
+    if (sql_copy == NULL)
+        goto out;
+
+    sqlite3_finalize(entry->stmt);
+    free(entry->sql);
+    entry->sql = sql_copy;
+    entry->stmt = *stmt;
+    entry->in_use = true;
+    cache->next = (uint32_t)(entry - cache->entries + 1) % _DB_STMT_CACHE_SIZE;
+
+out:
+    if (rc != LSM_ERR_OK) {
+        sqlite3_finalize(*stmt);
+        *stmt = NULL;
+    }
+    return rc;
+}
+
+int _db_stmt_step(char *err_msg, sqlite3 *db, sqlite3_stmt *stmt,
+                  bool *has_row) {
+    int sql_rc = SQLITE_OK;
+
+    assert(db != NULL);
+    assert(stmt != NULL);
+
+    sql_rc = sqlite3_step(stmt);
+    if (has_row != NULL)
+        *has_row = (sql_rc == SQLITE_ROW);
+
+    return _db_sql_rc_check(err_msg, db, sql_rc);
+}
+
+void _db_stmt_release(sqlite3_stmt *stmt) {
+    uint32_t i = 0;
+    struct _db_stmt_cache *cache = NULL;
+
+    if (stmt == NULL)
+        return;
+
+    cache = _db_stmt_cache_get(sqlite3_db_handle(stmt), false);
+
+    for (; (cache != NULL) && (i < _DB_STMT_CACHE_SIZE); ++i) {
+        if (cache->entries[i].stmt == stmt) {
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+            cache->entries[i].in_use = false;
+            return;
+        }
+    }
+    sqlite3_finalize(stmt);
+}
+
+int _db_stmt_rows_to_array(char *err_msg, sqlite3 *db, sqlite3_stmt *stmt,
+                           void *(*row_func)(char *err_msg,
+                                             sqlite3_stmt *stmt),
+                           void ***array, uint32_t *count) {
+    int rc = LSM_ERR_OK;
+    bool has_row = false;
+    uint32_t size = 0;
+    void **tmp_array = NULL;
+    void *item = NULL;
+
+    assert(db != NULL);
+    assert(stmt != NULL);
+    assert(row_func != NULL);
+    assert(array != NULL);
+    assert(count != NULL);
+
+    *array = NULL;
+    *count = 0;
+
+    while (true) {
+        _good(_db_stmt_step(err_msg, db, stmt, &has_row), rc, out);
+        if (!has_row)
+            break;
+
+        if (*count == size) {
+            size = (size == 0) ? 16 : size * 2;
+            tmp_array = (void **)realloc(*array, sizeof(void *) * size);
+            _alloc_null_check(err_msg, tmp_array, rc, out);
+            *array = tmp_array;
+        }
+        item = row_func(err_msg, stmt);
+        if (item == NULL) {
+            rc = LSM_ERR_PLUGIN_BUG;
+            goto out;
+        }
+        (*array)[(*count)++] = item;
+    }
+
+out:
+    if ((*count == 0) && (*array != NULL)) {
+        free(*array);
+        *array = NULL;
+    }
+    return rc;
+}
+
+void _db_sim_vol_decode(sqlite3_stmt *stmt, struct _db_sim_vol *sim_vol) {
+    assert(stmt != NULL);
+    assert(sim_vol != NULL);
+
+    sim_vol->id = sqlite3_column_int64(stmt, _DB_SIM_VOL_ID);
+    sim_vol->lsm_vol_id = _db_column_str(stmt, _DB_SIM_VOL_LSM_VOL_ID);
+    sim_vol->name = _db_column_str(stmt, _DB_SIM_VOL_NAME);
+    sim_vol->vpd83 = _db_column_str(stmt, _DB_SIM_VOL_VPD83);
+    sim_vol->total_space = sqlite3_column_int64(stmt, _DB_SIM_VOL_TOTAL_SPACE);
+    sim_vol->admin_state = sqlite3_column_int(stmt, _DB_SIM_VOL_ADMIN_STATE);
+    sim_vol->lsm_pool_id = _db_column_str(stmt, _DB_SIM_VOL_LSM_POOL_ID);
+}
+
+void _db_sim_disk_decode(sqlite3_stmt *stmt, struct _db_sim_disk *sim_disk) {
+    assert(stmt != NULL);
+    assert(sim_disk != NULL);
+
+    sim_disk->id = sqlite3_column_int64(stmt, _DB_SIM_DISK_ID);
+    sim_disk->lsm_disk_id = _db_column_str(stmt, _DB_SIM_DISK_LSM_DISK_ID);
+    sim_disk->name = _db_column_str(stmt, _DB_SIM_DISK_NAME);
+    sim_disk->total_space =
+        sqlite3_column_int64(stmt, _DB_SIM_DISK_TOTAL_SPACE);
+    sim_disk->disk_type = sqlite3_column_int(stmt, _DB_SIM_DISK_DISK_TYPE);
+    sim_disk->role = _db_column_str(stmt, _DB_SIM_DISK_ROLE);
+    sim_disk->status = sqlite3_column_int64(stmt, _DB_SIM_DISK_STATUS);
+    sim_disk->vpd83 = _db_column_str(stmt, _DB_SIM_DISK_VPD83);
+    sim_disk->rpm = sqlite3_column_int(stmt, _DB_SIM_DISK_RPM);
+    sim_disk->link_type = sqlite3_column_int(stmt, _DB_SIM_DISK_LINK_TYPE);
+    sim_disk->location = _db_column_str(stmt, _DB_SIM_DISK_LOCATION);
+}
+
 int _db_sql_trans_begin(char *err_msg, sqlite3 *db) {
     assert(db != NULL);
     return _db_sql_exec(err_msg, db, "BEGIN IMMEDIATE TRANSACTION;",
                         NULL /* don't parse output */);
 }
 
+int _db_sql_trans_begin_read(char *err_msg, sqlite3 *db) {
+    assert(db != NULL);
+    return _db_sql_exec(err_msg, db, "BEGIN DEFERRED TRANSACTION;",
+                        NULL /* don't parse output */);
+}
+
 int _db_sql_trans_commit(char *err_msg, sqlite3 *db) {
     assert(db != NULL);
     return _db_sql_exec(err_msg, db, "COMMIT;", NULL /* don't parse output */);
@@ -699,93 +1398,107 @@ int _db_data_add(char *err_msg, sqlite3 *db, const char *table_name, ...) {
     char keys_str[_BUFF_SIZE];
     char values_str[_BUFF_SIZE];
     const char *key_str = NULL;
-    const char *value_str = NULL;
+    const char *values[_DB_DATA_ADD_MAX_COLUMNS];
     int keys_printed = 0;
     int values_printed = 0;
+    int value_count = 0;
+    int i = 0;
+    sqlite3_stmt *stmt = NULL;
     va_list arg;
 
     assert(db != NULL);
     assert(table_name != NULL);
 
-    va_start(arg, table_name);
+    keys_str[0] = '\0';
+    values_str[0] = '\0';
 
-    key_str = va_arg(arg, const char *);
-    if (key_str != NULL)
-        value_str = va_arg(arg, const char *);
+    va_start(arg, table_name);
 
-    while ((key_str != NULL) && (value_str != NULL)) {
+    /* Values are bound rather than quoted into the SQL, so the statement
+     * text only depends on the table and keys and can be cached. */
+    while ((key_str = va_arg(arg, const char *)) != NULL) {
+        if (value_count == _DB_DATA_ADD_MAX_COLUMNS) {
+            va_end(arg);
+            rc = LSM_ERR_PLUGIN_BUG;
+            _lsm_err_msg_set(err_msg, "Too many columns");
+            goto out;
+        }
+        values[value_count] = va_arg(arg, const char *);
+        if (values[value_count] == NULL)
+            break;
         keys_printed += snprintf(keys_str + keys_printed,
-                                 _BUFF_SIZE - keys_printed, "'%s', ", key_str) -
-                        1;
-        values_printed +=
-            snprintf(values_str + values_printed, _BUFF_SIZE - values_printed,
-                     "'%s', ", value_str) -
-            1;
-        if ((_BUFF_SIZE == keys_printed) || (_BUFF_SIZE == values_printed)) {
+                                 _BUFF_SIZE - keys_printed, "%s%s",
+                                 value_count == 0 ? "" : ", ", key_str);
+        values_printed += snprintf(values_str + values_printed,
+                                   _BUFF_SIZE - values_printed, "%s?",
+                                   value_count == 0 ? "" : ", ");
+        if ((keys_printed >= _BUFF_SIZE) || (values_printed >= _BUFF_SIZE)) {
             va_end(arg);
             rc = LSM_ERR_PLUGIN_BUG;
             _lsm_err_msg_set(err_msg, "Buff too small");
             goto out;
         }
-        key_str = va_arg(arg, const char *);
-        if (key_str != NULL)
-            value_str = va_arg(arg, const char *);
+        ++value_count;
     }
     va_end(arg);
 
-    /* Remove the trailing ", " */
-    keys_str[keys_printed - strlen(", ") + 1] = '\0';
-    values_str[values_printed - strlen(", ") + 1] = '\0';
-
     _snprintf_buff(err_msg, rc, out, sql_cmd,
                    "INSERT INTO %s (%s) VALUES (%s);", table_name, keys_str,
                    values_str);
 
-    _good(
-        _db_sql_exec(err_msg, db, sql_cmd, NULL /* no need to parse output */),
-        rc, out);
+    _good(_db_stmt_get(err_msg, db, sql_cmd, &stmt), rc, out);
+    for (i = 0; i < value_count; ++i)
+        sqlite3_bind_text(stmt, i + 1, values[i], -1, SQLITE_STATIC);
+
+    _good(_db_stmt_step(err_msg, db, stmt, NULL /* no row expected */), rc,
+          out);
 
 out:
+    _db_stmt_release(stmt);
 
     return rc;
 }
 
 int _db_data_update(char *err_msg, sqlite3 *db, const char *table_name,
                     uint64_t data_id, const char *key, const char *value) {
+    int rc = LSM_ERR_OK;
     char sql_cmd[_BUFF_SIZE];
-    if (value == NULL) {
-        if (snprintf(sql_cmd, _BUFF_SIZE,
-                     "UPDATE %s SET %s=NULL "
-                     "WHERE id='%" PRIu64 "';",
-                     table_name, key, data_id) == _BUFF_SIZE)
-            goto buff_too_small;
-    } else {
-        if (snprintf(sql_cmd, _BUFF_SIZE,
-                     "UPDATE %s SET %s='%s' "
-                     "WHERE id='%" PRIu64 "';",
-                     table_name, key, value, data_id) == _BUFF_SIZE)
-            goto buff_too_small;
-    }
+    sqlite3_stmt *stmt = NULL;
 
-    return _db_sql_exec(err_msg, db, sql_cmd,
-                        NULL /* no need to parse output */);
-buff_too_small:
-    _lsm_err_msg_set(err_msg, "BUG: _db_data_add(): Buff too small");
-    return LSM_ERR_PLUGIN_BUG;
+    _snprintf_buff(err_msg, rc, out, sql_cmd,
+                   "UPDATE %s SET %s=? WHERE id=?;", table_name, key);
+
+    _good(_db_stmt_get(err_msg, db, sql_cmd, &stmt), rc, out);
+    /* NULL value binds SQL NULL */
+    sqlite3_bind_text(stmt, 1, value, -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, data_id);
+
+    _good(_db_stmt_step(err_msg, db, stmt, NULL /* no row expected */), rc,
+          out);
+
+out:
+    _db_stmt_release(stmt);
+    return rc;
 }
 
 int _db_data_delete(char *err_msg, sqlite3 *db, const char *table_name,
                     uint64_t data_id) {
+    int rc = LSM_ERR_OK;
     char sql_cmd[_BUFF_SIZE];
+    sqlite3_stmt *stmt = NULL;
 
-    if (snprintf(sql_cmd, _BUFF_SIZE, "DELETE FROM %s WHERE id=%" PRIu64 ";",
-                 table_name, data_id) == _BUFF_SIZE) {
-        _lsm_err_msg_set(err_msg, "BUG: _db_data_add(): Buff too small");
-        return LSM_ERR_PLUGIN_BUG;
-    }
+    _snprintf_buff(err_msg, rc, out, sql_cmd, "DELETE FROM %s WHERE id=?;",
+                   table_name);
 
-    return _db_sql_exec(err_msg, db, sql_cmd,
-                        NULL /* no need to parse output */);
+    _good(_db_stmt_get(err_msg, db, sql_cmd, &stmt), rc, out);
+    sqlite3_bind_int64(stmt, 1, data_id);
+
+    _good(_db_stmt_step(err_msg, db, stmt, NULL /* no row expected */), rc,
+          out);
+
+out:
+    _db_stmt_release(stmt);
+    return rc;
 }
 
 int _db_data_delete_condition(char *err_msg, sqlite3 *db,
@@ -887,13 +1600,17 @@ static int _db_sim_xxx_of_sim_id(char *err_msg, sqlite3 *db,
                                  lsm_hash **sim_xxx, int not_found_err,
                                  const char *not_found_err_str) {
     int rc = LSM_ERR_OK;
-    struct _vector *vec = NULL;
     char sql_cmd[_BUFF_SIZE];
+    sqlite3_stmt *stmt = NULL;
+    bool has_row = false;
+    int i = 0;
 
     assert(db != NULL);
     assert(table_name != NULL);
     assert(sim_xxx != NULL);
 
+    *sim_xxx = NULL;
+
     if (sim_id == _DB_SIM_ID_NONE) {
         rc = not_found_err;
         _lsm_err_msg_set(err_msg, "%s", not_found_err_str);
@@ -901,18 +1618,32 @@ static int _db_sim_xxx_of_sim_id(char *err_msg, sqlite3 *db,
     }
 
     _snprintf_buff(err_msg, rc, out, sql_cmd,
-                   "SELECT * FROM %s WHERE id=%" PRIu64, table_name, sim_id);
+                   "SELECT * FROM %s WHERE id=?;", table_name);
 
-    _good(_db_sql_exec(err_msg, db, sql_cmd, &vec), rc, out);
+    _good(_db_stmt_get(err_msg, db, sql_cmd, &stmt), rc, out);
+    sqlite3_bind_int64(stmt, 1, sim_id);
 
-    if (_vector_size(vec) == 1) {
-        *sim_xxx = _vector_get(vec, 0);
-        *sim_xxx = lsm_hash_copy(*sim_xxx);
-    } else if (_vector_size(vec) == 0) {
+    _good(_db_stmt_step(err_msg, db, stmt, &has_row), rc, out);
+    if (!has_row) {
         rc = not_found_err;
         _lsm_err_msg_set(err_msg, "%s", not_found_err_str);
         goto out;
-    } else {
+    }
+
+    *sim_xxx = lsm_hash_alloc();
+    _alloc_null_check(err_msg, *sim_xxx, rc, out);
+
+    for (; i < sqlite3_column_count(stmt); ++i) {
+        if (lsm_hash_string_set(*sim_xxx, sqlite3_column_name(stmt, i),
+                                _db_column_str(stmt, i)) != LSM_ERR_OK) {
+            rc = LSM_ERR_NO_MEMORY;
+            _lsm_err_msg_set(err_msg, "No memory");
+            goto out;
+        }
+    }
+
+    _good(_db_stmt_step(err_msg, db, stmt, &has_row), rc, out);
+    if (has_row) {
         rc = LSM_ERR_PLUGIN_BUG;
         _lsm_err_msg_set(err_msg,
                          "Got more than 1 data with id %" PRIu64 "in table %s",
@@ -921,9 +1652,11 @@ static int _db_sim_xxx_of_sim_id(char *err_msg, sqlite3 *db,
     }
 
 out:
-    _db_sql_exec_vec_free(vec);
-    if (rc != LSM_ERR_OK)
+    _db_stmt_release(stmt);
+    if ((rc != LSM_ERR_OK) && (*sim_xxx != NULL)) {
+        lsm_hash_free(*sim_xxx);
         *sim_xxx = NULL;
+    }
     return rc;
 }
 
@@ -17,9 +17,10 @@
  */
 
 #ifndef _SIMC_DB_H_
-#define _SIMC_DB_H
+#define _SIMC_DB_H_
 
 #include <sqlite3.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "utils.h"
@@ -75,27 +76,173 @@
 
 #define _DB_SIM_ID_NONE 0
 
+#define _DISK_ROLE_DATA   "DATA"
+#define _DISK_ROLE_PARITY "PARITY"
+
 #define _DB_LIST_SPLITTER      "#"
 #define _DB_VERSION_STR_PREFIX "LSM_SIMULATOR_DATA"
 #define _DB_ID_FMT_LEN         5
 #define _DB_ID_FMT_LEN_STR     "5"
 #define _DB_ID_PADDING         "00000"
 
+#define _DB_STMT_CACHE_SIZE 64
+/* ^ Prepared statements kept per connection, see _db_stmt_get() */
+
+/*
+ * Typed rows decoded straight from sqlite3_column_*() by
+ * _db_sim_vol_decode() and _db_sim_disk_decode().  The string pointers are
+ * owned by SQLite and only valid until the statement is stepped again or
+ * released.
+ */
+#define _DB_SIM_VOL_COLUMNS                                                    \
+    "id, lsm_vol_id, name, vpd83, total_space, admin_state, lsm_pool_id"
+
+struct _db_sim_vol {
+    uint64_t id;
+    const char *lsm_vol_id;
+    const char *name;
+    const char *vpd83;
+    uint64_t total_space;
+    uint32_t admin_state;
+    const char *lsm_pool_id;
+};
+
+#define _DB_SIM_DISK_COLUMNS                                                   \
+    "id, lsm_disk_id, name, total_space, disk_type, role, status, vpd83, "     \
+    "rpm, link_type, location"
+
+struct _db_sim_disk {
+    uint64_t id;
+    const char *lsm_disk_id;
+    const char *name;
+    uint64_t total_space;
+    uint32_t disk_type;
+    const char *role;
+    uint64_t status;
+    const char *vpd83;
+    int32_t rpm;
+    int32_t link_type;
+    const char *location;
+};
+
+#define _DB_SEED_ENV "LSM_SIM_SEED"
+/* ^ Same syntax as the 'seed' URI parameter, see _db_seed_parse() */
+
+#define _DB_SEED_MAX 90000
+/* ^ Per object type, keeps IDs within _DB_ID_FMT_LEN digits */
+
+/*
+ * Extra objects to create on top of the initial data when a new statefile
+ * is initialized. systems is the total system count, the rest are added to
+ * the initial data.
+ */
+struct _db_seed {
+    uint32_t systems;
+    uint32_t disks;
+    uint32_t pools;
+    uint32_t volumes;
+    uint32_t ags;
+    uint32_t inits;
+    uint32_t masks;
+    uint32_t fss;
+    uint32_t exports;
+};
+
+#define _DB_MEMORY_ENV "LSM_SIM_MEMORY"
+/* ^ Same values as the 'memory' URI parameter, see _db_mode_parse() */
+
+#define _DB_MODE_FILE            0
+/* ^ Database is the statefile */
+#define _DB_MODE_MEMORY_VOLATILE 1
+/* ^ Database in memory, statefile not used */
+#define _DB_MODE_MEMORY_SNAPSHOT 2
+/* ^ Database in memory, loaded from statefile by _db_init() and saved back
+ *   by _db_snapshot_save()
+ */
+
+/*
+ * Parse memory mode string 'volatile' or 'snapshot' into one of the
+ * _DB_MODE_MEMORY_XXX values.
+ */
+int _db_mode_parse(char *err_msg, const char *mode_str, int *mode);
+
+/*
+ * Parse seed string in the form of '[profile][,type:count]...' into seed.
+ * Profiles are 'small', 'medium' and 'large', types are the member names of
+ * struct _db_seed.  Example: 'large,volumes:50000,exports:0'.
+ * Every count is limited to _DB_SEED_MAX, pools to half of it.
+ */
+int _db_seed_parse(char *err_msg, const char *seed_str, struct _db_seed *seed);
+
 /*
  * Create db_file is not exist as 0666 mode, initialize database tables and
- * fill in with initial data.
+ * fill in with initial data, plus the objects requested by seed if not NULL.
+ * Existing statefile is not seeded again.
+ * With mode other than _DB_MODE_FILE, the database is opened in memory
+ * instead, loaded from db_file first for _DB_MODE_MEMORY_SNAPSHOT if exists.
  */
 int _db_init(char *err_msg, sqlite3 **db, const char *db_file,
-             uint32_t timeout);
+             uint32_t timeout, const struct _db_seed *seed, int mode);
+
+/*
+ * Copy the whole in-memory database db into db_file with the SQLite backup
+ * API, replacing its content.
+ */
+int _db_snapshot_save(char *err_msg, sqlite3 *db, const char *db_file,
+                      uint32_t timeout);
 
 int _db_sql_exec(char *err_msg, sqlite3 *db, const char *cmd,
                  struct _vector **vec);
 
 void _db_sql_exec_vec_free(struct _vector *vec);
 
+/*
+ * Return a prepared statement for sql from the cache of db, preparing and
+ * caching it on first use.  The statement is reset and has no bindings.
+ * Call _db_stmt_release() once done with it; do not finalize it.  Until
+ * then the statement is never evicted, a nested call with the same sql gets
+ * a separate statement.
+ */
+int _db_stmt_get(char *err_msg, sqlite3 *db, const char *sql,
+                 sqlite3_stmt **stmt);
+
+/*
+ * Step stmt once. has_row is set to true when a row is available and may be
+ * NULL for statements returning no data.
+ */
+int _db_stmt_step(char *err_msg, sqlite3 *db, sqlite3_stmt *stmt,
+                  bool *has_row);
+
+/*
+ * Reset stmt and clear its bindings so it can go back to the cache.
+ * NULL is allowed.
+ */
+void _db_stmt_release(sqlite3_stmt *stmt);
+
+/*
+ * Step through every row of stmt, converting each row with row_func into
+ * an element of *array.  On failure, *array and *count hold the rows
+ * converted so far and should be freed by the caller.
+ */
+int _db_stmt_rows_to_array(char *err_msg, sqlite3 *db, sqlite3_stmt *stmt,
+                           void *(*row_func)(char *err_msg,
+                                             sqlite3_stmt *stmt),
+                           void ***array, uint32_t *count);
+
+void _db_sim_vol_decode(sqlite3_stmt *stmt, struct _db_sim_vol *sim_vol);
+
+void _db_sim_disk_decode(sqlite3_stmt *stmt, struct _db_sim_disk *sim_disk);
+
 void _db_close(sqlite3 *db);
 
 int _db_sql_trans_begin(char *err_msg, sqlite3 *db);
+/*
+ * Begin a deferred transaction which only takes the shared lock on its first
+ * read, so read-only requests of several plugin instances run in parallel.
+ * Never write inside it: upgrading to a write lock fails with SQLITE_BUSY
+ * right away instead of waiting for the busy timeout.
+ */
+int _db_sql_trans_begin_read(char *err_msg, sqlite3 *db);
 int _db_sql_trans_commit(char *err_msg, sqlite3 *db);
 void _db_sql_trans_rollback(sqlite3 *db);
 
@@ -24,6 +24,127 @@
 #define _LSM_ACCESS_GROUP_INIT_TYPE_ISCSI_WWPN_MIXED_STR "7"
 #define _LSM_ACCESS_GROUP_INIT_TYPE_UNKNOWN_STR          "0"
 
+/*
+ * Pool capacity is kept up to date by the triggers below instead of being
+ * summed over disks, volumes, file systems and sub-pools on every read of
+ * pools_view:
+ *  data_disk_space:    total space of the DATA disks of the pool
+ *  data_disk_count:    number of DATA disks of the pool
+ *  disk_count:         number of disks of the pool
+ *  consumed_space:     space used by volumes, file systems and sub-pools
+ */
+#define _DB_POOLS_CAPACITY_COLUMNS                                             \
+    "    data_disk_space LONG NOT NULL DEFAULT 0,\n"                           \
+    "    data_disk_count INTEGER NOT NULL DEFAULT 0,\n"                        \
+    "    disk_count INTEGER NOT NULL DEFAULT 0,\n"                             \
+    "    consumed_space LONG NOT NULL DEFAULT 0"
+
+#define _DB_DISK_CAPACITY_SQL(sign, row)                                       \
+    "    UPDATE " _DB_TABLE_POOLS " SET\n"                                     \
+    "        disk_count = disk_count " sign " 1,\n"                            \
+    "        data_disk_count = data_disk_count " sign "\n"                     \
+    "            CASE WHEN " row ".role = '" _DISK_ROLE_DATA "'\n"             \
+    "                THEN 1 ELSE 0 END,\n"                                     \
+    "        data_disk_space = data_disk_space " sign "\n"                     \
+    "            CASE WHEN " row ".role = '" _DISK_ROLE_DATA "'\n"             \
+    "                THEN " row ".total_space ELSE 0 END\n"                    \
+    "        WHERE id = " row ".owner_pool_id;\n"
+
+#define _DB_CONSUMED_SQL(sign, row, size_column, pool_column)                  \
+    "    UPDATE " _DB_TABLE_POOLS " SET\n"                                     \
+    "        consumed_space = consumed_space " sign "\n"                       \
+    "            ifnull(" row "." size_column ", 0)\n"                         \
+    "        WHERE id = " row "." pool_column ";\n"
+
+#define _DB_CONSUMED_TRIGGERS(table, size_column, pool_column)                 \
+    "CREATE TRIGGER " table "_capacity_insert AFTER INSERT ON " table "\n"    \
+    "BEGIN\n" _DB_CONSUMED_SQL("+", "NEW", size_column, pool_column)          \
+    "END;\n"                                                                   \
+    "CREATE TRIGGER " table "_capacity_delete AFTER DELETE ON " table "\n"    \
+    "BEGIN\n" _DB_CONSUMED_SQL("-", "OLD", size_column, pool_column)          \
+    "END;\n"                                                                   \
+    "CREATE TRIGGER " table "_capacity_update\n"                              \
+    "    AFTER UPDATE OF " size_column ", " pool_column " ON " table "\n"     \
+    "BEGIN\n" _DB_CONSUMED_SQL("-", "OLD", size_column, pool_column)          \
+        _DB_CONSUMED_SQL("+", "NEW", size_column, pool_column) "END;\n"
+
+#define _DB_POOLS_CAPACITY_TRIGGERS                                            \
+    "CREATE TRIGGER disks_capacity_insert AFTER INSERT ON disks\n"            \
+    "BEGIN\n" _DB_DISK_CAPACITY_SQL("+", "NEW") "END;\n"                      \
+    "CREATE TRIGGER disks_capacity_delete AFTER DELETE ON disks\n"            \
+    "BEGIN\n" _DB_DISK_CAPACITY_SQL("-", "OLD") "END;\n"                      \
+    "CREATE TRIGGER disks_capacity_update\n"                                  \
+    "    AFTER UPDATE OF owner_pool_id, role, total_space ON disks\n"         \
+    "BEGIN\n" _DB_DISK_CAPACITY_SQL("-", "OLD")                               \
+        _DB_DISK_CAPACITY_SQL("+", "NEW") "END;\n"                            \
+    _DB_CONSUMED_TRIGGERS(_DB_TABLE_VOLS, "consumed_size", "pool_id")          \
+    _DB_CONSUMED_TRIGGERS(_DB_TABLE_FSS, "consumed_size", "pool_id")           \
+    _DB_CONSUMED_TRIGGERS(_DB_TABLE_POOLS, "total_space", "parent_pool_id")
+
+#define _DB_POOLS_VIEW_CREATE                                                  \
+    "CREATE VIEW " _DB_TABLE_POOLS_VIEW " AS\n"                               \
+    "    SELECT\n"                                                             \
+    "        id,\n"                                                            \
+    "            'POOL_ID_' || \n"                                             \
+    "                SUBSTR('" _DB_ID_PADDING "' || id, \n"                    \
+    "                       -" _DB_ID_FMT_LEN_STR ", " _DB_ID_FMT_LEN_STR ")\n"\
+    "        lsm_pool_id,\n"                                                   \
+    "        name,\n"                                                          \
+    "        status,\n"                                                        \
+    "        status_info,\n"                                                   \
+    "        element_type,\n"                                                  \
+    "        unsupported_actions,\n"                                           \
+    "        raid_type,\n"                                                     \
+    "        member_type,\n"                                                   \
+    "        parent_pool_id,\n"                                                \
+    "            'POOL_ID_' || \n"                                             \
+    "                SUBSTR('" _DB_ID_PADDING "' || parent_pool_id, \n"        \
+    "                       -" _DB_ID_FMT_LEN_STR ", " _DB_ID_FMT_LEN_STR ")\n"\
+    "        parent_lsm_pool_id,\n"                                            \
+    "        strip_size,\n"                                                    \
+    "        ifnull(total_space, data_disk_space) total_space,\n"              \
+    "        ifnull(total_space, data_disk_space) - consumed_space\n"          \
+    "        free_space,\n"                                                    \
+    "        data_disk_count,\n"                                               \
+    "        disk_count\n"                                                     \
+    "    FROM\n"                                                               \
+    "        " _DB_TABLE_POOLS ";\n"
+
+/*
+ * Bring a statefile created before the capacity columns existed (by an
+ * older simc or by the sim plug-in) up to date. The schema version string
+ * is unchanged as both plug-ins share the statefile.
+ */
+static const char *_TABLE_MIGRATE_POOLS_CAPACITY =
+    "ALTER TABLE " _DB_TABLE_POOLS " ADD COLUMN\n"
+    "    data_disk_space LONG NOT NULL DEFAULT 0;\n"
+    "ALTER TABLE " _DB_TABLE_POOLS " ADD COLUMN\n"
+    "    data_disk_count INTEGER NOT NULL DEFAULT 0;\n"
+    "ALTER TABLE " _DB_TABLE_POOLS " ADD COLUMN\n"
+    "    disk_count INTEGER NOT NULL DEFAULT 0;\n"
+    "ALTER TABLE " _DB_TABLE_POOLS " ADD COLUMN\n"
+    "    consumed_space LONG NOT NULL DEFAULT 0;\n"
+    "DROP VIEW " _DB_TABLE_POOLS_VIEW ";\n" _DB_POOLS_VIEW_CREATE
+        _DB_POOLS_CAPACITY_TRIGGERS
+    "UPDATE " _DB_TABLE_POOLS " SET\n"
+    "    data_disk_space = (\n"
+    "        SELECT ifnull(SUM(total_space), 0) FROM disks\n"
+    "            WHERE owner_pool_id = pools.id AND\n"
+    "                role = '" _DISK_ROLE_DATA "'),\n"
+    "    data_disk_count = (\n"
+    "        SELECT COUNT(id) FROM disks\n"
+    "            WHERE owner_pool_id = pools.id AND\n"
+    "                role = '" _DISK_ROLE_DATA "'),\n"
+    "    disk_count = (\n"
+    "        SELECT COUNT(id) FROM disks WHERE owner_pool_id = pools.id),\n"
+    "    consumed_space = (\n"
+    "        SELECT ifnull(SUM(consumed_size), 0) FROM " _DB_TABLE_VOLS "\n"
+    "            WHERE pool_id = pools.id) + (\n"
+    "        SELECT ifnull(SUM(consumed_size), 0) FROM " _DB_TABLE_FSS "\n"
+    "            WHERE pool_id = pools.id) + (\n"
+    "        SELECT ifnull(SUM(total_space), 0) FROM " _DB_TABLE_POOLS " sub\n"
+    "            WHERE sub.parent_pool_id = pools.id);\n";
+
 static const char *_TABLE_INIT =
     "PRAGMA foreign_keys = ON;\n"
     "CREATE TABLE " _DB_TABLE_SYS " (\n"
@@ -52,8 +173,9 @@ static const char *_TABLE_INIT =
     /* ^ Indicate this pool is allocated from other pool */
     "    member_type INTEGER,\n"
     "    strip_size INTEGER,\n"
-    "    total_space LONG);\n"
+    "    total_space LONG,\n"
     /* ^ total_space here is only for sub-pool (pool from pool) */
+    _DB_POOLS_CAPACITY_COLUMNS ");\n"
     "CREATE TABLE disks (\n"
     "    id INTEGER PRIMARY KEY,\n"
     "    total_space LONG NOT NULL,\n"
@@ -169,94 +291,7 @@ static const char *_TABLE_INIT =
     "    type INTEGER NOT NULL,\n"
     "    status INTEGER NOT NULL);\n"
     /* Create views */
-    "CREATE VIEW " _DB_TABLE_POOLS_VIEW " AS\n"
-    "    SELECT\n"
-    "        pool0.id,\n"
-    "            'POOL_ID_' || \n"
-    "                SUBSTR('" _DB_ID_PADDING "' || pool0.id, \n"
-    "                       -" _DB_ID_FMT_LEN_STR ", " _DB_ID_FMT_LEN_STR ")\n"
-    "        lsm_pool_id,\n"
-    "        pool0.name,\n"
-    "        pool0.status,\n"
-    "        pool0.status_info,\n"
-    "        pool0.element_type,\n"
-    "        pool0.unsupported_actions,\n"
-    "        pool0.raid_type,\n"
-    "        pool0.member_type,\n"
-    "        pool0.parent_pool_id,\n"
-    "            'POOL_ID_' || \n"
-    "                SUBSTR('" _DB_ID_PADDING "' || pool0.parent_pool_id, \n"
-    "                       -" _DB_ID_FMT_LEN_STR ", " _DB_ID_FMT_LEN_STR ")\n"
-    "        parent_lsm_pool_id,\n"
-    "        pool0.strip_size,\n"
-    "        pool1.total_space total_space,\n"
-    "        pool1.total_space -\n"
-    "        pool2.vol_consumed_size  -\n"
-    "        pool3.fs_consumed_size -\n"
-    "        pool4.sub_pool_consumed_size free_space,\n"
-    "        pool1.data_disk_count,\n"
-    "        pool5.disk_count\n"
-    "    FROM\n"
-    "        pools pool0\n"
-    "            LEFT JOIN (\n"
-    "                SELECT\n"
-    "                    pool.id,\n"
-    "                        ifnull(pool.total_space,\n"
-    "                            ifnull(SUM(disk.total_space), 0))\n"
-    "                    total_space,\n"
-    "                    COUNT(disk.id) data_disk_count\n"
-    "                FROM pools pool\n"
-    "                    LEFT JOIN disks disk\n"
-    "                        ON pool.id = disk.owner_pool_id AND\n"
-    "                            disk.role = 'DATA'\n"
-    "                GROUP BY\n"
-    "                    pool.id\n"
-    "            ) pool1 ON pool0.id = pool1.id\n"
-    "            LEFT JOIN (\n"
-    "                SELECT\n"
-    "                    pool.id,\n"
-    "                        ifnull(SUM(volume.consumed_size), 0)\n"
-    "                    vol_consumed_size\n"
-    "                FROM pools pool\n"
-    "                    LEFT JOIN volumes volume\n"
-    "                        ON volume.pool_id = pool.id\n"
-    "                GROUP BY\n"
-    "                    pool.id\n"
-    "            ) pool2 ON pool0.id = pool2.id\n"
-    "            LEFT JOIN (\n"
-    "                SELECT\n"
-    "                    pool.id,\n"
-    "                        ifnull(SUM(fs.consumed_size), 0)\n"
-    "                    fs_consumed_size\n"
-    "                FROM pools pool\n"
-    "                    LEFT JOIN fss fs\n"
-    "                        ON fs.pool_id = pool.id\n"
-    "                GROUP BY\n"
-    "                    pool.id\n"
-    "            ) pool3 ON pool0.id = pool3.id\n"
-    "            LEFT JOIN (\n"
-    "                SELECT\n"
-    "                    pool.id,\n"
-    "                        ifnull(SUM(sub_pool.total_space), 0)\n"
-    "                    sub_pool_consumed_size\n"
-    "                FROM pools pool\n"
-    "                    LEFT JOIN pools sub_pool\n"
-    "                        ON sub_pool.parent_pool_id = pool.id\n"
-    "                GROUP BY\n"
-    "                    pool.id\n"
-    "            ) pool4 ON pool0.id = pool4.id\n"
-    "            LEFT JOIN (\n"
-    "            SELECT\n"
-    "                pool.id,\n"
-    "                COUNT(disk.id) disk_count\n"
-    "            FROM pools pool\n"
-    "                LEFT JOIN disks disk\n"
-    "                    ON pool.id = disk.owner_pool_id\n"
-    "            GROUP BY\n"
-    "                pool.id\n"
-    "            ) pool5 ON pool0.id = pool5.id\n"
-    "    GROUP BY\n"
-    "         pool0.id;\n"
+    _DB_POOLS_VIEW_CREATE
     "CREATE VIEW " _DB_TABLE_TGTS_VIEW " AS\n"
     "    SELECT\n"
     "        id,\n"
@@ -515,6 +550,6 @@ static const char *_TABLE_INIT =
     "            ) exp4\n"
     "                ON exp.id = exp4.id\n"
     "    GROUP BY\n"
-    "        exp.id;\n";
+    "        exp.id;\n" _DB_POOLS_CAPACITY_TRIGGERS;
 
 #endif /* End of _SIMC_DB_TABLE_INIT_H_ */
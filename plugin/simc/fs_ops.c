@@ -147,7 +147,8 @@ int fs_create(lsm_plugin_ptr c, lsm_pool *pool, const char *name,
     _good(_fs_create_internal(err_msg, db, name, size_bytes,
                               _db_lsm_id_to_sim_id(lsm_pool_id_get(pool))),
           rc, out);
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_FS, _db_last_rowid(db), job),
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_FS, _db_last_rowid(db),
+                      job),
           rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
@@ -197,7 +198,7 @@ int fs_delete(lsm_plugin_ptr c, lsm_fs *fs, char **job, lsm_flag flags) {
     }
 
     _good(_db_data_delete(err_msg, db, _DB_TABLE_FSS, sim_fs_id), rc, out);
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
           rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
@@ -269,8 +270,8 @@ int fs_clone(lsm_plugin_ptr c, lsm_fs *src_fs, const char *dest_fs_name,
                        "dst_fs_id", dst_sim_fs_id_str, NULL),
           rc, out);
 
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_FS, dst_sim_fs_id, job), rc,
-          out);
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_FS, dst_sim_fs_id, job),
+          rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
 out:
@@ -306,7 +307,7 @@ int fs_child_dependency(lsm_plugin_ptr c, lsm_fs *fs, lsm_string_list *files,
 
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
 
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
 
     sim_fs_id = _db_lsm_id_to_sim_id(lsm_fs_id_get(fs));
 
@@ -391,7 +392,7 @@ int fs_child_dependency_rm(lsm_plugin_ptr c, lsm_fs *fs, lsm_string_list *files,
     _good(_db_data_delete_condition(err_msg, db, _DB_TABLE_FS_SNAPS, condition),
           rc, out);
 
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
           rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
@@ -458,7 +459,8 @@ int fs_resize(lsm_plugin_ptr c, lsm_fs *fs, uint64_t new_size, lsm_fs **rfs,
                           new_size_str),
           rc, out);
 
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_FS, sim_fs_id, job), rc, out);
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_FS, sim_fs_id, job),
+          rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
 out:
@@ -506,7 +508,7 @@ int fs_file_clone(lsm_plugin_ptr c, lsm_fs *fs, const char *src_file_name,
               rc, out);
     /* We don't have API to query file level clone. So do nothing here */
 
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
           rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
@@ -542,7 +544,7 @@ int fs_snapshot_list(lsm_plugin_ptr c, lsm_fs *fs, lsm_fs_ss **ss[],
           out);
 
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
     /* Check fs existence */
     sim_fs_id = _db_lsm_id_to_sim_id(lsm_fs_id_get(fs));
     _good(_db_sim_fs_of_sim_id(err_msg, db, sim_fs_id, &sim_fs), rc, out);
@@ -624,7 +626,8 @@ int fs_snapshot_create(lsm_plugin_ptr c, lsm_fs *fs, const char *name,
         }
         goto out;
     }
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_SS, _db_last_rowid(db), job),
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_SS, _db_last_rowid(db),
+                      job),
           rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
@@ -667,7 +670,7 @@ int fs_snapshot_delete(lsm_plugin_ptr c, lsm_fs *fs, lsm_fs_ss *ss, char **job,
           rc, out);
     _good(_db_data_delete(err_msg, db, _DB_TABLE_FS_SNAPS, sim_fs_snap_id), rc,
           out);
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
           rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
@@ -28,6 +28,7 @@
 
 #include "db.h"
 #include "fs_ops.h"
+#include "profile.h"
 #include "san_ops.h"
 #include "utils.h"
 
@@ -106,7 +107,7 @@ static const char *time_stamp_str_get(char *buff) {
     memset(buff, 0, _BUFF_SIZE);
 
     if (clock_gettime(CLOCK_REALTIME, &ts) == 0)
-        snprintf(buff, _BUFF_SIZE, "%ld.%ld", (long)difftime(ts.tv_sec, 0),
+        snprintf(buff, _BUFF_SIZE, "%ld.%09ld", (long)difftime(ts.tv_sec, 0),
                  ts.tv_nsec);
 
     return buff;
@@ -275,7 +276,7 @@ int job_status(lsm_plugin_ptr c, const char *job, lsm_job_status *status,
     char cur_time_stamp_str[_BUFF_SIZE];
     double job_start_time = 0;
     double cur_time = 0;
-    uint64_t duration = 0;
+    double duration = 0;
 
     _UNUSED(flags);
     _lsm_err_msg_clear(err_msg);
@@ -286,7 +287,7 @@ int job_status(lsm_plugin_ptr c, const char *job, lsm_job_status *status,
 
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
 
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
 
     sim_job_id = _db_lsm_id_to_sim_id(job);
     if (sim_job_id == 0) {
@@ -326,9 +327,7 @@ int job_status(lsm_plugin_ptr c, const char *job, lsm_job_status *status,
         goto out;
     }
 
-    _good(_str_to_uint64(err_msg, lsm_hash_string_get(sim_job, "duration"),
-                         &duration),
-          rc, out);
+    duration = strtod(lsm_hash_string_get(sim_job, "duration"), NULL);
 
     if (duration == 0) {
         *percent_complete = 100;
@@ -457,7 +456,7 @@ int system_list(lsm_plugin_ptr c, lsm_system **systems[],
 
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
 
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
 
     _good(_db_sql_exec(err_msg, db, "SELECT * from systems;", &vec), rc, out);
 
@@ -498,10 +497,12 @@ out:
     return rc;
 }
 
-int _job_create(char *err_msg, sqlite3 *db, lsm_data_type data_type,
-                uint64_t sim_id, char **lsm_job_id) {
+int _job_create(char *err_msg, lsm_plugin_ptr c, sqlite3 *db,
+                lsm_data_type data_type, uint64_t sim_id, char **lsm_job_id) {
     int rc = LSM_ERR_OK;
-    char *duration = NULL;
+    const char *duration = NULL;
+    char duration_str[_BUFF_SIZE];
+    double profile_duration = 0;
     char time_stamp_str[_BUFF_SIZE];
     char data_type_str[_BUFF_SIZE];
     char sim_id_str[_BUFF_SIZE];
@@ -512,9 +513,15 @@ int _job_create(char *err_msg, sqlite3 *db, lsm_data_type data_type,
 
     *lsm_job_id = NULL;
 
-    duration = getenv("LSM_SIM_TIME");
-    if (duration == NULL)
-        duration = _DB_DEFAULT_JOB_DURATION;
+    profile_duration = _profile_job_duration(c);
+    if (profile_duration >= 0) {
+        _snprintf_buff(err_msg, rc, out, duration_str, "%f", profile_duration);
+        duration = duration_str;
+    } else {
+        duration = getenv("LSM_SIM_TIME");
+        if (duration == NULL)
+            duration = _DB_DEFAULT_JOB_DURATION;
+    }
 
     _snprintf_buff(err_msg, rc, out, data_type_str, "%d", data_type);
     _snprintf_buff(err_msg, rc, out, sim_id_str, "%" PRIu64, sim_id);
@@ -536,21 +543,29 @@ out:
 bool _pool_has_enough_free_size(sqlite3 *db, uint64_t sim_pool_id,
                                 uint64_t size) {
     bool rc = false;
-    lsm_hash *sim_pool = NULL;
-    uint64_t free_size = 0;
+    bool has_row = false;
+    sqlite3_stmt *stmt = NULL;
+    int64_t free_size = 0;
 
     assert(db != NULL);
     assert(sim_pool_id != 0);
 
-    if (_db_sim_pool_of_sim_id(NULL /* ignore error message */, db, sim_pool_id,
-                               &sim_pool) == LSM_ERR_OK) {
-        if ((_str_to_uint64(NULL /* ignore error message */,
-                            lsm_hash_string_get(sim_pool, "free_space"),
-                            &free_size) == LSM_ERR_OK) &&
-            (free_size >= size))
+    /* free_space is maintained by triggers, this is a single row lookup */
+    if (_db_stmt_get(NULL /* ignore error message */, db,
+                     "SELECT free_space FROM " _DB_TABLE_POOLS_VIEW
+                     " WHERE id=?;",
+                     &stmt) != LSM_ERR_OK)
+        return false;
+
+    sqlite3_bind_int64(stmt, 1, sim_pool_id);
+    if ((_db_stmt_step(NULL /* ignore error message */, db, stmt, &has_row) ==
+         LSM_ERR_OK) &&
+        has_row) {
+        free_size = sqlite3_column_int64(stmt, 0);
+        if ((free_size >= 0) && ((uint64_t)free_size >= size))
             rc = true;
-        lsm_hash_free(sim_pool);
     }
+    _db_stmt_release(stmt);
 
     return rc;
 }
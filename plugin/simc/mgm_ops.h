@@ -48,8 +48,12 @@ int pool_list(lsm_plugin_ptr c, const char *search_key,
 int system_list(lsm_plugin_ptr c, lsm_system **systems[],
                 uint32_t *system_count, lsm_flag flags);
 
-int _job_create(char *err_msg, sqlite3 *db, lsm_data_type data_type,
-                uint64_t sim_id, char **lsm_job_id);
+/*
+ * The job takes the duration set by the profile for the current request,
+ * else LSM_SIM_TIME environment variable, else _DB_DEFAULT_JOB_DURATION.
+ */
+int _job_create(char *err_msg, lsm_plugin_ptr c, sqlite3 *db,
+                lsm_data_type data_type, uint64_t sim_id, char **lsm_job_id);
 
 bool _pool_has_enough_free_size(sqlite3 *db, uint64_t sim_pool_id,
                                 uint64_t size);
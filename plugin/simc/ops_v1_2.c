@@ -51,7 +51,7 @@ int volume_raid_info(lsm_plugin_ptr c, lsm_volume *volume,
                           strip_size, disk_count, min_io_size, opt_io_size),
           rc, out);
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
 
     sim_vol_id = _db_lsm_id_to_sim_id(lsm_volume_id_get(volume));
     sim_p_id = _db_lsm_id_to_sim_id(lsm_volume_pool_id_get(volume));
@@ -137,7 +137,7 @@ int pool_member_info(lsm_plugin_ptr c, lsm_pool *pool,
                           member_type, member_ids),
           rc, out);
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
 
     sim_p_id = _db_lsm_id_to_sim_id(lsm_pool_id_get(pool));
     _good(_db_sim_pool_of_sim_id(err_msg, db, sim_p_id, &sim_p), rc, out);
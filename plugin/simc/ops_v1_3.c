@@ -110,7 +110,7 @@ int volume_ident_led_on(lsm_plugin_ptr c, lsm_volume *volume, lsm_flag flags) {
     _lsm_err_msg_clear(err_msg);
     _good(_check_null_ptr(err_msg, 1 /* argument count */, volume), rc, out);
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
 
     /* Do nothing but check the existence of volume */
     sim_vol_id = _db_lsm_id_to_sim_id(lsm_volume_id_get(volume));
@@ -192,7 +192,7 @@ int volume_cache_info(lsm_plugin_ptr c, lsm_volume *volume,
                           physical_disk_cache),
           rc, out);
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
 
     sim_vol_id = _db_lsm_id_to_sim_id(lsm_volume_id_get(volume));
     _good(_db_sim_vol_of_sim_id(err_msg, db, sim_vol_id, &sim_vol), rc, out);
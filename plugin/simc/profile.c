@@ -0,0 +1,396 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <libstoragemgmt/libstoragemgmt_plug_interface.h>
+
+#include "profile.h"
+#include "utils.h"
+#include "vector.h"
+
+#define _PROFILE_UNSET       -1
+#define _PROFILE_ALL_METHODS "*"
+#define _PROFILE_DELIMITERS  " \t\r\n"
+#define _PROFILE_MSEC_PER_SEC 1000
+#define _PROFILE_NSEC_PER_MSEC 1000000
+
+#define _PROFILE_DIST_UNIFORM     0
+#define _PROFILE_DIST_NORMAL      1
+#define _PROFILE_DIST_EXPONENTIAL 2
+
+/*
+ * Every setting is _PROFILE_UNSET unless given in the profile file.
+ */
+struct _profile_rule {
+    char *method;
+    double latency;
+    double jitter;
+    int distribution;
+    double fail_rate;
+    int fail_error;
+    double job_duration;
+};
+
+struct _simc_profile {
+    struct _vector *rules;
+    struct _profile_rule *all;
+    unsigned short rand_state[3];
+    double job_duration;
+};
+
+/*
+ * Value of the setting from the method rule, else from the '*' rule, else
+ * the default.
+ */
+#define _rule_setting(rule, all, setting, default_value)                       \
+    ((((rule) != NULL) && ((rule)->setting != _PROFILE_UNSET))                 \
+         ? (rule)->setting                                                     \
+         : ((((all) != NULL) && ((all)->setting != _PROFILE_UNSET))            \
+                ? (all)->setting                                               \
+                : (default_value)))
+
+static void _profile_rule_free(struct _profile_rule *rule);
+
+static int _profile_number_parse(char *err_msg, unsigned int line_num,
+                                 const char *key, const char *value_str,
+                                 double max, double *value);
+
+static int _profile_setting_parse(char *err_msg, unsigned int line_num,
+                                  struct _profile_rule *rule, char *setting);
+
+static int _profile_line_parse(char *err_msg, unsigned int line_num,
+                               struct _simc_profile *profile, char *line);
+
+static struct _profile_rule *_profile_rule_find(struct _simc_profile *profile,
+                                                const char *method);
+
+static double _profile_delay_ms(struct _simc_profile *profile,
+                                const struct _profile_rule *rule);
+
+static void _profile_rule_free(struct _profile_rule *rule) {
+    if (rule != NULL) {
+        free(rule->method);
+        free(rule);
+    }
+}
+
+static int _profile_number_parse(char *err_msg, unsigned int line_num,
+                                 const char *key, const char *value_str,
+                                 double max, double *value) {
+    char *end_ptr = NULL;
+
+    errno = 0;
+    *value = strtod(value_str, &end_ptr);
+    if ((errno != 0) || (end_ptr == value_str) || (*end_ptr != '\0') ||
+        (*value < 0) || (*value > max)) {
+        _lsm_err_msg_set(err_msg,
+                         "Profile line %u: invalid value '%s' for '%s'",
+                         line_num, value_str, key);
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+    return LSM_ERR_OK;
+}
+
+static int _profile_setting_parse(char *err_msg, unsigned int line_num,
+                                  struct _profile_rule *rule, char *setting) {
+    int rc = LSM_ERR_OK;
+    char *value_str = NULL;
+    double value = 0;
+
+    value_str = strchr(setting, '=');
+    if (value_str == NULL) {
+        rc = LSM_ERR_INVALID_ARGUMENT;
+        _lsm_err_msg_set(err_msg, "Profile line %u: expecting key=value, "
+                         "got '%s'", line_num, setting);
+        goto out;
+    }
+    *value_str++ = '\0';
+
+    if (strcmp(setting, "distribution") == 0) {
+        if (strcmp(value_str, "uniform") == 0) {
+            rule->distribution = _PROFILE_DIST_UNIFORM;
+        } else if (strcmp(value_str, "normal") == 0) {
+            rule->distribution = _PROFILE_DIST_NORMAL;
+        } else if (strcmp(value_str, "exponential") == 0) {
+            rule->distribution = _PROFILE_DIST_EXPONENTIAL;
+        } else {
+            rc = LSM_ERR_INVALID_ARGUMENT;
+            _lsm_err_msg_set(err_msg, "Profile line %u: unknown distribution "
+                             "'%s'", line_num, value_str);
+        }
+        goto out;
+    }
+
+    if (strcmp(setting, "latency") == 0) {
+        _good(_profile_number_parse(err_msg, line_num, setting, value_str,
+                                    INT32_MAX, &rule->latency),
+              rc, out);
+    } else if (strcmp(setting, "jitter") == 0) {
+        _good(_profile_number_parse(err_msg, line_num, setting, value_str,
+                                    INT32_MAX, &rule->jitter),
+              rc, out);
+    } else if (strcmp(setting, "fail_rate") == 0) {
+        _good(_profile_number_parse(err_msg, line_num, setting, value_str, 1,
+                                    &rule->fail_rate),
+              rc, out);
+    } else if (strcmp(setting, "fail_error") == 0) {
+        _good(_profile_number_parse(err_msg, line_num, setting, value_str,
+                                    INT32_MAX, &value),
+              rc, out);
+        if ((value == LSM_ERR_OK) || (value != (int)value)) {
+            rc = LSM_ERR_INVALID_ARGUMENT;
+            _lsm_err_msg_set(err_msg, "Profile line %u: invalid error number "
+                             "'%s'", line_num, value_str);
+            goto out;
+        }
+        rule->fail_error = (int)value;
+    } else if (strcmp(setting, "job_duration") == 0) {
+        _good(_profile_number_parse(err_msg, line_num, setting, value_str,
+                                    INT32_MAX, &rule->job_duration),
+              rc, out);
+    } else {
+        rc = LSM_ERR_INVALID_ARGUMENT;
+        _lsm_err_msg_set(err_msg, "Profile line %u: unknown setting '%s'",
+                         line_num, setting);
+    }
+
+out:
+    return rc;
+}
+
+static int _profile_line_parse(char *err_msg, unsigned int line_num,
+                               struct _simc_profile *profile, char *line) {
+    int rc = LSM_ERR_OK;
+    char *saveptr = NULL;
+    char *word = NULL;
+    struct _profile_rule *rule = NULL;
+    double seed = 0;
+    char *comment = NULL;
+
+    comment = strchr(line, '#');
+    if (comment != NULL)
+        *comment = '\0';
+
+    word = strtok_r(line, _PROFILE_DELIMITERS, &saveptr);
+    if (word == NULL)
+        goto out;
+
+    if (strncmp(word, "seed=", strlen("seed=")) == 0) {
+        _good(_profile_number_parse(err_msg, line_num, "seed",
+                                    word + strlen("seed="), UINT32_MAX, &seed),
+              rc, out);
+        profile->rand_state[0] = 0x330E;
+        profile->rand_state[1] = (uint32_t)seed & 0xFFFF;
+        profile->rand_state[2] = ((uint32_t)seed >> 16) & 0xFFFF;
+        goto out;
+    }
+
+    if (_profile_rule_find(profile, word) != NULL) {
+        rc = LSM_ERR_INVALID_ARGUMENT;
+        _lsm_err_msg_set(err_msg, "Profile line %u: duplicate rule for '%s'",
+                         line_num, word);
+        goto out;
+    }
+
+    rule = (struct _profile_rule *)malloc(sizeof(struct _profile_rule));
+    _alloc_null_check(err_msg, rule, rc, out);
+    rule->method = strdup(word);
+    _alloc_null_check(err_msg, rule->method, rc, out);
+    rule->latency = _PROFILE_UNSET;
+    rule->jitter = _PROFILE_UNSET;
+    rule->distribution = _PROFILE_UNSET;
+    rule->fail_rate = _PROFILE_UNSET;
+    rule->fail_error = _PROFILE_UNSET;
+    rule->job_duration = _PROFILE_UNSET;
+
+    while ((word = strtok_r(NULL, _PROFILE_DELIMITERS, &saveptr)) != NULL)
+        _good(_profile_setting_parse(err_msg, line_num, rule, word), rc, out);
+
+    if (_vector_insert(profile->rules, rule) != 0) {
+        rc = LSM_ERR_NO_MEMORY;
+        _lsm_err_msg_set(err_msg, "No memory");
+        goto out;
+    }
+    if (strcmp(rule->method, _PROFILE_ALL_METHODS) == 0)
+        profile->all = rule;
+    rule = NULL;
+
+out:
+    _profile_rule_free(rule);
+    return rc;
+}
+
+static struct _profile_rule *_profile_rule_find(struct _simc_profile *profile,
+                                                const char *method) {
+    uint32_t i = 0;
+    struct _profile_rule *rule = NULL;
+
+    _vector_for_each(profile->rules, i, rule) {
+        if (strcmp(rule->method, method) == 0)
+            return rule;
+    }
+    return NULL;
+}
+
+static double _profile_delay_ms(struct _simc_profile *profile,
+                                const struct _profile_rule *rule) {
+    double latency = _rule_setting(rule, profile->all, latency, 0);
+    double jitter = _rule_setting(rule, profile->all, jitter, 0);
+    int distribution = _rule_setting(rule, profile->all, distribution,
+                                     _PROFILE_DIST_UNIFORM);
+    double delay = latency;
+    /* In (0, 1] so that log() is defined */
+    double u1 = 1 - erand48(profile->rand_state);
+    double u2 = erand48(profile->rand_state);
+
+    switch (distribution) {
+    case _PROFILE_DIST_NORMAL:
+        /* Box-Muller transform */
+        delay = latency + jitter * sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+        break;
+    case _PROFILE_DIST_EXPONENTIAL:
+        delay = -latency * log(u1);
+        break;
+    default:
+        delay = latency + jitter * (2 * u2 - 1);
+        break;
+    }
+
+    return delay > 0 ? delay : 0;
+}
+
+int _profile_load(char *err_msg, const char *path,
+                  struct _simc_profile **profile) {
+    int rc = LSM_ERR_OK;
+    FILE *file = NULL;
+    char *line = NULL;
+    size_t line_size = 0;
+    unsigned int line_num = 0;
+    uint32_t seed = 0;
+
+    assert(path != NULL);
+    assert(profile != NULL);
+
+    *profile = (struct _simc_profile *)calloc(1, sizeof(struct _simc_profile));
+    _alloc_null_check(err_msg, *profile, rc, out);
+    (*profile)->rules = _vector_new(_VECTOR_NO_PRE_ALLOCATION);
+    _alloc_null_check(err_msg, (*profile)->rules, rc, out);
+    (*profile)->job_duration = _PROFILE_UNSET;
+
+    /* Not reproducible unless the profile sets a seed */
+    seed = (uint32_t)time(NULL) ^ (uint32_t)getpid();
+    (*profile)->rand_state[0] = 0x330E;
+    (*profile)->rand_state[1] = seed & 0xFFFF;
+    (*profile)->rand_state[2] = (seed >> 16) & 0xFFFF;
+
+    file = fopen(path, "r");
+    if (file == NULL) {
+        rc = LSM_ERR_INVALID_ARGUMENT;
+        _lsm_err_msg_set(err_msg, "Failed to open profile '%s', error %d: %s",
+                         path, errno, strerror(errno));
+        goto out;
+    }
+
+    while (getline(&line, &line_size, file) != -1) {
+        _good(_profile_line_parse(err_msg, ++line_num, *profile, line), rc,
+              out);
+    }
+
+out:
+    free(line);
+    if (file != NULL)
+        fclose(file);
+    if (rc != LSM_ERR_OK) {
+        _profile_free(*profile);
+        *profile = NULL;
+    }
+    return rc;
+}
+
+void _profile_free(struct _simc_profile *profile) {
+    uint32_t i = 0;
+    struct _profile_rule *rule = NULL;
+
+    if (profile == NULL)
+        return;
+
+    _vector_for_each(profile->rules, i, rule)
+        _profile_rule_free(rule);
+    if (profile->rules != NULL)
+        _vector_free(profile->rules);
+    free(profile);
+}
+
+int _profile_apply(lsm_plugin_ptr c, const char *method) {
+    struct _simc_private_data *pri_data = NULL;
+    struct _simc_profile *profile = NULL;
+    const struct _profile_rule *rule = NULL;
+    double delay_ms = 0;
+    double fail_rate = 0;
+    int fail_error = LSM_ERR_TIMEOUT;
+    struct timespec delay;
+    char err_msg[_LSM_ERR_MSG_LEN];
+
+    pri_data = (struct _simc_private_data *)lsm_private_data_get(c);
+    if ((pri_data == NULL) || (pri_data->profile == NULL))
+        return LSM_ERR_OK;
+
+    profile = pri_data->profile;
+    rule = _profile_rule_find(profile, method);
+
+    profile->job_duration =
+        _rule_setting(rule, profile->all, job_duration, _PROFILE_UNSET);
+
+    delay_ms = _profile_delay_ms(profile, rule);
+    if (delay_ms > 0) {
+        delay.tv_sec = delay_ms / _PROFILE_MSEC_PER_SEC;
+        delay.tv_nsec = (delay_ms - delay.tv_sec * _PROFILE_MSEC_PER_SEC) *
+                        _PROFILE_NSEC_PER_MSEC;
+        while ((nanosleep(&delay, &delay) != 0) && (errno == EINTR))
+            ;
+    }
+
+    fail_rate = _rule_setting(rule, profile->all, fail_rate, 0);
+    if ((fail_rate > 0) && (erand48(profile->rand_state) < fail_rate)) {
+        fail_error =
+            _rule_setting(rule, profile->all, fail_error, LSM_ERR_TIMEOUT);
+        _lsm_err_msg_set(err_msg, "Failure of '%s' injected by profile",
+                         method);
+        lsm_log_error_basic(c, fail_error, err_msg);
+        return fail_error;
+    }
+
+    return LSM_ERR_OK;
+}
+
+double _profile_job_duration(lsm_plugin_ptr c) {
+    struct _simc_private_data *pri_data = NULL;
+
+    pri_data = (struct _simc_private_data *)lsm_private_data_get(c);
+    if ((pri_data == NULL) || (pri_data->profile == NULL))
+        return _PROFILE_UNSET;
+
+    return pri_data->profile->job_duration;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _SIMC_PROFILE_H_
+#define _SIMC_PROFILE_H_
+
+#include <libstoragemgmt/libstoragemgmt_plug_interface.h>
+
+#define _PROFILE_ENV "LSM_SIM_PROFILE"
+
+/*
+ * Latency and fault injection profile, loaded from a text file with one rule
+ * per line:
+ *
+ *      # Comment
+ *      seed=42
+ *      *               latency=2 jitter=1
+ *      volumes         latency=50 jitter=20 distribution=normal
+ *      volume_create   latency=200 fail_rate=0.1 fail_error=11 job_duration=5
+ *
+ * The first word is the IPC method name, '*' for every method.  Settings of
+ * a method rule override the '*' rule one by one:
+ *
+ *  latency         Mean delay in milliseconds before handling the request.
+ *  jitter          Spread of the delay in milliseconds.
+ *  distribution    'uniform' (latency +/- jitter, default), 'normal'
+ *                  (jitter is the standard deviation) or 'exponential'
+ *                  (latency is the mean, jitter unused).
+ *  fail_rate       Probability from 0 to 1 of failing the request after the
+ *                  delay.
+ *  fail_error      Error number of failed requests, default LSM_ERR_TIMEOUT.
+ *  job_duration    Seconds taken by the jobs created by the request,
+ *                  overriding the LSM_SIM_TIME environment variable.
+ *
+ * 'seed=<number>' makes the random sequence of every plugin instance the
+ * same, so runs are reproducible.
+ */
+struct _simc_profile;
+
+/*
+ * Parse profile file into newly allocated profile.
+ * Return LSM_ERR_INVALID_ARGUMENT with err_msg set on unreadable file or
+ * syntax error.
+ */
+int _profile_load(char *err_msg, const char *path,
+                  struct _simc_profile **profile);
+
+void _profile_free(struct _simc_profile *profile);
+
+/*
+ * Apply the rule of IPC method from the profile stored in the private data
+ * of the plugin: sleep, then fail the request or remember its job duration.
+ * Return LSM_ERR_OK to carry on with the request, else the injected error,
+ * already logged with lsm_log_error_basic().
+ */
+int _profile_apply(lsm_plugin_ptr c, const char *method);
+
+/*
+ * Callback tables calling _profile_apply() before the matching simc
+ * callback, registered instead of the plain ones when a profile is loaded.
+ * Defined in profile_ops.c.
+ */
+extern struct lsm_mgmt_ops_v1 _profile_mgm_ops;
+extern struct lsm_san_ops_v1 _profile_san_ops;
+extern struct lsm_fs_ops_v1 _profile_fs_ops;
+extern struct lsm_nas_ops_v1 _profile_nfs_ops;
+extern struct lsm_ops_v1_2 _profile_ops_v1_2;
+extern struct lsm_ops_v1_3 _profile_ops_v1_3;
+
+/*
+ * Return the job duration in seconds set by the profile for the request
+ * being handled, negative if not set.
+ */
+double _profile_job_duration(lsm_plugin_ptr c);
+
+#endif /* End of _SIMC_PROFILE_H_ */
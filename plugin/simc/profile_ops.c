@@ -0,0 +1,443 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <libstoragemgmt/libstoragemgmt_plug_interface.h>
+
+#include "fs_ops.h"
+#include "mgm_ops.h"
+#include "nfs_ops.h"
+#include "ops_v1_2.h"
+#include "ops_v1_3.h"
+#include "profile.h"
+#include "san_ops.h"
+
+/*
+ * Define _profile_<func>() applying the profile rule of the IPC method
+ * before calling func().  params is the parameter list of func, args the
+ * matching argument list; the plugin pointer must be named c.
+ */
+#define _PROFILE_WRAP(func, method, params, args)                              \
+    static int _profile_##func params {                                        \
+        int rc = _profile_apply(c, method);                                    \
+        if (rc != LSM_ERR_OK)                                                  \
+            return rc;                                                         \
+        return func args;                                                      \
+    }
+
+_PROFILE_WRAP(tmo_set, "time_out_set",
+              (lsm_plugin_ptr c, uint32_t timeout, lsm_flag flags),
+              (c, timeout, flags))
+
+_PROFILE_WRAP(tmo_get, "time_out_get",
+              (lsm_plugin_ptr c, uint32_t *timeout, lsm_flag flags),
+              (c, timeout, flags))
+
+_PROFILE_WRAP(capabilities, "capabilities",
+              (lsm_plugin_ptr c, lsm_system *sys,
+               lsm_storage_capabilities **cap, lsm_flag flags),
+              (c, sys, cap, flags))
+
+_PROFILE_WRAP(job_status, "job_status",
+              (lsm_plugin_ptr c, const char *job, lsm_job_status *status,
+               uint8_t *percent_complete, lsm_data_type *type, void **value,
+               lsm_flag flags),
+              (c, job, status, percent_complete, type, value, flags))
+
+_PROFILE_WRAP(job_free, "job_free",
+              (lsm_plugin_ptr c, char *job_id, lsm_flag flags),
+              (c, job_id, flags))
+
+_PROFILE_WRAP(pool_list, "pools",
+              (lsm_plugin_ptr c, const char *search_key,
+               const char *search_value, lsm_pool **pool_array[],
+               uint32_t *count, lsm_flag flags),
+              (c, search_key, search_value, pool_array, count, flags))
+
+_PROFILE_WRAP(system_list, "systems",
+              (lsm_plugin_ptr c, lsm_system **systems[], uint32_t *system_count,
+               lsm_flag flags),
+              (c, systems, system_count, flags))
+
+_PROFILE_WRAP(volume_list, "volumes",
+              (lsm_plugin_ptr c, const char *search_key, const char *search_val,
+               lsm_volume **vol_array[], uint32_t *count, lsm_flag flags),
+              (c, search_key, search_val, vol_array, count, flags))
+
+_PROFILE_WRAP(disk_list, "disks",
+              (lsm_plugin_ptr c, const char *search_key,
+               const char *search_value, lsm_disk **disk_array[],
+               uint32_t *count, lsm_flag flags),
+              (c, search_key, search_value, disk_array, count, flags))
+
+_PROFILE_WRAP(volume_create, "volume_create",
+              (lsm_plugin_ptr c, lsm_pool *pool, const char *volume_name,
+               uint64_t size, lsm_volume_provision_type provisioning,
+               lsm_volume **new_volume, char **job, lsm_flag flags),
+              (c, pool, volume_name, size, provisioning, new_volume, job,
+               flags))
+
+_PROFILE_WRAP(volume_replicate, "volume_replicate",
+              (lsm_plugin_ptr c, lsm_pool *pool, lsm_replication_type rep_type,
+               lsm_volume *volume_src, const char *name,
+               lsm_volume **new_replicant, char **job, lsm_flag flags),
+              (c, pool, rep_type, volume_src, name, new_replicant, job, flags))
+
+_PROFILE_WRAP(volume_replicate_range_block_size,
+              "volume_replicate_range_block_size",
+              (lsm_plugin_ptr c, lsm_system *system, uint32_t *bs,
+               lsm_flag flags),
+              (c, system, bs, flags))
+
+_PROFILE_WRAP(volume_replicate_range, "volume_replicate_range",
+              (lsm_plugin_ptr c, lsm_replication_type rep_type,
+               lsm_volume *src_vol, lsm_volume *dst_vol,
+               lsm_block_range **ranges, uint32_t num_ranges, char **job,
+               lsm_flag flags),
+              (c, rep_type, src_vol, dst_vol, ranges, num_ranges, job, flags))
+
+_PROFILE_WRAP(volume_resize, "volume_resize",
+              (lsm_plugin_ptr c, lsm_volume *volume, uint64_t new_size,
+               lsm_volume **resized_volume, char **job, lsm_flag flags),
+              (c, volume, new_size, resized_volume, job, flags))
+
+_PROFILE_WRAP(volume_delete, "volume_delete",
+              (lsm_plugin_ptr c, lsm_volume *volume, char **job,
+               lsm_flag flags),
+              (c, volume, job, flags))
+
+_PROFILE_WRAP(volume_enable, "volume_enable",
+              (lsm_plugin_ptr c, lsm_volume *v, lsm_flag flags),
+              (c, v, flags))
+
+_PROFILE_WRAP(volume_disable, "volume_disable",
+              (lsm_plugin_ptr c, lsm_volume *v, lsm_flag flags),
+              (c, v, flags))
+
+_PROFILE_WRAP(iscsi_chap_auth, "iscsi_chap_auth",
+              (lsm_plugin_ptr c, const char *init_id, const char *in_user,
+               const char *in_password, const char *out_user,
+               const char *out_password, lsm_flag flags),
+              (c, init_id, in_user, in_password, out_user, out_password, flags))
+
+_PROFILE_WRAP(access_group_list, "access_groups",
+              (lsm_plugin_ptr c, const char *search_key,
+               const char *search_value, lsm_access_group **groups[],
+               uint32_t *count, lsm_flag flags),
+              (c, search_key, search_value, groups, count, flags))
+
+_PROFILE_WRAP(access_group_create, "access_group_create",
+              (lsm_plugin_ptr c, const char *name, const char *initiator_id,
+               lsm_access_group_init_type init_type, lsm_system *system,
+               lsm_access_group **access_group, lsm_flag flags),
+              (c, name, initiator_id, init_type, system, access_group, flags))
+
+_PROFILE_WRAP(access_group_delete, "access_group_delete",
+              (lsm_plugin_ptr c, lsm_access_group *group, lsm_flag flags),
+              (c, group, flags))
+
+_PROFILE_WRAP(access_group_initiator_add, "access_group_initiator_add",
+              (lsm_plugin_ptr c, lsm_access_group *access_group,
+               const char *initiator_id, lsm_access_group_init_type init_type,
+               lsm_access_group **updated_access_group, lsm_flag flags),
+              (c, access_group, initiator_id, init_type, updated_access_group,
+               flags))
+
+_PROFILE_WRAP(access_group_initiator_delete, "access_group_initiator_delete",
+              (lsm_plugin_ptr c, lsm_access_group *access_group,
+               const char *initiator_id, lsm_access_group_init_type id_type,
+               lsm_access_group **updated_access_group, lsm_flag flags),
+              (c, access_group, initiator_id, id_type, updated_access_group,
+               flags))
+
+_PROFILE_WRAP(volume_mask, "volume_mask",
+              (lsm_plugin_ptr c, lsm_access_group *group, lsm_volume *volume,
+               lsm_flag flags),
+              (c, group, volume, flags))
+
+_PROFILE_WRAP(volume_unmask, "volume_unmask",
+              (lsm_plugin_ptr c, lsm_access_group *group, lsm_volume *volume,
+               lsm_flag flags),
+              (c, group, volume, flags))
+
+_PROFILE_WRAP(volumes_accessible_by_access_group,
+              "volumes_accessible_by_access_group",
+              (lsm_plugin_ptr c, lsm_access_group *group,
+               lsm_volume **volumes[], uint32_t *count, lsm_flag flags),
+              (c, group, volumes, count, flags))
+
+_PROFILE_WRAP(access_groups_granted_to_volume,
+              "access_groups_granted_to_volume",
+              (lsm_plugin_ptr c, lsm_volume *volume,
+               lsm_access_group **groups[], uint32_t *group_count,
+               lsm_flag flags),
+              (c, volume, groups, group_count, flags))
+
+_PROFILE_WRAP(vol_child_depends, "volume_child_dependency",
+              (lsm_plugin_ptr c, lsm_volume *volume, uint8_t *yes,
+               lsm_flag flags),
+              (c, volume, yes, flags))
+
+_PROFILE_WRAP(vol_child_depends_rm, "volume_child_dependency_rm",
+              (lsm_plugin_ptr c, lsm_volume *volume, char **job,
+               lsm_flag flags),
+              (c, volume, job, flags))
+
+_PROFILE_WRAP(target_port_list, "target_ports",
+              (lsm_plugin_ptr c, const char *search_key,
+               const char *search_value, lsm_target_port **target_port_array[],
+               uint32_t *count, lsm_flag flags),
+              (c, search_key, search_value, target_port_array, count, flags))
+
+_PROFILE_WRAP(fs_list, "fs",
+              (lsm_plugin_ptr c, const char *search_key,
+               const char *search_value, lsm_fs **fs[], uint32_t *fs_count,
+               lsm_flag flags),
+              (c, search_key, search_value, fs, fs_count, flags))
+
+_PROFILE_WRAP(fs_create, "fs_create",
+              (lsm_plugin_ptr c, lsm_pool *pool, const char *name,
+               uint64_t size_bytes, lsm_fs **fs, char **job, lsm_flag flags),
+              (c, pool, name, size_bytes, fs, job, flags))
+
+_PROFILE_WRAP(fs_delete, "fs_delete",
+              (lsm_plugin_ptr c, lsm_fs *fs, char **job, lsm_flag flags),
+              (c, fs, job, flags))
+
+_PROFILE_WRAP(fs_resize, "fs_resize",
+              (lsm_plugin_ptr c, lsm_fs *fs, uint64_t new_size, lsm_fs **rfs,
+               char **job, lsm_flag flags),
+              (c, fs, new_size, rfs, job, flags))
+
+_PROFILE_WRAP(fs_clone, "fs_clone",
+              (lsm_plugin_ptr c, lsm_fs *src_fs, const char *dest_fs_name,
+               lsm_fs **cloned_fs, lsm_fs_ss *optional_snapshot, char **job,
+               lsm_flag flags),
+              (c, src_fs, dest_fs_name, cloned_fs, optional_snapshot, job,
+               flags))
+
+_PROFILE_WRAP(fs_file_clone, "fs_file_clone",
+              (lsm_plugin_ptr c, lsm_fs *fs, const char *src_file_name,
+               const char *dest_file_name, lsm_fs_ss *snapshot, char **job,
+               lsm_flag flags),
+              (c, fs, src_file_name, dest_file_name, snapshot, job, flags))
+
+_PROFILE_WRAP(fs_child_dependency, "fs_child_dependency",
+              (lsm_plugin_ptr c, lsm_fs *fs, lsm_string_list *files,
+               uint8_t *yes),
+              (c, fs, files, yes))
+
+_PROFILE_WRAP(fs_child_dependency_rm, "fs_child_dependency_rm",
+              (lsm_plugin_ptr c, lsm_fs *fs, lsm_string_list *files, char **job,
+               lsm_flag flags),
+              (c, fs, files, job, flags))
+
+_PROFILE_WRAP(fs_snapshot_list, "fs_snapshots",
+              (lsm_plugin_ptr c, lsm_fs *fs, lsm_fs_ss **ss[],
+               uint32_t *ss_count, lsm_flag flags),
+              (c, fs, ss, ss_count, flags))
+
+_PROFILE_WRAP(fs_snapshot_create, "fs_snapshot_create",
+              (lsm_plugin_ptr c, lsm_fs *fs, const char *name,
+               lsm_fs_ss **snapshot, char **job, lsm_flag flags),
+              (c, fs, name, snapshot, job, flags))
+
+_PROFILE_WRAP(fs_snapshot_delete, "fs_snapshot_delete",
+              (lsm_plugin_ptr c, lsm_fs *fs, lsm_fs_ss *ss, char **job,
+               lsm_flag flags),
+              (c, fs, ss, job, flags))
+
+_PROFILE_WRAP(fs_snapshot_restore, "fs_snapshot_restore",
+              (lsm_plugin_ptr c, lsm_fs *fs, lsm_fs_ss *ss,
+               lsm_string_list *files, lsm_string_list *restore_files,
+               int all_files, char **job, lsm_flag flags),
+              (c, fs, ss, files, restore_files, all_files, job, flags))
+
+_PROFILE_WRAP(nfs_auth_types, "export_auth",
+              (lsm_plugin_ptr c, lsm_string_list **types, lsm_flag flags),
+              (c, types, flags))
+
+_PROFILE_WRAP(nfs_list, "exports",
+              (lsm_plugin_ptr c, const char *search_key,
+               const char *search_value, lsm_nfs_export **exports[],
+               uint32_t *count, lsm_flag flags),
+              (c, search_key, search_value, exports, count, flags))
+
+_PROFILE_WRAP(nfs_export_fs, "export_fs",
+              (lsm_plugin_ptr c, const char *fs_id, const char *export_path,
+               lsm_string_list *root_list, lsm_string_list *rw_list,
+               lsm_string_list *ro_list, uint64_t anon_uid, uint64_t anon_gid,
+               const char *auth_type, const char *options,
+               lsm_nfs_export **exported, lsm_flag flags),
+              (c, fs_id, export_path, root_list, rw_list, ro_list, anon_uid,
+               anon_gid, auth_type, options, exported, flags))
+
+_PROFILE_WRAP(nfs_export_remove, "export_remove",
+              (lsm_plugin_ptr c, lsm_nfs_export *e, lsm_flag flags),
+              (c, e, flags))
+
+_PROFILE_WRAP(volume_raid_info, "volume_raid_info",
+              (lsm_plugin_ptr c, lsm_volume *volume,
+               lsm_volume_raid_type *raid_type, uint32_t *strip_size,
+               uint32_t *disk_count, uint32_t *min_io_size,
+               uint32_t *opt_io_size, lsm_flag flags),
+              (c, volume, raid_type, strip_size, disk_count, min_io_size,
+               opt_io_size, flags))
+
+_PROFILE_WRAP(pool_member_info, "pool_member_info",
+              (lsm_plugin_ptr c, lsm_pool *pool,
+               lsm_volume_raid_type *raid_type,
+               lsm_pool_member_type *member_type, lsm_string_list **member_ids,
+               lsm_flag flags),
+              (c, pool, raid_type, member_type, member_ids, flags))
+
+_PROFILE_WRAP(volume_raid_create_cap_get, "volume_raid_create_cap_get",
+              (lsm_plugin_ptr c, lsm_system *system,
+               uint32_t **supported_raid_types,
+               uint32_t *supported_raid_type_count,
+               uint32_t **supported_strip_sizes,
+               uint32_t *supported_strip_size_count, lsm_flag flags),
+              (c, system, supported_raid_types, supported_raid_type_count,
+               supported_strip_sizes, supported_strip_size_count, flags))
+
+_PROFILE_WRAP(volume_raid_create, "volume_raid_create",
+              (lsm_plugin_ptr c, const char *name,
+               lsm_volume_raid_type raid_type, lsm_disk *disks[],
+               uint32_t disk_count, uint32_t strip_size,
+               lsm_volume **new_volume, lsm_flag flags),
+              (c, name, raid_type, disks, disk_count, strip_size, new_volume,
+               flags))
+
+_PROFILE_WRAP(volume_ident_led_on, "volume_ident_led_on",
+              (lsm_plugin_ptr c, lsm_volume *volume, lsm_flag flags),
+              (c, volume, flags))
+
+_PROFILE_WRAP(volume_ident_led_off, "volume_ident_led_off",
+              (lsm_plugin_ptr c, lsm_volume *volume, lsm_flag flags),
+              (c, volume, flags))
+
+_PROFILE_WRAP(system_read_cache_pct_update, "system_read_cache_pct_update",
+              (lsm_plugin_ptr c, lsm_system *system, uint32_t read_pct,
+               lsm_flag flags),
+              (c, system, read_pct, flags))
+
+_PROFILE_WRAP(battery_list, "batteries",
+              (lsm_plugin_ptr c, const char *search_key, const char *search_val,
+               lsm_battery **bs[], uint32_t *count, lsm_flag flags),
+              (c, search_key, search_val, bs, count, flags))
+
+_PROFILE_WRAP(volume_cache_info, "volume_cache_info",
+              (lsm_plugin_ptr c, lsm_volume *volume,
+               uint32_t *write_cache_policy, uint32_t *write_cache_status,
+               uint32_t *read_cache_policy, uint32_t *read_cache_status,
+               uint32_t *physical_disk_cache, lsm_flag flags),
+              (c, volume, write_cache_policy, write_cache_status,
+               read_cache_policy, read_cache_status, physical_disk_cache,
+               flags))
+
+_PROFILE_WRAP(volume_physical_disk_cache_update,
+              "volume_physical_disk_cache_update",
+              (lsm_plugin_ptr c, lsm_volume *volume, uint32_t pdc,
+               lsm_flag flags),
+              (c, volume, pdc, flags))
+
+_PROFILE_WRAP(volume_write_cache_policy_update,
+              "volume_write_cache_policy_update",
+              (lsm_plugin_ptr c, lsm_volume *volume, uint32_t wcp,
+               lsm_flag flags),
+              (c, volume, wcp, flags))
+
+_PROFILE_WRAP(volume_read_cache_policy_update,
+              "volume_read_cache_policy_update",
+              (lsm_plugin_ptr c, lsm_volume *volume, uint32_t rcp,
+               lsm_flag flags),
+              (c, volume, rcp, flags))
+
+struct lsm_mgmt_ops_v1 _profile_mgm_ops = {
+    _profile_tmo_set,
+    _profile_tmo_get,
+    _profile_capabilities,
+    _profile_job_status,
+    _profile_job_free,
+    _profile_pool_list,
+    _profile_system_list,
+};
+
+struct lsm_san_ops_v1 _profile_san_ops = {
+    _profile_volume_list,
+    _profile_disk_list,
+    _profile_volume_create,
+    _profile_volume_replicate,
+    _profile_volume_replicate_range_block_size,
+    _profile_volume_replicate_range,
+    _profile_volume_resize,
+    _profile_volume_delete,
+    _profile_volume_enable,
+    _profile_volume_disable,
+    _profile_iscsi_chap_auth,
+    _profile_access_group_list,
+    _profile_access_group_create,
+    _profile_access_group_delete,
+    _profile_access_group_initiator_add,
+    _profile_access_group_initiator_delete,
+    _profile_volume_mask,
+    _profile_volume_unmask,
+    _profile_volumes_accessible_by_access_group,
+    _profile_access_groups_granted_to_volume,
+    _profile_vol_child_depends,
+    _profile_vol_child_depends_rm,
+    _profile_target_port_list,
+};
+
+struct lsm_fs_ops_v1 _profile_fs_ops = {
+    _profile_fs_list,
+    _profile_fs_create,
+    _profile_fs_delete,
+    _profile_fs_resize,
+    _profile_fs_clone,
+    _profile_fs_file_clone,
+    _profile_fs_child_dependency,
+    _profile_fs_child_dependency_rm,
+    _profile_fs_snapshot_list,
+    _profile_fs_snapshot_create,
+    _profile_fs_snapshot_delete,
+    _profile_fs_snapshot_restore,
+};
+
+struct lsm_nas_ops_v1 _profile_nfs_ops = {
+    _profile_nfs_auth_types,
+    _profile_nfs_list,
+    _profile_nfs_export_fs,
+    _profile_nfs_export_remove,
+};
+
+struct lsm_ops_v1_2 _profile_ops_v1_2 = {
+    _profile_volume_raid_info,
+    _profile_pool_member_info,
+    _profile_volume_raid_create_cap_get,
+    _profile_volume_raid_create,
+};
+
+struct lsm_ops_v1_3 _profile_ops_v1_3 = {
+    _profile_volume_ident_led_on,
+    _profile_volume_ident_led_off,
+    _profile_system_read_cache_pct_update,
+    _profile_battery_list,
+    _profile_volume_cache_info,
+    _profile_volume_physical_disk_cache_update,
+    _profile_volume_write_cache_policy_update,
+    _profile_volume_read_cache_policy_update,
+};
@@ -34,19 +34,24 @@
 #define _VOLUME_ADMIN_STATE_ENABLE_STR  "1"
 #define _VOLUME_ADMIN_STATE_DISABLE_STR "0"
 
-static lsm_disk *_sim_disk_to_lsm(char *err_msg, lsm_hash *sim_disk);
+static void *_sim_vol_row_to_lsm(char *err_msg, sqlite3_stmt *stmt);
+static void *_sim_disk_row_to_lsm(char *err_msg, sqlite3_stmt *stmt);
 lsm_access_group *_sim_ag_to_lsm(char *err_msg, lsm_hash *sim_ag);
 static lsm_target_port *_sim_tgt_to_lsm(char *err_msg, lsm_hash *sim_tgt);
 static int _volume_admin_state_change(lsm_plugin_ptr c, lsm_volume *v,
                                       const char *admin_state_str);
 
-_xxx_list_func_gen(volume_list, lsm_volume, _sim_vol_to_lsm,
-                   lsm_plug_volume_search_filter, _DB_TABLE_VOLS_VIEW,
-                   lsm_volume_record_array_free);
+_xxx_stmt_list_func_gen(volume_list, lsm_volume, _sim_vol_row_to_lsm,
+                        lsm_plug_volume_search_filter,
+                        "SELECT " _DB_SIM_VOL_COLUMNS
+                        " FROM " _DB_TABLE_VOLS_VIEW ";",
+                        lsm_volume_record_array_free);
 
-_xxx_list_func_gen(disk_list, lsm_disk, _sim_disk_to_lsm,
-                   lsm_plug_disk_search_filter, _DB_TABLE_DISKS_VIEW,
-                   lsm_disk_record_array_free);
+_xxx_stmt_list_func_gen(disk_list, lsm_disk, _sim_disk_row_to_lsm,
+                        lsm_plug_disk_search_filter,
+                        "SELECT " _DB_SIM_DISK_COLUMNS
+                        " FROM " _DB_TABLE_DISKS_VIEW ";",
+                        lsm_disk_record_array_free);
 
 _xxx_list_func_gen(access_group_list, lsm_access_group, _sim_ag_to_lsm,
                    lsm_plug_access_group_search_filter, _DB_TABLE_AGS_VIEW,
@@ -83,41 +88,47 @@ lsm_volume *_sim_vol_to_lsm(char *err_msg, lsm_hash *sim_vol) {
     return lsm_vol;
 }
 
-static lsm_disk *_sim_disk_to_lsm(char *err_msg, lsm_hash *sim_disk) {
-    uint32_t disk_type_u32 = 0;
-    uint64_t total_space = 0;
-    uint64_t status = 0;
+static void *_sim_vol_row_to_lsm(char *err_msg, sqlite3_stmt *stmt) {
+    struct _db_sim_vol sim_vol;
+    lsm_volume *lsm_vol = NULL;
+
+    _db_sim_vol_decode(stmt, &sim_vol);
+
+    lsm_vol = lsm_volume_record_alloc(
+        sim_vol.lsm_vol_id, sim_vol.name, sim_vol.vpd83, _BLOCK_SIZE,
+        sim_vol.total_space / _BLOCK_SIZE, sim_vol.admin_state, _SYS_ID,
+        sim_vol.lsm_pool_id, NULL /* plugin_data */);
+
+    if (lsm_vol == NULL)
+        _lsm_err_msg_set(err_msg, "No memory");
+
+    return lsm_vol;
+}
+
+static void *_sim_disk_row_to_lsm(char *err_msg, sqlite3_stmt *stmt) {
+    struct _db_sim_disk sim_disk;
     lsm_disk *lsm_d = NULL;
-    int32_t rpm = LSM_DISK_RPM_UNKNOWN;
-    lsm_disk_link_type link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
-
-    if ((_str_to_uint32(err_msg, lsm_hash_string_get(sim_disk, "disk_type"),
-                        &disk_type_u32) != LSM_ERR_OK) ||
-        (_str_to_uint64(err_msg, lsm_hash_string_get(sim_disk, "status"),
-                        &status) != LSM_ERR_OK) ||
-        (_str_to_int(err_msg, lsm_hash_string_get(sim_disk, "rpm"),
-                     (int *)&rpm) != LSM_ERR_OK) ||
-        (_str_to_int(err_msg, lsm_hash_string_get(sim_disk, "link_type"),
-                     (int *)&link_type) != LSM_ERR_OK) ||
-        (_str_to_uint64(err_msg, lsm_hash_string_get(sim_disk, "total_space"),
-                        &total_space) != LSM_ERR_OK))
-        return NULL;
+    uint64_t status = 0;
+
+    _db_sim_disk_decode(stmt, &sim_disk);
 
-    if (strlen(lsm_hash_string_get(sim_disk, "role")) == 0)
+    status = sim_disk.status;
+    if (strlen(sim_disk.role) == 0)
         status |= LSM_DISK_STATUS_FREE;
 
-    lsm_d = lsm_disk_record_alloc(lsm_hash_string_get(sim_disk, "lsm_disk_id"),
-                                  lsm_hash_string_get(sim_disk, "name"),
-                                  (lsm_disk_type)disk_type_u32, _BLOCK_SIZE,
-                                  total_space / _BLOCK_SIZE, status, _SYS_ID);
+    lsm_d = lsm_disk_record_alloc(
+        sim_disk.lsm_disk_id, sim_disk.name, (lsm_disk_type)sim_disk.disk_type,
+        _BLOCK_SIZE, sim_disk.total_space / _BLOCK_SIZE, status, _SYS_ID);
 
-    if (lsm_d == NULL)
+    if (lsm_d == NULL) {
         _lsm_err_msg_set(err_msg, "No memory");
+        return NULL;
+    }
 
-    lsm_disk_rpm_set(lsm_d, rpm);
-    lsm_disk_link_type_set(lsm_d, link_type);
-    lsm_disk_vpd83_set(lsm_d, lsm_hash_string_get(sim_disk, "vpd83"));
-    lsm_disk_location_set(lsm_d, lsm_hash_string_get(sim_disk, "location"));
+    lsm_disk_rpm_set(lsm_d, sim_disk.rpm);
+    lsm_disk_link_type_set(lsm_d, (lsm_disk_link_type)sim_disk.link_type);
+    lsm_disk_vpd83_set(lsm_d, sim_disk.vpd83);
+    lsm_disk_location_set(lsm_d, sim_disk.location);
 
     return lsm_d;
 }
@@ -255,9 +266,9 @@ int volume_create(lsm_plugin_ptr c, lsm_pool *pool, const char *volume_name,
     _good(_volume_create_internal(err_msg, db, volume_name, size,
                                   _db_lsm_id_to_sim_id(lsm_pool_id_get(pool))),
           rc, out);
-    _good(
-        _job_create(err_msg, db, LSM_DATA_TYPE_VOLUME, _db_last_rowid(db), job),
-        rc, out);
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_VOLUME, _db_last_rowid(db),
+                      job),
+          rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
 out:
@@ -350,7 +361,7 @@ int volume_delete(lsm_plugin_ptr c, lsm_volume *volume, char **job,
               out);
     }
 
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
           rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
@@ -410,7 +421,8 @@ int volume_replicate(lsm_plugin_ptr c, lsm_pool *pool,
                        "dst_vol_id", new_sim_vol_id_str, "rep_type",
                        rep_type_str, NULL),
           rc, out);
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_VOLUME, new_sim_vol_id, job),
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_VOLUME, new_sim_vol_id,
+                      job),
           rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
@@ -483,7 +495,7 @@ int volume_replicate_range(lsm_plugin_ptr c, lsm_replication_type rep_type,
                        src_sim_vol_id_str, "dst_vol_id", dst_sim_vol_id_str,
                        "rep_type", rep_type_str, NULL),
           rc, out);
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
           rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
@@ -590,8 +602,8 @@ int volume_resize(lsm_plugin_ptr c, lsm_volume *volume, uint64_t new_size,
                           "consumed_size", new_size_str),
           rc, out);
 
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_VOLUME, sim_vol_id, job), rc,
-          out);
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_VOLUME, sim_vol_id, job),
+          rc, out);
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
 out:
@@ -1145,8 +1157,9 @@ int volumes_accessible_by_access_group(lsm_plugin_ptr c,
     uint64_t sim_ag_id = 0;
     sqlite3 *db = NULL;
     char err_msg[_LSM_ERR_MSG_LEN];
-    struct _vector *vec = NULL;
-    char sql_cmd[_BUFF_SIZE];
+    sqlite3_stmt *stmt = NULL;
+    lsm_volume **vols = NULL;
+    uint32_t vol_count = 0;
 
     _UNUSED(flags);
     _lsm_err_msg_clear(err_msg);
@@ -1155,39 +1168,37 @@ int volumes_accessible_by_access_group(lsm_plugin_ptr c,
         _check_null_ptr(err_msg, 3 /* argument count */, group, volumes, count),
         rc, out);
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
 
     sim_ag_id = _db_lsm_id_to_sim_id(lsm_access_group_id_get(group));
 
     _good(_db_sim_ag_of_sim_id(err_msg, db, sim_ag_id, &sim_ag), rc, out);
 
-    _snprintf_buff(err_msg, rc, out, sql_cmd,
-                   "SELECT * FROM " _DB_TABLE_VOLS_VIEW_BY_AG
-                   " WHERE ag_id=%" PRIu64 ";",
-                   sim_ag_id);
-
-    _good(_db_sql_exec(err_msg, db, sql_cmd, &vec), rc, out);
-
-    if (_vector_size(vec) == 0) {
-        *count = 0;
-        *volumes = NULL;
-        goto out;
-    }
+    _good(_db_stmt_get(err_msg, db,
+                       "SELECT " _DB_SIM_VOL_COLUMNS
+                       " FROM " _DB_TABLE_VOLS_VIEW_BY_AG " WHERE ag_id=?;",
+                       &stmt),
+          rc, out);
+    sqlite3_bind_int64(stmt, 1, sim_ag_id);
 
-    _vec_to_lsm_xxx_array(err_msg, vec, lsm_volume, _sim_vol_to_lsm, volumes,
-                          count, rc, out);
+    _good(_db_stmt_rows_to_array(err_msg, db, stmt, _sim_vol_row_to_lsm,
+                                 (void ***)&vols, &vol_count),
+          rc, out);
 
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
 
+    *volumes = vols;
+    *count = vol_count;
+
 out:
+    _db_stmt_release(stmt);
     _db_sql_trans_rollback(db);
     if (sim_ag != NULL)
         lsm_hash_free(sim_ag);
 
-    if (vec != NULL)
-        _db_sql_exec_vec_free(vec);
-
     if (rc != LSM_ERR_OK) {
+        if (vols != NULL)
+            lsm_volume_record_array_free(vols, vol_count);
         if (volumes != NULL)
             *volumes = NULL;
         if (count != NULL)
@@ -1215,7 +1226,7 @@ int access_groups_granted_to_volume(lsm_plugin_ptr c, lsm_volume *volume,
         _check_null_ptr(err_msg, 3 /* argument count */, volume, groups, count),
         rc, out);
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
 
     sim_vol_id = _db_lsm_id_to_sim_id(lsm_volume_id_get(volume));
 
@@ -1273,7 +1284,7 @@ int vol_child_depends(lsm_plugin_ptr c, lsm_volume *volume, uint8_t *yes,
     _good(_check_null_ptr(err_msg, 2 /* argument count */, volume, yes), rc,
           out);
     _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);
-    _good(_db_sql_trans_begin(err_msg, db), rc, out);
+    _good(_db_sql_trans_begin_read(err_msg, db), rc, out);
 
     sim_vol_id = _db_lsm_id_to_sim_id(lsm_volume_id_get(volume));
 
@@ -1351,7 +1362,7 @@ int vol_child_depends_rm(lsm_plugin_ptr c, lsm_volume *volume, char **job,
     _good(_db_data_delete_condition(err_msg, db, _DB_TABLE_VOL_REPS, condition),
           rc, out);
 
-    _good(_job_create(err_msg, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
+    _good(_job_create(err_msg, c, db, LSM_DATA_TYPE_NONE, _DB_SIM_ID_NONE, job),
           rc, out);
 
     _good(_db_sql_trans_commit(err_msg, db), rc, out);
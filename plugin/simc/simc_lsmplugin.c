@@ -35,6 +35,7 @@
 #include "nfs_ops.h"
 #include "ops_v1_2.h"
 #include "ops_v1_3.h"
+#include "profile.h"
 #include "san_ops.h"
 #include "utils.h"
 
@@ -126,6 +127,13 @@ int plugin_register(lsm_plugin_ptr c, const char *uri, const char *password,
     char *path = NULL;
     lsm_hash *uri_params = NULL;
     const char *statefile = NULL;
+    const char *seed_str = NULL;
+    const char *profile_path = NULL;
+    const char *memory_str = NULL;
+    int db_mode = _DB_MODE_FILE;
+    struct _simc_profile *profile = NULL;
+    struct _db_seed seed;
+    bool seed_wanted = false;
     int fd = -1;
     /* Create database file with 0666 permission if not exists */
     mode_t fd_mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
@@ -154,7 +162,34 @@ int plugin_register(lsm_plugin_ptr c, const char *uri, const char *password,
     if (statefile == NULL)
         statefile = DEFAULT_STATE_FILE_PATH;
 
-    if (!_file_exists(statefile)) {
+    /* Use URI 'seed' parameter as inventory seeding profile if defined,
+     * else use system environment LSM_SIM_SEED.
+     * Only applies when the statefile is created.
+     */
+    if (uri_params != NULL)
+        seed_str = lsm_hash_string_get(uri_params, "seed");
+
+    if (seed_str == NULL)
+        seed_str = getenv(_DB_SEED_ENV);
+
+    if ((seed_str != NULL) && (strlen(seed_str) != 0)) {
+        _good(_db_seed_parse(err_msg, seed_str, &seed), rc, out);
+        seed_wanted = true;
+    }
+
+    /* Use URI 'memory' parameter as in-memory database mode if defined,
+     * else use system environment LSM_SIM_MEMORY.
+     */
+    if (uri_params != NULL)
+        memory_str = lsm_hash_string_get(uri_params, "memory");
+
+    if (memory_str == NULL)
+        memory_str = getenv(_DB_MEMORY_ENV);
+
+    if ((memory_str != NULL) && (strlen(memory_str) != 0))
+        _good(_db_mode_parse(err_msg, memory_str, &db_mode), rc, out);
+
+    if ((db_mode != _DB_MODE_MEMORY_VOLATILE) && !_file_exists(statefile)) {
         fd = open(statefile, O_WRONLY | O_CREAT, fd_mode);
         if (fd < 0) {
             rc = LSM_ERR_INVALID_ARGUMENT;
@@ -167,17 +202,44 @@ int plugin_register(lsm_plugin_ptr c, const char *uri, const char *password,
         close(fd);
     }
 
-    _good(_db_init(err_msg, &db, statefile, timeout), rc, out);
+    /* Use URI 'profile' parameter as latency and fault injection profile
+     * if defined, else use system environment LSM_SIM_PROFILE.
+     */
+    if (uri_params != NULL)
+        profile_path = lsm_hash_string_get(uri_params, "profile");
+
+    if (profile_path == NULL)
+        profile_path = getenv(_PROFILE_ENV);
 
-    pri_data =
-        (struct _simc_private_data *)malloc(sizeof(struct _simc_private_data));
+    if ((profile_path != NULL) && (strlen(profile_path) != 0))
+        _good(_profile_load(err_msg, profile_path, &profile), rc, out);
+
+    _good(_db_init(err_msg, &db, statefile, timeout,
+                   seed_wanted ? &seed : NULL, db_mode),
+          rc, out);
+
+    pri_data = (struct _simc_private_data *)calloc(
+        1, sizeof(struct _simc_private_data));
     _alloc_null_check(err_msg, pri_data, rc, out);
 
     pri_data->db = db;
     pri_data->timeout = timeout;
+    pri_data->profile = profile;
+    pri_data->db_mode = db_mode;
+    if (db_mode == _DB_MODE_MEMORY_SNAPSHOT) {
+        pri_data->statefile = strdup(statefile);
+        _alloc_null_check(err_msg, pri_data->statefile, rc, out);
+    }
 
-    rc = lsm_register_plugin_v1_3(c, pri_data, &mgm_ops, &san_ops, &fs_ops,
-                                  &nfs_ops, &ops_v1_2, &ops_v1_3);
+    /* With a profile, every callback goes through _profile_apply() first */
+    if (profile != NULL)
+        rc = lsm_register_plugin_v1_3(
+            c, pri_data, &_profile_mgm_ops, &_profile_san_ops,
+            &_profile_fs_ops, &_profile_nfs_ops, &_profile_ops_v1_2,
+            &_profile_ops_v1_3);
+    else
+        rc = lsm_register_plugin_v1_3(c, pri_data, &mgm_ops, &san_ops,
+                                      &fs_ops, &nfs_ops, &ops_v1_2, &ops_v1_3);
 
 out:
     free(scheme);
@@ -188,7 +250,13 @@ out:
         lsm_hash_free(uri_params);
 
     if (rc != LSM_ERR_OK) {
-        _db_close(db);
+        if (db != NULL)
+            _db_close(db);
+        _profile_free(profile);
+        if (pri_data != NULL) {
+            free(pri_data->statefile);
+            free(pri_data);
+        }
         lsm_log_error_basic(c, rc, err_msg);
     }
 
@@ -198,12 +266,25 @@ out:
 int plugin_unregister(lsm_plugin_ptr c, lsm_flag flags) {
     int rc = LSM_ERR_OK;
     struct _simc_private_data *pri_data = NULL;
+    char err_msg[_LSM_ERR_MSG_LEN];
 
     _UNUSED(flags);
+    _lsm_err_msg_clear(err_msg);
     if (c != NULL) {
         pri_data = lsm_private_data_get(c);
-        if ((pri_data != NULL) && (pri_data->db != NULL))
+        if ((pri_data != NULL) && (pri_data->db != NULL)) {
+            if (pri_data->db_mode == _DB_MODE_MEMORY_SNAPSHOT) {
+                rc = _db_snapshot_save(err_msg, pri_data->db,
+                                       pri_data->statefile, pri_data->timeout);
+                if (rc != LSM_ERR_OK)
+                    lsm_log_error_basic(c, rc, err_msg);
+            }
             _db_close(pri_data->db);
+        }
+        if (pri_data != NULL) {
+            _profile_free(pri_data->profile);
+            free(pri_data->statefile);
+        }
         free(pri_data);
     }
 
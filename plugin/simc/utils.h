@@ -32,6 +32,10 @@
 struct _simc_private_data {
     struct sqlite3 *db;
     uint32_t timeout;
+    struct _simc_profile *profile;
+    int db_mode;
+    char *statefile;
+    /* ^ Only used to save the snapshot of _DB_MODE_MEMORY_SNAPSHOT */
 };
 
 #define _UNUSED(x)        (void)(x)
@@ -118,7 +122,7 @@ struct _simc_private_data {
         _lsm_err_msg_clear(err_msg);                                           \
         _check_null_ptr(err_msg, 2 /* argument count */, array, count);        \
         _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);              \
-        _good(_db_sql_trans_begin(err_msg, db), rc, out);                      \
+        _good(_db_sql_trans_begin_read(err_msg, db), rc, out);                 \
         _good(_db_sql_exec(err_msg, db, "SELECT * from " table ";", &vec), rc, \
               out);                                                            \
         if (_vector_size(vec) == 0) {                                          \
@@ -143,6 +147,47 @@ struct _simc_private_data {
         }                                                                      \
         return rc;                                                             \
     }
+/*
+ * Like _xxx_list_func_gen(), but runs the cached prepared statement sql and
+ * converts each row with row_conv_func straight from sqlite3_column_*()
+ * instead of going through a lsm_hash per row.
+ */
+#define _xxx_stmt_list_func_gen(func_name, rc_type, row_conv_func,            \
+                                filter_func, sql, lsm_xxx_array_free_func)     \
+    int func_name(lsm_plugin_ptr c, const char *search_key,                    \
+                  const char *search_value, rc_type **array[],                 \
+                  uint32_t *count, lsm_flag flags) {                           \
+        int rc = LSM_ERR_OK;                                                   \
+        sqlite3 *db = NULL;                                                    \
+        sqlite3_stmt *stmt = NULL;                                             \
+        char err_msg[_LSM_ERR_MSG_LEN];                                        \
+        _UNUSED(flags);                                                        \
+        _lsm_err_msg_clear(err_msg);                                           \
+        _check_null_ptr(err_msg, 2 /* argument count */, array, count);        \
+        *array = NULL;                                                         \
+        *count = 0;                                                            \
+        _good(_get_db_from_plugin_ptr(err_msg, c, &db), rc, out);              \
+        _good(_db_sql_trans_begin_read(err_msg, db), rc, out);                 \
+        _good(_db_stmt_get(err_msg, db, sql, &stmt), rc, out);                 \
+        _good(_db_stmt_rows_to_array(err_msg, db, stmt, row_conv_func,         \
+                                     (void ***)array, count),                  \
+              rc, out);                                                        \
+    out:                                                                       \
+        _db_stmt_release(stmt);                                                \
+        _db_sql_trans_rollback(db);                                            \
+        if (rc != LSM_ERR_OK) {                                                \
+            if (*array != NULL) {                                              \
+                lsm_xxx_array_free_func(*array, *count);                       \
+                *array = NULL;                                                 \
+                *count = 0;                                                    \
+            }                                                                  \
+            lsm_log_error_basic(c, rc, err_msg);                               \
+        } else {                                                               \
+            filter_func(search_key, search_value, *array, count);              \
+        }                                                                      \
+        return rc;                                                             \
+    }
+
 int _get_db_from_plugin_ptr(char *err_msg, lsm_plugin_ptr c, sqlite3 **db);
 
 /*
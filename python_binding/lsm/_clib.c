@@ -62,7 +62,9 @@ static PyObject *func_name(PyObject *self, PyObject *args, PyObject *kwargs) \
     if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", (char **) kwlist, \
                                      &arg)) \
         return NULL; \
+    Py_BEGIN_ALLOW_THREADS \
     rc = c_func_name(arg, &c_rt, &lsm_err); \
+    Py_END_ALLOW_THREADS \
     err_no_obj = PyInt_FromLong(rc); \
     _alloc_check(err_no_obj, flag_no_mem, out); \
     rc_list = PyList_New(3 /* rc_obj, errno, err_str*/); \
@@ -114,7 +116,9 @@ static PyObject *func_name(PyObject *self, PyObject *args, PyObject *kwargs) \
     if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", (char **) kwlist, \
                                      &disk_path)) \
         return NULL; \
+    Py_BEGIN_ALLOW_THREADS \
     rc = c_func_name(arg, &lsm_err); \
+    Py_END_ALLOW_THREADS \
     err_no_obj = PyInt_FromLong(rc); \
     _alloc_check(err_no_obj, flag_no_mem, out); \
     rc_list = PyList_New(3 /* rc_obj, errno, err_str*/); \
@@ -145,6 +149,78 @@ static PyObject *func_name(PyObject *self, PyObject *args, PyObject *kwargs) \
     return rc_list; \
 }
 
+/*
+ * Query every disk path of the 'disk_paths' argument, a list of string,
+ * without holding the GIL, and return one [data, rc, err_msg] list per disk
+ * path in the same order.
+ */
+#define _bulk_wrapper(func_name, c_func_name, c_rt_type, c_rt_default, \
+                      py_rt_conv_func, c_rt_free_func) \
+static PyObject *func_name(PyObject *self, PyObject *args, PyObject *kwargs) \
+{ \
+    static const char *kwlist[] = {"disk_paths", NULL}; \
+    PyObject *disk_paths_obj = NULL; \
+    PyObject *disk_path_seq = NULL; \
+    const char **disk_paths = NULL; \
+    Py_ssize_t count = 0; \
+    Py_ssize_t i = 0; \
+    c_rt_type *c_rts = NULL; \
+    int *rcs = NULL; \
+    lsm_error **lsm_errs = NULL; \
+    PyObject *rc_list = NULL; \
+    PyObject *rc_obj = NULL; \
+    PyObject *item = NULL; \
+    bool flag_no_mem = false; \
+    _UNUSED(self); \
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char **) kwlist, \
+                                     &disk_paths_obj)) \
+        return NULL; \
+    disk_path_seq = _py_str_seq_parse(disk_paths_obj, "disk_paths", \
+                                      &disk_paths, &count); \
+    if (disk_path_seq == NULL) \
+        return NULL; \
+    c_rts = (c_rt_type *) calloc(count + 1, sizeof(c_rt_type)); \
+    _alloc_check(c_rts, flag_no_mem, out); \
+    rcs = (int *) calloc(count + 1, sizeof(int)); \
+    _alloc_check(rcs, flag_no_mem, out); \
+    lsm_errs = (lsm_error **) calloc(count + 1, sizeof(lsm_error *)); \
+    _alloc_check(lsm_errs, flag_no_mem, out); \
+    Py_BEGIN_ALLOW_THREADS \
+    for (i = 0; i < count; ++i) { \
+        c_rts[i] = c_rt_default; \
+        rcs[i] = c_func_name(disk_paths[i], &c_rts[i], &lsm_errs[i]); \
+    } \
+    Py_END_ALLOW_THREADS \
+    rc_list = PyList_New(count); \
+    _alloc_check(rc_list, flag_no_mem, out); \
+    for (i = 0; i < count; ++i) { \
+        rc_obj = py_rt_conv_func(c_rts[i]); \
+        _alloc_check(rc_obj, flag_no_mem, out); \
+        item = _result_new(rc_obj, rcs[i], lsm_errs[i]); \
+        lsm_errs[i] = NULL; \
+        _alloc_check(item, flag_no_mem, out); \
+        PyList_SET_ITEM(rc_list, i, item); \
+    } \
+ out: \
+    Py_DECREF(disk_path_seq); \
+    free(disk_paths); \
+    for (i = 0; (c_rts != NULL) && (i < count); ++i) { \
+        c_rt_free_func(c_rts[i]); \
+    } \
+    free(c_rts); \
+    free(rcs); \
+    for (i = 0; (lsm_errs != NULL) && (i < count); ++i) { \
+        if (lsm_errs[i] != NULL) \
+            lsm_error_free(lsm_errs[i]); \
+    } \
+    free(lsm_errs); \
+    if (flag_no_mem == true) { \
+        Py_XDECREF(rc_list); \
+        return PyErr_NoMemory(); \
+    } \
+    return rc_list; \
+}
+
 static const char local_disk_vpd83_search_docstring[] =
     "INTERNAL USE ONLY!\n"
     "\n"
@@ -164,6 +240,26 @@ static const char local_disk_vpd83_search_docstring[] =
     "        err_msg (string)\n"
     "            Error message, empty if no error.\n";
 
+static const char local_disk_vpd83_bulk_search_docstring[] =
+    "INTERNAL USE ONLY!\n"
+    "\n"
+    "Usage:\n"
+    "    Find out the /dev/sdX paths for each of the given SCSI VPD page 0x83\n"
+    "    NAA type IDs, querying every local disk only once.\n"
+    "Parameters:\n"
+    "    vpd83_list (list of string)\n"
+    "        The VPD83 NAA type IDs.\n"
+    "Returns:\n"
+    "    [disk_path_lists, rc, err_msg]\n"
+    "        disk_path_lists (list of list of string)\n"
+    "            One list of disk paths per VPD83 NAA type ID, in the same\n"
+    "            order as vpd83_list. Empty list is not found.\n"
+    "            The string format: '/dev/sd[a-z]+'.\n"
+    "        rc (integer)\n"
+    "            Error code, lsm.ErrorNumber.OK if no error\n"
+    "        err_msg (string)\n"
+    "            Error message, empty if no error.\n";
+
 static const char local_disk_serial_num_get_docstring[] =
     "INTERNAL USE ONLY!\n"
     "\n"
@@ -374,11 +470,112 @@ static const char local_disk_link_speed_get_docstring[] =
     "            Error message, empty if no error.\n";
 
 
+static const char local_disk_serial_num_bulk_get_docstring[] =
+    "INTERNAL USE ONLY!\n"
+    "\n"
+    "Usage:\n"
+    "    Query the SCSI VPD80 serial number of each given disk\n"
+    "    path, without holding the GIL.\n"
+    "Parameters:\n"
+    "    disk_paths (list of string)\n"
+    "        The disk paths, example ['/dev/sdb', '/dev/sdc'].\n"
+    "Returns:\n"
+    "    [[serial_num, rc, err_msg]]\n"
+    "        One list per disk path, in the same order as disk_paths, as\n"
+    "        returned by _local_disk_serial_num_get().\n";
+
+static const char local_disk_vpd83_bulk_get_docstring[] =
+    "INTERNAL USE ONLY!\n"
+    "\n"
+    "Usage:\n"
+    "    Query the SCSI VPD83 NAA ID of each given disk\n"
+    "    path, without holding the GIL.\n"
+    "Parameters:\n"
+    "    disk_paths (list of string)\n"
+    "        The disk paths, example ['/dev/sdb', '/dev/sdc'].\n"
+    "Returns:\n"
+    "    [[vpd83, rc, err_msg]]\n"
+    "        One list per disk path, in the same order as disk_paths, as\n"
+    "        returned by _local_disk_vpd83_get().\n";
+
+static const char local_disk_health_status_bulk_get_docstring[] =
+    "INTERNAL USE ONLY!\n"
+    "\n"
+    "Usage:\n"
+    "    Query the health status of each given disk\n"
+    "    path, without holding the GIL.\n"
+    "Parameters:\n"
+    "    disk_paths (list of string)\n"
+    "        The disk paths, example ['/dev/sdb', '/dev/sdc'].\n"
+    "Returns:\n"
+    "    [[health_status, rc, err_msg]]\n"
+    "        One list per disk path, in the same order as disk_paths, as\n"
+    "        returned by _local_disk_health_status_get().\n";
+
+static const char local_disk_rpm_bulk_get_docstring[] =
+    "INTERNAL USE ONLY!\n"
+    "\n"
+    "Usage:\n"
+    "    Query the rotation speed of each given disk\n"
+    "    path, without holding the GIL.\n"
+    "Parameters:\n"
+    "    disk_paths (list of string)\n"
+    "        The disk paths, example ['/dev/sdb', '/dev/sdc'].\n"
+    "Returns:\n"
+    "    [[rpm, rc, err_msg]]\n"
+    "        One list per disk path, in the same order as disk_paths, as\n"
+    "        returned by _local_disk_rpm_get().\n";
+
+static const char local_disk_link_type_bulk_get_docstring[] =
+    "INTERNAL USE ONLY!\n"
+    "\n"
+    "Usage:\n"
+    "    Query the link type of each given disk\n"
+    "    path, without holding the GIL.\n"
+    "Parameters:\n"
+    "    disk_paths (list of string)\n"
+    "        The disk paths, example ['/dev/sdb', '/dev/sdc'].\n"
+    "Returns:\n"
+    "    [[link_type, rc, err_msg]]\n"
+    "        One list per disk path, in the same order as disk_paths, as\n"
+    "        returned by _local_disk_link_type_get().\n";
+
+static const char local_disk_led_status_bulk_get_docstring[] =
+    "INTERNAL USE ONLY!\n"
+    "\n"
+    "Usage:\n"
+    "    Query the LED status of each given disk\n"
+    "    path, without holding the GIL.\n"
+    "Parameters:\n"
+    "    disk_paths (list of string)\n"
+    "        The disk paths, example ['/dev/sdb', '/dev/sdc'].\n"
+    "Returns:\n"
+    "    [[led_status, rc, err_msg]]\n"
+    "        One list per disk path, in the same order as disk_paths, as\n"
+    "        returned by _local_disk_led_status_get().\n";
+
+static const char local_disk_link_speed_bulk_get_docstring[] =
+    "INTERNAL USE ONLY!\n"
+    "\n"
+    "Usage:\n"
+    "    Query the link speed of each given disk\n"
+    "    path, without holding the GIL.\n"
+    "Parameters:\n"
+    "    disk_paths (list of string)\n"
+    "        The disk paths, example ['/dev/sdb', '/dev/sdc'].\n"
+    "Returns:\n"
+    "    [[link_speed, rc, err_msg]]\n"
+    "        One list per disk path, in the same order as disk_paths, as\n"
+    "        returned by _local_disk_link_speed_get().\n";
+
+
 static PyObject *local_disk_serial_num_get(PyObject *self, PyObject *args,
                                            PyObject *kwargs);
 
 static PyObject *local_disk_vpd83_search(PyObject *self, PyObject *args,
                                          PyObject *kwargs);
+static PyObject *local_disk_vpd83_bulk_search(PyObject *self, PyObject *args,
+                                              PyObject *kwargs);
 static PyObject *local_disk_vpd83_get(PyObject *self, PyObject *args,
                                       PyObject *kwargs);
 static PyObject *local_disk_health_status_get(PyObject *self, PyObject *args,
@@ -392,9 +589,27 @@ static PyObject *local_disk_link_type_get(PyObject *self, PyObject *args,
 static PyObject *local_disk_link_speed_get(PyObject *self, PyObject *args,
                                            PyObject *kwargs);
 static PyObject *_lsm_string_list_to_pylist(lsm_string_list *str_list);
+static PyObject *_py_str_seq_parse(PyObject *seq_obj, const char *arg_name,
+                                   const char ***strs, Py_ssize_t *count);
+static PyObject *_result_new(PyObject *rc_obj, int rc, lsm_error *lsm_err);
 static PyObject *_c_str_to_py_str(const char *str);
 static PyObject *local_disk_led_status_get(PyObject *self, PyObject *args,
                                            PyObject *kwargs);
+static PyObject *local_disk_serial_num_bulk_get(PyObject *self, PyObject *args,
+                                                PyObject *kwargs);
+static PyObject *local_disk_vpd83_bulk_get(PyObject *self, PyObject *args,
+                                           PyObject *kwargs);
+static PyObject *local_disk_health_status_bulk_get(PyObject *self,
+                                                   PyObject *args,
+                                                   PyObject *kwargs);
+static PyObject *local_disk_rpm_bulk_get(PyObject *self, PyObject *args,
+                                         PyObject *kwargs);
+static PyObject *local_disk_link_type_bulk_get(PyObject *self, PyObject *args,
+                                               PyObject *kwargs);
+static PyObject *local_disk_led_status_bulk_get(PyObject *self, PyObject *args,
+                                                PyObject *kwargs);
+static PyObject *local_disk_link_speed_bulk_get(PyObject *self, PyObject *args,
+                                                PyObject *kwargs);
 
 _wrapper_no_output(local_disk_ident_led_on, lsm_local_disk_ident_led_on,
                    const char *, disk_path);
@@ -410,6 +625,9 @@ static PyMethodDef _methods[] = {
      METH_VARARGS | METH_KEYWORDS, local_disk_serial_num_get_docstring},
     {"_local_disk_vpd83_search",  (PyCFunction) local_disk_vpd83_search,
      METH_VARARGS | METH_KEYWORDS, local_disk_vpd83_search_docstring},
+    {"_local_disk_vpd83_bulk_search",
+     (PyCFunction) local_disk_vpd83_bulk_search,
+     METH_VARARGS | METH_KEYWORDS, local_disk_vpd83_bulk_search_docstring},
     {"_local_disk_vpd83_get",  (PyCFunction) local_disk_vpd83_get,
      METH_VARARGS | METH_KEYWORDS, local_disk_vpd83_get_docstring},
     {"_local_disk_health_status_get",  (PyCFunction) local_disk_health_status_get,
@@ -432,6 +650,27 @@ static PyMethodDef _methods[] = {
      METH_VARARGS | METH_KEYWORDS, local_disk_led_status_get_docstring},
     {"_local_disk_link_speed_get",  (PyCFunction) local_disk_link_speed_get,
      METH_VARARGS | METH_KEYWORDS, local_disk_link_speed_get_docstring},
+    {"_local_disk_serial_num_bulk_get",
+     (PyCFunction) local_disk_serial_num_bulk_get,
+     METH_VARARGS | METH_KEYWORDS, local_disk_serial_num_bulk_get_docstring},
+    {"_local_disk_vpd83_bulk_get",
+     (PyCFunction) local_disk_vpd83_bulk_get,
+     METH_VARARGS | METH_KEYWORDS, local_disk_vpd83_bulk_get_docstring},
+    {"_local_disk_health_status_bulk_get",
+     (PyCFunction) local_disk_health_status_bulk_get,
+     METH_VARARGS | METH_KEYWORDS, local_disk_health_status_bulk_get_docstring},
+    {"_local_disk_rpm_bulk_get",
+     (PyCFunction) local_disk_rpm_bulk_get,
+     METH_VARARGS | METH_KEYWORDS, local_disk_rpm_bulk_get_docstring},
+    {"_local_disk_link_type_bulk_get",
+     (PyCFunction) local_disk_link_type_bulk_get,
+     METH_VARARGS | METH_KEYWORDS, local_disk_link_type_bulk_get_docstring},
+    {"_local_disk_led_status_bulk_get",
+     (PyCFunction) local_disk_led_status_bulk_get,
+     METH_VARARGS | METH_KEYWORDS, local_disk_led_status_bulk_get_docstring},
+    {"_local_disk_link_speed_bulk_get",
+     (PyCFunction) local_disk_link_speed_bulk_get,
+     METH_VARARGS | METH_KEYWORDS, local_disk_link_speed_bulk_get_docstring},
     {NULL, NULL, 0, NULL}        /* Sentinel */
 };
 
@@ -464,6 +703,80 @@ static PyObject *_c_str_to_py_str(const char *str)
     return PyUnicode_FromString(str);
 }
 
+/*
+ * Return a new reference holding the strings of 'strs' alive, or NULL with
+ * Python exception set. Memory of 'strs' should be freed by free().
+ * The strings are kept alive by a tuple copy of 'seq_obj' rather than by
+ * 'seq_obj' itself, which other threads could change while the GIL is
+ * released, as PySequence_Fast() returns a list unchanged.
+ */
+static PyObject *_py_str_seq_parse(PyObject *seq_obj, const char *arg_name,
+                                   const char ***strs, Py_ssize_t *count)
+{
+    PyObject *seq = NULL;
+    Py_ssize_t i = 0;
+
+    *strs = NULL;
+    *count = 0;
+
+    seq = PySequence_Tuple(seq_obj);
+    if (seq == NULL) {
+        /* Same error as PySequence_Fast() */
+        if (PyErr_ExceptionMatches(PyExc_TypeError))
+            PyErr_SetString(PyExc_TypeError, arg_name);
+        return NULL;
+    }
+
+    *count = PyTuple_GET_SIZE(seq);
+    *strs = (const char **) calloc(*count + 1, sizeof(char *));
+    if (*strs == NULL) {
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (i = 0; i < *count; ++i) {
+        if (!PyArg_Parse(PyTuple_GET_ITEM(seq, i), "s", &(*strs)[i])) {
+            Py_DECREF(seq);
+            free(*strs);
+            *strs = NULL;
+            return NULL;
+        }
+    }
+    return seq;
+}
+
+/*
+ * Return [rc_obj, rc, err_msg] or NULL if no memory. Steal the reference of
+ * 'rc_obj' and free 'lsm_err' in any case.
+ */
+static PyObject *_result_new(PyObject *rc_obj, int rc, lsm_error *lsm_err)
+{
+    PyObject *rc_list = NULL;
+    PyObject *err_no_obj = NULL;
+    PyObject *err_msg_obj = NULL;
+
+    err_no_obj = PyInt_FromLong(rc);
+    if (rc != LSM_ERR_OK)
+        err_msg_obj = PyUnicode_FromString(lsm_error_message_get(lsm_err));
+    else
+        err_msg_obj = PyUnicode_FromString("");
+    rc_list = PyList_New(3 /* rc_obj, errno, err_str*/);
+    if (lsm_err != NULL)
+        lsm_error_free(lsm_err);
+
+    if ((err_no_obj == NULL) || (err_msg_obj == NULL) || (rc_list == NULL)) {
+        Py_XDECREF(rc_list);
+        Py_XDECREF(err_no_obj);
+        Py_XDECREF(err_msg_obj);
+        Py_XDECREF(rc_obj);
+        return NULL;
+    }
+    PyList_SET_ITEM(rc_list, 0, rc_obj);
+    PyList_SET_ITEM(rc_list, 1, err_no_obj);
+    PyList_SET_ITEM(rc_list, 2, err_msg_obj);
+    return rc_list;
+}
+
 _wrapper(local_disk_serial_num_get, lsm_local_disk_serial_num_get,
          const char *, disk_path, char *, NULL,
          _c_str_to_py_str, free);
@@ -489,6 +802,27 @@ _wrapper(local_disk_link_speed_get, lsm_local_disk_link_speed_get,
          const char *, disk_path, uint32_t, LSM_DISK_LINK_SPEED_UNKNOWN,
          PyInt_FromLong, _NO_NEED_TO_FREE);
 
+_bulk_wrapper(local_disk_serial_num_bulk_get, lsm_local_disk_serial_num_get,
+              char *, NULL, _c_str_to_py_str, free);
+_bulk_wrapper(local_disk_vpd83_bulk_get, lsm_local_disk_vpd83_get,
+              char *, NULL, _c_str_to_py_str, free);
+_bulk_wrapper(local_disk_health_status_bulk_get,
+              lsm_local_disk_health_status_get, int32_t,
+              LSM_DISK_HEALTH_STATUS_UNKNOWN, PyInt_FromLong,
+              _NO_NEED_TO_FREE);
+_bulk_wrapper(local_disk_rpm_bulk_get, lsm_local_disk_rpm_get,
+              int32_t, LSM_DISK_RPM_UNKNOWN, PyInt_FromLong,
+              _NO_NEED_TO_FREE);
+_bulk_wrapper(local_disk_link_type_bulk_get, lsm_local_disk_link_type_get,
+              lsm_disk_link_type, LSM_DISK_LINK_TYPE_UNKNOWN, PyInt_FromLong,
+              _NO_NEED_TO_FREE);
+_bulk_wrapper(local_disk_led_status_bulk_get, lsm_local_disk_led_status_get,
+              uint32_t, LSM_DISK_LED_STATUS_UNKNOWN, PyInt_FromLong,
+              _NO_NEED_TO_FREE);
+_bulk_wrapper(local_disk_link_speed_bulk_get, lsm_local_disk_link_speed_get,
+              uint32_t, LSM_DISK_LINK_SPEED_UNKNOWN, PyInt_FromLong,
+              _NO_NEED_TO_FREE);
+
 static PyObject *local_disk_list(PyObject *self, PyObject *args,
                                  PyObject *kwargs)
 {
@@ -504,7 +838,9 @@ static PyObject *local_disk_list(PyObject *self, PyObject *args,
     _UNUSED(self);
     _UNUSED(args);
     _UNUSED(kwargs);
+    Py_BEGIN_ALLOW_THREADS
     rc = lsm_local_disk_list(&disk_paths, &lsm_err);
+    Py_END_ALLOW_THREADS
     err_no_obj = PyInt_FromLong(rc);
     _alloc_check(err_no_obj, flag_no_mem, out);
     rc_list = PyList_New(3 /* rc_obj, errno, err_str*/);
@@ -539,6 +875,101 @@ static PyObject *local_disk_list(PyObject *self, PyObject *args,
     return rc_list;
 }
 
+static PyObject *local_disk_vpd83_bulk_search(PyObject *self, PyObject *args,
+                                              PyObject *kwargs)
+{
+    static const char *kwlist[] = {"vpd83_list", NULL};
+    PyObject *vpd83_list_obj = NULL;
+    PyObject *vpd83_seq = NULL;
+    lsm_string_list *vpd83_list = NULL;
+    lsm_string_list **disk_path_lists = NULL;
+    const char *vpd83 = NULL;
+    uint32_t count = 0;
+    uint32_t i = 0;
+    lsm_error *lsm_err = NULL;
+    int rc = LSM_ERR_OK;
+    PyObject *rc_list = NULL;
+    PyObject *rc_obj = NULL;
+    PyObject *path_list_obj = NULL;
+    PyObject *err_msg_obj = NULL;
+    PyObject *err_no_obj = NULL;
+    bool flag_no_mem = false;
+
+    _UNUSED(self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char **) kwlist,
+                                     &vpd83_list_obj))
+        return NULL;
+
+    vpd83_seq = PySequence_Fast(vpd83_list_obj,
+                                "vpd83_list should be a list of string");
+    if (vpd83_seq == NULL)
+        return NULL;
+
+    count = (uint32_t) PySequence_Fast_GET_SIZE(vpd83_seq);
+    vpd83_list = lsm_string_list_alloc(0 /* no pre-allocation */);
+    _alloc_check(vpd83_list, flag_no_mem, out);
+    for (i = 0; i < count; ++i) {
+        if (!PyArg_Parse(PySequence_Fast_GET_ITEM(vpd83_seq, i), "s",
+                         &vpd83)) {
+            Py_DECREF(vpd83_seq);
+            lsm_string_list_free(vpd83_list);
+            return NULL;
+        }
+        if (lsm_string_list_append(vpd83_list, vpd83) != 0) {
+            flag_no_mem = true;
+            goto out;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    rc = lsm_local_disk_vpd83_bulk_search(vpd83_list, &disk_path_lists,
+                                          &lsm_err);
+    Py_END_ALLOW_THREADS
+    err_no_obj = PyInt_FromLong(rc);
+    _alloc_check(err_no_obj, flag_no_mem, out);
+    rc_list = PyList_New(3 /* rc_obj, errno, err_str*/);
+    _alloc_check(rc_list, flag_no_mem, out);
+    rc_obj = PyList_New(rc == LSM_ERR_OK ? count : 0);
+    _alloc_check(rc_obj, flag_no_mem, out);
+    if (rc != LSM_ERR_OK) {
+        err_msg_obj = PyUnicode_FromString(lsm_error_message_get(lsm_err));
+        lsm_error_free(lsm_err);
+        lsm_err = NULL;
+        _alloc_check(err_msg_obj, flag_no_mem, out);
+        goto out;
+    }
+    for (i = 0; i < count; ++i) {
+        path_list_obj = _lsm_string_list_to_pylist(disk_path_lists[i]);
+        _alloc_check(path_list_obj, flag_no_mem, out);
+        PyList_SET_ITEM(rc_obj, i, path_list_obj);
+    }
+    err_msg_obj = PyUnicode_FromString("");
+    _alloc_check(err_msg_obj, flag_no_mem, out);
+
+ out:
+    Py_DECREF(vpd83_seq);
+    if (lsm_err != NULL)
+        lsm_error_free(lsm_err);
+    if (vpd83_list != NULL)
+        lsm_string_list_free(vpd83_list);
+    if (disk_path_lists != NULL) {
+        for (i = 0; i < count; ++i)
+            lsm_string_list_free(disk_path_lists[i]);
+        free(disk_path_lists);
+    }
+    if (flag_no_mem == true) {
+        Py_XDECREF(rc_list);
+        Py_XDECREF(err_no_obj);
+        Py_XDECREF(err_msg_obj);
+        Py_XDECREF(rc_obj);
+        return PyErr_NoMemory();
+    }
+    PyList_SET_ITEM(rc_list, 0, rc_obj);
+    PyList_SET_ITEM(rc_list, 1, err_no_obj);
+    PyList_SET_ITEM(rc_list, 2, err_msg_obj);
+    return rc_list;
+}
+
 #if PY_MAJOR_VERSION >= 3
     #define MOD_DEF(name, methods) \
         static struct PyModuleDef moduledef = { \
@@ -14,6 +14,7 @@
 #
 # Author: tasleson
 import os
+import stat
 import sys
 from lsm import (Volume, NfsExport, Capabilities, Pool, System, Battery,
                  Disk, AccessGroup, FileSystem, FsSnapshot,
@@ -118,6 +119,24 @@ def _check_daemon_exists():
             pass
         return False
 
+    # lsmd caches the plug-in description and version next to each socket,
+    # only valid when at least as new as the socket itself.
+    # @param    uds     Plug-in socket path
+    # @returns (desc, version) or None when not cached.
+    @staticmethod
+    def _plugin_info_cached(uds):
+        info_file = uds + '.info'
+        try:
+            if os.stat(info_file).st_mtime_ns < os.stat(uds).st_mtime_ns:
+                return None
+            with open(info_file) as f:
+                lines = f.read().split('\n')
+            if len(lines) >= 2:
+                return lines[0], lines[1]
+        except (OSError, IOError, AttributeError):
+            pass
+        return None
+
     @staticmethod
     def _plugin_uds_path():
         rc = _UDS_PATH
@@ -202,13 +221,32 @@ def available_plugins(field_sep=':', flags=FLAG_RSVD):
             _raise_no_daemon()
 
         uds_path = Client._plugin_uds_path()
+        pending = []
 
-        for root, sub_folders, files in os.walk(uds_path):
-            for filename in files:
-                uds = os.path.join(root, filename)
-                tp = _TransPort(_TransPort.get_socket(uds))
-                i, v = tp.rpc('plugin_info', dict(flags=flags))
+        try:
+            for root, sub_folders, files in os.walk(uds_path):
+                for filename in files:
+                    uds = os.path.join(root, filename)
+                    if not stat.S_ISSOCK(os.lstat(uds).st_mode):
+                        continue
+
+                    cached = Client._plugin_info_cached(uds)
+                    if cached:
+                        rc.append("%s%s%s" %
+                                  (cached[0], field_sep, cached[1]))
+                        continue
+
+                    # Ask every plug-in first and collect the answers after,
+                    # so the plug-ins start up in parallel.
+                    tp = _TransPort(_TransPort.get_socket(uds))
+                    pending.append(tp)
+                    tp.send_req('plugin_info', dict(flags=flags))
+
+            for tp in pending:
+                i, v = tp.read_resp()[0]
                 rc.append("%s%s%s" % (i, field_sep, v))
+        finally:
+            for tp in pending:
                 tp.close()
 
         return rc
@@ -294,6 +332,28 @@ def plugin_info(self, flags=FLAG_RSVD):
         """
         return self._tp.rpc('plugin_info', _del_self(locals()))
 
+    # Gets per method statistics kept by the plug-in runtime
+    # @param    self    The this pointer
+    # @param    flags   Reserved for future use
+    # @returns  List of dict, one per method called on the plug-in
+    @_return_requires([dict])
+    def plugin_stats(self, flags=FLAG_RSVD):
+        """
+        Returns the statistics the plug-in process keeps for each method it
+        has been called for since it was started, as a list of dict with
+        keys:
+            method      Method name
+            calls       Number of calls
+            errors      Number of calls which returned an error
+            bytes_in    Request bytes received
+            bytes_out   Reply bytes sent
+            total_us    Total time spent, in microseconds
+            max_us      Longest call, in microseconds
+            histogram   List of call counts, entry i counts calls which took
+                        [2^i, 2^(i+1)) microseconds
+        """
+        return self._tp.rpc('plugin_stats', _del_self(locals()))
+
     # Returns an array of pool objects.
     # @param    self            The this pointer
     # @param    search_key      Search key
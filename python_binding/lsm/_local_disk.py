@@ -20,12 +20,20 @@
 from lsm import LsmError, ErrorNumber
 
 from lsm._clib import (_local_disk_vpd83_search, _local_disk_vpd83_get,
+                       _local_disk_vpd83_bulk_search,
                        _local_disk_health_status_get,
                        _local_disk_rpm_get, _local_disk_list,
                        _local_disk_link_type_get, _local_disk_ident_led_on,
                        _local_disk_ident_led_off, _local_disk_fault_led_on,
                        _local_disk_fault_led_off, _local_disk_serial_num_get,
-                       _local_disk_led_status_get, _local_disk_link_speed_get)
+                       _local_disk_led_status_get, _local_disk_link_speed_get,
+                       _local_disk_serial_num_bulk_get,
+                       _local_disk_vpd83_bulk_get,
+                       _local_disk_health_status_bulk_get,
+                       _local_disk_rpm_bulk_get,
+                       _local_disk_link_type_bulk_get,
+                       _local_disk_led_status_bulk_get,
+                       _local_disk_link_speed_bulk_get)
 
 
 def _use_c_lib_function(func_ref, arg):
@@ -35,6 +43,17 @@ def _use_c_lib_function(func_ref, arg):
     return data
 
 
+def _use_c_lib_bulk_function(func_ref, disk_paths):
+    disk_paths = list(disk_paths)
+    rc = {}
+    for disk_path, (data, err_no, err_msg) in zip(disk_paths,
+                                                  func_ref(disk_paths)):
+        if err_no != ErrorNumber.OK:
+            data = LsmError(err_no, err_msg)
+        rc[disk_path] = data
+    return rc
+
+
 class LocalDisk(object):
 
     @staticmethod
@@ -66,6 +85,42 @@ def vpd83_search(vpd83):
         """
         return _use_c_lib_function(_local_disk_vpd83_search, vpd83)
 
+    @staticmethod
+    def vpd83_bulk_search(vpd83_list):
+        """
+        lsm.LocalDisk.vpd83_bulk_search(vpd83_list)
+
+        Version:
+            1.9
+        Usage:
+            Find out the disk paths for each of the given SCSI VPD page 0x83
+            NAA type IDs. Unlike calling lsm.LocalDisk.vpd83_search() for
+            each of them, every local disk is only queried once, which
+            should be preferred when mapping many volumes to disk paths.
+        Parameters:
+            vpd83_list (list of string)
+                The VPD83 NAA type IDs.
+        Returns:
+            {vpd83: [disk_path]}
+                Dictionary keyed by every given VPD83 NAA type ID, with the
+                list of its disk paths as value. Empty list if no disk
+                found. The disk_path string format is '/dev/sd[a-z]+' for
+                SCSI and ATA disks.
+        SpecialExceptions:
+            LsmError
+                ErrorNumber.LIB_BUG
+                    Internal bug.
+                ErrorNumber.INVALID_ARGUMENT
+                    Any of the VPD83 NAA type IDs is too long.
+        Capability:
+            N/A
+                No capability required as this is a library level method.
+        """
+        vpd83_list = list(vpd83_list)
+        disk_path_lists = _use_c_lib_function(_local_disk_vpd83_bulk_search,
+                                              vpd83_list)
+        return dict(zip(vpd83_list, disk_path_lists))
+
     @staticmethod
     def serial_num_get(disk_path):
         """
@@ -493,3 +548,199 @@ def link_speed_get(disk_path):
                 No capability required as this is a library level method.
         """
         return _use_c_lib_function(_local_disk_link_speed_get, disk_path)
+
+    @staticmethod
+    def serial_num_bulk_get(disk_paths):
+        """
+        lsm.LocalDisk.serial_num_bulk_get(disk_paths)
+
+        Version:
+            1.9
+        Usage:
+            Query the SCSI VPD80 serial number of each given disk path, as
+            lsm.LocalDisk.serial_num_get() does, in a single call into the
+            C library which does not hold the Python GIL meanwhile.
+        Parameters:
+            disk_paths (list of string)
+                The disk paths, example ['/dev/sdb', '/dev/sdc'].
+        Returns:
+            {disk_path: serial_num}
+                Dictionary keyed by every given disk path, with the value
+                lsm.LocalDisk.serial_num_get() would return, or the LsmError
+                it would raise for that disk.
+        SpecialExceptions:
+            N/A
+        Capability:
+            N/A
+                No capability required as this is a library level method.
+        """
+        return _use_c_lib_bulk_function(_local_disk_serial_num_bulk_get,
+                                        disk_paths)
+
+    @staticmethod
+    def vpd83_bulk_get(disk_paths):
+        """
+        lsm.LocalDisk.vpd83_bulk_get(disk_paths)
+
+        Version:
+            1.9
+        Usage:
+            Query the SCSI VPD83 NAA ID of each given disk path, as
+            lsm.LocalDisk.vpd83_get() does, in a single call into the
+            C library which does not hold the Python GIL meanwhile.
+        Parameters:
+            disk_paths (list of string)
+                The disk paths, example ['/dev/sdb', '/dev/sdc'].
+        Returns:
+            {disk_path: vpd83}
+                Dictionary keyed by every given disk path, with the value
+                lsm.LocalDisk.vpd83_get() would return, or the LsmError
+                it would raise for that disk.
+        SpecialExceptions:
+            N/A
+        Capability:
+            N/A
+                No capability required as this is a library level method.
+        """
+        return _use_c_lib_bulk_function(_local_disk_vpd83_bulk_get,
+                                        disk_paths)
+
+    @staticmethod
+    def health_status_bulk_get(disk_paths):
+        """
+        lsm.LocalDisk.health_status_bulk_get(disk_paths)
+
+        Version:
+            1.9
+        Usage:
+            Query the health status of each given disk path, as
+            lsm.LocalDisk.health_status_get() does, in a single call into the
+            C library which does not hold the Python GIL meanwhile.
+        Parameters:
+            disk_paths (list of string)
+                The disk paths, example ['/dev/sdb', '/dev/sdc'].
+        Returns:
+            {disk_path: health_status}
+                Dictionary keyed by every given disk path, with the value
+                lsm.LocalDisk.health_status_get() would return, or the LsmError
+                it would raise for that disk.
+        SpecialExceptions:
+            N/A
+        Capability:
+            N/A
+                No capability required as this is a library level method.
+        """
+        return _use_c_lib_bulk_function(_local_disk_health_status_bulk_get,
+                                        disk_paths)
+
+    @staticmethod
+    def rpm_bulk_get(disk_paths):
+        """
+        lsm.LocalDisk.rpm_bulk_get(disk_paths)
+
+        Version:
+            1.9
+        Usage:
+            Query the rotation speed of each given disk path, as
+            lsm.LocalDisk.rpm_get() does, in a single call into the
+            C library which does not hold the Python GIL meanwhile.
+        Parameters:
+            disk_paths (list of string)
+                The disk paths, example ['/dev/sdb', '/dev/sdc'].
+        Returns:
+            {disk_path: rpm}
+                Dictionary keyed by every given disk path, with the value
+                lsm.LocalDisk.rpm_get() would return, or the LsmError
+                it would raise for that disk.
+        SpecialExceptions:
+            N/A
+        Capability:
+            N/A
+                No capability required as this is a library level method.
+        """
+        return _use_c_lib_bulk_function(_local_disk_rpm_bulk_get,
+                                        disk_paths)
+
+    @staticmethod
+    def link_type_bulk_get(disk_paths):
+        """
+        lsm.LocalDisk.link_type_bulk_get(disk_paths)
+
+        Version:
+            1.9
+        Usage:
+            Query the link type of each given disk path, as
+            lsm.LocalDisk.link_type_get() does, in a single call into the
+            C library which does not hold the Python GIL meanwhile.
+        Parameters:
+            disk_paths (list of string)
+                The disk paths, example ['/dev/sdb', '/dev/sdc'].
+        Returns:
+            {disk_path: link_type}
+                Dictionary keyed by every given disk path, with the value
+                lsm.LocalDisk.link_type_get() would return, or the LsmError
+                it would raise for that disk.
+        SpecialExceptions:
+            N/A
+        Capability:
+            N/A
+                No capability required as this is a library level method.
+        """
+        return _use_c_lib_bulk_function(_local_disk_link_type_bulk_get,
+                                        disk_paths)
+
+    @staticmethod
+    def led_status_bulk_get(disk_paths):
+        """
+        lsm.LocalDisk.led_status_bulk_get(disk_paths)
+
+        Version:
+            1.9
+        Usage:
+            Query the LED status of each given disk path, as
+            lsm.LocalDisk.led_status_get() does, in a single call into the
+            C library which does not hold the Python GIL meanwhile.
+        Parameters:
+            disk_paths (list of string)
+                The disk paths, example ['/dev/sdb', '/dev/sdc'].
+        Returns:
+            {disk_path: led_status}
+                Dictionary keyed by every given disk path, with the value
+                lsm.LocalDisk.led_status_get() would return, or the LsmError
+                it would raise for that disk.
+        SpecialExceptions:
+            N/A
+        Capability:
+            N/A
+                No capability required as this is a library level method.
+        """
+        return _use_c_lib_bulk_function(_local_disk_led_status_bulk_get,
+                                        disk_paths)
+
+    @staticmethod
+    def link_speed_bulk_get(disk_paths):
+        """
+        lsm.LocalDisk.link_speed_bulk_get(disk_paths)
+
+        Version:
+            1.9
+        Usage:
+            Query the link speed of each given disk path, as
+            lsm.LocalDisk.link_speed_get() does, in a single call into the
+            C library which does not hold the Python GIL meanwhile.
+        Parameters:
+            disk_paths (list of string)
+                The disk paths, example ['/dev/sdb', '/dev/sdc'].
+        Returns:
+            {disk_path: link_speed}
+                Dictionary keyed by every given disk path, with the value
+                lsm.LocalDisk.link_speed_get() would return, or the LsmError
+                it would raise for that disk.
+        SpecialExceptions:
+            N/A
+        Capability:
+            N/A
+                No capability required as this is a library level method.
+        """
+        return _use_c_lib_bulk_function(_local_disk_link_speed_bulk_get,
+                                        disk_paths)
@@ -17,6 +17,7 @@
 import errno
 import socket
 import sys
+import time
 import traceback
 from typing import List
 
@@ -26,6 +27,7 @@
 from lsm import LsmError, error, ErrorNumber
 from lsm._common import SocketEOF as _SocketEOF
 from lsm._transport import TransPort
+from lsm import _trace
 
 
 def search_property(lsm_objs: List, search_key: str, search_value) -> List:
@@ -47,6 +49,10 @@ class PluginRunner(object):
     work.
     """
 
+    # Number of latency histogram buckets, bucket i counts calls which took
+    # [2^i, 2^(i+1)) microseconds, same as the C plug-in runtime.
+    STATS_BUCKETS = 32
+
     @staticmethod
     def _is_number(val):
         """
@@ -86,6 +92,36 @@ def __init__(self, plugin, args):
             self.cmdline = True
             cmd_line_wrapper(plugin)
 
+        self.stats = {}
+
+    def _stats_record(self, method, ok, start, bytes_in, bytes_out):
+        """
+        Account one call of method for the plugin_stats RPC.
+        """
+        us = int((time.monotonic() - start) * 1000000)
+        bucket = min(max(us, 1).bit_length() - 1, self.STATS_BUCKETS - 1)
+
+        if method not in self.stats:
+            self.stats[method] = dict(
+                method=method, calls=0, errors=0, bytes_in=0, bytes_out=0,
+                total_us=0, max_us=0, histogram=[0] * self.STATS_BUCKETS)
+
+        m = self.stats[method]
+        m['calls'] += 1
+        if not ok:
+            m['errors'] += 1
+        m['bytes_in'] += bytes_in
+        m['bytes_out'] += bytes_out
+        m['total_us'] += us
+        m['max_us'] = max(m['max_us'], us)
+        m['histogram'][bucket] += 1
+
+    def plugin_stats(self, flags=0):
+        """
+        Per method accounting, answered by the runner for every plug-in.
+        """
+        return [self.stats[k] for k in sorted(self.stats)]
+
     def run(self):
         # Don't need to invoke this when running stand alone as a cmdline
         if self.cmdline:
@@ -96,28 +132,44 @@ def run(self):
 
         try:
             while True:
+                method = None
+                ok = False
+                start = None
+                rx = self.tp.rx_bytes
+                tx = self.tp.tx_bytes
+
                 try:
                     # result = None
 
                     msg = self.tp.read_req()
+                    start = time.monotonic()
 
                     method = msg['method']
                     msg_id = msg['id']
                     params = msg['params']
+                    trace_id = msg.get('trace_id')
 
                     # Check to see if this plug-in implements this operation
                     # if not return the expected error.
-                    if hasattr(self.plugin, method):
-                        if params is None:
-                            result = getattr(self.plugin, method)()
+                    with _trace.Span('dispatch ' + method, trace_id):
+                        if trace_id and _trace.enabled():
+                            _trace.flow(trace_id, False)
+
+                        if method == 'plugin_stats':
+                            result = self.plugin_stats(**(params or {}))
+                        elif hasattr(self.plugin, method):
+                            if params is None:
+                                result = getattr(self.plugin, method)()
+                            else:
+                                result = getattr(self.plugin, method)(
+                                    **msg['params'])
                         else:
-                            result = getattr(self.plugin, method)(
-                                **msg['params'])
-                    else:
-                        raise LsmError(ErrorNumber.NO_SUPPORT,
-                                       "Unsupported operation")
+                            raise LsmError(ErrorNumber.NO_SUPPORT,
+                                           "Unsupported operation")
 
-                    self.tp.send_resp(result)
+                    with _trace.Span('reply ' + method, trace_id):
+                        self.tp.send_resp(result)
+                    ok = True
 
                     if method == 'plugin_register':
                         need_shutdown = True
@@ -137,6 +189,11 @@ def run(self):
                 except LsmError as lsm_err:
                     self.tp.send_error(msg_id, lsm_err.code, lsm_err.msg,
                                        lsm_err.data)
+                finally:
+                    if method is not None:
+                        self._stats_record(method, ok, start,
+                                           self.tp.rx_bytes - rx,
+                                           self.tp.tx_bytes - tx)
         except _SocketEOF:
             # Client went away and didn't meet our expectations for protocol,
             # this error message should not be seen as it shouldn't be
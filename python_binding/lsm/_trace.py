@@ -0,0 +1,117 @@
+# Copyright (C) 2026 Red Hat, Inc.
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; If not, see <http://www.gnu.org/licenses/>.
+
+"""
+Request tracing in Chrome trace-event format, the python counterpart of
+c_binding/lsm_trace.hpp.
+
+When LSM_TRACE_DIR names a writable directory, events are appended to
+$LSM_TRACE_DIR/lsm-trace-<pid>.json.  Time stamps are CLOCK_MONOTONIC in
+microseconds so they line up with the C library, lsmd and other plug-ins.
+"""
+
+import itertools
+import json
+import os
+import sys
+import threading
+import time
+
+TRACE_ENV = 'LSM_TRACE_DIR'
+
+_lock = threading.Lock()
+_file = None
+_pid = None
+_seq = itertools.count(1)
+
+
+def enabled():
+    return bool(os.environ.get(TRACE_ENV))
+
+
+def now_us():
+    return int(time.monotonic() * 1000000)
+
+
+def id_new():
+    """
+    Returns an id which identifies one request across processes.
+    """
+    return "%x.%x.%x" % (os.getpid(), now_us(), next(_seq))
+
+
+def _tid():
+    if hasattr(threading, 'get_native_id'):
+        return threading.get_native_id()
+    return threading.current_thread().ident
+
+
+def _write(event):
+    global _file, _pid
+
+    with _lock:
+        pid = os.getpid()
+        if _pid != pid:
+            _pid = pid
+            path = os.path.join(os.environ[TRACE_ENV],
+                                'lsm-trace-%d.json' % pid)
+            try:
+                _file = open(path, 'a')
+                name = os.path.basename(sys.argv[0]) if sys.argv else 'python'
+                _file.write('[\n%s,\n' % json.dumps(
+                    dict(name='process_name', ph='M', pid=pid,
+                         args=dict(name=name))))
+            except (IOError, OSError):
+                _file = None
+
+        if _file:
+            event.update(cat='lsm', pid=pid, tid=_tid())
+            _file.write(json.dumps(event) + ',\n')
+            _file.flush()
+
+
+def flow(trace_id, start):
+    """
+    Records one end of the arrow joining the client and plug-in spans of a
+    request, it binds to the span enclosing the current time.
+    """
+    event = dict(name='request', ph='s' if start else 'f', ts=now_us(),
+                 id=trace_id)
+    if not start:
+        event['bp'] = 'e'
+    _write(event)
+
+
+class Span(object):
+    """
+    Context manager recording a span, a no-op when tracing is disabled.
+    """
+    def __init__(self, name, trace_id=None):
+        self.name = name
+        self.trace_id = trace_id
+        self.start = None
+
+    def __enter__(self):
+        if enabled():
+            self.start = now_us()
+        return self
+
+    def __exit__(self, *exc):
+        if self.start is not None:
+            event = dict(name=self.name, ph='X', ts=self.start,
+                         dur=now_us() - self.start)
+            if self.trace_id:
+                event['args'] = dict(trace_id=self.trace_id)
+            _write(event)
+        return False
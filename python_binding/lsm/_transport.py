@@ -25,6 +25,7 @@
 from lsm._common import SocketEOF as _SocketEOF
 from lsm._data import DataDecoder as _DataDecoder
 from lsm._data import DataEncoder as _DataEncoder
+from lsm import _trace
 
 class TransPort(object):
     """
@@ -71,8 +72,10 @@ def _send_msg(self, msg):
 
         # Note: Don't catch io exceptions at this level!
         s = str.zfill(str(len(msg)), self.HDR_LEN) + msg
+        data = bytes(s.encode('utf-8'))
         # common.Info("SEND: ", msg)
-        self.s.sendall(bytes(s.encode('utf-8')))
+        self.s.sendall(data)
+        self.tx_bytes += len(data)
 
     def _recv_msg(self):
         """
@@ -82,6 +85,7 @@ def _recv_msg(self):
         try:
             l = self._read_all(self.HDR_LEN)
             msg = self._read_all(int(l))
+            self.rx_bytes += self.HDR_LEN + int(l)
             # common.Info("RECV: ", msg)
         except socket.error as e:
             raise LsmError(ErrorNumber.TRANSPORT_COMMUNICATION,
@@ -91,6 +95,9 @@ def _recv_msg(self):
 
     def __init__(self, socket_descriptor):
         self.s = socket_descriptor
+        # Running totals of bytes sent and received, headers included
+        self.tx_bytes = 0
+        self.rx_bytes = 0
 
     @staticmethod
     def get_socket(path):
@@ -122,7 +129,7 @@ def close(self):
         """
         self.s.close()
 
-    def send_req(self, method, args):
+    def send_req(self, method, args, trace_id=None):
         """
         Sends a request given a method and arguments.
         Note: arguments must be in the form that can be automatically
@@ -130,8 +137,13 @@ def send_req(self, method, args):
         """
         try:
             msg = {'method': method, 'id': 100, 'params': args}
-            data = json.dumps(msg, cls=_DataEncoder)
-            self._send_msg(data)
+            if _trace.enabled():
+                msg['trace_id'] = trace_id or _trace.id_new()
+            with _trace.Span('send ' + method, msg.get('trace_id')):
+                if 'trace_id' in msg:
+                    _trace.flow(msg['trace_id'], True)
+                data = json.dumps(msg, cls=_DataEncoder)
+                self._send_msg(data)
         except socket.error as se:
             raise LsmError(ErrorNumber.TRANSPORT_COMMUNICATION,
                            "Error while sending a message to the plug-in",
@@ -150,8 +162,10 @@ def rpc(self, method, args):
         """
         Sends a request and waits for a response.
         """
-        self.send_req(method, args)
-        (reply, msg_id) = self.read_resp()
+        trace_id = _trace.id_new() if _trace.enabled() else None
+        with _trace.Span('rpc ' + method, trace_id):
+            self.send_req(method, args, trace_id)
+            (reply, msg_id) = self.read_resp()
         assert msg_id == 100
         return reply
 
@@ -0,0 +1,403 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Test of the plug-in job executor.
+ *
+ * A forked child runs a minimal plug-in through lsm_plugin_init_v1() on one
+ * end of a socket pair, its volume_resize() hands the work to
+ * lsm_plugin_job_submit().  The parent speaks the IPC protocol on the other
+ * end and checks that:
+ *
+ *  - other requests are answered while a job runs,
+ *  - job_status reports progress, then the result or the error of the work,
+ *  - job_free cancels a running job,
+ *  - plugin_unregister cancels and waits for running jobs.
+ *
+ * The new size given to volume_resize() selects the work:
+ *      JOB_SIZE_FAIL   Work fails.
+ *      JOB_SIZE_LONG   Work runs until cancelled.
+ *      other           Work completes after JOB_STEPS steps.
+ *
+ * Usage: plugin_job_test
+ * lsmd is not required.
+ */
+
+#include <inttypes.h>
+#include <libstoragemgmt/libstoragemgmt_plug_interface.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define JOB_SIZE_FAIL     1
+#define JOB_SIZE_LONG     (1024ULL * 1024 * 1024 * 1024)
+#define JOB_SIZE_OK       (1024 * 1024)
+#define JOB_STEPS         10
+#define JOB_STEP_MS       50
+#define JOB_LONG_MAX_MS   30000
+#define JOB_FAIL_MSG      "Simulated job failure"
+#define JOB_VOLUME_NAME   "resized_by_job"
+#define TEST_TIMEOUT_MS   5000
+#define TEST_HDR_LEN      10
+#define TEST_MSG_MAX      65536
+
+#define TEST_VOLUME                                                            \
+    "{\"class\": \"Volume\", \"id\": \"VOL_1\", \"name\": \"job_vol\", "      \
+    "\"vpd83\": \"600508b1001c2d2a3b4c5d6e7f8a9b0c\", \"block_size\": 512, "   \
+    "\"num_of_blocks\": 8, \"admin_state\": 1, \"system_id\": \"sim\", "      \
+    "\"pool_id\": \"POOL_1\", \"plugin_data\": null}"
+
+/* Child writes a byte here each time a job sees it is cancelled */
+static int cancel_fd = -1;
+static int failures = 0;
+
+static void msleep(uint32_t ms) {
+    struct timespec ts;
+
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* Plug-in side, runs in the forked child */
+
+static int resize_work(lsm_plugin_ptr c, lsm_plugin_job *job, void *data) {
+    uint64_t new_size = *(uint64_t *)data;
+    lsm_volume *vol = NULL;
+    uint32_t step = 0;
+    int rc = LSM_ERR_OK;
+
+    (void)c;
+    if (new_size == JOB_SIZE_FAIL) {
+        lsm_plugin_job_error_set(job, JOB_FAIL_MSG);
+        return LSM_ERR_INVALID_ARGUMENT;
+    }
+
+    for (step = 0; new_size == JOB_SIZE_LONG || step < JOB_STEPS; ++step) {
+        if (lsm_plugin_job_cancelled(job)) {
+            if (write(cancel_fd, "c", 1) != 1)
+                return LSM_ERR_PLUGIN_BUG;
+            return LSM_ERR_OK;
+        }
+        if (step * JOB_STEP_MS > JOB_LONG_MAX_MS)
+            return LSM_ERR_TIMEOUT;
+        if (step < JOB_STEPS)
+            lsm_plugin_job_progress_set(job, step * 100 / JOB_STEPS);
+        msleep(JOB_STEP_MS);
+    }
+
+    vol = lsm_volume_record_alloc(
+        "VOL_1", JOB_VOLUME_NAME, "600508b1001c2d2a3b4c5d6e7f8a9b0c", 512,
+        new_size / 512, 1, "sim", "POOL_1", NULL);
+    if (vol == NULL)
+        return LSM_ERR_NO_MEMORY;
+    rc = lsm_plugin_job_result_set(job, LSM_DATA_TYPE_VOLUME, vol);
+    lsm_volume_record_free(vol);
+    return rc;
+}
+
+static int volume_resize(lsm_plugin_ptr c, lsm_volume *volume,
+                         uint64_t new_size, lsm_volume **resized_volume,
+                         char **job, lsm_flag flags) {
+    uint64_t *data = malloc(sizeof(uint64_t));
+    int rc = LSM_ERR_OK;
+
+    (void)volume;
+    (void)flags;
+    if (data == NULL)
+        return LSM_ERR_NO_MEMORY;
+    *data = new_size;
+    *resized_volume = NULL;
+
+    rc = lsm_plugin_job_submit(c, resize_work, data, free, job);
+    if (rc != LSM_ERR_OK) {
+        free(data);
+        return rc;
+    }
+    return LSM_ERR_JOB_STARTED;
+}
+
+static int system_list(lsm_plugin_ptr c, lsm_system **systems[],
+                       uint32_t *system_count, lsm_flag flags) {
+    (void)c;
+    (void)flags;
+    *systems = NULL;
+    *system_count = 0;
+    return LSM_ERR_OK;
+}
+
+static int job_status(lsm_plugin_ptr c, const char *job,
+                      lsm_job_status *status, uint8_t *percent_complete,
+                      lsm_data_type *type, void **value, lsm_flag flags) {
+    (void)job;
+    (void)status;
+    (void)percent_complete;
+    (void)type;
+    (void)value;
+    (void)flags;
+    return lsm_log_error_basic(c, LSM_ERR_NOT_FOUND_JOB, "Job not found");
+}
+
+static struct lsm_mgmt_ops_v1 mgm_ops = {
+    NULL, NULL, NULL, job_status, NULL, NULL, system_list,
+};
+
+static struct lsm_san_ops_v1 san_ops;
+
+static int plugin_register(lsm_plugin_ptr c, const char *uri,
+                           const char *password, uint32_t timeout,
+                           lsm_flag flags) {
+    (void)uri;
+    (void)password;
+    (void)timeout;
+    (void)flags;
+    san_ops.vol_resize = volume_resize;
+    return lsm_register_plugin_v1(c, NULL, &mgm_ops, &san_ops, NULL, NULL);
+}
+
+static int plugin_unregister(lsm_plugin_ptr c, lsm_flag flags) {
+    (void)c;
+    (void)flags;
+    return LSM_ERR_OK;
+}
+
+static void plugin_run(int sd) {
+    char fd_str[16];
+    char *argv[] = {"plugin_job_test", fd_str, NULL};
+
+    snprintf(fd_str, sizeof(fd_str), "%d", sd);
+    _exit(lsm_plugin_init_v1(2, argv, plugin_register, plugin_unregister,
+                             "Job executor test plug-in", "0.1"));
+}
+
+/* Client side */
+
+static int full_read(int fd, char *buff, size_t len) {
+    ssize_t got = 0;
+
+    while (len > 0) {
+        got = read(fd, buff, len);
+        if (got <= 0)
+            return -1;
+        buff += got;
+        len -= got;
+    }
+    return 0;
+}
+
+/*
+ * Sends a request and returns its response in a static buffer, NULL on
+ * transport failure.
+ */
+static const char *rpc(int sd, const char *method, const char *params) {
+    static uint32_t id = 0;
+    static char resp[TEST_MSG_MAX];
+    char msg[TEST_MSG_MAX];
+    char hdr[TEST_HDR_LEN + 1];
+    int len = 0;
+
+    len = snprintf(msg + TEST_HDR_LEN, sizeof(msg) - TEST_HDR_LEN,
+                   "{\"method\": \"%s\", \"id\": %" PRIu32
+                   ", \"params\": {%s%s\"flags\": 0}}",
+                   method, ++id, params, params[0] ? ", " : "");
+    snprintf(hdr, sizeof(hdr), "%0*d", TEST_HDR_LEN, len);
+    memcpy(msg, hdr, TEST_HDR_LEN);
+
+    if (write(sd, msg, TEST_HDR_LEN + len) != TEST_HDR_LEN + len)
+        return NULL;
+
+    if (full_read(sd, hdr, TEST_HDR_LEN) != 0)
+        return NULL;
+    hdr[TEST_HDR_LEN] = '\0';
+    len = atoi(hdr);
+    if (len <= 0 || len >= (int)sizeof(resp))
+        return NULL;
+    if (full_read(sd, resp, len) != 0)
+        return NULL;
+    resp[len] = '\0';
+    return resp;
+}
+
+static void check(int ok, const char *what, const char *resp) {
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n    response: %s\n", what,
+                resp ? resp : "(none)");
+        failures++;
+    }
+}
+
+/* Returns job id from volume_resize response in a static buffer */
+static const char *resize(int sd, uint64_t new_size) {
+    static char job_id[64];
+    char params[TEST_MSG_MAX];
+    const char *resp = NULL;
+    const char *start = NULL;
+    size_t len = 0;
+
+    snprintf(params, sizeof(params),
+             "\"volume\": %s, \"new_size_bytes\": %" PRIu64, TEST_VOLUME,
+             new_size);
+    resp = rpc(sd, "volume_resize", params);
+    start = resp ? strstr(resp, "LSM_PLUGIN_JOB_") : NULL;
+    check(start != NULL, "volume_resize returns an executor job", resp);
+    if (start == NULL)
+        return "";
+
+    len = strcspn(start, "\"");
+    if (len >= sizeof(job_id))
+        len = sizeof(job_id) - 1;
+    memcpy(job_id, start, len);
+    job_id[len] = '\0';
+    return job_id;
+}
+
+static const char *job_call(int sd, const char *method, const char *job_id) {
+    char params[128];
+
+    snprintf(params, sizeof(params), "\"job_id\": \"%s\"", job_id);
+    return rpc(sd, method, params);
+}
+
+/* Polls job_status until the job is no longer in progress */
+static const char *job_wait(int sd, const char *job_id, int *saw_progress) {
+    const char *resp = NULL;
+    double deadline = now_ms() + TEST_TIMEOUT_MS;
+
+    while (now_ms() < deadline) {
+        resp = job_call(sd, "job_status", job_id);
+        if (resp == NULL || strstr(resp, "\"result\": [1,") == NULL)
+            return resp;
+        if (saw_progress && strstr(resp, "\"result\": [1, 0,") == NULL)
+            *saw_progress = 1;
+        msleep(JOB_STEP_MS / 2);
+    }
+    return resp;
+}
+
+static int cancel_wait(int fd) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    char c = 0;
+
+    if (poll(&pfd, 1, TEST_TIMEOUT_MS) != 1)
+        return 0;
+    return read(fd, &c, 1) == 1;
+}
+
+int main(void) {
+    int sv[2];
+    int cancel_pipe[2];
+    const char *resp = NULL;
+    const char *job_id = NULL;
+    char job_copy[64];
+    int saw_progress = 0;
+    double start = 0;
+    int status = 0;
+    pid_t pid = 0;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0 ||
+        pipe(cancel_pipe) != 0) {
+        perror("socketpair");
+        return EXIT_FAILURE;
+    }
+
+    pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return EXIT_FAILURE;
+    }
+    if (pid == 0) {
+        close(sv[0]);
+        close(cancel_pipe[0]);
+        cancel_fd = cancel_pipe[1];
+        plugin_run(sv[1]);
+    }
+    close(sv[1]);
+    close(cancel_pipe[1]);
+
+    resp = rpc(sv[0], "plugin_register",
+               "\"uri\": \"job://\", \"password\": null, \"timeout\": 1000");
+    check(resp && strstr(resp, "\"result\""), "plugin_register", resp);
+
+    /* Completing job, the plug-in keeps answering meanwhile */
+    job_id = resize(sv[0], JOB_SIZE_OK);
+    snprintf(job_copy, sizeof(job_copy), "%s", job_id);
+    start = now_ms();
+    resp = rpc(sv[0], "systems", "");
+    check(resp && strstr(resp, "\"result\": []") &&
+              now_ms() - start < JOB_STEPS * JOB_STEP_MS / 2,
+          "systems answered while job runs", resp);
+    resp = job_call(sv[0], "job_status", job_copy);
+    check(resp && strstr(resp, "\"result\": [1,"), "job in progress", resp);
+    resp = job_wait(sv[0], job_copy, &saw_progress);
+    check(resp && strstr(resp, "\"result\": [2, 100, {") &&
+              strstr(resp, JOB_VOLUME_NAME) && strstr(resp, "2048"),
+          "job complete with resized volume", resp);
+    check(saw_progress, "job progress reported", NULL);
+    resp = job_call(sv[0], "job_free", job_copy);
+    check(resp && strstr(resp, "\"result\": null"), "job_free", resp);
+    resp = job_call(sv[0], "job_status", job_copy);
+    check(resp && strstr(resp, "\"code\": 202"),
+          "freed job left to plug-in job_status", resp);
+
+    /* Failing job */
+    job_id = resize(sv[0], JOB_SIZE_FAIL);
+    resp = job_wait(sv[0], job_id, NULL);
+    check(resp && strstr(resp, "\"code\": 101") && strstr(resp, JOB_FAIL_MSG),
+          "job error returned by job_status", resp);
+    resp = job_call(sv[0], "job_free", job_id);
+    check(resp && strstr(resp, "\"result\": null"), "job_free failed", resp);
+
+    /* job_free cancels a running job */
+    job_id = resize(sv[0], JOB_SIZE_LONG);
+    msleep(JOB_STEP_MS * 2);
+    resp = job_call(sv[0], "job_free", job_id);
+    check(resp && strstr(resp, "\"result\": null"), "job_free running", resp);
+    check(cancel_wait(cancel_pipe[0]), "job_free cancels job", NULL);
+
+    /* Unregister cancels and waits for running jobs */
+    resize(sv[0], JOB_SIZE_LONG);
+    resize(sv[0], JOB_SIZE_LONG);
+    msleep(JOB_STEP_MS * 2);
+    resp = rpc(sv[0], "plugin_unregister", "");
+    check(resp && strstr(resp, "\"result\": null"), "plugin_unregister", resp);
+    check(cancel_wait(cancel_pipe[0]) && cancel_wait(cancel_pipe[0]),
+          "plugin_unregister cancels jobs", NULL);
+
+    close(sv[0]);
+    check(waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+              WEXITSTATUS(status) == 0,
+          "plug-in exits cleanly", NULL);
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,297 @@
+#!/usr/bin/env python3
+# Copyright (C) 2026 Red Hat, Inc.
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; If not, see <http://www.gnu.org/licenses/>.
+
+"""
+Scale test of the sim plugin back store.
+
+Single object operations must not get slower as the inventory grows: volume
+create/delete, mask/unmask and the listings of volumes accessible by an
+access group and access groups granted to a volume.  The test records the
+SQL those operations issue against an inventory of 2000 volumes (with one
+access group per ten volumes and every volume masked) and fails if
+EXPLAIN QUERY PLAN shows any of it scanning a whole table.
+
+Timing the operations is opt-in, by setting LSM_SIM_SCALE_TIMING=1: the
+inventory then grows to 32000 volumes and the test also fails if any of
+them gets more than 4 times slower while the inventory grows 16 times.
+Full listings are linear by nature, their cost per object is printed only.
+
+The SimArray is driven directly, lsmd is not required.
+
+Usage: sim_scale_test.py [max_volume_count]
+"""
+
+import os
+import shutil
+import sys
+import tempfile
+import time
+
+from lsm import AccessGroup, Volume
+from lsm.plugin.sim.simarray import BackStore, SimArray
+
+_VOL_SIZE = 1024 * 1024
+_VOLS_PER_AG = 10
+_STEPS = 3
+_STEP_GROWTH = 4
+_MAX_SLOWDOWN = 4
+_REPEAT = 5
+_OP_COUNT = 20
+_TIMEOUT_MS = 30000
+_PLAN_VOL_COUNT = 2000
+_TIMING_ENV = 'LSM_SIM_SCALE_TIMING'
+
+
+def _seed(sim_array, vol_count):
+    """
+    Fill the back store with vol_count volumes in a single transaction.
+    Volumes are inserted directly as creating them one by one would take
+    far longer than the operations being measured.
+    """
+    bs_obj = sim_array.bs_obj
+    pool_id = SimArray._sim_pool_id_of(_test_pool_id(sim_array))
+    start = len(sim_array.volumes()) - 1
+
+    bs_obj.trans_begin()
+    for i in range(start, vol_count):
+        if i % _VOLS_PER_AG == 0:
+            bs_obj._data_add('ags', {'name': 'scale_ag_%d' % i})
+            sim_ag_id = bs_obj.lastrowid
+            bs_obj._data_add(
+                'inits',
+                {
+                    'id': 'iqn.2026-01.com.example:scale-%d' % i,
+                    'init_type': AccessGroup.INIT_TYPE_ISCSI_IQN,
+                    'owner_ag_id': sim_ag_id,
+                })
+        bs_obj._data_add(
+            'volumes',
+            {
+                'vpd83': '600b3420%024x' % i,
+                'name': 'scale_vol_%d' % i,
+                'total_space': _VOL_SIZE,
+                'consumed_size': _VOL_SIZE,
+                'admin_state': Volume.ADMIN_STATE_ENABLED,
+                'is_hw_raid_vol': 0,
+                'write_cache_policy': BackStore.DEFAULT_WRITE_CACHE_POLICY,
+                'read_cache_policy': BackStore.DEFAULT_READ_CACHE_POLICY,
+                'phy_disk_cache': BackStore.DEFAULT_PHYSICAL_DISK_CACHE,
+                'pool_id': pool_id,
+            })
+        bs_obj._data_add(
+            'vol_masks', {'vol_id': bs_obj.lastrowid, 'ag_id': sim_ag_id})
+    bs_obj.trans_commit()
+
+
+def _test_pool_id(sim_array):
+    for pool in sim_array.pools():
+        if pool.name == 'lsm_test_aggr':
+            return pool.id
+    raise RuntimeError("Pool 'lsm_test_aggr' not found")
+
+
+def _best(func):
+    """
+    Return the best time of _REPEAT runs of func, in seconds.
+    """
+    best = None
+    for _ in range(_REPEAT):
+        start = time.time()
+        func()
+        elapsed = time.time() - start
+        if best is None or elapsed < best:
+            best = elapsed
+    return best
+
+
+def _vol_create(sim_array, pool_id, name):
+    (job_id, _) = sim_array.volume_create(pool_id, name, _VOL_SIZE, 0)
+    (_, _, vol) = sim_array.job_status(job_id)
+    sim_array.job_free(job_id)
+    return vol
+
+
+def _point_ops(sim_array, free_vol):
+    """
+    Return the [(name, func)] of the operations whose cost must not depend
+    on the inventory size.
+    """
+    pool_id = _test_pool_id(sim_array)
+    vols = sim_array.volumes()
+    ags = sim_array.ags()
+    vol = vols[len(vols) // 2]
+    ag = ags[len(ags) // 2]
+
+    def vol_create_delete():
+        for i in range(_OP_COUNT):
+            new_vol = _vol_create(sim_array, pool_id, 'scale_new_vol_%d' % i)
+            sim_array.job_free(sim_array.volume_delete(new_vol.id))
+
+    def vol_mask_unmask():
+        for _ in range(_OP_COUNT):
+            sim_array.volume_mask(ag.id, free_vol.id)
+            sim_array.volume_unmask(ag.id, free_vol.id)
+
+    def vols_of_ag():
+        for _ in range(_OP_COUNT):
+            sim_array.volumes_accessible_by_access_group(ag.id)
+
+    def ags_of_vol():
+        for _ in range(_OP_COUNT):
+            sim_array.access_groups_granted_to_volume(vol.id)
+
+    return [
+        ('volume create/delete', vol_create_delete),
+        ('volume mask/unmask', vol_mask_unmask),
+        ('volumes of access group', vols_of_ag),
+        ('access groups of volume', ags_of_vol),
+    ]
+
+
+def _full_scans(sql_conn, sql_cmd):
+    """
+    Return the full table scans in the query plan of sql_cmd.  Scans of
+    co-routines and materialized views only walk rows already produced by
+    their own, separately listed, plan.
+    """
+    # Older python hands the trace callback the statement before binding
+    plan = [row['detail'] for row in sql_conn.execute(
+        'EXPLAIN QUERY PLAN ' + sql_cmd, (None,) * sql_cmd.count('?'))]
+    produced = set(
+        detail.split()[-1] for detail in plan
+        if detail.startswith(('CO-ROUTINE', 'MATERIALIZE')))
+    return [detail for detail in plan
+            if detail.startswith('SCAN') and
+            detail.split()[1] not in produced and
+            detail != 'SCAN CONSTANT ROW']
+
+
+def _plan_check(sim_array, free_vol):
+    """
+    Run every point operation once, recording its SQL, and return False if
+    any statement does a full table scan.
+    """
+    sql_conn = sim_array.bs_obj.sql_conn
+    rc = True
+
+    for (name, func) in _point_ops(sim_array, free_vol):
+        sql_cmds = []
+        sql_conn.set_trace_callback(sql_cmds.append)
+        try:
+            func()
+        finally:
+            sql_conn.set_trace_callback(None)
+
+        scans = set()
+        for sql_cmd in set(sql_cmds):
+            if sql_cmd.split()[0].upper() in ('SELECT', 'UPDATE', 'DELETE'):
+                for scan in _full_scans(sql_conn, sql_cmd):
+                    scans.add((' '.join(sql_cmd.split()), scan))
+
+        print("%-24s %s" % (name, "FULL SCAN" if scans else "indexed"))
+        for (sql_cmd, scan) in sorted(scans):
+            print("    %s\n        %s" % (sql_cmd, scan))
+            rc = False
+    return rc
+
+
+def _measure(sim_array, free_vol):
+    vols = sim_array.volumes()
+    ags = sim_array.ags()
+    point_ops = _point_ops(sim_array, free_vol)
+    results = dict(
+        (name, _best(func) / _OP_COUNT) for (name, func) in point_ops)
+
+    for (name, func, count) in [
+            ('volume list', sim_array.volumes, len(vols)),
+            ('access group list', sim_array.ags, len(ags))]:
+        results[name + ' per object'] = _best(func) / count
+
+    return [name for (name, _) in point_ops], results
+
+
+def _timing_check(sim_array, free_vol, max_vol_count):
+    """
+    Time the operations while growing the inventory up to max_vol_count
+    volumes, return False if any point operation slows down too much.
+    """
+    vol_counts = [max_vol_count // _STEP_GROWTH ** i
+                  for i in reversed(range(_STEPS))]
+    first = None
+    rc = True
+
+    for vol_count in vol_counts:
+        start = time.time()
+        _seed(sim_array, vol_count)
+        print("Seeded %d volumes in %.2fs" %
+              (vol_count, time.time() - start))
+
+        (checked, results) = _measure(sim_array, free_vol)
+        if first is None:
+            first = results
+        for name in sorted(results.keys()):
+            print("    %-32s %8.3fms" % (name, results[name] * 1000))
+        sys.stdout.flush()
+
+    for name in checked:
+        slowdown = results[name] / first[name]
+        print("%-24s %5.1fx slower with %dx volumes" %
+              (name, slowdown, vol_counts[-1] // vol_counts[0]))
+        if slowdown > _MAX_SLOWDOWN:
+            rc = False
+    return rc
+
+
+def main():
+    max_vol_count = 32000
+    if len(sys.argv) > 1:
+        max_vol_count = int(sys.argv[1])
+
+    tmp_dir = tempfile.mkdtemp()
+    failed = False
+
+    # Complete jobs at once
+    os.environ['LSM_SIM_TIME'] = '0'
+
+    try:
+        sim_array = SimArray(os.path.join(tmp_dir, 'lsm_sim_scale'),
+                             _TIMEOUT_MS)
+        # Stays unmasked for the mask/unmask measurement
+        free_vol = _vol_create(
+            sim_array, _test_pool_id(sim_array), 'scale_free_vol')
+
+        # Timing grows the inventory from max_vol_count / 16 volumes, so it
+        # has to run before seeding for the plan check
+        if os.environ.get(_TIMING_ENV):
+            if not _timing_check(sim_array, free_vol, max_vol_count):
+                print("FAIL: operations slow down with inventory size")
+                failed = True
+        else:
+            print("Timing skipped, set %s=1 to run it" % _TIMING_ENV)
+
+        _seed(sim_array, _PLAN_VOL_COUNT)
+        if not _plan_check(sim_array, free_vol):
+            print("FAIL: operations scan whole tables")
+            failed = True
+    finally:
+        shutil.rmtree(tmp_dir)
+
+    if failed:
+        sys.exit(1)
+    print("PASS")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Measure list throughput of the simc plug-in with several client processes
+ * sharing one statefile.  Every client connection gets its own simc process,
+ * so this exercises the SQLite locking between plug-in instances.
+ *
+ * The statefile is seeded with the 'small' profile, then for 1, 4 and 16
+ * clients every client runs volume_list() and pool_list() in turn for the
+ * given duration.  Exits with failure if any list call failed.
+ *
+ * Usage: simc_concurrency_bench [seconds] [statefile]
+ * lsmd must be running (or LSM_UDS_PATH pointing to its socket directory).
+ */
+
+#include <inttypes.h>
+#include <libstoragemgmt/libstoragemgmt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_DEFAULT_SECONDS   5
+#define BENCH_DEFAULT_STATEFILE "/tmp/lsm_sim_concurrency_data"
+#define BENCH_URI_SIZE          1024
+#define BENCH_TIMEOUT_MS        30000
+
+struct bench_result {
+    uint64_t lists;
+    uint64_t errors;
+    uint64_t timeouts;
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int plugin_connect(const char *statefile, const char *seed,
+                          lsm_connect **c) {
+    char uri[BENCH_URI_SIZE];
+    lsm_error_ptr e = NULL;
+    int rc = LSM_ERR_OK;
+
+    snprintf(uri, sizeof(uri), "simc://?statefile=%s%s%s", statefile,
+             seed != NULL ? "&seed=" : "", seed != NULL ? seed : "");
+    *c = NULL;
+    rc = lsm_connect_password(uri, NULL, c, BENCH_TIMEOUT_MS, &e,
+                              LSM_CLIENT_FLAG_RSVD);
+    if (rc != LSM_ERR_OK) {
+        fprintf(stderr, "Failed to connect to '%s': %d %s\n", uri, rc,
+                e != NULL ? lsm_error_message_get(e) : "");
+        lsm_error_free(e);
+    }
+    return rc;
+}
+
+static void result_count(struct bench_result *result, int rc) {
+    if (rc == LSM_ERR_OK)
+        result->lists++;
+    else if (rc == LSM_ERR_TIMEOUT)
+        result->timeouts++;
+    else
+        result->errors++;
+}
+
+/*
+ * Runs in the forked child: connect, wait for the parent to close the start
+ * pipe so all clients begin together, then list until the deadline.
+ */
+static void client_run(const char *statefile, double seconds, int start_fd,
+                       int result_fd) {
+    struct bench_result result;
+    lsm_connect *c = NULL;
+    lsm_volume **volumes = NULL;
+    lsm_pool **pools = NULL;
+    uint32_t count = 0;
+    double deadline = 0;
+    char buff = 0;
+    int rc = LSM_ERR_OK;
+
+    memset(&result, 0, sizeof(result));
+
+    if (plugin_connect(statefile, NULL, &c) != LSM_ERR_OK) {
+        result.errors++;
+        c = NULL;
+    }
+
+    /* Returns 0 (EOF) once the parent closes its end */
+    if (read(start_fd, &buff, 1) < 0)
+        result.errors++;
+
+    deadline = now_sec() + seconds;
+    while ((c != NULL) && (now_sec() < deadline)) {
+        rc = lsm_volume_list(c, NULL, NULL, &volumes, &count,
+                             LSM_CLIENT_FLAG_RSVD);
+        result_count(&result, rc);
+        if (rc == LSM_ERR_OK)
+            lsm_volume_record_array_free(volumes, count);
+        volumes = NULL;
+
+        rc = lsm_pool_list(c, NULL, NULL, &pools, &count,
+                           LSM_CLIENT_FLAG_RSVD);
+        result_count(&result, rc);
+        if (rc == LSM_ERR_OK)
+            lsm_pool_record_array_free(pools, count);
+        pools = NULL;
+    }
+
+    if (c != NULL)
+        lsm_connect_close(c, LSM_CLIENT_FLAG_RSVD);
+
+    if (write(result_fd, &result, sizeof(result)) != sizeof(result))
+        _exit(EXIT_FAILURE);
+    _exit(EXIT_SUCCESS);
+}
+
+static int clients_run(const char *statefile, uint32_t client_count,
+                       double seconds, struct bench_result *total) {
+    int start_pipe[2];
+    int result_pipe[2];
+    struct bench_result result;
+    uint32_t i = 0;
+    uint32_t done = 0;
+    pid_t pid = 0;
+
+    memset(total, 0, sizeof(struct bench_result));
+
+    if ((pipe(start_pipe) != 0) || (pipe(result_pipe) != 0))
+        return -1;
+
+    for (i = 0; i < client_count; ++i) {
+        pid = fork();
+        if (pid < 0)
+            return -1;
+        if (pid == 0) {
+            close(start_pipe[1]);
+            close(result_pipe[0]);
+            client_run(statefile, seconds, start_pipe[0], result_pipe[1]);
+        }
+    }
+    close(start_pipe[0]);
+    close(result_pipe[1]);
+
+    /* Let every client finish connecting before starting the clock */
+    sleep(1);
+    close(start_pipe[1]);
+
+    while (read(result_pipe[0], &result, sizeof(result)) == sizeof(result)) {
+        total->lists += result.lists;
+        total->errors += result.errors;
+        total->timeouts += result.timeouts;
+        done++;
+    }
+    close(result_pipe[0]);
+
+    while (wait(NULL) > 0)
+        ;
+
+    if (done != client_count)
+        total->errors += client_count - done;
+
+    return 0;
+}
+
+static void statefile_remove(const char *statefile) {
+    char path[BENCH_URI_SIZE];
+
+    unlink(statefile);
+    snprintf(path, sizeof(path), "%s-wal", statefile);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s-shm", statefile);
+    unlink(path);
+}
+
+int main(int argc, char *argv[]) {
+    const uint32_t client_counts[] = {1, 4, 16};
+    double seconds = BENCH_DEFAULT_SECONDS;
+    const char *statefile = BENCH_DEFAULT_STATEFILE;
+    lsm_connect *c = NULL;
+    struct bench_result total;
+    uint32_t i = 0;
+    int failed = 0;
+
+    if (argc > 1)
+        seconds = strtod(argv[1], NULL);
+    if (argc > 2)
+        statefile = argv[2];
+
+    statefile_remove(statefile);
+
+    if (plugin_connect(statefile, "small", &c) != LSM_ERR_OK)
+        return EXIT_FAILURE;
+    lsm_connect_close(c, LSM_CLIENT_FLAG_RSVD);
+
+    for (i = 0; i < sizeof(client_counts) / sizeof(client_counts[0]); ++i) {
+        if (clients_run(statefile, client_counts[i], seconds, &total) != 0) {
+            fprintf(stderr, "Failed to start clients\n");
+            failed = 1;
+            break;
+        }
+        printf("clients: %2" PRIu32 " lists: %8" PRIu64 " (%.1f/s) "
+               "timeouts: %" PRIu64 " errors: %" PRIu64 "\n",
+               client_counts[i], total.lists, total.lists / seconds,
+               total.timeouts, total.errors);
+        fflush(stdout);
+        if ((total.errors != 0) || (total.timeouts != 0))
+            failed = 1;
+    }
+
+    statefile_remove(statefile);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Benchmark volume_list() of the simc plug-in against a large inventory.
+ *
+ * The statefile is created through the plug-in first, then filled with
+ * simulated volumes directly with SQLite, as creating them one by one through
+ * volume_create() would take far longer than the listing being measured.
+ *
+ * Usage: simc_volume_list_bench [volume_count] [iterations] [statefile]
+ * lsmd must be running (or LSM_UDS_PATH pointing to its socket directory).
+ */
+
+#include <inttypes.h>
+#include <libstoragemgmt/libstoragemgmt.h>
+#include <sqlite3.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_DEFAULT_VOLUME_COUNT 100000
+#define BENCH_DEFAULT_ITERATIONS   5
+#define BENCH_DEFAULT_STATEFILE    "/tmp/lsm_sim_bench_data"
+#define BENCH_VOLUME_SIZE          (1024 * 1024)
+#define BENCH_URI_SIZE             1024
+
+static double now_sec(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int plugin_connect(const char *statefile, lsm_connect **c) {
+    char uri[BENCH_URI_SIZE];
+    lsm_error_ptr e = NULL;
+    int rc = LSM_ERR_OK;
+
+    snprintf(uri, sizeof(uri), "simc://?statefile=%s", statefile);
+    rc = lsm_connect_password(uri, NULL, c, 300000, &e, LSM_CLIENT_FLAG_RSVD);
+    if (rc != LSM_ERR_OK) {
+        fprintf(stderr, "Failed to connect to '%s': %d %s\n", uri, rc,
+                e != NULL ? lsm_error_message_get(e) : "");
+        lsm_error_free(e);
+    }
+    return rc;
+}
+
+static int volumes_seed(const char *statefile, uint32_t count) {
+    sqlite3 *db = NULL;
+    sqlite3_stmt *stmt = NULL;
+    char name[64];
+    char vpd83[33];
+    uint32_t i = 0;
+    int rc = -1;
+
+    if (sqlite3_open(statefile, &db) != SQLITE_OK)
+        goto out;
+
+    if ((sqlite3_exec(db, "BEGIN IMMEDIATE TRANSACTION;", NULL, NULL, NULL) !=
+         SQLITE_OK) ||
+        (sqlite3_prepare_v2(
+             db,
+             "INSERT INTO volumes (vpd83, name, total_space, consumed_size, "
+             "admin_state, is_hw_raid_vol, write_cache_policy, "
+             "read_cache_policy, phy_disk_cache, pool_id) "
+             "VALUES (?, ?, ?, ?, 1, 0, 3, 2, 3, "
+             "(SELECT id FROM pools WHERE name = 'Pool 1'));",
+             -1, &stmt, NULL) != SQLITE_OK))
+        goto out;
+
+    for (i = 0; i < count; ++i) {
+        snprintf(name, sizeof(name), "bench_vol_%" PRIu32, i);
+        snprintf(vpd83, sizeof(vpd83), "600b3420%08" PRIx32 "%016" PRIx32, i,
+                 i);
+        sqlite3_bind_text(stmt, 1, vpd83, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, name, -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 3, BENCH_VOLUME_SIZE);
+        sqlite3_bind_int64(stmt, 4, BENCH_VOLUME_SIZE);
+        if (sqlite3_step(stmt) != SQLITE_DONE)
+            goto out;
+        sqlite3_reset(stmt);
+    }
+
+    if (sqlite3_exec(db, "COMMIT;", NULL, NULL, NULL) == SQLITE_OK)
+        rc = 0;
+
+out:
+    if (rc != 0)
+        fprintf(stderr, "Failed to seed volumes: %s\n", sqlite3_errmsg(db));
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return rc;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t volume_count = BENCH_DEFAULT_VOLUME_COUNT;
+    uint32_t iterations = BENCH_DEFAULT_ITERATIONS;
+    const char *statefile = BENCH_DEFAULT_STATEFILE;
+    lsm_connect *c = NULL;
+    lsm_volume **volumes = NULL;
+    uint32_t count = 0;
+    uint32_t i = 0;
+    double start = 0;
+    double elapsed = 0;
+    double best = 0;
+    int rc = LSM_ERR_OK;
+
+    if (argc > 1)
+        volume_count = strtoul(argv[1], NULL, 10);
+    if (argc > 2)
+        iterations = strtoul(argv[2], NULL, 10);
+    if (argc > 3)
+        statefile = argv[3];
+
+    unlink(statefile);
+
+    /* Let the plug-in create the schema and initial data */
+    if (plugin_connect(statefile, &c) != LSM_ERR_OK)
+        return EXIT_FAILURE;
+    lsm_connect_close(c, LSM_CLIENT_FLAG_RSVD);
+    c = NULL;
+
+    start = now_sec();
+    if (volumes_seed(statefile, volume_count) != 0)
+        return EXIT_FAILURE;
+    printf("Seeded %" PRIu32 " volumes in %.3fs\n", volume_count,
+           now_sec() - start);
+    fflush(stdout);
+
+    if (plugin_connect(statefile, &c) != LSM_ERR_OK)
+        return EXIT_FAILURE;
+
+    for (i = 0; i < iterations; ++i) {
+        start = now_sec();
+        rc = lsm_volume_list(c, NULL, NULL, &volumes, &count,
+                             LSM_CLIENT_FLAG_RSVD);
+        elapsed = now_sec() - start;
+        if (rc != LSM_ERR_OK) {
+            fprintf(stderr, "lsm_volume_list() failed: %d\n", rc);
+            break;
+        }
+        lsm_volume_record_array_free(volumes, count);
+        volumes = NULL;
+        if ((i == 0) || (elapsed < best))
+            best = elapsed;
+        printf("volume_list: %" PRIu32 " volumes in %.3fs\n", count, elapsed);
+    }
+    if (rc == LSM_ERR_OK)
+        printf("volume_list best of %" PRIu32 ": %.3fs\n", iterations, best);
+
+    lsm_connect_close(c, LSM_CLIENT_FLAG_RSVD);
+    unlink(statefile);
+
+    return rc == LSM_ERR_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
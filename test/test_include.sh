@@ -262,10 +262,19 @@ function lsm_test_base_install
     _good $LIBTOOL_CMD_NO_WARN --mode install \
         install "${build_dir}/test/tester" "${LSM_TEST_BIN_DIR}/tester"
     _good chrpath -d "${LSM_TEST_BIN_DIR}/tester"
+    _good $LIBTOOL_CMD_NO_WARN --mode install \
+        install "${build_dir}/test/plugin_job_test" \
+        "${LSM_TEST_BIN_DIR}/plugin_job_test"
+    _good chrpath -d "${LSM_TEST_BIN_DIR}/plugin_job_test"
+    _good $LIBTOOL_CMD_NO_WARN --mode install \
+        install "${build_dir}/c_binding/libsg_async_test" \
+        "${LSM_TEST_BIN_DIR}/libsg_async_test"
     _good install "${build_dir}/test/plugin_test.py" \
         "${LSM_TEST_BIN_DIR}/plugin_test.py"
     _good install "${build_dir}/test/cmdtest.py" \
         "${LSM_TEST_BIN_DIR}/cmdtest.py"
+    _good install "${src_dir}/test/sim_scale_test.py" \
+        "${LSM_TEST_BIN_DIR}/sim_scale_test.py"
 
     _good install "${src_dir}/config/lsmd.conf" \
         "${LSM_TEST_CFG_DIR}/lsmd.conf"
@@ -369,10 +378,15 @@ function lsm_test_c_unit_test_run
 {
     local with_mem_check="$1"
     local plugin_type="$2"
+    local db_mode="$3"
     local cmd="${LSM_TEST_BIN_DIR}/tester"
 
     if [ "CHK$plugin_type" == "CHK$LSM_TEST_SIMC_URI" ];then
         cmd="${cmd} use_simc"
+        # 'memory' runs simc with the in-memory database
+        if [ "CHK$db_mode" == "CHKmemory" ];then
+            cmd="${cmd} memory"
+        fi
     fi
 
     if [ "CHK${with_mem_check}" == "CHK${LSM_TEST_WITH_MEM_CHECK}" ];then
@@ -400,6 +414,21 @@ function lsm_test_cmd_test_run
     # TODO(Gris Ge): Should we add running from plugin here.
 }
 
+function lsm_test_sim_scale_test_run
+{
+    _good $LSM_TEST_BIN_DIR/sim_scale_test.py
+}
+
+function lsm_test_plugin_job_test_run
+{
+    _good $LSM_TEST_BIN_DIR/plugin_job_test
+}
+
+function lsm_test_libsg_async_test_run
+{
+    _good $LSM_TEST_BIN_DIR/libsg_async_test
+}
+
 function lsm_test_plugin_test_run
 {
     export LSM_TEST_URI="$1";
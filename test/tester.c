@@ -21,6 +21,7 @@
 
 #include <check.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <libstoragemgmt/libstoragemgmt.h>
 #include <libstoragemgmt/libstoragemgmt_plug_interface.h>
 #include <stdint.h>
@@ -37,13 +38,14 @@ const char SYSTEM_ID[] = "sim-01";
 const char *ISCSI_HOST[2] = {"iqn.1994-05.com.domain:01.89bd01",
                              "iqn.1994-05.com.domain:01.89bd02"};
 static int is_simc_plugin = 0;
+static int is_simc_memory = 0;
 
 #define POLL_SLEEP                50000
 #define VPD83_TO_SEARCH           "600508b1001c79ade5178f0626caaa9c"
 #define INVALID_VPD83             "600508b1001c79ade5178f0626caaa9c1"
 #define VALID_BUT_NOT_EXIST_VPD83 "5000000000000000"
 #define NOT_EXIST_SD_PATH         "/dev/sdazzzzzzzzzzz"
-#define _URI_BUFF_SIZE            128
+#define _URI_BUFF_SIZE            256
 
 lsm_connect *c = NULL;
 
@@ -148,8 +150,9 @@ const char *plugin_to_use(char *uri_buff) {
     if (rundir) {
         generate_random(name, sizeof(name) / sizeof(name[0]));
         snprintf(uri_buff, _URI_BUFF_SIZE,
-                 "%s://localhost/?statefile=%s/lsm_sim_%s",
-                 is_simc_plugin == 1 ? "simc" : "sim", rundir, name);
+                 "%s://localhost/?statefile=%s/lsm_sim_%s%s",
+                 is_simc_plugin == 1 ? "simc" : "sim", rundir, name,
+                 is_simc_memory == 1 ? "&memory=volatile" : "");
     } else {
         printf("Missing LSM_TEST_RUNDIR, expect test failures!\n");
         exit(1);
@@ -3397,6 +3400,366 @@ START_TEST(test_local_disk_vpd83_search) {
 }
 END_TEST
 
+START_TEST(test_local_disk_vpd83_bulk_search) {
+    int rc = LSM_ERR_OK;
+    uint32_t i = 0;
+    lsm_string_list *vpd83_list = NULL;
+    lsm_string_list **disk_path_lists;
+    /* Not initialized in order to test dangling pointer disk_path_lists */
+    lsm_string_list *disk_path_list = NULL;
+    lsm_error *lsm_err = NULL;
+
+    if (is_simc_plugin == 1) {
+        /* silently skip on simc, no need for duplicate test. */
+        return;
+    }
+
+    rc = lsm_local_disk_vpd83_bulk_search(NULL, &disk_path_lists, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "lsm_local_disk_vpd83_bulk_search(): Expecting "
+                  "LSM_ERR_INVALID_ARGUMENT when vpd83_list argument "
+                  "pointer is NULL");
+    ck_assert_msg(disk_path_lists == NULL,
+                  "lsm_local_disk_vpd83_bulk_search(): Expecting "
+                  "disk_path_lists been set as NULL.");
+    ck_assert_msg(lsm_err != NULL,
+                  "lsm_local_disk_vpd83_bulk_search(): Expecting "
+                  "lsm_err been set as non-NULL.");
+    lsm_error_free(lsm_err);
+
+    vpd83_list = lsm_string_list_alloc(0);
+    ck_assert_msg(vpd83_list != NULL, "lsm_string_list_alloc() failed");
+    lsm_string_list_append(vpd83_list, INVALID_VPD83);
+
+    rc = lsm_local_disk_vpd83_bulk_search(vpd83_list, &disk_path_lists,
+                                          &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "lsm_local_disk_vpd83_bulk_search(): Expecting "
+                  "LSM_ERR_INVALID_ARGUMENT when incorrect VPD83 provided");
+    ck_assert_msg(disk_path_lists == NULL,
+                  "lsm_local_disk_vpd83_bulk_search(): Expecting "
+                  "disk_path_lists been set as NULL.");
+    lsm_error_free(lsm_err);
+    lsm_string_list_free(vpd83_list);
+
+    /* Results should be identical to lsm_local_disk_vpd83_search(), with
+     * the duplicated entry answered twice.
+     */
+    vpd83_list = lsm_string_list_alloc(0);
+    ck_assert_msg(vpd83_list != NULL, "lsm_string_list_alloc() failed");
+    lsm_string_list_append(vpd83_list, VPD83_TO_SEARCH);
+    lsm_string_list_append(vpd83_list, VALID_BUT_NOT_EXIST_VPD83);
+    lsm_string_list_append(vpd83_list, VPD83_TO_SEARCH);
+
+    rc = lsm_local_disk_vpd83_bulk_search(vpd83_list, &disk_path_lists,
+                                          &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK,
+                  "lsm_local_disk_vpd83_bulk_search(): Expecting LSM_ERR_OK "
+                  "when valid argument provided, got %d", rc);
+    ck_assert_msg(lsm_err == NULL,
+                  "lsm_local_disk_vpd83_bulk_search(): Expecting lsm_err as "
+                  "NULL when valid argument provided");
+    ck_assert_msg(disk_path_lists != NULL,
+                  "lsm_local_disk_vpd83_bulk_search(): Expecting "
+                  "disk_path_lists as non-NULL on success");
+
+    for (i = 0; i < lsm_string_list_size(vpd83_list); ++i) {
+        rc = lsm_local_disk_vpd83_search(
+            lsm_string_list_elem_get(vpd83_list, i), &disk_path_list,
+            &lsm_err);
+        ck_assert_msg(rc == LSM_ERR_OK,
+                      "lsm_local_disk_vpd83_search(): Expecting LSM_ERR_OK");
+        ck_assert_msg(disk_path_lists[i] != NULL,
+                      "lsm_local_disk_vpd83_bulk_search(): Expecting "
+                      "non-NULL list for every vpd83");
+        ck_assert_msg(lsm_string_list_size(disk_path_lists[i]) ==
+                          lsm_string_list_size(disk_path_list),
+                      "lsm_local_disk_vpd83_bulk_search(): Expecting the "
+                      "same disk count as lsm_local_disk_vpd83_search()");
+        if (disk_path_list != NULL)
+            lsm_string_list_free(disk_path_list);
+        lsm_string_list_free(disk_path_lists[i]);
+    }
+    free(disk_path_lists);
+    lsm_string_list_free(vpd83_list);
+}
+END_TEST
+
+/*
+ * Compare the inventory with the uncached lsm_local_disk_*() functions.
+ */
+START_TEST(test_local_disk_inventory) {
+    int rc = LSM_ERR_OK;
+    uint32_t i = 0;
+    lsm_local_disk_inventory *inventory = NULL;
+    lsm_string_list *disk_paths = NULL;
+    lsm_string_list *inv_disk_paths = NULL;
+    const char *disk_path = NULL;
+    char *vpd83 = NULL;
+    char *inv_vpd83 = NULL;
+    int32_t rpm = LSM_DISK_RPM_UNKNOWN;
+    int32_t inv_rpm = LSM_DISK_RPM_UNKNOWN;
+    lsm_error *lsm_err = NULL;
+
+    if (is_simc_plugin == 1) {
+        /* silently skip on simc, no need for duplicate test. */
+        return;
+    }
+
+    rc = lsm_local_disk_inventory_alloc(NULL, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "lsm_local_disk_inventory_alloc(): Expecting "
+                  "LSM_ERR_INVALID_ARGUMENT when inventory argument pointer "
+                  "is NULL");
+    lsm_error_free(lsm_err);
+
+    rc = lsm_local_disk_inventory_alloc(&inventory, &lsm_err);
+    if (rc == LSM_ERR_NO_SUPPORT) {
+        /* No udev events, like in some containers */
+        lsm_error_free(lsm_err);
+        return;
+    }
+    ck_assert_msg(rc == LSM_ERR_OK,
+                  "lsm_local_disk_inventory_alloc() failed as %d", rc);
+
+    rc = lsm_local_disk_list(&disk_paths, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK, "lsm_local_disk_list() failed as %d", rc);
+    rc = lsm_local_disk_inventory_list(inventory, &inv_disk_paths, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK,
+                  "lsm_local_disk_inventory_list() failed as %d", rc);
+    ck_assert_msg(lsm_string_list_size(disk_paths) ==
+                      lsm_string_list_size(inv_disk_paths),
+                  "lsm_local_disk_inventory_list(): Expecting the same "
+                  "disk count as lsm_local_disk_list()");
+
+    /* Twice, to compare both the first query and the cached result */
+    for (i = 0; i < 2 * lsm_string_list_size(disk_paths); ++i) {
+        disk_path = lsm_string_list_elem_get(
+            disk_paths, i % lsm_string_list_size(disk_paths));
+
+        rc = lsm_local_disk_vpd83_get(disk_path, &vpd83, &lsm_err);
+        if (rc != LSM_ERR_OK)
+            lsm_error_free(lsm_err);
+        ck_assert_msg(lsm_local_disk_inventory_vpd83_get(
+                          inventory, disk_path, &inv_vpd83, &lsm_err) == rc,
+                      "lsm_local_disk_inventory_vpd83_get(): Expecting the "
+                      "same return code as lsm_local_disk_vpd83_get()");
+        if (rc == LSM_ERR_OK) {
+            ck_assert_msg(strcmp(vpd83, inv_vpd83) == 0,
+                          "lsm_local_disk_inventory_vpd83_get(): Expecting "
+                          "'%s', got '%s'", vpd83, inv_vpd83);
+        } else {
+            lsm_error_free(lsm_err);
+        }
+        free(vpd83);
+        free(inv_vpd83);
+
+        rc = lsm_local_disk_rpm_get(disk_path, &rpm, &lsm_err);
+        if (rc != LSM_ERR_OK)
+            lsm_error_free(lsm_err);
+        ck_assert_msg(lsm_local_disk_inventory_rpm_get(inventory, disk_path,
+                                                       &inv_rpm,
+                                                       &lsm_err) == rc,
+                      "lsm_local_disk_inventory_rpm_get(): Expecting the "
+                      "same return code as lsm_local_disk_rpm_get()");
+        if (rc != LSM_ERR_OK)
+            lsm_error_free(lsm_err);
+        ck_assert_msg(rpm == inv_rpm,
+                      "lsm_local_disk_inventory_rpm_get(): Expecting %d, "
+                      "got %d", rpm, inv_rpm);
+    }
+
+    rc = lsm_local_disk_inventory_refresh(inventory, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK,
+                  "lsm_local_disk_inventory_refresh() failed as %d", rc);
+
+    lsm_string_list_free(disk_paths);
+    lsm_string_list_free(inv_disk_paths);
+    lsm_local_disk_inventory_free(inventory);
+}
+END_TEST
+
+/*
+ * Compare lsm_local_disk_info_list() with the single disk functions.
+ */
+START_TEST(test_local_disk_info_list) {
+    int rc = LSM_ERR_OK;
+    uint32_t i = 0;
+    uint32_t count = 0;
+    lsm_local_disk_info **infos = NULL;
+    lsm_string_list *disk_paths = NULL;
+    const char *disk_path = NULL;
+    char *vpd83 = NULL;
+    int32_t rpm = LSM_DISK_RPM_UNKNOWN;
+    lsm_disk_link_type link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
+    lsm_error *lsm_err = NULL;
+
+    if (is_simc_plugin == 1) {
+        /* silently skip on simc, no need for duplicate test. */
+        return;
+    }
+
+    rc = lsm_local_disk_info_list(0, NULL, &count, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "lsm_local_disk_info_list(): Expecting "
+                  "LSM_ERR_INVALID_ARGUMENT when infos argument pointer "
+                  "is NULL");
+    lsm_error_free(lsm_err);
+
+    rc = lsm_local_disk_info_list(4, &infos, &count, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK, "lsm_local_disk_info_list() failed as %d",
+                  rc);
+    rc = lsm_local_disk_list(&disk_paths, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK, "lsm_local_disk_list() failed as %d", rc);
+    ck_assert_msg(count == lsm_string_list_size(disk_paths),
+                  "lsm_local_disk_info_list(): Expecting the same disk "
+                  "count as lsm_local_disk_list()");
+
+    for (i = 0; i < count; ++i) {
+        disk_path = lsm_local_disk_info_disk_path_get(infos[i]);
+        ck_assert_msg(strcmp(disk_path,
+                             lsm_string_list_elem_get(disk_paths, i)) == 0,
+                      "lsm_local_disk_info_list(): Expecting disks in the "
+                      "order of lsm_local_disk_list()");
+
+        if (lsm_local_disk_vpd83_get(disk_path, &vpd83, &lsm_err) ==
+            LSM_ERR_OK) {
+            ck_assert_msg(strcmp(vpd83 != NULL ? vpd83 : "",
+                                 lsm_local_disk_info_vpd83_get(infos[i])) ==
+                              0,
+                          "lsm_local_disk_info_vpd83_get(): Got different "
+                          "VPD83 for %s", disk_path);
+            free(vpd83);
+        } else {
+            lsm_error_free(lsm_err);
+        }
+
+        if (lsm_local_disk_rpm_get(disk_path, &rpm, &lsm_err) != LSM_ERR_OK)
+            lsm_error_free(lsm_err);
+        ck_assert_msg(rpm == lsm_local_disk_info_rpm_get(infos[i]),
+                      "lsm_local_disk_info_rpm_get(): Got different RPM "
+                      "for %s", disk_path);
+
+        if (lsm_local_disk_link_type_get(disk_path, &link_type, &lsm_err) !=
+            LSM_ERR_OK)
+            lsm_error_free(lsm_err);
+        ck_assert_msg(link_type == lsm_local_disk_info_link_type_get(infos[i]),
+                      "lsm_local_disk_info_link_type_get(): Got different "
+                      "link type for %s", disk_path);
+    }
+
+    lsm_string_list_free(disk_paths);
+    lsm_local_disk_info_array_free(infos, count);
+}
+END_TEST
+
+START_TEST(test_local_disk_health_sampler) {
+    int rc = LSM_ERR_OK;
+    uint32_t i = 0;
+    uint32_t wait_count = 0;
+    char shm_name[64];
+    lsm_local_disk_sampler *sampler = NULL;
+    lsm_local_disk_health_table *table = NULL;
+    lsm_string_list *disk_paths = NULL;
+    const char *disk_path = NULL;
+    int32_t health_status = LSM_DISK_HEALTH_STATUS_UNKNOWN;
+    lsm_disk_link_type link_type = LSM_DISK_LINK_TYPE_UNKNOWN;
+    uint32_t link_speed = LSM_DISK_LINK_SPEED_UNKNOWN;
+    uint64_t sample_time = 0;
+    lsm_error *lsm_err = NULL;
+
+    if (is_simc_plugin == 1) {
+        /* silently skip on simc, no need for duplicate test. */
+        return;
+    }
+
+    snprintf(shm_name, sizeof(shm_name), "/lsm_tester_health_%d",
+             (int)getpid());
+
+    rc = lsm_local_disk_sampler_start(shm_name, 1000, 0, 0, NULL, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "lsm_local_disk_sampler_start(): Expecting "
+                  "LSM_ERR_INVALID_ARGUMENT when sampler argument pointer "
+                  "is NULL");
+    lsm_error_free(lsm_err);
+
+    rc = lsm_local_disk_sampler_start("no_slash", 1000, 0, 0, &sampler,
+                                      &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "lsm_local_disk_sampler_start(): Expecting "
+                  "LSM_ERR_INVALID_ARGUMENT when name does not start "
+                  "with '/'");
+    lsm_error_free(lsm_err);
+
+    rc = lsm_local_disk_sampler_start(shm_name, 0, 0, 0, &sampler, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "lsm_local_disk_sampler_start(): Expecting "
+                  "LSM_ERR_INVALID_ARGUMENT when interval is 0");
+    lsm_error_free(lsm_err);
+
+    rc = lsm_local_disk_health_table_open(shm_name, &table, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_DAEMON_NOT_RUNNING,
+                  "lsm_local_disk_health_table_open(): Expecting "
+                  "LSM_ERR_DAEMON_NOT_RUNNING when no sampler, got %d", rc);
+    lsm_error_free(lsm_err);
+
+    rc = lsm_local_disk_sampler_start(shm_name, 1000, 100, 4, &sampler,
+                                      &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK,
+                  "lsm_local_disk_sampler_start() failed as %d", rc);
+    rc = lsm_local_disk_health_table_open(shm_name, &table, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK,
+                  "lsm_local_disk_health_table_open() failed as %d", rc);
+
+    while ((lsm_local_disk_health_table_generation_get(table) == 0) &&
+           (wait_count++ < 600))
+        usleep(100000);
+    ck_assert_msg(lsm_local_disk_health_table_generation_get(table) > 0,
+                  "lsm_local_disk_health_table_generation_get(): No round "
+                  "published in 60 seconds");
+
+    rc = lsm_local_disk_list(&disk_paths, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK, "lsm_local_disk_list() failed as %d", rc);
+
+    for (i = 0; i < lsm_string_list_size(disk_paths); ++i) {
+        disk_path = lsm_string_list_elem_get(disk_paths, i);
+        rc = lsm_local_disk_health_table_get(table, disk_path, &health_status,
+                                             &link_type, &link_speed,
+                                             &sample_time, &lsm_err);
+        if (rc != LSM_ERR_OK)
+            lsm_error_free(lsm_err);
+        ck_assert_msg(rc != LSM_ERR_NOT_FOUND_DISK,
+                      "lsm_local_disk_health_table_get(): %s was not "
+                      "sampled", disk_path);
+        ck_assert_msg(sample_time > 0,
+                      "lsm_local_disk_health_table_get(): Expecting sample "
+                      "time of %s", disk_path);
+    }
+
+    rc = lsm_local_disk_health_table_get(table, "/dev/not_exist",
+                                         &health_status, &link_type,
+                                         &link_speed, &sample_time, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_NOT_FOUND_DISK,
+                  "lsm_local_disk_health_table_get(): Expecting "
+                  "LSM_ERR_NOT_FOUND_DISK for not exist disk, got %d", rc);
+    lsm_error_free(lsm_err);
+
+    lsm_local_disk_sampler_stop(sampler);
+
+    rc = lsm_local_disk_health_table_get(table, "/dev/not_exist",
+                                         &health_status, &link_type,
+                                         &link_speed, &sample_time, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_DAEMON_NOT_RUNNING,
+                  "lsm_local_disk_health_table_get(): Expecting "
+                  "LSM_ERR_DAEMON_NOT_RUNNING once sampler stopped, got %d",
+                  rc);
+    lsm_error_free(lsm_err);
+
+    lsm_local_disk_health_table_close(table);
+    lsm_string_list_free(disk_paths);
+}
+END_TEST
+
 START_TEST(test_local_disk_serial_num_get) {
     int rc = LSM_ERR_OK;
     char *serial_num;
@@ -3928,6 +4291,72 @@ START_TEST(test_local_disk_fault_led) {
 }
 END_TEST
 
+START_TEST(test_local_disk_led_batch) {
+    int rc = LSM_ERR_OK;
+    lsm_string_list *disk_paths = NULL;
+    lsm_string_list *empty_paths = NULL;
+    lsm_error *lsm_err = NULL;
+
+    rc = lsm_local_disk_ident_led_on_batch(NULL, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "lsm_local_disk_ident_led_on_batch(): Expecting "
+                  "LSM_ERR_INVALID_ARGUMENT when disk_paths is NULL, "
+                  "but got %d",
+                  rc);
+    ck_assert_msg(lsm_err != NULL, "lsm_local_disk_ident_led_on_batch(): "
+                                   "Got NULL lsm_err on error");
+    lsm_error_free(lsm_err);
+    lsm_err = NULL;
+
+    empty_paths = lsm_string_list_alloc(0);
+    ck_assert_msg(empty_paths != NULL, "lsm_string_list_alloc() failed");
+    rc = lsm_local_disk_fault_led_off_batch(empty_paths, &lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK,
+                  "lsm_local_disk_fault_led_off_batch(): Expecting "
+                  "LSM_ERR_OK for empty list, but got %d",
+                  rc);
+    lsm_string_list_free(empty_paths);
+
+    rc = lsm_local_disk_list(&disk_paths, &lsm_err);
+    if (lsm_err != NULL)
+        lsm_error_free(lsm_err);
+    ck_assert_msg(rc == LSM_ERR_OK, "lsm_local_disk_list() failed as %d",
+                  rc);
+    lsm_err = NULL;
+
+    if (lsm_string_list_size(disk_paths) > 0) {
+        rc = lsm_local_disk_ident_led_on_batch(disk_paths, &lsm_err);
+        ck_assert_msg(rc == LSM_ERR_OK || rc == LSM_ERR_NO_SUPPORT ||
+                          rc == LSM_ERR_PERMISSION_DENIED,
+                      "lsm_local_disk_ident_led_on_batch(): "
+                      "Got unexpected return: %d",
+                      rc);
+        if (rc != LSM_ERR_OK) {
+            ck_assert_msg(lsm_err != NULL,
+                          "lsm_local_disk_ident_led_on_batch(): Got NULL "
+                          "lsm_err while rc(%d) != LSM_ERR_OK",
+                          rc);
+            lsm_error_free(lsm_err);
+            lsm_err = NULL;
+        }
+        rc = lsm_local_disk_ident_led_off_batch(disk_paths, &lsm_err);
+        ck_assert_msg(rc == LSM_ERR_OK || rc == LSM_ERR_NO_SUPPORT ||
+                          rc == LSM_ERR_PERMISSION_DENIED,
+                      "lsm_local_disk_ident_led_off_batch(): "
+                      "Got unexpected return: %d",
+                      rc);
+        if (rc != LSM_ERR_OK) {
+            ck_assert_msg(lsm_err != NULL,
+                          "lsm_local_disk_ident_led_off_batch(): Got NULL "
+                          "lsm_err while rc(%d) != LSM_ERR_OK",
+                          rc);
+            lsm_error_free(lsm_err);
+        }
+    }
+    lsm_string_list_free(disk_paths);
+}
+END_TEST
+
 START_TEST(test_local_disk_led_status_get) {
     int rc = LSM_ERR_OK;
     lsm_string_list *disk_paths = NULL;
@@ -4057,6 +4486,393 @@ START_TEST(test_local_disk_link_speed_get) {
 }
 END_TEST
 
+START_TEST(test_async_requests) {
+    int rc = 0;
+    int fd = -1;
+    int done = 0;
+    uint32_t completed = 0;
+    uint32_t total = 0;
+    uint32_t count = 0;
+    uint32_t vol_count = 0;
+    lsm_request *vol_req = NULL;
+    lsm_request *pool_req = NULL;
+    lsm_request *create_req = NULL;
+    lsm_request *orphan_req = NULL;
+    lsm_request *delete_req = NULL;
+    lsm_volume **volumes = NULL;
+    lsm_pool **pools = NULL;
+    lsm_volume *new_vol = NULL;
+    char *job = NULL;
+    struct pollfd pfd;
+
+    lsm_pool *test_pool = get_test_pool(c);
+    ck_assert_msg(test_pool != NULL, "Expecting test pool");
+
+    G(rc, lsm_connect_fd_get, c, &fd, LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(fd >= 0, "Expecting valid connection fd, got %d", fd);
+
+    /* Pipeline several requests before reading any response, the orphaned
+     * one goes first so it is released before the others complete and is
+     * never counted as completed. */
+    G(rc, lsm_volume_list_async, c, "id", "non-existent-id", &orphan_req,
+      LSM_CLIENT_FLAG_RSVD);
+    G(rc, lsm_request_free, c, orphan_req);
+    G(rc, lsm_volume_list_async, c, NULL, NULL, &vol_req,
+      LSM_CLIENT_FLAG_RSVD);
+    G(rc, lsm_pool_list_async, c, NULL, NULL, &pool_req, LSM_CLIENT_FLAG_RSVD);
+    G(rc, lsm_volume_create_async, c, test_pool, "async_test_vol", 20000000,
+      LSM_VOLUME_PROVISION_DEFAULT, &create_req, LSM_CLIENT_FLAG_RSVD);
+
+    /* Blocking calls are refused while requests are outstanding */
+    F(rc, lsm_volume_list, c, NULL, NULL, &volumes, &vol_count,
+      LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "Expecting LSM_ERR_INVALID_ARGUMENT, got %d", rc);
+
+    /* Results are not available before completion */
+    G(rc, lsm_request_done, vol_req, &done);
+    if (!done) {
+        F(rc, lsm_request_volumes_get, c, vol_req, &volumes, &vol_count);
+    }
+
+    while (total < 3) {
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        ck_assert_msg(poll(&pfd, 1, 30000) == 1, "poll() timed out");
+
+        G(rc, lsm_connect_process, c, &completed, LSM_CLIENT_FLAG_RSVD);
+        total += completed;
+    }
+
+    ck_assert_msg(total == 3, "Expecting 3 completions, got %" PRIu32 "",
+                  total);
+
+    /* Every response has been consumed, nothing left to signal */
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    ck_assert_msg(poll(&pfd, 1, 0) == 0, "Expecting idle connection fd");
+
+    G(rc, lsm_request_done, vol_req, &done);
+    ck_assert_msg(done == 1, "Expecting done request");
+    G(rc, lsm_request_done, pool_req, &done);
+    ck_assert_msg(done == 1, "Expecting done request");
+    G(rc, lsm_request_done, create_req, &done);
+    ck_assert_msg(done == 1, "Expecting done request");
+
+    /* Wrong result type for request */
+    F(rc, lsm_request_pools_get, c, vol_req, &pools, &count);
+
+    G(rc, lsm_request_volumes_get, c, vol_req, &volumes, &vol_count);
+    G(rc, lsm_request_pools_get, c, pool_req, &pools, &count);
+    ck_assert_msg(count > 0, "Expecting some pools");
+
+    rc = lsm_request_volume_get(c, create_req, &new_vol, &job);
+    if (LSM_ERR_JOB_STARTED == rc) {
+        new_vol = wait_for_job_vol(c, &job);
+    } else {
+        ck_assert_msg(LSM_ERR_OK == rc, "rc = %d %s", rc,
+                      error(lsm_error_last_get(c)));
+    }
+    ck_assert_msg(new_vol != NULL, "Expecting new volume");
+
+    G(rc, lsm_request_free, c, vol_req);
+    G(rc, lsm_request_free, c, pool_req);
+    G(rc, lsm_request_free, c, create_req);
+
+    /* Complete the delete by polling the connection fd */
+    G(rc, lsm_volume_delete_async, c, new_vol, &delete_req,
+      LSM_CLIENT_FLAG_RSVD);
+    do {
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        ck_assert_msg(poll(&pfd, 1, 30000) == 1, "poll() timed out");
+        G(rc, lsm_connect_process, c, &completed, LSM_CLIENT_FLAG_RSVD);
+    } while (!completed);
+
+    rc = lsm_request_job_get(c, delete_req, &job);
+    if (LSM_ERR_JOB_STARTED == rc) {
+        wait_for_job(c, &job);
+    } else {
+        ck_assert_msg(LSM_ERR_OK == rc, "rc = %d %s", rc,
+                      error(lsm_error_last_get(c)));
+    }
+    G(rc, lsm_request_free, c, delete_req);
+
+    G(rc, lsm_volume_record_free, new_vol);
+    if (vol_count) {
+        G(rc, lsm_volume_record_array_free, volumes, vol_count);
+    }
+    G(rc, lsm_pool_record_array_free, pools, count);
+    G(rc, lsm_pool_record_free, test_pool);
+
+    /* Invalid arguments */
+    rc = lsm_request_done(NULL, &done);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "Expecting LSM_ERR_INVALID_ARGUMENT, got %d", rc);
+    rc = lsm_connect_process(c, NULL, LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "Expecting LSM_ERR_INVALID_ARGUMENT, got %d", rc);
+    rc = lsm_volume_list_async(c, NULL, NULL, NULL, LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "Expecting LSM_ERR_INVALID_ARGUMENT, got %d", rc);
+    rc = lsm_volume_list_async(c, NULL, NULL, &vol_req, ~LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "Expecting LSM_ERR_INVALID_ARGUMENT, got %d", rc);
+    rc = lsm_pool_list_async(c, NULL, NULL, &pool_req, ~LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(rc == LSM_ERR_INVALID_ARGUMENT,
+                  "Expecting LSM_ERR_INVALID_ARGUMENT, got %d", rc);
+}
+END_TEST
+
+struct rpc_timing_seen {
+    uint32_t calls;
+    lsm_rpc_timing last;
+};
+
+static void rpc_timing_cb(const lsm_rpc_timing *timing, void *user_data) {
+    struct rpc_timing_seen *seen = (struct rpc_timing_seen *)user_data;
+
+    seen->calls++;
+    seen->last = *timing;
+}
+
+START_TEST(test_rpc_timing) {
+    int rc = 0;
+    uint32_t count = 0;
+    lsm_pool **pools = NULL;
+    struct rpc_timing_seen seen;
+
+    memset(&seen, 0, sizeof(seen));
+
+    rc = lsm_connect_rpc_timing_cb_set(NULL, rpc_timing_cb, &seen,
+                                       LSM_CLIENT_FLAG_RSVD);
+    ck_assert_int_eq(rc, LSM_ERR_INVALID_ARGUMENT);
+
+    G(rc, lsm_connect_rpc_timing_cb_set, c, rpc_timing_cb, &seen,
+      LSM_CLIENT_FLAG_RSVD);
+
+    G(rc, lsm_pool_list, c, NULL, NULL, &pools, &count, LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(seen.calls == 1, "Expecting 1 timing report, got %u",
+                  seen.calls);
+    ASSERT_STR_MATCH(seen.last.method, "pools");
+    ck_assert_int_eq(seen.last.rc, LSM_ERR_OK);
+    ck_assert_msg(seen.last.request_bytes > 0 && seen.last.response_bytes > 0,
+                  "Expecting payload sizes, got %" PRIu64 "/%" PRIu64,
+                  seen.last.request_bytes, seen.last.response_bytes);
+    ck_assert_msg(seen.last.wait_ns > 0, "Expecting wait time");
+
+    if (count) {
+        G(rc, lsm_pool_record_array_free, pools, count);
+        pools = NULL;
+    }
+
+    /* Disabled again, nothing more should be reported */
+    G(rc, lsm_connect_rpc_timing_cb_set, c, NULL, NULL, LSM_CLIENT_FLAG_RSVD);
+    G(rc, lsm_pool_list, c, NULL, NULL, &pools, &count, LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(seen.calls == 1, "Expecting no more reports, got %u",
+                  seen.calls);
+
+    if (count) {
+        G(rc, lsm_pool_record_array_free, pools, count);
+    }
+}
+END_TEST
+
+START_TEST(test_simc_seed) {
+    int rc = 0;
+    char uri[_URI_BUFF_SIZE];
+    char seed_uri[_URI_BUFF_SIZE * 2];
+    lsm_connect *seed_c = NULL;
+    lsm_error_ptr e = NULL;
+    lsm_volume **vols = NULL;
+    lsm_access_group **ags = NULL;
+    uint32_t count = 0;
+
+    if (is_simc_plugin == 0) {
+        /* Inventory seeding is simc only */
+        return;
+    }
+
+    snprintf(seed_uri, sizeof(seed_uri),
+             "%s&seed=small,volumes:200,ags:10,fss:0,exports:0",
+             plugin_to_use(uri));
+
+    rc = lsm_connect_password(seed_uri, NULL, &seed_c, 30000, &e,
+                              LSM_CLIENT_FLAG_RSVD);
+    if (rc != LSM_ERR_OK)
+        dump_error(e);
+    ck_assert_int_eq(rc, LSM_ERR_OK);
+
+    G(rc, lsm_volume_list, seed_c, NULL, NULL, &vols, &count,
+      LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(count == 200, "Expecting 200 seeded volumes, got %u", count);
+    G(rc, lsm_volume_record_array_free, vols, count);
+
+    G(rc, lsm_access_group_list, seed_c, NULL, NULL, &ags, &count,
+      LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(count == 10, "Expecting 10 seeded access groups, got %u",
+                  count);
+    G(rc, lsm_access_group_record_array_free, ags, count);
+
+    G(rc, lsm_connect_close, seed_c, LSM_CLIENT_FLAG_RSVD);
+    seed_c = NULL;
+
+    /* Unknown profile, the plugin refuses to register */
+    snprintf(seed_uri, sizeof(seed_uri), "%s&seed=huge", plugin_to_use(uri));
+    rc = lsm_connect_password(seed_uri, NULL, &seed_c, 30000, &e,
+                              LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(rc != LSM_ERR_OK, "Expecting failure on unknown profile");
+    if (e != NULL) {
+        lsm_error_free(e);
+        e = NULL;
+    }
+
+    /* Two disks per pool would exceed the per type maximum of 90000 */
+    snprintf(seed_uri, sizeof(seed_uri), "%s&seed=pools:45001",
+             plugin_to_use(uri));
+    rc = lsm_connect_password(seed_uri, NULL, &seed_c, 30000, &e,
+                              LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(rc != LSM_ERR_OK, "Expecting failure on 45001 pools");
+    if (e != NULL)
+        lsm_error_free(e);
+}
+END_TEST
+
+START_TEST(test_simc_profile) {
+    int rc = 0;
+    char uri[_URI_BUFF_SIZE];
+    char profile_uri[_URI_BUFF_SIZE * 2];
+    char profile_path[_URI_BUFF_SIZE];
+    FILE *profile = NULL;
+    lsm_connect *profile_c = NULL;
+    lsm_error_ptr e = NULL;
+    lsm_volume **vols = NULL;
+    lsm_pool **pools = NULL;
+    uint32_t count = 0;
+    struct timespec start;
+    struct timespec end;
+    double elapsed = 0;
+
+    if (is_simc_plugin == 0) {
+        /* Latency and fault injection profile is simc only */
+        return;
+    }
+
+    snprintf(profile_path, sizeof(profile_path), "%s/lsm_sim_profile_%d",
+             getenv("LSM_TEST_RUNDIR"), (int)getpid());
+    profile = fopen(profile_path, "w");
+    ck_assert_msg(profile != NULL, "Failed to create %s", profile_path);
+    fprintf(profile, "seed=1\n"
+                     "*        latency=1\n"
+                     "volumes  fail_rate=1 fail_error=%d\n"
+                     "pools    latency=200 # milliseconds\n",
+            LSM_ERR_TIMEOUT);
+    fclose(profile);
+
+    snprintf(profile_uri, sizeof(profile_uri), "%s&profile=%s",
+             plugin_to_use(uri), profile_path);
+
+    rc = lsm_connect_password(profile_uri, NULL, &profile_c, 30000, &e,
+                              LSM_CLIENT_FLAG_RSVD);
+    if (rc != LSM_ERR_OK)
+        dump_error(e);
+    ck_assert_int_eq(rc, LSM_ERR_OK);
+
+    rc = lsm_volume_list(profile_c, NULL, NULL, &vols, &count,
+                         LSM_CLIENT_FLAG_RSVD);
+    ck_assert_msg(rc == LSM_ERR_TIMEOUT, "Expecting injected failure, got %d",
+                  rc);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    G(rc, lsm_pool_list, profile_c, NULL, NULL, &pools, &count,
+      LSM_CLIENT_FLAG_RSVD);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed = (end.tv_sec - start.tv_sec) +
+              (end.tv_nsec - start.tv_nsec) / 1000000000.0;
+    ck_assert_msg(elapsed >= 0.2, "Expecting 200ms latency, got %fs",
+                  elapsed);
+    G(rc, lsm_pool_record_array_free, pools, count);
+
+    G(rc, lsm_connect_close, profile_c, LSM_CLIENT_FLAG_RSVD);
+    unlink(profile_path);
+}
+END_TEST
+
+START_TEST(test_simc_memory_snapshot) {
+    int rc = 0;
+    char statefile[_URI_BUFF_SIZE];
+    char memory_uri[_URI_BUFF_SIZE * 2];
+    lsm_connect *memory_c = NULL;
+    lsm_error_ptr e = NULL;
+    lsm_pool *pool = NULL;
+    lsm_volume *vol = NULL;
+    lsm_volume **vols = NULL;
+    uint32_t count = 0;
+    uint32_t i = 0;
+    int found = 0;
+    char *job = NULL;
+
+    if (is_simc_plugin == 0) {
+        /* In-memory database is simc only */
+        return;
+    }
+
+    snprintf(statefile, sizeof(statefile), "%s/lsm_sim_snapshot_%d",
+             getenv("LSM_TEST_RUNDIR"), (int)getpid());
+    unlink(statefile);
+
+    /* Changes made in memory are saved to statefile on close */
+    snprintf(memory_uri, sizeof(memory_uri),
+             "simc://localhost/?statefile=%s&memory=snapshot", statefile);
+    rc = lsm_connect_password(memory_uri, NULL, &memory_c, 30000, &e,
+                              LSM_CLIENT_FLAG_RSVD);
+    if (rc != LSM_ERR_OK)
+        dump_error(e);
+    ck_assert_int_eq(rc, LSM_ERR_OK);
+
+    pool = get_test_pool(memory_c);
+    ck_assert_msg(pool != NULL, "pool = %p", pool);
+
+    rc = lsm_volume_create(memory_c, pool, "memory_snapshot_vol", 20000000,
+                           LSM_VOLUME_PROVISION_DEFAULT, &vol, &job,
+                           LSM_CLIENT_FLAG_RSVD);
+    if (LSM_ERR_JOB_STARTED == rc)
+        vol = wait_for_job_vol(memory_c, &job);
+    else
+        ck_assert_int_eq(rc, LSM_ERR_OK);
+    ck_assert_msg(vol != NULL, "vol = %p", vol);
+
+    G(rc, lsm_volume_record_free, vol);
+    G(rc, lsm_pool_record_free, pool);
+    G(rc, lsm_connect_close, memory_c, LSM_CLIENT_FLAG_RSVD);
+    memory_c = NULL;
+
+    /* Load the saved statefile with the on-disk database */
+    snprintf(memory_uri, sizeof(memory_uri),
+             "simc://localhost/?statefile=%s", statefile);
+    rc = lsm_connect_password(memory_uri, NULL, &memory_c, 30000, &e,
+                              LSM_CLIENT_FLAG_RSVD);
+    if (rc != LSM_ERR_OK)
+        dump_error(e);
+    ck_assert_int_eq(rc, LSM_ERR_OK);
+
+    G(rc, lsm_volume_list, memory_c, NULL, NULL, &vols, &count,
+      LSM_CLIENT_FLAG_RSVD);
+    for (i = 0; i < count; ++i) {
+        if (strcmp(lsm_volume_name_get(vols[i]), "memory_snapshot_vol") == 0)
+            found = 1;
+    }
+    ck_assert_msg(found == 1, "Volume created in memory was not saved");
+    G(rc, lsm_volume_record_array_free, vols, count);
+
+    G(rc, lsm_connect_close, memory_c, LSM_CLIENT_FLAG_RSVD);
+    unlink(statefile);
+}
+END_TEST
+
 Suite *lsm_suite(void) {
     Suite *s = suite_create("libStorageMgmt");
 
@@ -4103,6 +4919,10 @@ Suite *lsm_suite(void) {
     tcase_add_test(basic, test_volume_ident_led_on);
     tcase_add_test(basic, test_volume_ident_led_off);
     tcase_add_test(basic, test_local_disk_vpd83_search);
+    tcase_add_test(basic, test_local_disk_vpd83_bulk_search);
+    tcase_add_test(basic, test_local_disk_inventory);
+    tcase_add_test(basic, test_local_disk_info_list);
+    tcase_add_test(basic, test_local_disk_health_sampler);
     tcase_add_test(basic, test_local_disk_serial_num_get);
     tcase_add_test(basic, test_local_disk_vpd83_get);
     tcase_add_test(basic, test_read_cache_pct_update);
@@ -4117,8 +4937,14 @@ Suite *lsm_suite(void) {
     tcase_add_test(basic, test_volume_rcp_update);
     tcase_add_test(basic, test_local_disk_ident_led);
     tcase_add_test(basic, test_local_disk_fault_led);
+    tcase_add_test(basic, test_local_disk_led_batch);
     tcase_add_test(basic, test_local_disk_led_status_get);
     tcase_add_test(basic, test_local_disk_link_speed_get);
+    tcase_add_test(basic, test_async_requests);
+    tcase_add_test(basic, test_rpc_timing);
+    tcase_add_test(basic, test_simc_seed);
+    tcase_add_test(basic, test_simc_profile);
+    tcase_add_test(basic, test_simc_memory_snapshot);
 
     suite_add_tcase(s, basic);
     return s;
@@ -4135,6 +4961,11 @@ int main(int argc, char **argv) {
     if ((argc >= 2) && (argv[1] != NULL))
         is_simc_plugin = 1;
 
+    /* Run simc:// with in-memory database if second argument is 'memory' */
+    if ((is_simc_plugin == 1) && (argc >= 3) && (argv[2] != NULL) &&
+        (strcmp(argv[2], "memory") == 0))
+        is_simc_memory = 1;
+
     srunner_run_all(sr, CK_NORMAL);
 
     number_failed = srunner_ntests_failed(sr);
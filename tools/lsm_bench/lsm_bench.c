@@ -0,0 +1,810 @@
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Benchmark of the whole client/lsmd/plug-in stack.
+ *
+ * Every worker thread opens its own connection, so lsmd starts one plug-in
+ * process per worker, then runs operations picked at random from the mix
+ * until the duration is over.  Throughput and latency percentiles of every
+ * operation are reported as text, and optionally as JSON for regression
+ * tracking.
+ *
+ * Operations:
+ *      volume_list     lsm_volume_list()
+ *      pool_list       lsm_pool_list()
+ *      create_delete   lsm_volume_create() then lsm_volume_delete(), both
+ *                      including the wait for their jobs
+ *      mask_unmask     lsm_volume_mask() then lsm_volume_unmask() of a
+ *                      volume and access group created by the worker
+ *      job_poll        One lsm_job_status_volume_get() of a volume resize
+ *                      job kept running by the worker
+ *
+ * Objects created by the workers are deleted at the end.  With the sim and
+ * simc plug-ins create_delete is dominated by the simulated job duration,
+ * start lsmd with LSM_SIM_TIME=0 to measure the stack instead.
+ *
+ * Usage: lsm_bench [--uri URI] [--workers N] [--duration SECONDS]
+ *                  [--mix name=weight,...] [--json PATH]
+ * lsmd must be running (or LSM_UDS_PATH pointing to its socket directory).
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <libstoragemgmt/libstoragemgmt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_DEFAULT_URI        "simc://"
+#define BENCH_DEFAULT_MIX                                                      \
+    "volume_list=40,pool_list=20,create_delete=10,mask_unmask=20,job_poll=10"
+#define BENCH_DEFAULT_WORKERS    1
+#define BENCH_DEFAULT_SECONDS    10
+#define BENCH_DEFAULT_TIMEOUT_MS 30000
+#define BENCH_VOLUME_SIZE        (1024 * 1024)
+#define BENCH_JOB_POLL_MS        10
+#define BENCH_NAME_SIZE          128
+
+enum bench_op {
+    BENCH_OP_VOLUME_LIST = 0,
+    BENCH_OP_POOL_LIST,
+    BENCH_OP_CREATE_DELETE,
+    BENCH_OP_MASK_UNMASK,
+    BENCH_OP_JOB_POLL,
+    BENCH_OP_COUNT,
+};
+
+static const char *const op_names[BENCH_OP_COUNT] = {
+    "volume_list", "pool_list", "create_delete", "mask_unmask", "job_poll",
+};
+
+/* Latencies in nanoseconds of one operation */
+struct bench_samples {
+    uint64_t *ns;
+    size_t count;
+    size_t size;
+    uint64_t errors;
+};
+
+struct bench_worker {
+    pthread_t thread;
+    uint32_t index;
+    lsm_connect *c;
+    unsigned int seed;
+    lsm_pool *pool;
+    lsm_volume *volume;     /* Masked and unmasked by mask_unmask */
+    lsm_access_group *ag;   /* Used by mask_unmask */
+    lsm_volume *job_volume; /* Resized by job_poll */
+    char *job;              /* Resize job polled by job_poll */
+    int job_grow;           /* Next resize grows job_volume */
+    uint64_t created;       /* Volumes created by create_delete */
+    int started;            /* Thread of the current phase is running */
+    int setup_rc;
+    struct bench_samples samples[BENCH_OP_COUNT];
+};
+
+struct bench_config {
+    const char *uri;
+    const char *password;
+    const char *json_path;
+    uint32_t workers;
+    double seconds;
+    uint32_t timeout_ms;
+    uint32_t weights[BENCH_OP_COUNT];
+    uint32_t weight_total;
+};
+
+static struct bench_config cfg;
+/* CLOCK_MONOTONIC end of the run, read by every worker */
+static uint64_t deadline_ns = 0;
+
+static double now_sec(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void sleep_ms(uint32_t ms) {
+    struct timespec ts;
+
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+static void __attribute__((__noreturn__)) usage(const char *prog, int err) {
+    fprintf(err ? stderr : stdout,
+            "Usage: %s [options]\n"
+            "\n"
+            "Options:\n"
+            "  -u, --uri URI           Plug-in URI, default '%s'\n"
+            "  -P, --password PASS     Plug-in password\n"
+            "  -w, --workers N         Worker threads, each with its own "
+            "connection,\n"
+            "                          default %d\n"
+            "  -d, --duration SECONDS  Run time, default %d\n"
+            "  -m, --mix MIX           Operation weights, default\n"
+            "                          '%s'\n"
+            "  -t, --timeout MS        Plug-in timeout, default %d\n"
+            "  -j, --json PATH         Also write results as JSON to PATH, "
+            "'-' for\n"
+            "                          standard output\n"
+            "  -h, --help              Display this help and exit\n"
+            "\n"
+            "Operations: volume_list, pool_list, create_delete, "
+            "mask_unmask, job_poll\n"
+            "lsmd must be running (or LSM_UDS_PATH pointing to its socket "
+            "directory).\n",
+            prog, BENCH_DEFAULT_URI, BENCH_DEFAULT_WORKERS,
+            BENCH_DEFAULT_SECONDS, BENCH_DEFAULT_MIX,
+            BENCH_DEFAULT_TIMEOUT_MS);
+    exit(err);
+}
+
+/* Parses 'name=weight,...' into cfg.weights */
+static int mix_parse(const char *mix) {
+    char *copy = strdup(mix);
+    char *saveptr = NULL;
+    char *item = NULL;
+    char *value = NULL;
+    char *end = NULL;
+    unsigned long weight = 0;
+    int op = 0;
+    int rc = 0;
+
+    if (copy == NULL)
+        return -1;
+
+    memset(cfg.weights, 0, sizeof(cfg.weights));
+    cfg.weight_total = 0;
+
+    for (item = strtok_r(copy, ",", &saveptr); item != NULL;
+         item = strtok_r(NULL, ",", &saveptr)) {
+        value = strchr(item, '=');
+        if (value == NULL) {
+            rc = -1;
+            break;
+        }
+        *value++ = '\0';
+        errno = 0;
+        weight = strtoul(value, &end, 10);
+        if (errno || end == value || *end != '\0' || weight > 1000000) {
+            rc = -1;
+            break;
+        }
+        for (op = 0; op < BENCH_OP_COUNT; ++op) {
+            if (strcmp(item, op_names[op]) == 0)
+                break;
+        }
+        if (op == BENCH_OP_COUNT) {
+            rc = -1;
+            break;
+        }
+        cfg.weights[op] = weight;
+    }
+    free(copy);
+
+    for (op = 0; op < BENCH_OP_COUNT; ++op)
+        cfg.weight_total += cfg.weights[op];
+    if (cfg.weight_total == 0)
+        rc = -1;
+    if (rc != 0)
+        fprintf(stderr, "Invalid operation mix '%s'\n", mix);
+    return rc;
+}
+
+static void samples_add(struct bench_samples *s, uint64_t ns, int rc) {
+    uint64_t *grown = NULL;
+
+    if (rc != LSM_ERR_OK) {
+        s->errors++;
+        return;
+    }
+    if (s->count == s->size) {
+        grown = realloc(s->ns, (s->size ? s->size * 2 : 1024) *
+                                   sizeof(uint64_t));
+        if (grown == NULL) {
+            s->errors++;
+            return;
+        }
+        s->ns = grown;
+        s->size = s->size ? s->size * 2 : 1024;
+    }
+    s->ns[s->count++] = ns;
+}
+
+static void error_report(struct bench_worker *w, const char *what, int rc) {
+    lsm_error *e = lsm_error_last_get(w->c);
+
+    fprintf(stderr, "worker %" PRIu32 ": %s failed: %d %s\n", w->index, what,
+            rc, e != NULL ? lsm_error_message_get(e) : "");
+    lsm_error_free(e);
+}
+
+/*
+ * Waits for a job to finish, returning the volume it produced if vol is not
+ * NULL.  Frees the job.
+ */
+static int job_wait(struct bench_worker *w, char **job, lsm_volume **vol) {
+    lsm_job_status status = LSM_JOB_INPROGRESS;
+    uint8_t percent = 0;
+    int rc = LSM_ERR_OK;
+
+    while (status == LSM_JOB_INPROGRESS) {
+        if (vol != NULL)
+            rc = lsm_job_status_volume_get(w->c, *job, &status, &percent, vol,
+                                           LSM_CLIENT_FLAG_RSVD);
+        else
+            rc = lsm_job_status_get(w->c, *job, &status, &percent,
+                                    LSM_CLIENT_FLAG_RSVD);
+        if (rc != LSM_ERR_OK)
+            break;
+        if (status == LSM_JOB_INPROGRESS)
+            sleep_ms(BENCH_JOB_POLL_MS);
+        else if (status == LSM_JOB_ERROR)
+            rc = LSM_ERR_PLUGIN_BUG;
+    }
+    lsm_job_free(w->c, job, LSM_CLIENT_FLAG_RSVD);
+    return rc;
+}
+
+static int volume_create(struct bench_worker *w, const char *name,
+                         lsm_volume **vol) {
+    char *job = NULL;
+    int rc = LSM_ERR_OK;
+
+    *vol = NULL;
+    rc = lsm_volume_create(w->c, w->pool, name, BENCH_VOLUME_SIZE,
+                           LSM_VOLUME_PROVISION_DEFAULT, vol, &job,
+                           LSM_CLIENT_FLAG_RSVD);
+    if (rc == LSM_ERR_JOB_STARTED)
+        rc = job_wait(w, &job, vol);
+    return rc;
+}
+
+static int volume_delete(struct bench_worker *w, lsm_volume *vol) {
+    char *job = NULL;
+    int rc = LSM_ERR_OK;
+
+    rc = lsm_volume_delete(w->c, vol, &job, LSM_CLIENT_FLAG_RSVD);
+    if (rc == LSM_ERR_JOB_STARTED)
+        rc = job_wait(w, &job, NULL);
+    return rc;
+}
+
+/* Picks the pool able to hold volumes with the most free space */
+static int pool_pick(struct bench_worker *w) {
+    lsm_pool **pools = NULL;
+    uint32_t count = 0;
+    uint32_t i = 0;
+    uint32_t best = 0;
+    int found = 0;
+    int rc = LSM_ERR_OK;
+
+    rc = lsm_pool_list(w->c, NULL, NULL, &pools, &count,
+                       LSM_CLIENT_FLAG_RSVD);
+    if (rc != LSM_ERR_OK)
+        return rc;
+
+    for (i = 0; i < count; ++i) {
+        if (!(lsm_pool_element_type_get(pools[i]) &
+              LSM_POOL_ELEMENT_TYPE_VOLUME))
+            continue;
+        if (!found || lsm_pool_free_space_get(pools[i]) >
+                          lsm_pool_free_space_get(pools[best])) {
+            best = i;
+            found = 1;
+        }
+    }
+    if (found)
+        w->pool = lsm_pool_record_copy(pools[best]);
+    lsm_pool_record_array_free(pools, count);
+    return w->pool != NULL ? LSM_ERR_OK : LSM_ERR_NOT_FOUND_POOL;
+}
+
+/* Creates what the operations of the mix need */
+static int worker_setup(struct bench_worker *w) {
+    char name[BENCH_NAME_SIZE];
+    char iqn[BENCH_NAME_SIZE];
+    lsm_system **systems = NULL;
+    uint32_t count = 0;
+    lsm_error *e = NULL;
+    int rc = LSM_ERR_OK;
+
+    rc = lsm_connect_password(cfg.uri, cfg.password, &w->c, cfg.timeout_ms,
+                              &e, LSM_CLIENT_FLAG_RSVD);
+    if (rc != LSM_ERR_OK) {
+        fprintf(stderr, "worker %" PRIu32 ": connect to '%s' failed: %d %s\n",
+                w->index, cfg.uri, rc,
+                e != NULL ? lsm_error_message_get(e) : "");
+        lsm_error_free(e);
+        w->c = NULL;
+        return rc;
+    }
+
+    if (cfg.weights[BENCH_OP_CREATE_DELETE] ||
+        cfg.weights[BENCH_OP_MASK_UNMASK] || cfg.weights[BENCH_OP_JOB_POLL]) {
+        rc = pool_pick(w);
+        if (rc != LSM_ERR_OK) {
+            error_report(w, "pool_pick", rc);
+            return rc;
+        }
+    }
+
+    if (cfg.weights[BENCH_OP_MASK_UNMASK]) {
+        snprintf(name, sizeof(name), "lsm_bench_%d_%" PRIu32 "_masked",
+                 (int)getpid(), w->index);
+        rc = volume_create(w, name, &w->volume);
+        if (rc != LSM_ERR_OK) {
+            error_report(w, "volume_create", rc);
+            return rc;
+        }
+
+        rc = lsm_system_list(w->c, &systems, &count, LSM_CLIENT_FLAG_RSVD);
+        if (rc == LSM_ERR_OK && count == 0)
+            rc = LSM_ERR_NOT_FOUND_SYSTEM;
+        if (rc == LSM_ERR_OK) {
+            snprintf(name, sizeof(name), "lsm_bench_%d_%" PRIu32,
+                     (int)getpid(), w->index);
+            snprintf(iqn, sizeof(iqn),
+                     "iqn.2026-01.com.example:lsm-bench-%d-%" PRIu32,
+                     (int)getpid(), w->index);
+            rc = lsm_access_group_create(w->c, name, iqn,
+                                         LSM_ACCESS_GROUP_INIT_TYPE_ISCSI_IQN,
+                                         systems[0], &w->ag,
+                                         LSM_CLIENT_FLAG_RSVD);
+        }
+        if (systems != NULL)
+            lsm_system_record_array_free(systems, count);
+        if (rc != LSM_ERR_OK) {
+            error_report(w, "access_group_create", rc);
+            return rc;
+        }
+    }
+
+    if (cfg.weights[BENCH_OP_JOB_POLL]) {
+        snprintf(name, sizeof(name), "lsm_bench_%d_%" PRIu32 "_resized",
+                 (int)getpid(), w->index);
+        rc = volume_create(w, name, &w->job_volume);
+        if (rc != LSM_ERR_OK) {
+            error_report(w, "volume_create", rc);
+            return rc;
+        }
+        w->job_grow = 1;
+    }
+    return LSM_ERR_OK;
+}
+
+static void worker_cleanup(struct bench_worker *w) {
+    lsm_volume *resized = NULL;
+
+    if (w->c == NULL)
+        return;
+
+    if (w->job != NULL) {
+        job_wait(w, &w->job, &resized);
+        lsm_volume_record_free(resized);
+    }
+    if (w->job_volume != NULL) {
+        volume_delete(w, w->job_volume);
+        lsm_volume_record_free(w->job_volume);
+    }
+    if (w->ag != NULL) {
+        lsm_access_group_delete(w->c, w->ag, LSM_CLIENT_FLAG_RSVD);
+        lsm_access_group_record_free(w->ag);
+    }
+    if (w->volume != NULL) {
+        volume_delete(w, w->volume);
+        lsm_volume_record_free(w->volume);
+    }
+    lsm_pool_record_free(w->pool);
+    lsm_connect_close(w->c, LSM_CLIENT_FLAG_RSVD);
+    w->c = NULL;
+}
+
+static int op_volume_list(struct bench_worker *w) {
+    lsm_volume **volumes = NULL;
+    uint32_t count = 0;
+    int rc = lsm_volume_list(w->c, NULL, NULL, &volumes, &count,
+                             LSM_CLIENT_FLAG_RSVD);
+
+    if (rc == LSM_ERR_OK)
+        lsm_volume_record_array_free(volumes, count);
+    return rc;
+}
+
+static int op_pool_list(struct bench_worker *w) {
+    lsm_pool **pools = NULL;
+    uint32_t count = 0;
+    int rc = lsm_pool_list(w->c, NULL, NULL, &pools, &count,
+                           LSM_CLIENT_FLAG_RSVD);
+
+    if (rc == LSM_ERR_OK)
+        lsm_pool_record_array_free(pools, count);
+    return rc;
+}
+
+static int op_create_delete(struct bench_worker *w) {
+    char name[BENCH_NAME_SIZE];
+    lsm_volume *vol = NULL;
+    int rc = LSM_ERR_OK;
+
+    snprintf(name, sizeof(name), "lsm_bench_%d_%" PRIu32 "_%" PRIu64,
+             (int)getpid(), w->index, w->created++);
+    rc = volume_create(w, name, &vol);
+    if (rc == LSM_ERR_OK) {
+        rc = volume_delete(w, vol);
+        lsm_volume_record_free(vol);
+    }
+    return rc;
+}
+
+static int op_mask_unmask(struct bench_worker *w) {
+    int rc = lsm_volume_mask(w->c, w->ag, w->volume, LSM_CLIENT_FLAG_RSVD);
+
+    if (rc == LSM_ERR_OK)
+        rc = lsm_volume_unmask(w->c, w->ag, w->volume, LSM_CLIENT_FLAG_RSVD);
+    return rc;
+}
+
+/*
+ * Polls the resize job once, starting a new one first if the previous job
+ * is done.  Resizes alternate between growing and shrinking back.
+ */
+static int op_job_poll(struct bench_worker *w) {
+    lsm_job_status status = LSM_JOB_INPROGRESS;
+    uint8_t percent = 0;
+    lsm_volume *resized = NULL;
+    uint64_t size = 0;
+    int rc = LSM_ERR_OK;
+
+    if (w->job == NULL) {
+        size = w->job_grow ? BENCH_VOLUME_SIZE * 2 : BENCH_VOLUME_SIZE;
+        rc = lsm_volume_resize(w->c, w->job_volume, size, &resized, &w->job,
+                               LSM_CLIENT_FLAG_RSVD);
+        w->job_grow = !w->job_grow;
+        if (rc == LSM_ERR_OK) {
+            /* Completed at once, nothing to poll */
+            lsm_volume_record_free(w->job_volume);
+            w->job_volume = resized;
+            return LSM_ERR_OK;
+        }
+        if (rc != LSM_ERR_JOB_STARTED)
+            return rc;
+    }
+
+    rc = lsm_job_status_volume_get(w->c, w->job, &status, &percent, &resized,
+                                   LSM_CLIENT_FLAG_RSVD);
+    if (rc == LSM_ERR_OK && status != LSM_JOB_INPROGRESS) {
+        if (resized != NULL) {
+            lsm_volume_record_free(w->job_volume);
+            w->job_volume = resized;
+        }
+        lsm_job_free(w->c, &w->job, LSM_CLIENT_FLAG_RSVD);
+        w->job = NULL;
+        if (status == LSM_JOB_ERROR)
+            rc = LSM_ERR_PLUGIN_BUG;
+    }
+    return rc;
+}
+
+static int (*const op_funcs[BENCH_OP_COUNT])(struct bench_worker *w) = {
+    op_volume_list, op_pool_list, op_create_delete, op_mask_unmask,
+    op_job_poll,
+};
+
+static enum bench_op op_pick(struct bench_worker *w) {
+    uint32_t pick = rand_r(&w->seed) % cfg.weight_total;
+    int op = 0;
+
+    for (op = 0; op < BENCH_OP_COUNT - 1; ++op) {
+        if (pick < cfg.weights[op])
+            break;
+        pick -= cfg.weights[op];
+    }
+    return (enum bench_op)op;
+}
+
+static void *worker_run(void *arg) {
+    struct bench_worker *w = (struct bench_worker *)arg;
+    enum bench_op op = BENCH_OP_VOLUME_LIST;
+    uint64_t start = 0;
+    int rc = LSM_ERR_OK;
+
+    while (now_ns() < __atomic_load_n(&deadline_ns, __ATOMIC_RELAXED)) {
+        op = op_pick(w);
+        start = now_ns();
+        rc = op_funcs[op](w);
+        samples_add(&w->samples[op], now_ns() - start, rc);
+        if (rc != LSM_ERR_OK && w->samples[op].errors == 1)
+            error_report(w, op_names[op], rc);
+    }
+    return NULL;
+}
+
+static void *worker_setup_run(void *arg) {
+    struct bench_worker *w = (struct bench_worker *)arg;
+
+    w->setup_rc = worker_setup(w);
+    return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+/* Nearest rank percentile of sorted samples, in milliseconds */
+static double percentile_ms(const struct bench_samples *s, uint32_t p) {
+    size_t rank = 0;
+
+    if (s->count == 0)
+        return 0;
+    rank = (s->count * p + 99) / 100;
+    if (rank == 0)
+        rank = 1;
+    return s->ns[rank - 1] / 1e6;
+}
+
+/* Merges the samples of every worker into total, sorted */
+static int samples_merge(struct bench_worker *workers, int op,
+                         struct bench_samples *total) {
+    uint32_t i = 0;
+
+    memset(total, 0, sizeof(*total));
+    for (i = 0; i < cfg.workers; ++i)
+        total->count += workers[i].samples[op].count;
+
+    if (total->count) {
+        total->ns = malloc(total->count * sizeof(uint64_t));
+        if (total->ns == NULL)
+            return -1;
+    }
+    total->count = 0;
+    for (i = 0; i < cfg.workers; ++i) {
+        if (workers[i].samples[op].count)
+            memcpy(total->ns + total->count, workers[i].samples[op].ns,
+                   workers[i].samples[op].count * sizeof(uint64_t));
+        total->count += workers[i].samples[op].count;
+        total->errors += workers[i].samples[op].errors;
+    }
+    qsort(total->ns, total->count, sizeof(uint64_t), cmp_u64);
+    return 0;
+}
+
+/* Writes s as a JSON string, quotes included */
+static void json_string_print(FILE *f, const char *s) {
+    const unsigned char *p = (const unsigned char *)s;
+
+    fputc('"', f);
+    for (; *p; ++p) {
+        if (*p == '"' || *p == '\\')
+            fprintf(f, "\\%c", *p);
+        else if (*p < 0x20)
+            fprintf(f, "\\u%04x", *p);
+        else
+            fputc(*p, f);
+    }
+    fputc('"', f);
+}
+
+static void report(struct bench_samples *totals, double elapsed) {
+    FILE *json = NULL;
+    int first = 1;
+    int op = 0;
+
+    printf("uri: %s workers: %" PRIu32 " duration: %.1fs\n", cfg.uri,
+           cfg.workers, elapsed);
+    printf("%-14s %9s %7s %10s %9s %9s %9s %9s\n", "operation", "count",
+           "errors", "ops/s", "p50 ms", "p95 ms", "p99 ms", "max ms");
+    for (op = 0; op < BENCH_OP_COUNT; ++op) {
+        if (!cfg.weights[op])
+            continue;
+        printf("%-14s %9zu %7" PRIu64 " %10.1f %9.3f %9.3f %9.3f %9.3f\n",
+               op_names[op], totals[op].count, totals[op].errors,
+               totals[op].count / elapsed, percentile_ms(&totals[op], 50),
+               percentile_ms(&totals[op], 95), percentile_ms(&totals[op], 99),
+               percentile_ms(&totals[op], 100));
+    }
+    fflush(stdout);
+
+    if (cfg.json_path == NULL)
+        return;
+
+    if (strcmp(cfg.json_path, "-") == 0) {
+        json = stdout;
+    } else {
+        json = fopen(cfg.json_path, "w");
+        if (json == NULL) {
+            fprintf(stderr, "Failed to open '%s': %s\n", cfg.json_path,
+                    strerror(errno));
+            return;
+        }
+    }
+
+    fprintf(json, "{\"uri\": ");
+    json_string_print(json, cfg.uri);
+    fprintf(json,
+            ", \"workers\": %" PRIu32 ", \"duration\": %.3f, "
+            "\"operations\": {",
+            cfg.workers, elapsed);
+    for (op = 0; op < BENCH_OP_COUNT; ++op) {
+        if (!cfg.weights[op])
+            continue;
+        fprintf(json,
+                "%s\"%s\": {\"count\": %zu, \"errors\": %" PRIu64 ", "
+                "\"ops_per_sec\": %.3f, \"p50_ms\": %.3f, \"p95_ms\": %.3f, "
+                "\"p99_ms\": %.3f, \"max_ms\": %.3f}",
+                first ? "" : ", ", op_names[op], totals[op].count,
+                totals[op].errors, totals[op].count / elapsed,
+                percentile_ms(&totals[op], 50), percentile_ms(&totals[op], 95),
+                percentile_ms(&totals[op], 99),
+                percentile_ms(&totals[op], 100));
+        first = 0;
+    }
+    fprintf(json, "}}\n");
+
+    if (json != stdout)
+        fclose(json);
+    else
+        fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+    static const struct option long_options[] = {
+        {"uri", required_argument, NULL, 'u'},
+        {"password", required_argument, NULL, 'P'},
+        {"workers", required_argument, NULL, 'w'},
+        {"duration", required_argument, NULL, 'd'},
+        {"mix", required_argument, NULL, 'm'},
+        {"timeout", required_argument, NULL, 't'},
+        {"json", required_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    struct bench_worker *workers = NULL;
+    struct bench_samples totals[BENCH_OP_COUNT];
+    const char *mix = BENCH_DEFAULT_MIX;
+    double start = 0;
+    uint64_t errors = 0;
+    uint32_t i = 0;
+    int failed = 0;
+    int op = 0;
+    int c = 0;
+
+    cfg.uri = BENCH_DEFAULT_URI;
+    cfg.workers = BENCH_DEFAULT_WORKERS;
+    cfg.seconds = BENCH_DEFAULT_SECONDS;
+    cfg.timeout_ms = BENCH_DEFAULT_TIMEOUT_MS;
+
+    while ((c = getopt_long(argc, argv, "u:P:w:d:m:t:j:h", long_options,
+                            NULL)) != -1) {
+        switch (c) {
+        case 'u':
+            cfg.uri = optarg;
+            break;
+        case 'P':
+            cfg.password = optarg;
+            break;
+        case 'w':
+            cfg.workers = strtoul(optarg, NULL, 10);
+            break;
+        case 'd':
+            cfg.seconds = strtod(optarg, NULL);
+            break;
+        case 'm':
+            mix = optarg;
+            break;
+        case 't':
+            cfg.timeout_ms = strtoul(optarg, NULL, 10);
+            break;
+        case 'j':
+            cfg.json_path = optarg;
+            break;
+        case 'h':
+            usage(argv[0], EXIT_SUCCESS);
+        default:
+            usage(argv[0], EXIT_FAILURE);
+        }
+    }
+    if (optind != argc || cfg.workers == 0 || cfg.seconds <= 0)
+        usage(argv[0], EXIT_FAILURE);
+    if (mix_parse(mix) != 0)
+        return EXIT_FAILURE;
+
+    workers = calloc(cfg.workers, sizeof(struct bench_worker));
+    if (workers == NULL)
+        return EXIT_FAILURE;
+
+    /* Connect and create the objects of every worker in parallel */
+    for (i = 0; i < cfg.workers; ++i) {
+        workers[i].index = i;
+        workers[i].seed = (unsigned int)time(NULL) + i;
+        if (pthread_create(&workers[i].thread, NULL, worker_setup_run,
+                           &workers[i]) == 0)
+            workers[i].started = 1;
+        else
+            failed = 1;
+    }
+    for (i = 0; i < cfg.workers; ++i) {
+        if (workers[i].started)
+            pthread_join(workers[i].thread, NULL);
+    }
+    for (i = 0; i < cfg.workers; ++i) {
+        if (!workers[i].started || workers[i].setup_rc != LSM_ERR_OK)
+            failed = 1;
+        workers[i].started = 0;
+    }
+
+    if (!failed) {
+        start = now_sec();
+        __atomic_store_n(&deadline_ns,
+                         now_ns() + (uint64_t)(cfg.seconds * 1e9),
+                         __ATOMIC_RELAXED);
+        for (i = 0; i < cfg.workers; ++i) {
+            if (pthread_create(&workers[i].thread, NULL, worker_run,
+                               &workers[i]) != 0) {
+                fprintf(stderr, "Failed to start worker %" PRIu32 "\n", i);
+                __atomic_store_n(&deadline_ns, 0, __ATOMIC_RELAXED);
+                failed = 1;
+                break;
+            }
+            workers[i].started = 1;
+        }
+        for (i = 0; i < cfg.workers; ++i) {
+            if (workers[i].started)
+                pthread_join(workers[i].thread, NULL);
+        }
+
+        if (!failed) {
+            for (op = 0; op < BENCH_OP_COUNT; ++op) {
+                if (samples_merge(workers, op, &totals[op]) != 0)
+                    return EXIT_FAILURE;
+                errors += totals[op].errors;
+            }
+            report(totals, now_sec() - start);
+            for (op = 0; op < BENCH_OP_COUNT; ++op)
+                free(totals[op].ns);
+            if (errors)
+                failed = 1;
+        }
+    }
+
+    for (i = 0; i < cfg.workers; ++i) {
+        worker_cleanup(&workers[i]);
+        for (op = 0; op < BENCH_OP_COUNT; ++op)
+            free(workers[i].samples[op].ns);
+    }
+    free(workers);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -54,10 +54,6 @@
     from ordereddict import OrderedDict
 
 
-# Used to speed up volume listing routines
-LOCAL_DISK_LOOKUP = None
-
-
 # Wraps the invocation to the command line
 # @param    c   Object to invoke calls on (optional)
 def cmd_line_wrapper(c=None):
@@ -345,34 +341,24 @@ def _add_common_options(arg_parser, is_child=False):
         arg_parser.set_defaults(**default_dict)
 
 
-def _sd_paths_cache():
-    lookup = {}
-    for d in LocalDisk.list():
-        try:
-            vpd = LocalDisk.vpd83_get(d)
-            lookup[vpd] = d
-        except LsmError as lsm_err:
-            if lsm_err.code != ErrorNumber.NO_SUPPORT:
-                raise
-    return lookup
-
-
-def _add_sd_paths(lsm_obj):
-    global LOCAL_DISK_LOOKUP
-    lsm_obj.sd_paths = []
-
-    if LOCAL_DISK_LOOKUP is None:
-        LOCAL_DISK_LOOKUP = _sd_paths_cache()
+def _add_sd_paths(lsm_objs):
+    """
+    Set the sd_paths property of every volume or disk in lsm_objs, looking
+    all of them up in a single pass over the local disks.
+    """
+    sd_paths = {}
+    vpd83s = set(o.vpd83 for o in lsm_objs if len(o.vpd83) > 0)
 
     try:
-        if len(lsm_obj.vpd83) > 0:
-            # If we know of this vpd we will go out and get the paths.
-            if lsm_obj.vpd83 in LOCAL_DISK_LOOKUP:
-                lsm_obj.sd_paths = LocalDisk.vpd83_search(lsm_obj.vpd83)
+        if len(vpd83s) > 0:
+            sd_paths = LocalDisk.vpd83_bulk_search(vpd83s)
     except LsmError as lsm_err:
         if lsm_err.code != ErrorNumber.NO_SUPPORT:
             raise
-    return lsm_obj
+
+    for lsm_obj in lsm_objs:
+        lsm_obj.sd_paths = sd_paths.get(lsm_obj.vpd83, [])
+    return lsm_objs
 
 
 # This class represents a command line argument error
@@ -544,6 +530,11 @@ def _check_network_host(addr):
         help='Retrieves plugin description and version',
     ),
 
+    dict(
+        name='plugin-stats',
+        help='Retrieves plugin per method call statistics',
+    ),
+
     dict(
         name='volume-create',
         help='Creates a volume (logical unit)',
@@ -1331,7 +1322,7 @@ def list(self, args):
             else:
                 lsm_vols = self.c.volumes(search_key, search_value)
 
-            self.display_data(list(_add_sd_paths(v) for v in lsm_vols))
+            self.display_data(_add_sd_paths(lsm_vols))
 
         elif args.type == 'POOLS':
             if search_key == 'pool_id':
@@ -1398,8 +1389,7 @@ def list(self, args):
                 raise ArgError("Search key '%s' is not supported by "
                                "disk listing" % search_key)
             self.display_data(
-                list(_add_sd_paths(d)
-                     for d in self.c.disks(search_key, search_value)))
+                _add_sd_paths(self.c.disks(search_key, search_value)))
         elif args.type == 'TARGET_PORTS':
             if search_key == 'tgt_port_id':
                 search_key = 'id'
@@ -1454,7 +1444,7 @@ def access_group_volumes(self, args):
         agl = self.c.access_groups()
         group = _get_item(agl, args.ag, "Access Group")
         vols = self.c.volumes_accessible_by_access_group(group)
-        self.display_data(list(_add_sd_paths(v) for v in vols))
+        self.display_data(_add_sd_paths(vols))
 
     def iscsi_chap(self, args):
         (init_id, init_type) = parse_convert_init(args.init)
@@ -1605,6 +1595,39 @@ def plugin_info(self, args):
         else:
             out("Description: %s Version: %s" % (desc, version))
 
+    def plugin_stats(self, args):
+        sep = DisplayData.DEFAULT_SPLITTER
+        if self.args.sep is not None:
+            sep = self.args.sep
+
+        data = []
+        for m in self.c.plugin_stats():
+            d = OrderedDict()
+            d['Method'] = m['method']
+            d['Calls'] = m['calls']
+            d['Errors'] = m['errors']
+            d['Average (us)'] = m['total_us'] // max(m['calls'], 1)
+            d['Max (us)'] = m['max_us']
+            d['Bytes In'] = m['bytes_in']
+            d['Bytes Out'] = m['bytes_out']
+
+            # Bucket i holds calls which took [2^i, 2^(i+1)) microseconds
+            last = len(m['histogram']) - 1
+            latency = []
+            for i, count in enumerate(m['histogram']):
+                if count == 0:
+                    continue
+                low = 0 if i == 0 else 2 ** i
+                if i == last:
+                    latency.append("%d+ us: %d" % (low, count))
+                else:
+                    latency.append("%d-%d us: %d" %
+                                   (low, 2 ** (i + 1) - 1, count))
+            d['Latency'] = latency
+            data.append(d)
+
+        DisplayData.display_data_script_way(data, sep)
+
     # Creates a volume
     def volume_create(self, args):
         # Get pool
@@ -1616,7 +1639,7 @@ def volume_create(self, args):
                 args.name,
                 self._size(args.size),
                 vol_provision_str_to_type(args.provisioning)))
-        self.display_data([_add_sd_paths(vol)])
+        self.display_data(_add_sd_paths([vol]))
 
     # Creates a snapshot
     def fs_snap_create(self, args):
@@ -1705,7 +1728,7 @@ def job_status(self, args):
 
         if s == JobStatus.COMPLETE:
             if item:
-                self.display_data([_add_sd_paths(item)])
+                self.display_data(_add_sd_paths([item]))
 
             self.c.job_free(args.job)
         else:
@@ -1727,7 +1750,7 @@ def volume_replicate(self, args):
         vol = self._wait_for_it(
             "replicate volume",
             *self.c.volume_replicate(p, rep_type, v, args.name))
-        self.display_data([_add_sd_paths(vol)])
+        self.display_data(_add_sd_paths([vol]))
 
     # Check to see if block ranges are overlapping
     @staticmethod
@@ -1827,7 +1850,7 @@ def volume_resize(self, args):
         if self.confirm_prompt(False):
             vol = self._wait_for_it("resize",
                                     *self.c.volume_resize(v, size))
-            self.display_data([_add_sd_paths(vol)])
+            self.display_data(_add_sd_paths([vol]))
 
     # Enable a volume
     def volume_enable(self, args):
@@ -1915,10 +1938,10 @@ def volume_raid_create(self, args):
         else:
             strip_size = Volume.VCR_STRIP_SIZE_DEFAULT
 
-        self.display_data([
-            _add_sd_paths(
+        self.display_data(
+            _add_sd_paths([
                 self.c.volume_raid_create(
-                    args.name, raid_type, lsm_disks, strip_size))])
+                    args.name, raid_type, lsm_disks, strip_size)]))
 
     def volume_raid_create_cap(self, args):
         lsm_sys = _get_item(self.c.systems(), args.sys, "System")
@@ -2080,15 +2103,20 @@ def process(self, cli=None):
     def local_disk_list(self, args):
         local_disks = []
         func_dict = {
-            "vpd83": LocalDisk.vpd83_get,
-            "rpm": LocalDisk.rpm_get,
-            "link_type": LocalDisk.link_type_get,
-            "serial_num": LocalDisk.serial_num_get,
-            "led_status": LocalDisk.led_status_get,
-            "link_speed": LocalDisk.link_speed_get,
-            "health_status": LocalDisk.health_status_get,
+            "vpd83": LocalDisk.vpd83_bulk_get,
+            "rpm": LocalDisk.rpm_bulk_get,
+            "link_type": LocalDisk.link_type_bulk_get,
+            "serial_num": LocalDisk.serial_num_bulk_get,
+            "led_status": LocalDisk.led_status_bulk_get,
+            "link_speed": LocalDisk.link_speed_bulk_get,
+            "health_status": LocalDisk.health_status_bulk_get,
         }
-        for disk_path in LocalDisk.list():
+        disk_paths = LocalDisk.list()
+        # Query each property of all disks in one call instead of one call
+        # per disk and property.
+        bulk_dict = dict((key, func(disk_paths))
+                         for key, func in func_dict.items())
+        for disk_path in disk_paths:
             info_dict = {
                 "vpd83": "",
                 "rpm": Disk.RPM_NO_SUPPORT,
@@ -2099,13 +2127,12 @@ def local_disk_list(self, args):
                 "health_status": Disk.HEALTH_STATUS_UNKNOWN,
             }
             for key in info_dict.keys():
-                try:
-                    info_dict[key] = func_dict[key](disk_path)
-                except LsmError as lsm_err:
-                    if lsm_err.code != ErrorNumber.NO_SUPPORT:
-                        sys.stderr.write("WARN: %s('%s'): %d %s\n" %
-                                         (func_dict[key].__name__, disk_path,
-                                          lsm_err.code, lsm_err.msg))
+                value = bulk_dict[key][disk_path]
+                if not isinstance(value, LsmError):
+                    info_dict[key] = value
+                elif value.code != ErrorNumber.NO_SUPPORT:
+                    sys.stderr.write("WARN: %s_get('%s'): %d %s\n" %
+                                     (key, disk_path, value.code, value.msg))
 
             local_disks.append(
                 LocalDiskInfo(disk_path,